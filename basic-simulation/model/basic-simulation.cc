@@ -20,6 +20,7 @@
  */
 
 #include "basic-simulation.h"
+#include "log_sink.h"
 
 namespace ns3 {
 
@@ -55,6 +56,27 @@ BasicSimulation::BasicSimulation(std::string run_dir) {
     WriteFinished(false);
 }
 
+void BasicSimulation::ConfigureVariant(std::string run_dir, const std::map<std::string, std::string>& config_overrides) {
+    std::cout << "CONFIGURE SWEEP VARIANT" << std::endl;
+
+    // Keys read while the shared scenario was built have already taken effect
+    for (const std::pair<std::string, std::string> key_val : config_overrides) {
+        if (m_configRequestedKeys.find(key_val.first) != m_configRequestedKeys.end()) {
+            throw std::runtime_error(format_string("Config key \'%s\' was read while building the shared scenario, it cannot differ between sweep variants", key_val.first.c_str()));
+        }
+        m_config[key_val.first] = key_val.second;
+        printf("  > %-40s  %s\n", key_val.first.c_str(), key_val.second.c_str());
+    }
+    printf("\n");
+
+    // Files registered by the shared scenario move along with the results
+    LogSink::Redirect(m_run_dir + "/", run_dir + "/");
+    m_run_dir = run_dir;
+    ConfigureRunDirectory();
+    PrepareBasicSimulationLogFiles();
+    WriteFinished(false);
+}
+
 int64_t BasicSimulation::NowNsSinceEpoch() {
     return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
@@ -189,6 +211,19 @@ void BasicSimulation::ConfigureSimulation() {
     Simulator::Stop(NanoSeconds(m_simulation_end_time_ns));
     printf("  > Duration......... %.2f s (%" PRId64 " ns)\n", m_simulation_end_time_ns / 1e9, m_simulation_end_time_ns);
 
+    // Result and log files are written by the log sink thread
+    uint32_t log_sink_ring_records = parse_geq_one_int64(GetConfigParamOrDefault("log_sink_ring_records", "16384"));
+    uint64_t log_sink_ring_bytes = parse_geq_one_int64(GetConfigParamOrDefault("log_sink_ring_megabytes", "64")) << 20;
+    std::string log_sink_backpressure = GetConfigParamOrDefault("log_sink_backpressure", "block");
+    if (log_sink_backpressure == "block") {
+        LogSink::Configure(log_sink_ring_records, log_sink_ring_bytes, LogSink::BLOCK);
+    } else if (log_sink_backpressure == "drop") {
+        LogSink::Configure(log_sink_ring_records, log_sink_ring_bytes, LogSink::DROP);
+    } else {
+        throw std::runtime_error(format_string("Unknown log sink backpressure policy: %s", log_sink_backpressure.c_str()));
+    }
+    printf("  > Log sink......... %u records / %" PRIu64 " MB per thread, %s when full\n", log_sink_ring_records, log_sink_ring_bytes >> 20, log_sink_backpressure.c_str());
+
     std::cout << std::endl;
     RegisterTimestamp("Configure simulator");
 }
@@ -389,6 +424,12 @@ void BasicSimulation::Finalize() {
     }
     std::cout << std::endl;
 
+    // Everything queued by the results writers is on disk before the run is marked finished
+    LogSink::Shutdown();
+    if (LogSink::GetNDropped() > 0) {
+        printf("  > Log sink dropped %" PRIu64 " record(s)\n\n", LogSink::GetNDropped());
+    }
+
     WriteFinished(true);
 
     if (m_enable_distributed) {
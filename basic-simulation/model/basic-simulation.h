@@ -78,6 +78,9 @@ public:
 
     void CleanUpSimulation();
 
+    // Sweep variant, see SimulationSweep
+    void ConfigureVariant(std::string run_dir, const std::map<std::string, std::string>& config_overrides);
+
 private:
 
     // Internal setup
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "benchmark_report.h"
+#include "exp-util.h"
+#include "log_sink.h"
+
+namespace ns3 {
+
+	// written by a run, never linked into a derived run directory
+	static const std::set<std::string> BENCHMARK_OUTPUT_ENTRIES = {"logs_ns3", "results", "ITERATION", "pcap"};
+
+	static std::string
+	ResolvePath(const std::string& dirname){
+		char* path = realpath(dirname.c_str(), NULL);
+		if(path == NULL){
+			throw std::runtime_error("Cannot resolve run directory " + dirname);
+		}
+		std::string resolved = path;
+		free(path);
+		return resolved;
+	}
+
+	BenchmarkReport::BenchmarkReport (std::string suite, std::string outputFilename)
+		: m_suite(suite),
+		  m_outputFilename(outputFilename),
+		  m_nRecords(0){
+
+	}
+
+	BenchmarkReport::~BenchmarkReport (){
+
+	}
+
+	int64_t
+	BenchmarkReport::NowNs(){
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void
+	BenchmarkReport::Record(std::string name, const nlohmann::json& parameters, uint64_t iterations, int64_t wallclockNs,
+			uint64_t events, const nlohmann::json& counters){
+		nlohmann::ordered_json record;
+		record["suite"] = m_suite;
+		record["benchmark"] = name;
+		record["parameters"] = parameters.is_null() ? nlohmann::json::object() : parameters;
+		record["iterations"] = iterations;
+		record["wallclock_ns"] = wallclockNs;
+		record["ns_per_iteration"] = iterations == 0 ? 0.0 : double(wallclockNs) / iterations;
+		record["events"] = events;
+		record["events_per_s"] = wallclockNs <= 0 ? 0.0 : events * 1e9 / wallclockNs;
+		record["counters"] = counters;
+		std::string line = record.dump();
+
+		std::cout << line << std::endl;
+		if(!m_outputFilename.empty()){
+			// appended one line at a time, the programs measuring in child processes share the file
+			std::ofstream ofs(m_outputFilename, std::ofstream::out | std::ofstream::app);
+			ofs << line << std::endl;
+			if(!ofs){
+				throw std::runtime_error("Cannot write benchmark results to " + m_outputFilename);
+			}
+		}
+		m_nRecords++;
+	}
+
+	uint32_t
+	BenchmarkReport::GetNRecords() const{
+		return m_nRecords;
+	}
+
+	void
+	BenchmarkReport::DeriveRunDir(std::string templateRunDir, std::string runDir, const std::map<std::string, nlohmann::json>& patches){
+		// absolute, to recognize runDir inside the template
+		std::string templatePath = ResolvePath(templateRunDir);
+		if(dir_exists(runDir) && ResolvePath(runDir) == templatePath){
+			throw std::invalid_argument("A run directory cannot be derived from itself: " + runDir);
+		}
+		remove_dir_and_subfile_if_exists(runDir);
+		mkdir_force_if_not_exists(runDir);
+		templateRunDir = templatePath;
+		runDir = ResolvePath(runDir);
+
+		// patches of the entries of this directory, by entry
+		std::map<std::string, std::map<std::string, nlohmann::json>> entryPatches;
+		for(auto& patch : patches){
+			size_t slash = patch.first.find('/');
+			std::string entry = patch.first.substr(0, slash);
+			entryPatches[entry][slash == std::string::npos ? "" : patch.first.substr(slash + 1)] = patch.second;
+		}
+
+		DIR* dir = opendir(templateRunDir.c_str());
+		if(dir == NULL){
+			throw std::runtime_error("Cannot list run directory " + templateRunDir);
+		}
+		std::set<std::string> names;
+		for(struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir)){
+			names.insert(entry->d_name);
+		}
+		closedir(dir);
+
+		for(auto& name : names){
+			std::string from = templateRunDir + "/" + name;
+			std::string to = runDir + "/" + name;
+			if(name == "." || name == ".." || BENCHMARK_OUTPUT_ENTRIES.count(name) > 0 || starts_with(name, "system_")
+					|| starts_with(runDir + "/", from + "/")){
+				continue;
+			}
+			auto it = entryPatches.find(name);
+			if(it == entryPatches.end()){
+				if(symlink(from.c_str(), to.c_str()) != 0){
+					throw std::runtime_error("Cannot link " + from + " into " + runDir);
+				}
+			}
+			else if(it->second.count("") > 0){
+				std::ifstream ifs(from);
+				nlohmann::json content;
+				ifs >> content;
+				content.merge_patch(it->second[""]);
+				std::ofstream ofs(to, std::ofstream::out | std::ofstream::trunc);
+				ofs << content.dump(4) << std::endl;
+				if(!ofs){
+					throw std::runtime_error("Cannot write " + to);
+				}
+				entryPatches.erase(it);
+			}
+			else{
+				DeriveRunDir(from, to, it->second);
+				entryPatches.erase(it);
+			}
+		}
+
+		if(!entryPatches.empty()){
+			throw std::runtime_error("Cannot patch " + entryPatches.begin()->first + ", not in " + templateRunDir);
+		}
+	}
+
+	int
+	BenchmarkReport::RunIsolated(std::function<void ()> body){
+		// threads do not survive a fork and unflushed output would be written twice
+		LogSink::Shutdown();
+		std::cout.flush();
+		std::cerr.flush();
+		fflush(NULL);
+		pid_t pid = fork();
+		if(pid < 0){
+			throw std::runtime_error("Cannot fork a benchmark process");
+		}
+		if(pid == 0){
+			int code = 0;
+			try{
+				body();
+				LogSink::Shutdown();
+			}
+			catch(std::exception& e){
+				std::cerr << "Benchmark failed: " << e.what() << std::endl;
+				code = 1;
+			}
+			std::cout.flush();
+			std::cerr.flush();
+			fflush(NULL);
+			_exit(code);
+		}
+		int status;
+		if(waitpid(pid, &status, 0) != pid){
+			throw std::runtime_error("Lost track of the benchmark process");
+		}
+		return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+	}
+
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <string>
+#include "ns3/json.hpp"
+
+namespace ns3 {
+
+/**
+ * \ingroup BasicSim
+ *
+ * \brief Machine-readable results of the benchmark programs
+ *
+ * Every measurement is one JSON object per line on stdout and, if a file is
+ * given, appended to it, so that the runs of several programs and revisions
+ * can be collected in one file and compared:
+ *
+ * {"suite": "sag-routing", "benchmark": "spf", "parameters": {"planes": 6, ...},
+ *  "iterations": 16, "wallclock_ns": 1200000, "ns_per_iteration": 75000,
+ *  "events": 1056, "events_per_s": 880000000, "counters": {...}}
+ *
+ * Events are the simulator events of a run, or the unit of work of a micro
+ * benchmark (routes computed, lookups, ...). The benchmark programs use fixed
+ * seeds, so that two runs measure the same work.
+ */
+class BenchmarkReport
+{
+public:
+	BenchmarkReport (std::string suite, std::string outputFilename);
+	virtual ~BenchmarkReport ();
+
+	/**
+	 * \brief Monotonic wall-clock time in ns
+	 */
+	static int64_t NowNs();
+
+	/**
+	 * \param iterations		Repetitions of the measured operation
+	 * \param wallclockNs		Time spent in all repetitions
+	 * \param events			Events executed or units of work processed
+	 * \param counters			Other results worth tracking, e.g. routes found
+	 */
+	void Record(std::string name, const nlohmann::json& parameters, uint64_t iterations, int64_t wallclockNs,
+			uint64_t events, const nlohmann::json& counters = nlohmann::json::object());
+
+	uint32_t GetNRecords() const;
+
+	/**
+	 * \brief Make runDir a run directory reading the inputs of templateRunDir, some of them patched
+	 *
+	 * runDir is replaced if it exists.
+	 * Entries of the template are linked, except the outputs of a run and the
+	 * files generated by one (system_*). A patched file is a copy with a JSON
+	 * merge patch (RFC 7386) applied, the directories on its path are created
+	 * instead of linked.
+	 *
+	 * \param patches		Path relative to the run directory -> merge patch
+	 */
+	static void DeriveRunDir(std::string templateRunDir, std::string runDir, const std::map<std::string, nlohmann::json>& patches);
+
+	/**
+	 * \brief Run body in a child process
+	 *
+	 * For measurements that need a fresh simulator, e.g. a topology of
+	 * another size: ns-3 keeps nodes and channels until the process exits.
+	 *
+	 * \return exit status of the child, non-zero if body threw
+	 */
+	static int RunIsolated(std::function<void ()> body);
+
+private:
+	std::string m_suite;
+	std::string m_outputFilename;
+	uint32_t m_nRecords;
+};
+
+}
+
+#endif /* BENCHMARK_REPORT_H */
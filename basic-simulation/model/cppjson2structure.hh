@@ -270,6 +270,18 @@ namespace jsonns {
         j.at("installation_scope").get_to(v.installation_scope);
     }
 
+    struct ip_tlr_info {
+    	std::string tlr_enabled = "false";
+		std::string priority;
+		std::string installation_scope;
+    };
+
+    inline void from_json(const json& j, ip_tlr_info& v) {
+    	v.tlr_enabled = j.at("tlr_enabled").dump();
+    	v.priority = j.at("priority").dump();
+        j.at("installation_scope").get_to(v.installation_scope);
+    }
+
     struct ip_routing {
     	ip_export_routing_tables_info export_routing_tables;
     	ip_ospf_info ospf;
@@ -277,6 +289,7 @@ namespace jsonns {
     	ip_aodv_info aodv;
     	ip_bgp_info bgp;
     	ip_satellite_to_ground_routing_info satellite_to_ground_routing;
+    	ip_tlr_info tlr;
     };
 
     inline void from_json(const json& j, ip_routing& v) {
@@ -286,6 +299,10 @@ namespace jsonns {
         v.minhop = j.at("minhop");
         v.bgp = j.at("bgp");
         v.satellite_to_ground_routing = j.at("satellite_to_ground_routing");
+        // optional, older run directories have no traffic light based routing
+        if(j.count("tlr") > 0){
+        	v.tlr = j.at("tlr");
+        }
     }
 
 
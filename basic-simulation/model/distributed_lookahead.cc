@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "distributed_lookahead.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+	NS_LOG_COMPONENT_DEFINE ("DistributedLookahead");
+
+	Callback<void, Time> DistributedLookahead::m_sink;
+	Time DistributedLookahead::m_lookahead = Time::Max();
+	Time DistributedLookahead::m_epochStart = Time(0);
+
+	void
+	DistributedLookahead::SetLookaheadSink(Callback<void, Time> sink){
+		m_sink = sink;
+		if(!m_sink.IsNull() && m_lookahead != Time::Max()){
+			m_sink(m_lookahead);
+		}
+	}
+
+	void
+	DistributedLookahead::Update(Time epochStart, Time lookahead){
+		NS_ASSERT_MSG(lookahead.IsStrictlyPositive(), "Lookahead must be positive");
+		NS_LOG_INFO("Lookahead from " << epochStart.GetSeconds() << "s: " << lookahead.GetNanoSeconds() << "ns");
+		m_epochStart = epochStart;
+		m_lookahead = lookahead;
+		if(!m_sink.IsNull()){
+			m_sink(lookahead);
+		}
+	}
+
+	Time
+	DistributedLookahead::GetLookahead(){
+		return m_lookahead;
+	}
+
+	Time
+	DistributedLookahead::GetEpochStart(){
+		return m_epochStart;
+	}
+
+}
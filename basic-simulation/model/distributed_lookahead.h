@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef DISTRIBUTED_LOOKAHEAD_H
+#define DISTRIBUTED_LOOKAHEAD_H
+
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup BasicSim
+ *
+ * \brief Per-epoch MPI lookahead, kept in memory
+ *
+ * The topology publishes, at the start of every dynamic state epoch, the
+ * smallest propagation delay any link between its system and another one can
+ * have until the end of the following epoch, and writes it to
+ * system_<id>_mpi_lookahead.txt, from which the MPI simulator
+ * implementation takes the lookahead of its next window. The value may grow
+ * as well as shrink between epochs.
+ *
+ * A simulator implementation that can take the lookahead directly registers
+ * a sink and receives every value. It is not passed to
+ * DistributedSimulatorImpl::BoundLookAhead (), which could only ever tighten
+ * it.
+ */
+class DistributedLookahead
+{
+public:
+	/**
+	 * \brief Register the receiver of the per-epoch lookahead
+	 */
+	static void SetLookaheadSink(Callback<void, Time> sink);
+
+	/**
+	 * \brief Publish the lookahead valid from epochStart on
+	 */
+	static void Update(Time epochStart, Time lookahead);
+
+	/**
+	 * \return the last published lookahead, Time::Max () before the first update
+	 */
+	static Time GetLookahead();
+	static Time GetEpochStart();
+
+private:
+	static Callback<void, Time> m_sink;
+	static Time m_lookahead;
+	static Time m_epochStart;
+};
+
+}
+
+#endif /* DISTRIBUTED_LOOKAHEAD_H */
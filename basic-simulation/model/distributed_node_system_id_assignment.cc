@@ -19,6 +19,7 @@
 
 #include "distributed_node_system_id_assignment.h"
 #include "cppjson2structure.hh"
+#include <queue>
 
 namespace ns3 {
 
@@ -60,6 +61,67 @@ PartitioningTopology::GetDistributedNodeSystemIdAssignment(std::string algorithm
 	else if(algorithm == "customize"){
 		return n->CustomizeMode(m_basicsimulation->GetRunDir(), satellite_counter, groundStation_counter, systems_cnt);
 	}
+	else if(algorithm == "multilevel"){
+		double imbalance = parse_double(m_basicsimulation->GetConfigParamOrDefault("distributed_partition_imbalance", "1.05"));
+		uint64_t seed = parse_positive_int64(m_basicsimulation->GetConfigParamOrDefault("distributed_partition_seed", "1"));
+		int64_t windowNs = parse_positive_int64(m_basicsimulation->GetConfigParamOrDefault("distributed_partition_window_ns", "0"));
+		int64_t endNs = m_basicsimulation->GetSimulationEndTimeNs();
+		if(windowNs == 0 || windowNs >= endNs){
+			return n->MultilevelKWay(satellite_network_dir, m_basicsimulation->GetRunDir(), satellite_counter, groundStation_counter, systems_cnt, 0, endNs, imbalance, seed);
+		}
+
+		// Time-windowed partitioning: node system ids are fixed once the nodes are created, so the
+		// simulation runs with the first window's assignment, and every window's assignment is
+		// written as a coalitions file that a run (re)started at that window can use in customize mode.
+		std::vector<int64_t> first;
+		std::vector<int64_t> previous;
+		for(int64_t startNs = 0, w = 0; startNs < endNs; startNs += windowNs, w++){
+			std::vector<int64_t> assignment = n->MultilevelKWay(satellite_network_dir, m_basicsimulation->GetRunDir(), satellite_counter, groundStation_counter, systems_cnt,
+					startNs, std::min(startNs + windowNs, endNs), imbalance, seed);
+			if(!previous.empty()){
+				// Relabel the systems to keep as many nodes as possible where they were in the previous window
+				std::vector<std::vector<uint32_t>> overlap(systems_cnt, std::vector<uint32_t>(systems_cnt, 0));
+				for(uint32_t v = 0; v < assignment.size(); v++){
+					overlap[assignment[v]][previous[v]]++;
+				}
+				std::vector<int64_t> relabel(systems_cnt, -1);
+				std::vector<bool> taken(systems_cnt, false);
+				for(uint32_t round = 0; round < systems_cnt; round++){
+					int64_t bestFrom = -1, bestTo = -1;
+					for(uint32_t from = 0; from < systems_cnt; from++){
+						for(uint32_t to = 0; to < systems_cnt; to++){
+							if(relabel[from] == -1 && !taken[to] && (bestFrom == -1 || overlap[from][to] > overlap[bestFrom][bestTo])){
+								bestFrom = from;
+								bestTo = to;
+							}
+						}
+					}
+					relabel[bestFrom] = bestTo;
+					taken[bestTo] = true;
+				}
+				for(uint32_t v = 0; v < assignment.size(); v++){
+					assignment[v] = relabel[assignment[v]];
+				}
+			}
+
+			json coalitions = json::array();
+			for(uint32_t k = 0; k < systems_cnt; k++){
+				coalitions.push_back(json::array());
+			}
+			for(uint32_t v = 0; v < assignment.size(); v++){
+				coalitions[assignment[v]].push_back(v);
+			}
+			std::ofstream coalitionsJson(satellite_network_dir + "/system_" + std::to_string(MpiInterface::GetSystemId()) + "_coalitions_window_" + std::to_string(w) + ".json", std::ofstream::out);
+			coalitionsJson << coalitions.dump();
+			coalitionsJson.close();
+
+			if(first.empty()){
+				first = assignment;
+			}
+			previous = assignment;
+		}
+		return first;
+	}
 	else
 		throw std::runtime_error(format_string("Unknown distributed Node to System Id Assign Algorithm type: %s", algorithm));
 }
@@ -482,6 +544,230 @@ AlgorithmForPartitioning::DivideEvenlyAtRandom(int64_t num,uint32_t systems_cnt)
 
 
 
+PartitionGraph
+AlgorithmForPartitioning::BuildTrafficAwareGraph(std::string satellite_network_dir, std::string run_dir, int64_t satellite_counter, int64_t groundStation_counter,
+		int64_t startNs, int64_t endNs){
+
+	// Weight of a node without traffic, stands for its periodic (routing, handover, ...) events
+	const uint64_t baseVertexWeight = 100;
+	// Weight of one ground-to-satellite association inside the window
+	const uint64_t associationWeight = 10;
+	uint32_t nodes = satellite_counter + groundStation_counter;
+
+	// ISLs, as written by the pre-process run
+	std::vector<std::vector<uint32_t>> islAdjacency(satellite_counter);
+	std::vector<std::pair<uint32_t, uint32_t>> isls;
+	json j;
+	std::ifstream config_file(satellite_network_dir + "/config_constellation.json");
+	NS_ABORT_MSG_UNLESS(config_file.is_open(), "File config_constellation.json could not be opened");
+	config_file >> j;
+	config_file.close();
+	for(uint32_t c = 0; c < j["constellations"].size(); c++){
+		jsonns::constellationinfo consinfo = j["constellations"][c];
+		std::string filename = satellite_network_dir + "/system_0_" + consinfo.name + "_adjacency.txt";
+		std::ifstream fs(filename);
+		if(!fs.is_open()){
+			throw std::runtime_error(format_string("File %s does not exist, run the distributed pre-process first.", filename.c_str()));
+		}
+		std::string line;
+		while(std::getline(fs, line)){
+			std::vector<std::string> res = split_string(line, " ", 2);
+			uint32_t a = parse_positive_int64(res[0]);
+			uint32_t b = parse_positive_int64(res[1]);
+			if(a >= satellite_counter || b >= satellite_counter){
+				throw std::runtime_error(format_string("Invalid ISL %u-%u in %s", a, b, filename.c_str()));
+			}
+			islAdjacency[a].push_back(b);
+			islAdjacency[b].push_back(a);
+			isls.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+		}
+		fs.close();
+	}
+
+	// Ground-to-satellite associations over time, as written by the pre-process run
+	std::map<uint32_t, std::vector<std::pair<int64_t, uint32_t>>> gs2Sats;  // gs -> (time ns, sat)
+	if(groundStation_counter > 0){
+		std::ifstream fs(satellite_network_dir + "/system_0_topology_change_message.txt");
+		NS_ABORT_MSG_UNLESS(fs.is_open(), "topology_change_message.txt");
+		std::string line;
+		while(std::getline(fs, line)){
+			std::vector<std::string> res = split_string(line, ",", 3);
+			int64_t timeNs = parse_positive_int64(res[0]) * 1000000;
+			uint32_t gs = parse_positive_int64(res[1]);
+			uint32_t sat = parse_positive_int64(res[2]);
+			gs2Sats[gs].push_back(std::make_pair(timeNs, sat));
+		}
+		fs.close();
+	}
+	// satellite a ground station is attached to at a given time (the latest association before it)
+	auto attachedSatellite = [&gs2Sats](uint32_t gs, int64_t timeNs) -> int64_t {
+		auto iter = gs2Sats.find(gs);
+		if(iter == gs2Sats.end()){
+			return -1;
+		}
+		int64_t sat = iter->second[0].second;
+		for(auto record : iter->second){
+			if(record.first > timeNs){
+				break;
+			}
+			sat = record.second;
+		}
+		return sat;
+	};
+
+	// Expected packets handled per node and carried per link
+	std::vector<double> nodePackets(nodes, 0.0);
+	std::map<std::pair<uint32_t, uint32_t>, double> linkPackets;
+	std::map<uint32_t, std::vector<int64_t>> bfsParents;
+	std::vector<std::string> flowTypes = {"udp", "tcp", "quic", "rtp", "scps_tp"};
+	for(std::string flowType : flowTypes){
+		std::string filename = run_dir + "/config_traffic/application_schedule_" + flowType + ".json";
+		if(!file_exists(filename)){
+			continue;
+		}
+		std::ifstream jfile(filename);
+		json jf;
+		jfile >> jf;
+		jfile.close();
+		if(jf.find(flowType + "_flows") == jf.end()){
+			continue;
+		}
+		jsonns::application_schedules flows = jf.at(flowType + "_flows");
+		for(jsonns::application_schedule flow : flows.my_application_schedules){
+			int64_t flowStart = parse_positive_int64(remove_start_end_double_quote_if_present(flow.start_time_ns));
+			int64_t flowEnd = flowStart + parse_positive_int64(remove_start_end_double_quote_if_present(flow.duration_time_ns));
+			int64_t overlapNs = std::min(flowEnd, endNs) - std::max(flowStart, startNs);
+			if(overlapNs <= 0){
+				continue;
+			}
+			double rateMbps = parse_positive_double(remove_start_end_double_quote_if_present(flow.target_flow_rate_mbps));
+			double packets = rateMbps * 1e6 / 8.0 / 1500.0 * overlapNs / 1e9;
+
+			uint32_t src = satellite_counter + parse_positive_int64(remove_start_end_double_quote_if_present(flow.sender));
+			uint32_t dst = satellite_counter + parse_positive_int64(remove_start_end_double_quote_if_present(flow.receiver));
+			if(src >= nodes || dst >= nodes){
+				throw std::runtime_error(format_string("Invalid endpoint in %s", filename.c_str()));
+			}
+			nodePackets[src] += packets;
+			nodePackets[dst] += packets;
+
+			int64_t srcSat = attachedSatellite(src, std::max(flowStart, startNs));
+			int64_t dstSat = attachedSatellite(dst, std::max(flowStart, startNs));
+			if(srcSat < 0 || dstSat < 0){
+				continue;
+			}
+			linkPackets[std::make_pair(std::min<uint32_t>(src, srcSat), std::max<uint32_t>(src, srcSat))] += packets;
+			linkPackets[std::make_pair(std::min<uint32_t>(dst, dstSat), std::max<uint32_t>(dst, dstSat))] += packets;
+
+			// Minimum-hop ISL path between the access satellites
+			if(bfsParents.find(srcSat) == bfsParents.end()){
+				std::vector<int64_t> parent(satellite_counter, -1);
+				std::queue<uint32_t> q;
+				parent[srcSat] = srcSat;
+				q.push(srcSat);
+				while(!q.empty()){
+					uint32_t cur = q.front();
+					q.pop();
+					for(uint32_t next : islAdjacency[cur]){
+						if(parent[next] == -1){
+							parent[next] = cur;
+							q.push(next);
+						}
+					}
+				}
+				bfsParents[srcSat] = parent;
+			}
+			const std::vector<int64_t>& parent = bfsParents[srcSat];
+			if(parent[dstSat] == -1){
+				continue;
+			}
+			for(int64_t cur = dstSat; ; cur = parent[cur]){
+				nodePackets[cur] += packets;
+				if(cur == srcSat){
+					break;
+				}
+				linkPackets[std::make_pair(std::min(cur, parent[cur]), std::max(cur, parent[cur]))] += packets;
+			}
+		}
+	}
+
+	// Scale the traffic so that it weighs as much in total as the background load
+	double totalPackets = 0.0;
+	for(double p : nodePackets){
+		totalPackets += p;
+	}
+	double vertexScale = totalPackets > 0 ? baseVertexWeight * nodes / totalPackets : 0.0;
+	double totalLinkPackets = 0.0;
+	for(auto link : linkPackets){
+		totalLinkPackets += link.second;
+	}
+	double edgeScale = totalLinkPackets > 0 ? associationWeight * linkPackets.size() / totalLinkPackets : 0.0;
+
+	PartitionGraph graph(nodes);
+	for(uint32_t v = 0; v < nodes; v++){
+		graph.SetVertexWeight(v, baseVertexWeight + uint64_t(nodePackets[v] * vertexScale + 0.5));
+	}
+	for(auto isl : isls){
+		graph.AddEdgeWeight(isl.first, isl.second, 1);
+	}
+	for(auto gs : gs2Sats){
+		int64_t active = attachedSatellite(gs.first, startNs);
+		for(auto record : gs.second){
+			if(record.first > startNs && record.first < endNs){
+				graph.AddEdgeWeight(gs.first, record.second, associationWeight);
+			}
+		}
+		if(active >= 0){
+			graph.AddEdgeWeight(gs.first, active, associationWeight);
+		}
+	}
+	for(auto link : linkPackets){
+		graph.AddEdgeWeight(link.first.first, link.first.second, uint64_t(link.second * edgeScale + 0.5));
+	}
+	graph.Finalize();
+	return graph;
+
+}
+
+std::vector<int64_t>
+AlgorithmForPartitioning::MultilevelKWay(std::string satellite_network_dir, std::string run_dir, int64_t satellite_counter, int64_t groundStation_counter, uint32_t systems_cnt,
+		int64_t startNs, int64_t endNs, double imbalance, uint64_t seed){
+	printf("Using Multilevel K-Way Partitioning Algorithm ([%" PRId64 ", %" PRId64 ") ns)\n", startNs, endNs);
+
+	PartitionGraph graph = BuildTrafficAwareGraph(satellite_network_dir, run_dir, satellite_counter, groundStation_counter, startNs, endNs);
+	MultilevelGraphPartitioner partitioner(systems_cnt, imbalance, seed);
+	std::vector<uint32_t> part = partitioner.Partition(graph);
+
+	// Number the systems in order of their lowest node id, so node 0 stays on system 0
+	std::vector<int64_t> relabel(systems_cnt, -1);
+	int64_t next = 0;
+	std::vector<int64_t> assignment(part.size());
+	for(uint32_t v = 0; v < part.size(); v++){
+		if(relabel[part[v]] == -1){
+			relabel[part[v]] = next++;
+		}
+		assignment[v] = relabel[part[v]];
+	}
+
+	std::vector<uint64_t> systemWeight(systems_cnt, 0);
+	for(uint32_t v = 0; v < part.size(); v++){
+		systemWeight[assignment[v]] += graph.GetVertexWeight(v);
+	}
+	printf("  > Edge cut %" PRIu64 " of total vertex weight %" PRIu64 "\n", MultilevelGraphPartitioner::EdgeCut(graph, part), graph.GetTotalVertexWeight());
+	for(uint32_t k = 0; k < systems_cnt; k++){
+		printf("    >> System %u has load %" PRIu64 "\n", k, systemWeight[k]);
+	}
+
+	std::ofstream assignmentTxt(satellite_network_dir + "/system_" +std::to_string(MpiInterface::GetSystemId()) +"_distributed_node_system_id_assignment.txt", std::ofstream::out);
+	for(uint32_t v = 0; v < assignment.size(); v++){
+		assignmentTxt<<v<<"  "<<assignment[v]<<std::endl;
+	}
+	assignmentTxt.close();
+
+	return assignment;
+
+}
+
 } // namespace ns3
 
 
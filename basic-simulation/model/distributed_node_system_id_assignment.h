@@ -32,6 +32,7 @@
 #include "ns3/exp-util.h"
 #include "ns3/mpi-interface.h"
 #include "ns3/basic-simulation.h"
+#include "ns3/multilevel_graph_partitioner.h"
 
 namespace ns3 {
 
@@ -63,6 +64,18 @@ public:
 	std::vector<int64_t> DivideEvenlyInOrder(int64_t num, uint32_t systems_cnt);
 	std::vector<int64_t> DivideEvenlyAtRandom(int64_t num, uint32_t systems_cnt);
 
+	/**
+	 * \brief Multilevel k-way partitioning of the ISL graph plus ground stations
+	 *
+	 * Vertices are weighted by their expected event load and edges by their expected
+	 * traffic, both taken from the application schedules of [startNs, endNs), so that
+	 * the ISLs crossing process boundaries carry as little traffic as possible.
+	 */
+	std::vector<int64_t> MultilevelKWay(std::string satellite_network_dir, std::string run_dir, int64_t satellite_counter, int64_t groundStation_counter, uint32_t systems_cnt,
+			int64_t startNs, int64_t endNs, double imbalance, uint64_t seed);
+	PartitionGraph BuildTrafficAwareGraph(std::string satellite_network_dir, std::string run_dir, int64_t satellite_counter, int64_t groundStation_counter,
+			int64_t startNs, int64_t endNs);
+
 
 private:
 
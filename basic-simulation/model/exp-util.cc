@@ -686,6 +686,9 @@ void read_config(const std::string& run_dir, std::map<std::string, std::string>&
 			key = trim("enable_satellite_to_ground_routing");
 			value = remove_start_end_double_quote_if_present(trim(vj.satellite_to_ground_routing.satellite_to_ground_routing_enabled));
 			config[key] = value;
+			key = trim("enable_traffic_light_based_routing");
+			value = remove_start_end_double_quote_if_present(trim(vj.tlr.tlr_enabled));
+			config[key] = value;
 
 		//		// Check key does not exist yet
 		//		if (config.find(key) != config.end()) {
@@ -812,6 +815,11 @@ void read_config(const std::string& run_dir, std::map<std::string, std::string>&
 			key = trim("enable_trajectory_tracing");
 			value = remove_start_end_double_quote_if_present(trim(vi.enable_trajectory_tracing));
 			config[key] = value;
+			if(j["utilization"].count("enable_gsl_handover_log") > 0){
+				key = trim("enable_gsl_handover_log");
+				value = remove_start_end_double_quote_if_present(trim(j["utilization"]["enable_gsl_handover_log"].dump()));
+				config[key] = value;
+			}
 
 			key = trim("enable_pcap_tracing");
 			value = remove_start_end_double_quote_if_present(trim(vj.wireshark_enabled));
@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include <sys/stat.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "log_sink.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+	NS_LOG_COMPONENT_DEFINE ("LogSink");
+
+	namespace {
+
+		const uint32_t MAX_OPEN_FILES = 256;
+		const std::chrono::milliseconds WRITER_IDLE_WAIT(10);
+
+		struct Record
+		{
+			uint32_t file;
+			bool truncate;						//!< Truncate the file instead of appending data
+			std::string data;
+		};
+
+		/**
+		 * Single producer, single consumer: only the owning thread advances
+		 * m_tail and only the writer advances m_head.
+		 */
+		struct Ring
+		{
+			explicit Ring(uint32_t capacity)
+				: m_slots(capacity),
+				  m_head(0),
+				  m_tail(0),
+				  m_bytes(0)
+			{
+			}
+
+			std::vector<Record> m_slots;
+			std::atomic<uint64_t> m_head;		//!< Next slot the writer drains
+			std::atomic<uint64_t> m_tail;		//!< Next slot the producer fills
+			std::atomic<uint64_t> m_bytes;		//!< Payload bytes queued
+		};
+
+		class SinkState
+		{
+		public:
+			SinkState()
+				: m_ringRecords(16384),
+				  m_ringBytes(64 << 20),
+				  m_policy(LogSink::BLOCK),
+				  m_running(false),
+				  m_stop(false),
+				  m_flushRequested(0),
+				  m_flushDone(0),
+				  m_dropped(0),
+				  m_nOpen(0)
+			{
+			}
+
+			~SinkState(){
+				try{
+					Shutdown();
+				}
+				catch(std::exception& e){
+					std::cerr << e.what() << std::endl;
+				}
+			}
+
+			void Configure(uint32_t ringRecords, uint64_t ringBytes, LogSink::BackpressurePolicy policy){
+				NS_ASSERT_MSG(ringRecords > 0, "Log sink rings need at least one slot");
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_ringRecords = ringRecords;
+				m_ringBytes = ringBytes;
+				m_policy = policy;
+			}
+
+			uint32_t Intern(const std::string& path){
+				std::lock_guard<std::mutex> lock(m_mutex);
+				auto it = m_fileIds.find(path);
+				if(it != m_fileIds.end()){
+					return it->second;
+				}
+				uint32_t id = m_paths.size();
+				std::string redirected = path;
+				for(auto& redirect : m_redirects){
+					redirected = Rewrite(redirected, redirect.first, redirect.second);
+				}
+				m_paths.push_back(redirected);
+				m_fileIds[path] = id;
+				return id;
+			}
+
+			void Redirect(const std::string& from, const std::string& to){
+				std::lock_guard<std::mutex> lock(m_mutex);
+				NS_ASSERT_MSG(!m_running, "Stop the log sink before redirecting its files");
+				m_redirects.push_back(std::make_pair(from, to));
+				for(auto& path : m_paths){
+					std::string redirected = Rewrite(path, from, to);
+					if(redirected != path){
+						// records are appended to what the file got so far, e.g. its header
+						CopyContent(path, redirected);
+						path = redirected;
+					}
+				}
+			}
+
+			void Push(uint32_t file, bool truncate, std::string&& data){
+				Ring* ring = GetRing();
+				uint64_t capacity = ring->m_slots.size();
+				uint64_t size = data.size();
+				while(true){
+					uint64_t tail = ring->m_tail.load(std::memory_order_relaxed);
+					uint64_t queued = tail - ring->m_head.load(std::memory_order_acquire);
+					uint64_t bytes = ring->m_bytes.load(std::memory_order_relaxed);
+					if(queued < capacity && (bytes == 0 || bytes + size <= m_ringBytes)){
+						Record& slot = ring->m_slots[tail % capacity];
+						slot.file = file;
+						slot.truncate = truncate;
+						slot.data = std::move(data);
+						ring->m_bytes.fetch_add(size, std::memory_order_relaxed);
+						ring->m_tail.store(tail + 1, std::memory_order_release);
+						if(queued + 1 == capacity / 2){
+							m_wake.notify_one();
+						}
+						return;
+					}
+					if(!truncate && m_policy == LogSink::DROP){
+						m_dropped.fetch_add(1, std::memory_order_relaxed);
+						return;
+					}
+					m_wake.notify_one();
+					std::this_thread::yield();
+				}
+			}
+
+			void Flush(){
+				std::unique_lock<std::mutex> lock(m_mutex);
+				if(m_running){
+					uint64_t target = ++m_flushRequested;
+					m_wake.notify_one();
+					m_flushed.wait(lock, [this, target]{ return m_flushDone >= target; });
+				}
+				ThrowErrors();
+			}
+
+			void Shutdown(){
+				std::unique_lock<std::mutex> lock(m_mutex);
+				if(m_running){
+					m_stop = true;
+					m_wake.notify_one();
+					lock.unlock();
+					m_writer.join();
+					lock.lock();
+					m_stop = false;
+					m_running = false;
+				}
+				ThrowErrors();
+			}
+
+			uint64_t GetNDropped() const{
+				return m_dropped.load(std::memory_order_relaxed);
+			}
+
+		private:
+			Ring* GetRing(){
+				thread_local Ring* ring = nullptr;
+				if(ring == nullptr){
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_rings.emplace_back(new Ring(m_ringRecords));
+					ring = m_rings.back().get();
+				}
+				if(!m_running.load(std::memory_order_acquire)){
+					Start();
+				}
+				return ring;
+			}
+
+			void Start(){
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if(!m_running){
+					m_writer = std::thread(&SinkState::Run, this);
+					m_running = true;
+				}
+			}
+
+			void Run(){
+				std::unique_lock<std::mutex> lock(m_mutex);
+				while(true){
+					std::vector<Ring*> rings;
+					for(auto& ring : m_rings){
+						rings.push_back(ring.get());
+					}
+					uint64_t flushTarget = m_flushRequested;
+					bool stop = m_stop;
+					lock.unlock();
+
+					// records pushed before the flush or stop request was read are drained by this pass
+					bool drained = false;
+					for(Ring* ring : rings){
+						drained |= Drain(ring);
+					}
+					if(flushTarget > m_flushDone || stop){
+						FlushStreams(stop);
+					}
+
+					lock.lock();
+					if(flushTarget > m_flushDone){
+						m_flushDone = flushTarget;
+						m_flushed.notify_all();
+					}
+					if(stop){
+						return;
+					}
+					if(!drained && !m_stop && m_flushRequested == flushTarget){
+						m_wake.wait_for(lock, WRITER_IDLE_WAIT);
+					}
+				}
+			}
+
+			bool Drain(Ring* ring){
+				uint64_t head = ring->m_head.load(std::memory_order_relaxed);
+				uint64_t tail = ring->m_tail.load(std::memory_order_acquire);
+				if(head == tail){
+					return false;
+				}
+				uint64_t capacity = ring->m_slots.size();
+				for(; head != tail; head++){
+					Record& record = ring->m_slots[head % capacity];
+					uint64_t size = record.data.size();
+					Process(record);
+					record.data = std::string();
+					ring->m_bytes.fetch_sub(size, std::memory_order_relaxed);
+					ring->m_head.store(head + 1, std::memory_order_release);
+				}
+				return true;
+			}
+
+			void Process(const Record& record){
+				if(record.file >= m_streams.size()){
+					m_streams.resize(record.file + 1);
+				}
+				std::unique_ptr<std::ofstream>& stream = m_streams[record.file];
+				if(record.truncate){
+					if(stream){
+						stream->close();
+						m_nOpen--;
+					}
+					stream.reset(OpenStream(record.file, std::ofstream::out | std::ofstream::trunc));
+				}
+				else if(!stream){
+					stream.reset(OpenStream(record.file, std::ofstream::out | std::ofstream::app));
+				}
+				if(stream && !record.data.empty()){
+					stream->write(record.data.data(), record.data.size());
+					if(!*stream){
+						ReportError("Log sink could not write to " + GetPath(record.file));
+					}
+				}
+			}
+
+			std::ofstream* OpenStream(uint32_t file, std::ios::openmode mode){
+				if(m_nOpen >= MAX_OPEN_FILES){
+					// files are reopened in append mode on their next record
+					FlushStreams(true);
+				}
+				std::ofstream* stream = new std::ofstream(GetPath(file), mode);
+				if(!stream->is_open()){
+					ReportError("Log sink could not open " + GetPath(file));
+					delete stream;
+					return nullptr;
+				}
+				m_nOpen++;
+				return stream;
+			}
+
+			void FlushStreams(bool close){
+				for(auto& stream : m_streams){
+					if(stream){
+						stream->flush();
+						if(close){
+							stream.reset();
+						}
+					}
+				}
+				if(close){
+					m_nOpen = 0;
+				}
+			}
+
+			static void CopyContent(const std::string& from, const std::string& to){
+				std::ifstream src(from, std::ios::binary);
+				if(!src.is_open() || src.peek() == std::ifstream::traits_type::eof()){
+					return;
+				}
+				for(size_t slash = to.find('/', 1); slash != std::string::npos; slash = to.find('/', slash + 1)){
+					if(mkdir(to.substr(0, slash).c_str(), 0777) != 0 && errno != EEXIST){
+						throw std::runtime_error("Log sink could not create the directory of " + to);
+					}
+				}
+				std::ofstream dst(to, std::ios::binary | std::ios::trunc);
+				dst << src.rdbuf();
+				if(!dst){
+					throw std::runtime_error("Log sink could not copy " + from + " to " + to);
+				}
+			}
+
+			static std::string Rewrite(const std::string& path, const std::string& from, const std::string& to){
+				if(path.compare(0, from.size(), from) == 0){
+					return to + path.substr(from.size());
+				}
+				return path;
+			}
+
+			std::string GetPath(uint32_t file){
+				std::lock_guard<std::mutex> lock(m_mutex);
+				return m_paths[file];
+			}
+
+			void ReportError(const std::string& error){
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_errors.push_back(error);
+			}
+
+			// m_mutex held
+			void ThrowErrors(){
+				if(!m_errors.empty()){
+					std::string error = m_errors.front();
+					m_errors.clear();
+					throw std::runtime_error(error);
+				}
+			}
+
+			std::mutex m_mutex;							//!< Guards everything but the ring contents and the streams
+			std::condition_variable m_wake;
+			std::condition_variable m_flushed;
+			std::thread m_writer;
+
+			uint32_t m_ringRecords;
+			uint64_t m_ringBytes;
+			LogSink::BackpressurePolicy m_policy;
+			std::vector<std::unique_ptr<Ring>> m_rings;
+			std::vector<std::string> m_paths;
+			std::unordered_map<std::string, uint32_t> m_fileIds;				//!< Keyed by the path before redirection
+			std::vector<std::pair<std::string, std::string>> m_redirects;
+
+			std::atomic<bool> m_running;
+			bool m_stop;
+			uint64_t m_flushRequested;
+			uint64_t m_flushDone;
+			std::atomic<uint64_t> m_dropped;
+			std::vector<std::string> m_errors;
+
+			std::vector<std::unique_ptr<std::ofstream>> m_streams;	//!< Writer thread only
+			uint32_t m_nOpen;										//!< Writer thread only
+		};
+
+		SinkState&
+		GetSinkState(){
+			static SinkState state;
+			return state;
+		}
+
+		void
+		FlushAtDestroy(){
+			GetSinkState().Flush();
+		}
+
+	}
+
+	void
+	LogSink::Configure(uint32_t ringRecords, uint64_t ringBytes, BackpressurePolicy policy){
+		GetSinkState().Configure(ringRecords, ringBytes, policy);
+		Simulator::ScheduleDestroy(&FlushAtDestroy);
+	}
+
+	uint32_t
+	LogSink::Open(const std::string& path, bool truncate){
+		uint32_t id = GetSinkState().Intern(path);
+		if(truncate){
+			GetSinkState().Push(id, true, std::string());
+		}
+		return id;
+	}
+
+	void
+	LogSink::Write(uint32_t file, std::string record){
+		GetSinkState().Push(file, false, std::move(record));
+	}
+
+	void
+	LogSink::Append(const std::string& path, std::string record){
+		thread_local std::unordered_map<std::string, uint32_t> files;
+		auto it = files.find(path);
+		if(it == files.end()){
+			it = files.insert(std::make_pair(path, GetSinkState().Intern(path))).first;
+		}
+		GetSinkState().Push(it->second, false, std::move(record));
+	}
+
+	void
+	LogSink::WriteFile(const std::string& path, std::string content){
+		Write(Open(path, true), std::move(content));
+	}
+
+	void
+	LogSink::Flush(){
+		GetSinkState().Flush();
+	}
+
+	void
+	LogSink::Shutdown(){
+		GetSinkState().Shutdown();
+	}
+
+	uint64_t
+	LogSink::GetNDropped(){
+		return GetSinkState().GetNDropped();
+	}
+
+	void
+	LogSink::Redirect(const std::string& from, const std::string& to){
+		GetSinkState().Redirect(from, to);
+	}
+
+}
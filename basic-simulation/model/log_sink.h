@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+#include <stdint.h>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup BasicSim
+ *
+ * \brief Asynchronous writer of result and log files
+ *
+ * Every producing thread owns a bounded single-producer ring of formatted
+ * records, so that writing a record is a move into the ring and no lock or
+ * system call is taken on the producing thread. A background thread drains
+ * the rings and keeps the files open. Records of one thread reach their
+ * file in the order they were written; records of different threads to the
+ * same file may interleave at record granularity.
+ *
+ * A full ring either blocks the producer until the writer catches up or,
+ * with the DROP policy, discards the record and counts it. Truncations are
+ * never dropped. Everything written before Flush () is on disk when it
+ * returns; the sink flushes at Simulator::Destroy () and at process exit.
+ */
+class LogSink
+{
+public:
+	enum BackpressurePolicy
+	{
+		BLOCK,
+		DROP
+	};
+
+	/**
+	 * \brief Set the bounds of the rings created from now on and the full ring policy
+	 *
+	 * Also registers the flush at Simulator::Destroy (), call it from the
+	 * simulation thread before the simulation runs.
+	 *
+	 * \param ringRecords	Records a ring holds at most
+	 * \param ringBytes		Payload bytes a ring holds at most, a single larger record is still accepted
+	 * \param policy		What a producer does with a full ring
+	 */
+	static void Configure(uint32_t ringRecords, uint64_t ringBytes, BackpressurePolicy policy);
+
+	/**
+	 * \brief Register a file, truncating it in order with the records of the calling thread
+	 * \return id to write to
+	 */
+	static uint32_t Open(const std::string& path, bool truncate);
+
+	static void Write(uint32_t file, std::string record);
+
+	/**
+	 * \brief Append to path, opened on first use and cached per thread
+	 */
+	static void Append(const std::string& path, std::string record);
+
+	/**
+	 * \brief Replace the content of path
+	 */
+	static void WriteFile(const std::string& path, std::string content);
+
+	/**
+	 * \brief Block until all records written so far by any thread are on disk
+	 *
+	 * Throws if the writer could not open or write a file.
+	 */
+	static void Flush();
+
+	/**
+	 * \brief Flush, close all files and stop the writer, which restarts on the next record
+	 */
+	static void Shutdown();
+
+	static uint64_t GetNDropped();
+
+	/**
+	 * \brief Write the files whose path starts with from under to instead, including files already registered
+	 *
+	 * Used by a forked sweep variant to move the files of the shared scenario
+	 * to its own run directory. What a registered file holds so far is copied
+	 * to its new path, so that it continues there. The writer must be
+	 * stopped, see Shutdown ().
+	 */
+	static void Redirect(const std::string& from, const std::string& to);
+};
+
+}
+
+#endif /* LOG_SINK_H */
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "multilevel_graph_partitioner.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace ns3 {
+
+	static const uint32_t NO_PART = 0xFFFFFFFF;
+
+	PartitionGraph::PartitionGraph (){
+
+	}
+
+	PartitionGraph::PartitionGraph (uint32_t n)
+		: m_vwgt(n, 0),
+		  m_pending(n){
+
+	}
+
+	uint32_t
+	PartitionGraph::GetN() const{
+		return m_vwgt.size();
+	}
+
+	void
+	PartitionGraph::SetVertexWeight(uint32_t v, uint64_t w){
+		m_vwgt.at(v) = w;
+	}
+
+	void
+	PartitionGraph::AddVertexWeight(uint32_t v, uint64_t w){
+		m_vwgt.at(v) += w;
+	}
+
+	uint64_t
+	PartitionGraph::GetVertexWeight(uint32_t v) const{
+		return m_vwgt[v];
+	}
+
+	uint64_t
+	PartitionGraph::GetTotalVertexWeight() const{
+		return std::accumulate(m_vwgt.begin(), m_vwgt.end(), uint64_t(0));
+	}
+
+	void
+	PartitionGraph::AddEdgeWeight(uint32_t u, uint32_t v, uint64_t w){
+		if(u >= m_vwgt.size() || v >= m_vwgt.size()){
+			throw std::runtime_error("PartitionGraph: edge endpoint out of range");
+		}
+		if(u == v || w == 0){
+			return;
+		}
+		m_pending[u].push_back(std::make_pair(v, w));
+		m_pending[v].push_back(std::make_pair(u, w));
+	}
+
+	void
+	PartitionGraph::Finalize(){
+
+		uint32_t n = m_vwgt.size();
+		m_xadj.assign(n + 1, 0);
+		m_adjncy.clear();
+		m_adjwgt.clear();
+		for(uint32_t v = 0; v < n; v++){
+			std::vector<std::pair<uint32_t, uint64_t>>& list = m_pending[v];
+			std::sort(list.begin(), list.end());
+			for(uint32_t i = 0; i < list.size(); i++){
+				if(!m_adjncy.empty() && m_adjncy.size() > m_xadj[v] && m_adjncy.back() == list[i].first){
+					m_adjwgt.back() += list[i].second;
+				}
+				else{
+					m_adjncy.push_back(list[i].first);
+					m_adjwgt.push_back(list[i].second);
+				}
+			}
+			m_xadj[v + 1] = m_adjncy.size();
+			std::vector<std::pair<uint32_t, uint64_t>>().swap(list);
+		}
+
+	}
+
+	MultilevelGraphPartitioner::MultilevelGraphPartitioner (uint32_t parts, double imbalance, uint64_t seed)
+		: m_parts(parts),
+		  m_imbalance(imbalance),
+		  m_rng(seed){
+		if(parts == 0){
+			throw std::runtime_error("MultilevelGraphPartitioner: number of parts must be positive");
+		}
+		if(imbalance < 1.0){
+			throw std::runtime_error("MultilevelGraphPartitioner: imbalance must be >= 1.0");
+		}
+	}
+
+	uint64_t
+	MultilevelGraphPartitioner::EdgeCut(const PartitionGraph& graph, const std::vector<uint32_t>& part){
+		uint64_t cut = 0;
+		for(uint32_t v = 0; v < graph.GetN(); v++){
+			for(uint32_t e = graph.Begin(v); e < graph.End(v); e++){
+				if(part[v] != part[graph.Neighbor(e)]){
+					cut += graph.EdgeWeight(e);
+				}
+			}
+		}
+		return cut / 2;
+	}
+
+	std::vector<uint32_t>
+	MultilevelGraphPartitioner::Partition(const PartitionGraph& graph){
+
+		uint32_t n = graph.GetN();
+		if(m_parts == 1 || n == 0){
+			return std::vector<uint32_t>(n, 0);
+		}
+
+		// Coarsening until the graph is small enough for the initial partitioning
+		uint32_t coarsenTo = std::max<uint32_t>(20 * m_parts, 80);
+		std::vector<PartitionGraph> levels;
+		std::vector<std::vector<uint32_t>> cmaps;
+		levels.push_back(graph);
+		while(levels.back().GetN() > coarsenTo){
+			std::vector<uint32_t> cmap;
+			PartitionGraph coarse = Coarsen(levels.back(), cmap);
+			if(coarse.GetN() > 0.95 * levels.back().GetN()){
+				break;
+			}
+			levels.push_back(coarse);
+			cmaps.push_back(cmap);
+		}
+
+		std::vector<uint32_t> part = InitialPartition(levels.back());
+
+		// Uncoarsening with refinement at every level
+		for(int32_t l = cmaps.size() - 1; l >= 0; l--){
+			std::vector<uint32_t> finePart(levels[l].GetN());
+			for(uint32_t v = 0; v < finePart.size(); v++){
+				finePart[v] = part[cmaps[l][v]];
+			}
+			part.swap(finePart);
+			Refine(levels[l], part);
+		}
+
+		return part;
+
+	}
+
+	PartitionGraph
+	MultilevelGraphPartitioner::Coarsen(const PartitionGraph& graph, std::vector<uint32_t>& cmap){
+
+		uint32_t n = graph.GetN();
+		uint32_t coarsenTo = std::max<uint32_t>(20 * m_parts, 80);
+		// Keep coarse vertices light enough for a balanced initial partition
+		uint64_t maxVertexWeight = std::max<uint64_t>(1, 1.5 * graph.GetTotalVertexWeight() / coarsenTo);
+
+		std::vector<uint32_t> order(n);
+		std::iota(order.begin(), order.end(), 0);
+		std::shuffle(order.begin(), order.end(), m_rng);
+
+		// Heavy-edge matching
+		std::vector<uint32_t> match(n, NO_PART);
+		cmap.assign(n, 0);
+		uint32_t nc = 0;
+		for(uint32_t v : order){
+			if(match[v] != NO_PART){
+				continue;
+			}
+			uint32_t best = NO_PART;
+			uint64_t bestWeight = 0;
+			for(uint32_t e = graph.Begin(v); e < graph.End(v); e++){
+				uint32_t u = graph.Neighbor(e);
+				if(match[u] != NO_PART || graph.GetVertexWeight(v) + graph.GetVertexWeight(u) > maxVertexWeight){
+					continue;
+				}
+				if(best == NO_PART || graph.EdgeWeight(e) > bestWeight){
+					best = u;
+					bestWeight = graph.EdgeWeight(e);
+				}
+			}
+			if(best == NO_PART){
+				match[v] = v;
+				cmap[v] = nc++;
+			}
+			else{
+				match[v] = best;
+				match[best] = v;
+				cmap[v] = nc;
+				cmap[best] = nc;
+				nc++;
+			}
+		}
+
+		PartitionGraph coarse(nc);
+		for(uint32_t v = 0; v < n; v++){
+			coarse.AddVertexWeight(cmap[v], graph.GetVertexWeight(v));
+			for(uint32_t e = graph.Begin(v); e < graph.End(v); e++){
+				uint32_t u = graph.Neighbor(e);
+				if(v < u && cmap[v] != cmap[u]){
+					coarse.AddEdgeWeight(cmap[v], cmap[u], graph.EdgeWeight(e));
+				}
+			}
+		}
+		coarse.Finalize();
+		return coarse;
+
+	}
+
+	std::vector<uint32_t>
+	MultilevelGraphPartitioner::InitialPartition(const PartitionGraph& graph){
+
+		uint64_t limit = m_imbalance * graph.GetTotalVertexWeight() / m_parts;
+		std::vector<uint32_t> best;
+		uint64_t bestCut = 0;
+		bool bestBalanced = false;
+		for(uint32_t trial = 0; trial < 8; trial++){
+			std::vector<uint32_t> part;
+			GrowRegions(graph, part);
+			Refine(graph, part);
+
+			std::vector<uint64_t> pw(m_parts, 0);
+			for(uint32_t v = 0; v < graph.GetN(); v++){
+				pw[part[v]] += graph.GetVertexWeight(v);
+			}
+			bool balanced = *std::max_element(pw.begin(), pw.end()) <= limit;
+			uint64_t cut = EdgeCut(graph, part);
+			if(best.empty() || (balanced && !bestBalanced) || (balanced == bestBalanced && cut < bestCut)){
+				best = part;
+				bestCut = cut;
+				bestBalanced = balanced;
+			}
+		}
+		return best;
+
+	}
+
+	void
+	MultilevelGraphPartitioner::GrowRegions(const PartitionGraph& graph, std::vector<uint32_t>& part){
+
+		uint32_t n = graph.GetN();
+		part.assign(n, NO_PART);
+		uint64_t remaining = graph.GetTotalVertexWeight();
+		uint32_t unassigned = n;
+		std::vector<uint64_t> conn(n, 0);
+
+		for(uint32_t p = 0; p < m_parts && unassigned > 0; p++){
+			if(p == m_parts - 1){
+				for(uint32_t v = 0; v < n; v++){
+					if(part[v] == NO_PART){
+						part[v] = p;
+					}
+				}
+				break;
+			}
+
+			uint64_t target = remaining / (m_parts - p);
+			uint64_t pw = 0;
+			std::fill(conn.begin(), conn.end(), 0);
+			while(pw < target && unassigned > 0){
+				// Frontier vertex most connected to the region, otherwise a new random seed
+				uint32_t next = NO_PART;
+				for(uint32_t v = 0; v < n; v++){
+					if(part[v] == NO_PART && conn[v] > 0 && (next == NO_PART || conn[v] > conn[next])){
+						next = v;
+					}
+				}
+				if(next == NO_PART){
+					uint32_t skip = std::uniform_int_distribution<uint32_t>(0, unassigned - 1)(m_rng);
+					for(uint32_t v = 0; v < n; v++){
+						if(part[v] == NO_PART && skip-- == 0){
+							next = v;
+							break;
+						}
+					}
+				}
+				uint64_t vw = graph.GetVertexWeight(next);
+				if(pw > 0 && pw + vw > target && pw + vw - target > target - pw){
+					break;
+				}
+				part[next] = p;
+				pw += vw;
+				unassigned--;
+				for(uint32_t e = graph.Begin(next); e < graph.End(next); e++){
+					conn[graph.Neighbor(e)] += graph.EdgeWeight(e);
+				}
+			}
+			remaining -= pw;
+		}
+
+	}
+
+	void
+	MultilevelGraphPartitioner::Refine(const PartitionGraph& graph, std::vector<uint32_t>& part){
+
+		uint32_t n = graph.GetN();
+		std::vector<uint64_t> pw(m_parts, 0);
+		for(uint32_t v = 0; v < n; v++){
+			pw[part[v]] += graph.GetVertexWeight(v);
+		}
+		uint64_t limit = m_imbalance * graph.GetTotalVertexWeight() / m_parts;
+
+		// A part left empty by the region growing takes a vertex of the heaviest part
+		if(n >= m_parts){
+			for(uint32_t p = 0; p < m_parts; p++){
+				if(pw[p] != 0){
+					continue;
+				}
+				uint32_t heaviest = std::max_element(pw.begin(), pw.end()) - pw.begin();
+				for(uint32_t v = 0; v < n; v++){
+					if(part[v] == heaviest){
+						pw[heaviest] -= graph.GetVertexWeight(v);
+						pw[p] += graph.GetVertexWeight(v);
+						part[v] = p;
+						break;
+					}
+				}
+			}
+		}
+
+		std::vector<uint32_t> order(n);
+		std::iota(order.begin(), order.end(), 0);
+		std::vector<uint64_t> conn(m_parts, 0);
+		std::vector<uint32_t> touched;
+		for(uint32_t pass = 0; pass < 10; pass++){
+			std::shuffle(order.begin(), order.end(), m_rng);
+			uint32_t moved = 0;
+			std::vector<bool> locked(n, false);
+			for(uint32_t v : order){
+				uint32_t from = part[v];
+				uint64_t vw = graph.GetVertexWeight(v);
+				bool overweight = pw[from] > limit;
+
+				touched.clear();
+				for(uint32_t e = graph.Begin(v); e < graph.End(v); e++){
+					uint32_t p = part[graph.Neighbor(e)];
+					if(conn[p] == 0){
+						touched.push_back(p);
+					}
+					conn[p] += graph.EdgeWeight(e);
+				}
+				if(overweight){
+					// an overweight part may also shed vertices to the lightest part
+					uint32_t lightest = std::min_element(pw.begin(), pw.end()) - pw.begin();
+					if(std::find(touched.begin(), touched.end(), lightest) == touched.end()){
+						touched.push_back(lightest);
+					}
+				}
+
+				uint32_t to = NO_PART;
+				int64_t bestGain = 0;
+				for(uint32_t p : touched){
+					if(p == from){
+						continue;
+					}
+					bool feasible = pw[p] + vw <= limit || (overweight && pw[p] + vw < pw[from]);
+					if(!feasible){
+						continue;
+					}
+					int64_t gain = int64_t(conn[p]) - int64_t(conn[from]);
+					if(to == NO_PART || gain > bestGain || (gain == bestGain && pw[p] < pw[to])){
+						to = p;
+						bestGain = gain;
+					}
+				}
+				for(uint32_t p : touched){
+					conn[p] = 0;
+				}
+				conn[from] = 0;
+
+				if(to == NO_PART){
+					continue;
+				}
+				// zero-gain moves let boundaries slide, each vertex takes at most one per pass
+				if(bestGain > 0 || (bestGain == 0 && !locked[v]) || overweight){
+					locked[v] = true;
+					part[v] = to;
+					pw[from] -= vw;
+					pw[to] += vw;
+					moved++;
+				}
+			}
+			if(moved == 0){
+				break;
+			}
+		}
+
+	}
+
+}
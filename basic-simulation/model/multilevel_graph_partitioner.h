@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef MULTILEVEL_GRAPH_PARTITIONER_H
+#define MULTILEVEL_GRAPH_PARTITIONER_H
+
+#include <stdint.h>
+#include <random>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Undirected graph with vertex and edge weights, in CSR form once finalized
+ */
+class PartitionGraph
+{
+public:
+	PartitionGraph ();
+	PartitionGraph (uint32_t n);
+
+	uint32_t GetN() const;
+	void SetVertexWeight(uint32_t v, uint64_t w);
+	void AddVertexWeight(uint32_t v, uint64_t w);
+	uint64_t GetVertexWeight(uint32_t v) const;
+	uint64_t GetTotalVertexWeight() const;
+
+	/**
+	 * \brief Add w to the weight of edge (u, v), creating it if needed
+	 */
+	void AddEdgeWeight(uint32_t u, uint32_t v, uint64_t w);
+
+	/**
+	 * \brief Merge parallel edges and build the CSR arrays, must be called before partitioning
+	 */
+	void Finalize();
+
+	uint32_t Begin(uint32_t v) const { return m_xadj[v]; }
+	uint32_t End(uint32_t v) const { return m_xadj[v + 1]; }
+	uint32_t Neighbor(uint32_t e) const { return m_adjncy[e]; }
+	uint64_t EdgeWeight(uint32_t e) const { return m_adjwgt[e]; }
+
+private:
+	std::vector<uint64_t> m_vwgt;
+	std::vector<std::vector<std::pair<uint32_t, uint64_t>>> m_pending;
+
+	std::vector<uint32_t> m_xadj;
+	std::vector<uint32_t> m_adjncy;
+	std::vector<uint64_t> m_adjwgt;
+};
+
+/**
+ * \brief Multilevel k-way graph partitioner
+ *
+ * Follows the usual multilevel scheme: the graph is coarsened by heavy-edge
+ * matching, the coarsest graph is split by greedy region growing (best of a
+ * few trials), and the partition is projected back level by level with a
+ * boundary k-way refinement that only accepts moves keeping every part below
+ * imbalance * total / k.
+ *
+ * All random choices come from a generator seeded at construction, so every
+ * MPI process computes the same assignment.
+ */
+class MultilevelGraphPartitioner
+{
+public:
+	MultilevelGraphPartitioner (uint32_t parts, double imbalance, uint64_t seed);
+
+	/**
+	 * \return part of every vertex, in [0, parts)
+	 */
+	std::vector<uint32_t> Partition(const PartitionGraph& graph);
+
+	static uint64_t EdgeCut(const PartitionGraph& graph, const std::vector<uint32_t>& part);
+
+private:
+	PartitionGraph Coarsen(const PartitionGraph& graph, std::vector<uint32_t>& cmap);
+	std::vector<uint32_t> InitialPartition(const PartitionGraph& graph);
+	void GrowRegions(const PartitionGraph& graph, std::vector<uint32_t>& part);
+	void Refine(const PartitionGraph& graph, std::vector<uint32_t>& part);
+
+	uint32_t m_parts;
+	double m_imbalance;
+	std::mt19937_64 m_rng;
+};
+
+}
+
+#endif /* MULTILEVEL_GRAPH_PARTITIONER_H */
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "simulation_sweep.h"
+#include "log_sink.h"
+#include "ns3/config.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/string.h"
+
+namespace ns3 {
+
+	NS_LOG_COMPONENT_DEFINE ("SimulationSweep");
+
+	// written by the simulation, never linked into a variant run directory
+	static const std::set<std::string> SWEEP_OUTPUT_ENTRIES = {"logs_ns3", "results", "ITERATION", "pcap"};
+
+	static std::map<std::string, std::string>
+	ReadStringMap(const json& variant, const std::string& key){
+		std::map<std::string, std::string> values;
+		if(variant.count(key) > 0){
+			for(auto it = variant[key].begin(); it != variant[key].end(); it++){
+				values[it.key()] = it.value().is_string() ? it.value().get<std::string>() : it.value().dump();
+			}
+		}
+		return values;
+	}
+
+	static void
+	MirrorDirectories(const std::string& from, const std::string& to){
+		DIR* dir = opendir(from.c_str());
+		if(dir == NULL){
+			return;
+		}
+		mkdir_if_not_exists(to);
+		for(struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir)){
+			std::string name = entry->d_name;
+			if(entry->d_type == DT_DIR && name != "." && name != ".."){
+				MirrorDirectories(from + "/" + name, to + "/" + name);
+			}
+		}
+		closedir(dir);
+	}
+
+	// routing protocols cache the run directory in their BaseDir attribute when they are created
+	static void
+	RedirectRoutingBaseDir(const std::string& runDir){
+		for(NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++){
+			Ptr<Ipv4> ipv4 = (*node)->GetObject<Ipv4>();
+			if(ipv4 == 0 || ipv4->GetRoutingProtocol() == 0){
+				continue;
+			}
+			std::vector<Ptr<Ipv4RoutingProtocol>> protocols = {ipv4->GetRoutingProtocol()};
+			Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting>(ipv4->GetRoutingProtocol());
+			if(list != 0){
+				int16_t priority;
+				for(uint32_t i = 0; i < list->GetNRoutingProtocols(); i++){
+					protocols.push_back(list->GetRoutingProtocol(i, priority));
+				}
+			}
+			for(auto& protocol : protocols){
+				protocol->SetAttributeFailSafe("BaseDir", StringValue(runDir));
+			}
+		}
+	}
+
+	SimulationSweep::SimulationSweep (Ptr<BasicSimulation> basicSimulation)
+		: m_basicSimulation(basicSimulation),
+		  m_outputDir("sweep"),
+		  m_parallelism(1){
+
+		char* path = realpath(basicSimulation->GetRunDir().c_str(), NULL);
+		if(path == NULL){
+			throw std::runtime_error("Cannot resolve run directory " + basicSimulation->GetRunDir());
+		}
+		m_baseRunDir = path;
+		free(path);
+	}
+
+	SimulationSweep::~SimulationSweep (){
+
+	}
+
+	void
+	SimulationSweep::ReadVariants(std::string filename){
+		std::ifstream jfile(filename);
+		if(!jfile.is_open()){
+			throw std::runtime_error("Cannot open sweep file: " + filename);
+		}
+		json j;
+		jfile >> j;
+		if(j.count("parallelism") > 0){
+			SetParallelism(j["parallelism"].get<uint32_t>());
+		}
+		if(j.count("output_dir") > 0){
+			SetOutputDir(j["output_dir"].get<std::string>());
+		}
+		for(auto& v : j.at("variants")){
+			Variant variant;
+			variant.m_name = v.at("name").get<std::string>();
+			variant.m_run = v.value("run", 0u);
+			variant.m_config = ReadStringMap(v, "config");
+			variant.m_attributes = ReadStringMap(v, "attributes");
+			variant.m_inputs = ReadStringMap(v, "inputs");
+			AddVariant(variant);
+		}
+	}
+
+	void
+	SimulationSweep::AddVariant(const Variant& variant){
+		if(variant.m_name.empty() || variant.m_name.find('/') != std::string::npos){
+			throw std::invalid_argument("Invalid sweep variant name: \"" + variant.m_name + "\"");
+		}
+		for(auto& other : m_variants){
+			if(other.m_name == variant.m_name){
+				throw std::invalid_argument("Duplicate sweep variant: " + variant.m_name);
+			}
+		}
+		for(auto& input : variant.m_inputs){
+			if(input.first.empty() || input.first.find('/') != std::string::npos || SWEEP_OUTPUT_ENTRIES.count(input.first) > 0){
+				throw std::invalid_argument("Variant " + variant.m_name + " cannot replace run directory entry \"" + input.first + "\"");
+			}
+		}
+		m_variants.push_back(variant);
+	}
+
+	const std::vector<SimulationSweep::Variant>&
+	SimulationSweep::GetVariants() const{
+		return m_variants;
+	}
+
+	void
+	SimulationSweep::SetParallelism(uint32_t parallelism){
+		if(parallelism == 0){
+			throw std::invalid_argument("Sweep parallelism must be at least one");
+		}
+		m_parallelism = parallelism;
+	}
+
+	void
+	SimulationSweep::SetOutputDir(std::string outputDir){
+		if(outputDir.empty() || outputDir[0] == '/' || SWEEP_OUTPUT_ENTRIES.count(outputDir.substr(0, outputDir.find('/'))) > 0){
+			throw std::invalid_argument("Sweep output directory must be a new directory of the run directory: " + outputDir);
+		}
+		m_outputDir = outputDir;
+	}
+
+	std::string
+	SimulationSweep::PrepareRunDir(const Variant& variant){
+		std::string root = m_baseRunDir + "/" + m_outputDir;
+		std::string runDir = root + "/" + variant.m_name;
+		mkdir_force_if_not_exists(root);
+		remove_dir_and_subfile_if_exists(runDir);
+		mkdir_if_not_exists(runDir);
+
+		std::map<std::string, std::string> links;
+		DIR* dir = opendir(m_baseRunDir.c_str());
+		if(dir == NULL){
+			throw std::runtime_error("Cannot list run directory " + m_baseRunDir);
+		}
+		std::string outputTop = m_outputDir.substr(0, m_outputDir.find('/'));
+		for(struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir)){
+			std::string name = entry->d_name;
+			if(name != "." && name != ".." && name != outputTop && SWEEP_OUTPUT_ENTRIES.count(name) == 0){
+				links[name] = m_baseRunDir + "/" + name;
+			}
+		}
+		closedir(dir);
+		for(auto& input : variant.m_inputs){
+			std::string target = input.second[0] == '/' ? input.second : m_baseRunDir + "/" + input.second;
+			if(!file_exists(target) && !dir_exists(target)){
+				throw std::runtime_error("Input " + target + " of sweep variant " + variant.m_name + " does not exist");
+			}
+			links[input.first] = target;
+		}
+		for(auto& link : links){
+			if(symlink(link.second.c_str(), (runDir + "/" + link.first).c_str()) != 0){
+				throw std::runtime_error("Cannot link " + link.second + " into " + runDir);
+			}
+		}
+		return runDir;
+	}
+
+	void
+	SimulationSweep::RunVariant(VariantRunner& runner, const Variant& variant, const std::string& runDir){
+		// one console log per variant instead of interleaved output
+		std::string output = runDir + "/sweep_output.txt";
+		if(freopen(output.c_str(), "w", stdout) == NULL || dup2(fileno(stdout), fileno(stderr)) < 0){
+			throw std::runtime_error("Cannot redirect the output of sweep variant " + variant.m_name);
+		}
+
+		m_basicSimulation->ConfigureVariant(runDir, variant.m_config);
+		RedirectRoutingBaseDir(runDir);
+		// result directories the shared scenario created for its objects
+		for(auto& entry : SWEEP_OUTPUT_ENTRIES){
+			MirrorDirectories(m_baseRunDir + "/" + entry, runDir + "/" + entry);
+		}
+		if(variant.m_run != 0){
+			RngSeedManager::SetRun(variant.m_run);
+		}
+		for(auto& attribute : variant.m_attributes){
+			if(attribute.first[0] == '/'){
+				Config::Set(attribute.first, StringValue(attribute.second));
+			}
+			else{
+				Config::SetDefault(attribute.first, StringValue(attribute.second));
+			}
+		}
+		runner(m_basicSimulation, variant);
+	}
+
+	uint32_t
+	SimulationSweep::Run(VariantRunner runner){
+		if(m_basicSimulation->IsDistributedEnabled()){
+			throw std::runtime_error("Sweeps do not support distributed simulations");
+		}
+		std::cout << "SWEEP" << std::endl;
+		printf("  > %u variant(s), at most %u at a time, in %s/%s\n\n", (uint32_t) m_variants.size(), m_parallelism, m_baseRunDir.c_str(), m_outputDir.c_str());
+
+		std::vector<int> exitStatus(m_variants.size(), -1);
+		std::vector<double> wallclockS(m_variants.size(), 0);
+		std::map<pid_t, std::pair<uint32_t, std::chrono::steady_clock::time_point>> running;
+		uint32_t next = 0;
+		while(next < m_variants.size() || !running.empty()){
+			while(next < m_variants.size() && running.size() < m_parallelism){
+				std::string runDir = PrepareRunDir(m_variants[next]);
+				// threads do not survive a fork and unflushed output would be written twice
+				LogSink::Shutdown();
+				std::cout.flush();
+				std::cerr.flush();
+				fflush(NULL);
+				pid_t pid = fork();
+				if(pid < 0){
+					throw std::runtime_error("Cannot fork sweep variant " + m_variants[next].m_name);
+				}
+				if(pid == 0){
+					int code = 0;
+					try{
+						RunVariant(runner, m_variants[next], runDir);
+					}
+					catch(std::exception& e){
+						std::cerr << "Sweep variant " << m_variants[next].m_name << " failed: " << e.what() << std::endl;
+						code = 1;
+					}
+					try{
+						LogSink::Shutdown();
+					}
+					catch(std::exception& e){
+						std::cerr << e.what() << std::endl;
+						code = 1;
+					}
+					std::cout.flush();
+					std::cerr.flush();
+					fflush(NULL);
+					_exit(code);
+				}
+				NS_LOG_INFO("Variant " << m_variants[next].m_name << " runs in process " << pid);
+				running[pid] = std::make_pair(next, std::chrono::steady_clock::now());
+				next++;
+			}
+
+			int status;
+			pid_t pid = waitpid(-1, &status, 0);
+			if(pid < 0){
+				throw std::runtime_error("Lost track of the sweep variant processes");
+			}
+			auto it = running.find(pid);
+			if(it == running.end()){
+				continue;
+			}
+			uint32_t i = it->second.first;
+			exitStatus[i] = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+			wallclockS[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - it->second.second).count();
+			printf("  > %-30s %s in %.1f s\n", m_variants[i].m_name.c_str(), exitStatus[i] == 0 ? "finished" : "FAILED", wallclockS[i]);
+			running.erase(it);
+		}
+
+		uint32_t failed = 0;
+		std::ofstream summary(m_baseRunDir + "/" + m_outputDir + "/sweep_summary.csv");
+		summary << "variant,exit_status,wallclock_s" << std::endl;
+		for(uint32_t i = 0; i < m_variants.size(); i++){
+			summary << m_variants[i].m_name << "," << exitStatus[i] << "," << wallclockS[i] << std::endl;
+			failed += exitStatus[i] != 0;
+		}
+		summary.close();
+		printf("  > %u of %u variant(s) failed\n\n", failed, (uint32_t) m_variants.size());
+		return failed;
+	}
+
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef SIMULATION_SWEEP_H
+#define SIMULATION_SWEEP_H
+
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/basic-simulation.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup BasicSim
+ *
+ * \brief Runs variants of a scenario built once
+ *
+ * The caller builds everything the variants share (basic simulation,
+ * topology, stacks, routing) and hands the rest of the setup and the run to
+ * Run (). Every variant then runs in a child process forked from that state,
+ * so it starts from a simulator that has not run yet and from the random
+ * streams of the shared scenario, exactly as a fresh process with the same
+ * seed would, without paying for the setup again.
+ *
+ * A variant gets its own run directory, <run_dir>/<output_dir>/<name>, which
+ * links to the inputs of the base run directory, some of them possibly
+ * replaced (e.g. another config_traffic), and receives all results and logs,
+ * including the files the shared scenario registered at the LogSink. The
+ * BaseDir attribute of the routing protocols is pointed to it as well;
+ * anything else that writes to a path cached before the fork without the
+ * LogSink still writes to the base run directory. Config keys that the
+ * shared scenario has not read yet, the RngRun of the streams created by the
+ * variant, and attribute defaults ("ns3::Class::Attribute") or paths
+ * ("/NodeList/...") can differ per variant.
+ *
+ * Variants are read from a JSON file:
+ *
+ * {"parallelism": 4, "output_dir": "sweep", "variants": [
+ *     {"name": "load_10", "run": 2,
+ *      "config": {"key": "value"},
+ *      "attributes": {"ns3::TcpSocket::SegmentSize": "1400"},
+ *      "inputs": {"config_traffic": "sweep_inputs/config_traffic_10"}}]}
+ *
+ * Relative input paths are relative to the base run directory. Distributed
+ * runs are not supported, MPI does not survive a fork.
+ */
+class SimulationSweep
+{
+public:
+	struct Variant
+	{
+		std::string m_name;
+		uint32_t m_run;										//!< RngRun of the streams the variant creates, 0 keeps the current one
+		std::map<std::string, std::string> m_config;
+		std::map<std::string, std::string> m_attributes;
+		std::map<std::string, std::string> m_inputs;		//!< Entry of the base run directory -> path replacing it
+	};
+
+	/**
+	 * Installs what differs between variants, e.g. the application
+	 * schedules, then runs and finalizes the simulation
+	 */
+	typedef std::function<void (Ptr<BasicSimulation>, const Variant&)> VariantRunner;
+
+	SimulationSweep (Ptr<BasicSimulation> basicSimulation);
+	virtual ~SimulationSweep ();
+
+	void ReadVariants(std::string filename);
+	void AddVariant(const Variant& variant);
+	const std::vector<Variant>& GetVariants() const;
+
+	/**
+	 * \brief Maximum number of variants running at the same time
+	 */
+	void SetParallelism(uint32_t parallelism);
+	void SetOutputDir(std::string outputDir);
+
+	/**
+	 * \brief Run all variants and write <run_dir>/<output_dir>/sweep_summary.csv
+	 *
+	 * Call it once the shared scenario is built and before the simulation runs.
+	 *
+	 * \return number of variants that failed
+	 */
+	uint32_t Run(VariantRunner runner);
+
+private:
+	std::string PrepareRunDir(const Variant& variant);
+	void RunVariant(VariantRunner& runner, const Variant& variant, const std::string& runDir);
+
+	Ptr<BasicSimulation> m_basicSimulation;
+	std::string m_baseRunDir;
+	std::string m_outputDir;
+	uint32_t m_parallelism;
+	std::vector<Variant> m_variants;
+};
+
+}
+
+#endif /* SIMULATION_SWEEP_H */
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+#include "ns3/distributed_lookahead.h"
+#include "ns3/log_sink.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup BasicSim
+ *
+ * \brief A registered sink receives every per-epoch lookahead
+ */
+class DistributedLookaheadSinkTestCase : public TestCase
+{
+public:
+	DistributedLookaheadSinkTestCase ();
+
+private:
+	virtual void DoRun (void);
+	void Receive (Time lookahead);
+
+	std::vector<Time> m_received; //!< lookahead values delivered to the sink
+};
+
+DistributedLookaheadSinkTestCase::DistributedLookaheadSinkTestCase ()
+	: TestCase ("Per-epoch lookahead is delivered to the registered sink")
+{
+}
+
+void
+DistributedLookaheadSinkTestCase::Receive (Time lookahead)
+{
+	m_received.push_back(lookahead);
+}
+
+void
+DistributedLookaheadSinkTestCase::DoRun (void)
+{
+	DistributedLookahead::SetLookaheadSink(MakeCallback(&DistributedLookaheadSinkTestCase::Receive, this));
+
+	// The lookahead may grow as well as shrink between epochs
+	DistributedLookahead::Update(Seconds(0), MilliSeconds(3));
+	DistributedLookahead::Update(Seconds(1), MilliSeconds(12));
+	DistributedLookahead::Update(Seconds(2), MilliSeconds(5));
+
+	NS_TEST_ASSERT_MSG_EQ(m_received.size(), 3, "Every update must reach the sink");
+	NS_TEST_EXPECT_MSG_EQ(m_received[0], MilliSeconds(3), "First epoch lookahead");
+	NS_TEST_EXPECT_MSG_EQ(m_received[1], MilliSeconds(12), "A larger lookahead must be passed on unchanged");
+	NS_TEST_EXPECT_MSG_EQ(m_received[2], MilliSeconds(5), "Third epoch lookahead");
+	NS_TEST_EXPECT_MSG_EQ(DistributedLookahead::GetLookahead(), MilliSeconds(5), "Last published lookahead");
+	NS_TEST_EXPECT_MSG_EQ(DistributedLookahead::GetEpochStart(), Seconds(2), "Start of the last epoch");
+
+	// A sink registered late gets the current value right away
+	m_received.clear();
+	DistributedLookahead::SetLookaheadSink(MakeCallback(&DistributedLookaheadSinkTestCase::Receive, this));
+	NS_TEST_ASSERT_MSG_EQ(m_received.size(), 1, "Late sink must receive the current lookahead");
+	NS_TEST_EXPECT_MSG_EQ(m_received[0], MilliSeconds(5), "Late sink received a stale lookahead");
+
+	DistributedLookahead::SetLookaheadSink(MakeNullCallback<void, Time>());
+}
+
+/**
+ * \ingroup BasicSim
+ *
+ * \brief A redirected file continues at its new path with what it held before
+ */
+class LogSinkRedirectTestCase : public TestCase
+{
+public:
+	LogSinkRedirectTestCase ();
+
+private:
+	virtual void DoRun (void);
+	std::string ReadFile (std::string filename);
+};
+
+LogSinkRedirectTestCase::LogSinkRedirectTestCase ()
+	: TestCase ("Redirected log sink files keep their content")
+{
+}
+
+std::string
+LogSinkRedirectTestCase::ReadFile (std::string filename)
+{
+	std::ifstream ifs(filename, std::ifstream::binary);
+	std::ostringstream content;
+	content << ifs.rdbuf();
+	return content.str();
+}
+
+void
+LogSinkRedirectTestCase::DoRun (void)
+{
+	std::string base = CreateTempDirFilename("log-sink-base");
+	std::string variant = CreateTempDirFilename("log-sink-variant");
+	mkdir(base.c_str(), 0777);
+	mkdir((base + "/logs").c_str(), 0777);
+	mkdir(variant.c_str(), 0777);
+
+	// as done by a recorder of the shared scenario before the variants are forked
+	uint32_t file = LogSink::Open(base + "/logs/recorder.bin", true);
+	LogSink::Write(file, "HEADER");
+	LogSink::Shutdown();
+
+	LogSink::Redirect(base + "/", variant + "/");
+	LogSink::Write(file, "record");
+	LogSink::Flush();
+
+	NS_TEST_EXPECT_MSG_EQ(ReadFile(variant + "/logs/recorder.bin"), "HEADERrecord", "Redirected file must continue after the header");
+	NS_TEST_EXPECT_MSG_EQ(ReadFile(base + "/logs/recorder.bin"), "HEADER", "Records after the redirect must not reach the old path");
+	LogSink::Shutdown();
+}
+
+/**
+ * \ingroup BasicSim
+ *
+ * \brief Unit tests of the basic simulation module
+ */
+class BasicSimulationTestSuite : public TestSuite
+{
+public:
+	BasicSimulationTestSuite ();
+};
+
+BasicSimulationTestSuite::BasicSimulationTestSuite ()
+	: TestSuite ("basic-simulation", TestSuite::UNIT)
+{
+	AddTestCase (new DistributedLookaheadSinkTestCase, TestCase::QUICK);
+	AddTestCase (new LogSinkRedirectTestCase, TestCase::QUICK);
+}
+
+static BasicSimulationTestSuite g_basicSimulationTestSuite;
@@ -19,6 +19,7 @@
 
 #include "sag_application_schedule_3gpphttp.h"
 #include "ns3/cppjson2structure.hh"
+#include "ns3/log_sink.h"
 
 namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("ThreeGppHttpApplicationScheduler");
@@ -237,14 +238,7 @@ void SAGApplicationSchedulerThreeGppHttp::WriteResults() {
 			jsonContents.push_back(jsonContent);
 
 		}
-		std::ofstream httpRes(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/http_" + std::to_string(entry.GetBurstId())+"/http_" + std::to_string(entry.GetBurstId())+"_log.json", std::ofstream::out);
-		if (httpRes.is_open()) {
-			httpRes << jsonContents.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-			httpRes.close();
-			//std::cout << "JSON file created successfully." << std::endl;
-		} else {
-			std::cout << "Failed to create JSON file." << std::endl;
-		}
+		LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/http_" + std::to_string(entry.GetBurstId())+"/http_" + std::to_string(entry.GetBurstId())+"_log.json", jsonContents.dump(4));
 	}
 
 }
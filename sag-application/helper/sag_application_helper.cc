@@ -28,6 +28,20 @@
 
 namespace ns3 {
 
+// Shared by all packet senders
+static TimeValue
+GetSendBatchWindow (Ptr<ns3::BasicSimulation> basicSimulation)
+{
+  return TimeValue (NanoSeconds (parse_positive_int64 (basicSimulation->GetConfigParamOrDefault ("application_send_batch_window_ns", "0"))));
+}
+
+// Shared by all codec users
+static BooleanValue
+GetRandomTraceStart (Ptr<ns3::BasicSimulation> basicSimulation)
+{
+  return BooleanValue (parse_boolean (basicSimulation->GetConfigParamOrDefault ("application_random_trace_start", "false")));
+}
+
 //base sag application helper
 SAGApplicationHelper::SAGApplicationHelper (Ptr<ns3::BasicSimulation> basicSimulation)
 {
@@ -210,6 +224,8 @@ SAGApplicationHelperUdp::SAGApplicationHelperUdp (Ptr<ns3::BasicSimulation> basi
   //SetAttribute (m_udpFactory, "Port", UintegerValue (port));
   SetAttribute (m_udpFactory, "BaseLogsDir", StringValue (basicSimulation->GetLogsDir()));
   SetAttribute (m_udpFactory, "BaseDir", StringValue (basicSimulation->GetRunDir()));
+  SetAttribute (m_udpFactory, "SendBatchWindow", GetSendBatchWindow (basicSimulation));
+  SetAttribute (m_udpFactory, "RandomTraceStart", GetRandomTraceStart (basicSimulation));
 }
 
 SAGApplicationHelperUdp::SAGApplicationHelperUdp (Ptr<ns3::BasicSimulation> basicSimulation)
@@ -219,6 +235,10 @@ SAGApplicationHelperUdp::SAGApplicationHelperUdp (Ptr<ns3::BasicSimulation> basi
   //SetAttribute (m_udpFactory, "Port", UintegerValue (port));
   SetAttribute (m_udpFactory, "BaseLogsDir", StringValue (basicSimulation->GetLogsDir()));
   SetAttribute (m_udpFactory, "BaseDir", StringValue (basicSimulation->GetRunDir()));
+  SetAttribute (m_udpFactory, "DetailsLogSampler", StringValue (basicSimulation->GetConfigParamOrDefault ("udp_details_log_sampler", "every_n")));
+  SetAttribute (m_udpFactory, "DetailsLogSampleInterval", UintegerValue (parse_geq_one_int64 (basicSimulation->GetConfigParamOrDefault ("udp_details_log_sample_interval", "100"))));
+  SetAttribute (m_udpFactory, "DetailsLogSampleSize", UintegerValue (parse_geq_one_int64 (basicSimulation->GetConfigParamOrDefault ("udp_details_log_sample_size", "10000"))));
+  SetAttribute (m_udpFactory, "DetailsLogStratum", TimeValue (NanoSeconds (parse_geq_one_int64 (basicSimulation->GetConfigParamOrDefault ("udp_details_log_stratum_ns", "1000000000")))));
 }
 
 Ptr<Application>
@@ -246,6 +266,7 @@ SAGApplicationHelperRtpSender::SAGApplicationHelperRtpSender (Ptr<ns3::BasicSimu
   SetAttribute (m_rtpsendFactory, "Port", UintegerValue (port));
   SetAttribute (m_rtpsendFactory, "BaseLogsDir", StringValue (basicSimulation->GetLogsDir()));
   SetAttribute (m_rtpsendFactory, "BaseDir", StringValue (basicSimulation->GetRunDir()));
+  SetAttribute (m_rtpsendFactory, "RandomTraceStart", GetRandomTraceStart (basicSimulation));
 }
 
 Ptr<Application>
@@ -307,6 +328,8 @@ SAGApplicationHelperTcpSend::SAGApplicationHelperTcpSend (Ptr<ns3::BasicSimulati
 
   SetAttribute (m_tcpSendFactory, "BaseLogsDir", StringValue (basicSimulation->GetLogsDir()));
   SetAttribute (m_tcpSendFactory, "BaseDir", StringValue (basicSimulation->GetRunDir()));
+  SetAttribute (m_tcpSendFactory, "SendBatchWindow", GetSendBatchWindow (basicSimulation));
+  SetAttribute (m_tcpSendFactory, "RandomTraceStart", GetRandomTraceStart (basicSimulation));
 }
 
 Ptr<Application>
@@ -358,6 +381,8 @@ SAGApplicationHelperScpsTpSend::SAGApplicationHelperScpsTpSend (Ptr<ns3::BasicSi
 
   SetAttribute (m_scpstpSendFactory, "BaseLogsDir", StringValue (basicSimulation->GetLogsDir()));
   SetAttribute (m_scpstpSendFactory, "BaseDir", StringValue (basicSimulation->GetRunDir()));
+  SetAttribute (m_scpstpSendFactory, "SendBatchWindow", GetSendBatchWindow (basicSimulation));
+  SetAttribute (m_scpstpSendFactory, "RandomTraceStart", GetRandomTraceStart (basicSimulation));
 }
 
 Ptr<Application>
@@ -410,6 +435,8 @@ SAGApplicationHelperQuicSend::SAGApplicationHelperQuicSend (Ptr<ns3::BasicSimula
 
   SetAttribute (m_quicSendFactory, "BaseLogsDir", StringValue (basicSimulation->GetLogsDir()));
   SetAttribute (m_quicSendFactory, "BaseDir", StringValue (basicSimulation->GetRunDir()));
+  SetAttribute (m_quicSendFactory, "SendBatchWindow", GetSendBatchWindow (basicSimulation));
+  SetAttribute (m_quicSendFactory, "RandomTraceStart", GetRandomTraceStart (basicSimulation));
 }
 
 Ptr<Application>
@@ -18,6 +18,7 @@
  */
 
 #include "sag_application_schedule_ftp.h"
+#include "ns3/log_sink.h"
 
 namespace ns3 {
 
@@ -278,14 +279,7 @@ void SAGApplicationSchedulerFTP::WriteResults() {
 
         }
 
-		std::ofstream ftpRecord(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_ftp_flows.json", std::ofstream::out);
-		if (ftpRecord.is_open()) {
-			ftpRecord << jsonFtp.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-			ftpRecord.close();
-			//std::cout << "JSON file created successfully." << std::endl;
-		} else {
-			std::cout << "Failed to create JSON file." << std::endl;
-		}
+		LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_ftp_flows.json", jsonFtp.dump(4));
 
         // Close files
         std::cout << "  > Closing FTP flow log files:" << std::endl;
@@ -336,16 +330,10 @@ void SAGApplicationSchedulerFTP::WriteResults() {
 			jsonPathObject["path_change_times"] = path_change_number;
             jsonPathObject["path_hop_count"] = path_hop_count;
             jsonPathObject["path_hop_count_timestamp_us"] = route_timestamp;
+            jsonPathObject["path_node_ids"] = routes;
 			jsonObject["path_info"] = jsonPathObject;
 
-			std::ofstream pathRecord(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/ftp_" + std::to_string(info.GetFtpFlowId())+"/ftp_" + std::to_string(info.GetFtpFlowId())+"_path_log.json", std::ofstream::out);
-			if (pathRecord.is_open()) {
-				pathRecord << jsonObject.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathRecord.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/ftp_" + std::to_string(info.GetFtpFlowId())+"/ftp_" + std::to_string(info.GetFtpFlowId())+"_path_log.json", jsonObject.dump(4));
 
 
 			// Route Record
@@ -433,14 +421,7 @@ void SAGApplicationSchedulerFTP::WriteResults() {
 				path_change.push_back(jsonContent);
 			}
 
-			std::ofstream pathCzml(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/ftp_" + std::to_string(info.GetFtpFlowId())+"/ftp_" + std::to_string(info.GetFtpFlowId())+"_czml.json", std::ofstream::out);
-			if (pathCzml.is_open()) {
-				pathCzml << path_change.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathCzml.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/ftp_" + std::to_string(info.GetFtpFlowId())+"/ftp_" + std::to_string(info.GetFtpFlowId())+"_czml.json", path_change.dump(4));
 		}
 
 
@@ -469,27 +450,13 @@ void SAGApplicationSchedulerFTP::WriteResults() {
 			jsonObject1["name"] = "ftp_" + std::to_string(info.GetFtpFlowId());
 			jsonObject1["delay_sample_us"] = pkt_delay;
 			jsonObject1["time_stamp_us"] = record_timestamp;
-			std::ofstream pathRecord1(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/ftp_" + std::to_string(info.GetFtpFlowId())+"/ftp_" + std::to_string(info.GetFtpFlowId())+"_delay_log.json", std::ofstream::out);
-			if (pathRecord1.is_open()) {
-				pathRecord1 << jsonObject1.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathRecord1.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/ftp_" + std::to_string(info.GetFtpFlowId())+"/ftp_" + std::to_string(info.GetFtpFlowId())+"_delay_log.json", jsonObject1.dump(4));
 
 			nlohmann::ordered_json jsonObject2;
 			jsonObject2["name"] = "ftp_" + std::to_string(info.GetFtpFlowId());
 			jsonObject2["flow_rate_mbps"] = flow_rate;
 			jsonObject2["time_stamp_us"] = record_process_timestamp;
-			std::ofstream pathRecord2(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/ftp_" + std::to_string(info.GetFtpFlowId())+"/ftp_" + std::to_string(info.GetFtpFlowId())+"_flow_rate_log.json", std::ofstream::out);
-			if (pathRecord2.is_open()) {
-				pathRecord2 << jsonObject2.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathRecord2.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/ftp_" + std::to_string(info.GetFtpFlowId())+"/ftp_" + std::to_string(info.GetFtpFlowId())+"_flow_rate_log.json", jsonObject2.dump(4));
 
 		}
 
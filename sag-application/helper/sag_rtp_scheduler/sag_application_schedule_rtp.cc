@@ -2,6 +2,7 @@
 #include "ns3/sag_application_layer_rtp_sender.h"
 #include "ns3/sag_application_layer_rtp_receiver.h"
 #include "ns3/cppjson2structure.hh"
+#include "ns3/log_sink.h"
 
 namespace ns3 {
 
@@ -331,42 +332,22 @@ void SAGApplicationSchedulerRtp::WriteResults()
             jsonPathObject["path_change_times"] = path_change_number;
             jsonPathObject["path_hop_count"] = path_hop_count;
             jsonPathObject["path_hop_count_timestamp_us"] = route_timestamp;
+            jsonPathObject["path_node_ids"] = routes;
             jsonObject["path_info"] = jsonPathObject;
 
-			std::ofstream pathRecord(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/rtp_" + std::to_string(info.GetBurstId())+"/rtp_" + std::to_string(info.GetBurstId())+"_path_log.json", std::ofstream::out);
-			if (pathRecord.is_open()) {
-				pathRecord << jsonObject.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathRecord.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/rtp_" + std::to_string(info.GetBurstId())+"/rtp_" + std::to_string(info.GetBurstId())+"_path_log.json", jsonObject.dump(4));
 
 			nlohmann::ordered_json jsonObject1;
 			jsonObject1["name"] = "rtp_" + std::to_string(info.GetBurstId());
 			jsonObject1["delay_sample_us"] = pkt_delay;
 			jsonObject1["time_stamp_us"] = record_timestamp;
-			std::ofstream pathRecord1(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/rtp_" + std::to_string(info.GetBurstId())+"/rtp_" + std::to_string(info.GetBurstId())+"_delay_log.json", std::ofstream::out);
-			if (pathRecord1.is_open()) {
-				pathRecord1 << jsonObject1.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathRecord1.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/rtp_" + std::to_string(info.GetBurstId())+"/rtp_" + std::to_string(info.GetBurstId())+"_delay_log.json", jsonObject1.dump(4));
 
 			nlohmann::ordered_json jsonObject2;
 			jsonObject2["name"] = "rtp_" + std::to_string(info.GetBurstId());
 			jsonObject2["flow_rate_mbps"] = flow_rate;
 			jsonObject2["time_stamp_us"] = record_timestamp;
-			std::ofstream pathRecord2(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/rtp_" + std::to_string(info.GetBurstId())+"/rtp_" + std::to_string(info.GetBurstId())+"_flow_rate_log.json", std::ofstream::out);
-			if (pathRecord2.is_open()) {
-				pathRecord2 << jsonObject2.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathRecord2.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/rtp_" + std::to_string(info.GetBurstId())+"/rtp_" + std::to_string(info.GetBurstId())+"_flow_rate_log.json", jsonObject2.dump(4));
 
 			// Route Record
 			nlohmann::ordered_json path_change;
@@ -452,14 +433,7 @@ void SAGApplicationSchedulerRtp::WriteResults()
 				path_change.push_back(jsonContent);
 			}
 
-			std::ofstream pathCzml(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/rtp_" + std::to_string(info.GetBurstId())+"/rtp_" + std::to_string(info.GetBurstId())+"_czml.json", std::ofstream::out);
-			if (pathCzml.is_open()) {
-				pathCzml << path_change.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathCzml.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/rtp_" + std::to_string(info.GetBurstId())+"/rtp_" + std::to_string(info.GetBurstId())+"_czml.json", path_change.dump(4));
         }
 
 
@@ -536,14 +510,7 @@ void SAGApplicationSchedulerRtp::WriteResults()
             jsonRtpOutgoing.push_back(jsonObject);
 		}
 
-		std::ofstream rtpOutgoingRecord(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_rtp_flows_outgoing.json", std::ofstream::out);
-		if (rtpOutgoingRecord.is_open()) {
-			rtpOutgoingRecord << jsonRtpOutgoing.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-			rtpOutgoingRecord.close();
-			//std::cout << "JSON file created successfully." << std::endl;
-		} else {
-			std::cout << "Failed to create JSON file." << std::endl;
-		}
+		LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_rtp_flows_outgoing.json", jsonRtpOutgoing.dump(4));
 
 		// Incoming bursts
 		std::cout << "  > Writing incoming log files" << std::endl;
@@ -616,14 +583,7 @@ void SAGApplicationSchedulerRtp::WriteResults()
             jsonRtpIncoming.push_back(jsonObject);
 		}
 
-		std::ofstream rtpIncomingRecord(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_rtp_flows_incoming.json", std::ofstream::out);
-		if (rtpIncomingRecord.is_open()) {
-			rtpIncomingRecord << jsonRtpIncoming.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-			rtpIncomingRecord.close();
-			//std::cout << "JSON file created successfully." << std::endl;
-		} else {
-			std::cout << "Failed to create JSON file." << std::endl;
-		}
+		LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_rtp_flows_incoming.json", jsonRtpIncoming.dump(4));
 
 		// Close files
 		std::cout << "  > Closing RTP flow log files:" << std::endl;
@@ -20,6 +20,7 @@
  #include "sag_application_schedule_scps_tp.h"
 
  #include "ns3/cppjson2structure.hh"
+ #include "ns3/log_sink.h"
  
  namespace ns3 {
  
@@ -290,14 +291,7 @@
              jsonScpsTp.push_back(jsonObject);
  
          }
-     std::ofstream scpstpRecord(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_scps_tp_flows.json", std::ofstream::out);
-     if (scpstpRecord.is_open()) {
-       scpstpRecord << jsonScpsTp.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-       scpstpRecord.close();
-       //std::cout << "JSON file created successfully." << std::endl;
-     } else {
-       std::cout << "Failed to create JSON file." << std::endl;
-     }
+     LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_scps_tp_flows.json", jsonScpsTp.dump(4));
          // Close files
          std::cout << "  > Closing SCPSTP flow log files:" << std::endl;
          fclose(file_csv);
@@ -348,16 +342,10 @@
        jsonPathObject["path_change_times"] = path_change_number;
              jsonPathObject["path_hop_count"] = path_hop_count;
              jsonPathObject["path_hop_count_timestamp_us"] = route_timestamp;
+             jsonPathObject["path_node_ids"] = routes;
        jsonObject["path_info"] = jsonPathObject;
  
-       std::ofstream pathRecord(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"_path_log.json", std::ofstream::out);
-       if (pathRecord.is_open()) {
-         pathRecord << jsonObject.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-         pathRecord.close();
-         //std::cout << "JSON file created successfully." << std::endl;
-       } else {
-         std::cout << "Failed to create JSON file." << std::endl;
-       }
+       LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"_path_log.json", jsonObject.dump(4));
  
  
        // Route Record
@@ -445,14 +433,7 @@
          path_change.push_back(jsonContent);
        }
  
-       std::ofstream pathCzml(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"_czml.json", std::ofstream::out);
-       if (pathCzml.is_open()) {
-         pathCzml << path_change.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-         pathCzml.close();
-         //std::cout << "JSON file created successfully." << std::endl;
-       } else {
-         std::cout << "Failed to create JSON file." << std::endl;
-       }
+       LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"_czml.json", path_change.dump(4));
 
        
        const std::vector<double> pkt_delay =  sagApplicationFtpIncoming->GetRecordDelaymsDetailsTimeStampLogUs();
@@ -477,14 +458,7 @@
        jsonObject1["average_delay_us"] = average_delay;
        jsonObject1["delay_sample_us"] = pkt_delay;
        jsonObject1["time_stamp_us"] = record_timestamp;
-       std::ofstream pathRecord1(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"_delay_log.json", std::ofstream::out);
-       if (pathRecord1.is_open()) {
-         pathRecord1 << jsonObject1.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-         pathRecord1.close();
-         //std::cout << "JSON file created successfully." << std::endl;
-       } else {
-         std::cout << "Failed to create JSON file." << std::endl;
-       }
+       LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"_delay_log.json", jsonObject1.dump(4));
      }
  
  
@@ -515,14 +489,7 @@
        jsonObject2["name"] = "scps_tp_" + std::to_string(info.GetScpsTpFlowId());
        jsonObject2["flow_rate_mbps"] = flow_rate;
        jsonObject2["time_stamp_us"] = record_process_timestamp;
-       std::ofstream pathRecord2(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"_flow_rate_log.json", std::ofstream::out);
-       if (pathRecord2.is_open()) {
-         pathRecord2 << jsonObject2.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-         pathRecord2.close();
-         //std::cout << "JSON file created successfully." << std::endl;
-       } else {
-         std::cout << "Failed to create JSON file." << std::endl;
-       }
+       LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"_flow_rate_log.json", jsonObject2.dump(4));
  
  //			std::ofstream pathRecord1(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"/scps_tp_" + std::to_string(info.GetScpsTpFlowId())+"_delay_log.json", std::ofstream::out);
  //			if (pathRecord1.is_open()) {
@@ -739,4 +706,4 @@
  }
  
  }
- 
\ No newline at end of file
+ 
@@ -34,9 +34,13 @@
 #include "ns3/exp-util.h"
 #include "ns3/statistic.h"
 #include "ns3/cppjson2structure.hh"
+#include "ns3/log_sink.h"
 
 namespace ns3 {
 
+static const uint32_t FLOW_LEVEL_PACKET_SIZE_BYTE = 1500;
+static const uint32_t FLOW_LEVEL_PAYLOAD_SIZE_BYTE = 1472;      // 1500 - 20 (IP) - 8 (UDP), as the applications send
+
 SAGApplicationSchedulerUdp::SAGApplicationSchedulerUdp(Ptr<BasicSimulation> basicSimulation, Ptr<TopologySatelliteNetwork> topology)
 :SAGApplicationScheduler(basicSimulation, topology)
 {
@@ -91,87 +95,185 @@ SAGApplicationSchedulerUdp::SAGApplicationSchedulerUdp(Ptr<BasicSimulation> basi
         printf("  > Removed previous SAG application log files if present\n");
         m_basicSimulation->RegisterTimestamp("Remove previous SAG application log files");
 
-        // Install sink on endpoint node
-        uint16_t my_port_num = 1026;
-        uint16_t dst_port_num = 1026;
-
-        std::cout << "  > Setting up applications on endpoint nodes" << std::endl;
-        for (SAGBurstInfoUdp entry : m_schedule) {
-        	int64_t src = entry.GetFromNodeId();
-        	int64_t dst = entry.GetToNodeId();
-        	std::string traceType = entry.GetMetadata();
-        	std::string codecType = entry.GetAdditionalParameters();
-
-        	if (!m_enable_distributed || m_distributed_node_system_id_assignment[src] == m_system_id){
-        		SAGApplicationHelperUdp sagApplicationHelperUdp(m_basicSimulation, codecType, traceType);
-                // Setup the application
-				ApplicationContainer app = sagApplicationHelperUdp.Install(m_nodes.Get(src));
-				app.Start(Seconds(0.0));
-				m_apps.push_back(app);
-
-				// Register all bursts being sent from there and being received
-				Ptr<SAGApplicationLayerUdp> sagApplicationLayerUdp = app.Get(0)->GetObject<SAGApplicationLayerUdp>();
-                sagApplicationLayerUdp->RegisterOutgoingBurst(
-                        entry,
-                        m_nodes.Get(entry.GetToNodeId()),
-						my_port_num,
-						dst_port_num,
-                        m_enable_logging_for_sag_application_ids.find(entry.GetBurstId()) != m_enable_logging_for_sag_application_ids.end()
-                );
-                m_responsible_for_outgoing_bursts.push_back(std::make_pair(entry, sagApplicationLayerUdp));
-
-				// must be both set in sinks and senders
-                sagApplicationLayerUdp->SetBasicSimuAttr(m_basicSimulation);
-                sagApplicationLayerUdp->SetSourceNode(m_nodes.Get(entry.GetFromNodeId()));
-                sagApplicationLayerUdp->SetDestinationNode(m_nodes.Get(entry.GetToNodeId()));
-        	}
-
-        	if (!m_enable_distributed || m_distributed_node_system_id_assignment[dst] == m_system_id){
-        		SAGApplicationHelperUdp sagApplicationHelperUdp(m_basicSimulation);
-				// Setup the application
-				ApplicationContainer app = sagApplicationHelperUdp.Install(m_nodes.Get(dst));
-				app.Start(Seconds(0.0));
-				m_apps.push_back(app);
-
-				// Register all bursts being sent from there and being received
-				Ptr<SAGApplicationLayerUdp> sagApplicationLayerUdp = app.Get(0)->GetObject<SAGApplicationLayerUdp>();
-				sagApplicationLayerUdp->RegisterIncomingBurst(
-					   entry,
-					   my_port_num,
-					   m_enable_logging_for_sag_application_ids.find(entry.GetBurstId()) != m_enable_logging_for_sag_application_ids.end()
-				);
-				m_responsible_for_incoming_bursts.push_back(std::make_pair(entry, sagApplicationLayerUdp));
-
-				// must be both set in sinks and senders
-                sagApplicationLayerUdp->SetBasicSimuAttr(m_basicSimulation);
-                sagApplicationLayerUdp->SetSourceNode(m_nodes.Get(entry.GetFromNodeId()));
-                sagApplicationLayerUdp->SetDestinationNode(m_nodes.Get(entry.GetToNodeId()));
-        	}
-        	else{
-				// Setup the virtual application, just for minimum hop routing
-        		SAGApplicationHelper sagApplicationHelper(m_basicSimulation);
-				ApplicationContainer app = sagApplicationHelper.Install(m_nodes.Get(dst));
-				Ptr<SAGApplicationLayer> sagApplicationLayer = app.Get(0)->GetObject<SAGApplicationLayer>();
-
-				// must be both set in sinks and senders
-				sagApplicationLayer->SetSourceNode(m_nodes.Get(entry.GetFromNodeId()));
-				sagApplicationLayer->SetDestinationNode(m_nodes.Get(entry.GetToNodeId()));
-
-        	}
-
-        	my_port_num++;
-        	dst_port_num++;
+        // Fluid mode for constant bit rate flows
+        m_enable_fluid_mode = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("udp_fluid_mode", "false"));
+        m_fluid_probe_fraction = parse_positive_double(m_basicSimulation->GetConfigParamOrDefault("udp_fluid_probe_fraction", "0.01"));
+        if (m_enable_fluid_mode) {
+            if (m_fluid_probe_fraction <= 0 || m_fluid_probe_fraction > 1) {
+                throw std::invalid_argument("udp_fluid_probe_fraction must be in (0, 1]");
+            }
+            printf("  > Constant bit rate flows are sent as fluid (probe fraction: %.4f)\n", m_fluid_probe_fraction);
+        }
 
+        // Flow-level mode: rates are allocated over the current paths at each topology tick instead of sending packets
+        std::string flow_level_mode = m_basicSimulation->GetConfigParamOrDefault("udp_flow_level_mode", "none");
+        if (flow_level_mode != "none") {
+            if (m_enable_distributed) {
+                throw std::invalid_argument("udp_flow_level_mode is not supported in distributed simulations");
+            }
+            if (m_enable_fluid_mode) {
+                throw std::invalid_argument("udp_flow_level_mode and udp_fluid_mode cannot be combined");
+            }
+            int64_t iterations = parse_geq_one_int64(m_basicSimulation->GetConfigParamOrDefault("udp_flow_level_iterations", "50"));
+            m_flow_level_solver.reset(new SAGFlowLevelSolver(SAGFlowLevelSolver::ParseFairness(flow_level_mode), iterations, FLOW_LEVEL_PACKET_SIZE_BYTE));
+            m_flow_level_records.resize(m_schedule.size());
+            for (SAGBurstInfoUdp entry : m_schedule) {
+                m_responsible_for_outgoing_bursts.push_back(std::make_pair(entry, Ptr<SAGApplicationLayerUdp>()));
+                m_responsible_for_incoming_bursts.push_back(std::make_pair(entry, Ptr<SAGApplicationLayerUdp>()));
+            }
+            m_topology->AddTopologyTickPhase("udp_flow_level", TOPOLOGY_TICK_FLOW, MakeCallback(&SAGApplicationSchedulerUdp::FlowLevelTick, this));
+            Simulator::Schedule(Seconds(0), &SAGApplicationSchedulerUdp::FlowLevelTick, this, 0.0);
+            printf("  > Flows are allocated %s rates at each topology tick, no packets are sent\n", flow_level_mode.c_str());
+            m_basicSimulation->RegisterTimestamp("Setup flow-level solver");
+
+        } else {
+
+            // Install sink on endpoint node
+            uint16_t my_port_num = 1026;
+            uint16_t dst_port_num = 1026;
+
+            std::cout << "  > Setting up applications on endpoint nodes" << std::endl;
+            for (SAGBurstInfoUdp entry : m_schedule) {
+            	int64_t src = entry.GetFromNodeId();
+            	int64_t dst = entry.GetToNodeId();
+            	std::string traceType = entry.GetMetadata();
+            	std::string codecType = entry.GetAdditionalParameters();
+
+            	if (!m_enable_distributed || m_distributed_node_system_id_assignment[src] == m_system_id){
+            		SAGApplicationHelperUdp sagApplicationHelperUdp(m_basicSimulation, codecType, traceType);
+                    // Setup the application
+    				ApplicationContainer app = sagApplicationHelperUdp.Install(m_nodes.Get(src));
+    				app.Start(Seconds(0.0));
+    				m_apps.push_back(app);
+
+    				// Register all bursts being sent from there and being received
+    				Ptr<SAGApplicationLayerUdp> sagApplicationLayerUdp = app.Get(0)->GetObject<SAGApplicationLayerUdp>();
+                    sagApplicationLayerUdp->RegisterOutgoingBurst(
+                            entry,
+                            m_nodes.Get(entry.GetToNodeId()),
+    						my_port_num,
+    						dst_port_num,
+                            m_enable_logging_for_sag_application_ids.find(entry.GetBurstId()) != m_enable_logging_for_sag_application_ids.end()
+                    );
+                    m_responsible_for_outgoing_bursts.push_back(std::make_pair(entry, sagApplicationLayerUdp));
+                    if (m_enable_fluid_mode && (codecType == "SYNCODEC_TYPE_PERFECT" || codecType == "SYNCODEC_TYPE_FIXFPS")) {
+                        sagApplicationLayerUdp->EnableFluidMode(m_fluid_probe_fraction);
+                    }
+
+    				// must be both set in sinks and senders
+                    sagApplicationLayerUdp->SetBasicSimuAttr(m_basicSimulation);
+                    sagApplicationLayerUdp->SetSourceNode(m_nodes.Get(entry.GetFromNodeId()));
+                    sagApplicationLayerUdp->SetDestinationNode(m_nodes.Get(entry.GetToNodeId()));
+            	}
+
+            	if (!m_enable_distributed || m_distributed_node_system_id_assignment[dst] == m_system_id){
+            		SAGApplicationHelperUdp sagApplicationHelperUdp(m_basicSimulation);
+    				// Setup the application
+    				ApplicationContainer app = sagApplicationHelperUdp.Install(m_nodes.Get(dst));
+    				app.Start(Seconds(0.0));
+    				m_apps.push_back(app);
+
+    				// Register all bursts being sent from there and being received
+    				Ptr<SAGApplicationLayerUdp> sagApplicationLayerUdp = app.Get(0)->GetObject<SAGApplicationLayerUdp>();
+    				sagApplicationLayerUdp->RegisterIncomingBurst(
+    					   entry,
+    					   my_port_num,
+    					   m_enable_logging_for_sag_application_ids.find(entry.GetBurstId()) != m_enable_logging_for_sag_application_ids.end()
+    				);
+    				m_responsible_for_incoming_bursts.push_back(std::make_pair(entry, sagApplicationLayerUdp));
+
+    				// must be both set in sinks and senders
+                    sagApplicationLayerUdp->SetBasicSimuAttr(m_basicSimulation);
+                    sagApplicationLayerUdp->SetSourceNode(m_nodes.Get(entry.GetFromNodeId()));
+                    sagApplicationLayerUdp->SetDestinationNode(m_nodes.Get(entry.GetToNodeId()));
+            	}
+            	else{
+    				// Setup the virtual application, just for minimum hop routing
+            		SAGApplicationHelper sagApplicationHelper(m_basicSimulation);
+    				ApplicationContainer app = sagApplicationHelper.Install(m_nodes.Get(dst));
+    				Ptr<SAGApplicationLayer> sagApplicationLayer = app.Get(0)->GetObject<SAGApplicationLayer>();
+
+    				// must be both set in sinks and senders
+    				sagApplicationLayer->SetSourceNode(m_nodes.Get(entry.GetFromNodeId()));
+    				sagApplicationLayer->SetDestinationNode(m_nodes.Get(entry.GetToNodeId()));
+
+            	}
+
+            	my_port_num++;
+            	dst_port_num++;
 
-        }
 
-        m_basicSimulation->RegisterTimestamp("Setup applications on endpoint nodes");
+            }
+
+            m_basicSimulation->RegisterTimestamp("Setup applications on endpoint nodes");
+
+        }
 
     }
 
     std::cout << std::endl;
 }
 
+void SAGApplicationSchedulerUdp::FlowLevelTick(double timeNs)
+{
+    int64_t now_ns = (int64_t) timeNs;
+    int64_t next_ns = std::min(now_ns + m_topology->GetTopologyTickIntervalNs(), m_simulation_end_time_ns);
+
+    // Flows active at some point before the next tick
+    std::vector<SAGFlowLevelSolver::Flow> flows;
+    std::vector<int64_t> burst_ids;
+    for (const SAGBurstInfoUdp& entry : m_schedule) {
+        if (entry.GetStartTimeNs() < next_ns && entry.GetStartTimeNs() + entry.GetDurationNs() > now_ns) {
+            flows.push_back({(uint32_t) entry.GetFromNodeId(), (uint32_t) entry.GetToNodeId(), entry.GetTargetRateMegabitPerSec() * 1e6});
+            burst_ids.push_back(entry.GetBurstId());
+        }
+    }
+    if (flows.empty()) {
+        return;
+    }
+
+    std::vector<SAGFlowLevelSolver::Allocation> allocations = m_flow_level_solver->Solve(
+            m_topology->GetCurrentLinks(), flows, m_topology->GetNumSatellites()
+    );
+    for (size_t i = 0; i < flows.size(); i++) {
+        const SAGBurstInfoUdp& info = m_schedule[burst_ids[i]];
+        FlowLevelRecord& record = m_flow_level_records[burst_ids[i]];
+        int64_t from_ns = std::max(now_ns, info.GetStartTimeNs());
+        int64_t to_ns = std::min(next_ns, info.GetStartTimeNs() + info.GetDurationNs());
+
+        // Samples as the receiver of a logged flow would take them
+        if (!allocations[i].m_path.empty()
+                && m_enable_logging_for_sag_application_ids.find(info.GetBurstId()) != m_enable_logging_for_sag_application_ids.end()) {
+            int64_t timestamp_us = from_ns / 1000;
+            if (record.routes.empty() || record.routes.back() != allocations[i].m_path) {
+                record.routes.push_back(allocations[i].m_path);
+                record.route_timestamps_us.push_back(timestamp_us);
+            }
+            record.timestamps_us.push_back(timestamp_us);
+            record.delays_us.push_back(allocations[i].m_delayNs / 1e3);
+            record.received_bytes_log.push_back((uint64_t) record.received_bytes);
+        }
+
+        record.sent_bytes += flows[i].m_demandBps / 8 * nanosec_to_sec(to_ns - from_ns);
+        record.received_bytes += allocations[i].m_rateBps / 8 * nanosec_to_sec(to_ns - from_ns);
+    }
+}
+
+void SAGApplicationSchedulerUdp::GetCounters(const SAGBurstInfoUdp& info, Ptr<SAGApplicationLayerUdp> app, bool outgoing, uint64_t& packets, uint64_t& bytes)
+{
+    if (m_flow_level_solver) {
+        const FlowLevelRecord& record = m_flow_level_records[info.GetBurstId()];
+        bytes = (uint64_t) (outgoing ? record.sent_bytes : record.received_bytes);
+        packets = (bytes + FLOW_LEVEL_PAYLOAD_SIZE_BYTE - 1) / FLOW_LEVEL_PAYLOAD_SIZE_BYTE;
+    } else if (outgoing) {
+        packets = app->GetSentCounterOf(info.GetBurstId());
+        bytes = app->GetSentCounterSizeOf(info.GetBurstId());
+    } else {
+        packets = app->GetReceivedCounterOf(info.GetBurstId());
+        bytes = app->GetReceivedCounterSizeOf(info.GetBurstId());
+    }
+}
+
 void SAGApplicationSchedulerUdp::WriteResults() 
 {
     std::cout << "STORE SAG APPLICATION RESULTS" << std::endl;
@@ -231,11 +333,36 @@ void SAGApplicationSchedulerUdp::WriteResults()
     		//mkdir_force_if_not_exists(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/udp_" + std::to_string(info.GetBurstId()));
 
             // Flow Details
-            const std::vector<std::vector<uint32_t>> routes = sagApplicationUdpIncoming->GetRecordRouteDetailsLog();
+            std::vector<std::vector<uint32_t>> routes;
+            std::vector<int64_t> route_timestamp;
+            std::vector<int64_t> record_timestamp;
+            std::vector<double> pkt_delay;
+            std::vector<uint64_t> pkt_size;
+            double max_delay_us = 0;
+            double min_delay_us = 0;
+            if (m_flow_level_solver) {
+                const FlowLevelRecord& record = m_flow_level_records[info.GetBurstId()];
+                routes = record.routes;
+                route_timestamp = record.route_timestamps_us;
+                record_timestamp = record.timestamps_us;
+                pkt_delay = record.delays_us;
+                pkt_size = record.received_bytes_log;
+                if (!pkt_delay.empty()) {
+                    max_delay_us = *std::max_element(pkt_delay.begin(), pkt_delay.end());
+                    min_delay_us = *std::min_element(pkt_delay.begin(), pkt_delay.end());
+                }
+            } else {
+                routes = sagApplicationUdpIncoming->GetRecordRouteDetailsLog();
+                route_timestamp = sagApplicationUdpIncoming->GetRecordRouteDetailsTimeStampLogUs();
+                record_timestamp = sagApplicationUdpIncoming->GetRecordTimeStampLogUs();
+                pkt_delay = sagApplicationUdpIncoming->GetRecordDelaymsDetailsTimeStampLogUs();
+                pkt_size = sagApplicationUdpIncoming->GetRecordPktSizeBytes();
+                max_delay_us = sagApplicationUdpIncoming->GetMaxDelayUs();
+                min_delay_us = sagApplicationUdpIncoming->GetMinDelayUs();
+            }
             if(routes.size() == 0){
             	continue;
             }
-            const std::vector<int64_t> route_timestamp =  sagApplicationUdpIncoming->GetRecordRouteDetailsTimeStampLogUs();
             uint32_t path_change_number = routes.size() - 1;
             std::vector<uint32_t> path_hop_count;
             for(auto path: routes){
@@ -245,10 +372,6 @@ void SAGApplicationSchedulerUdp::WriteResults()
             auto min_it = std::min_element(path_hop_count.begin(), path_hop_count.end());
             uint32_t path_hop_count_maxdif = *max_it - *min_it;
 
-            const std::vector<int64_t> record_timestamp =  sagApplicationUdpIncoming->GetRecordTimeStampLogUs();
-            const std::vector<double> pkt_delay =  sagApplicationUdpIncoming->GetRecordDelaymsDetailsTimeStampLogUs();
-            const std::vector<uint64_t> pkt_size = sagApplicationUdpIncoming->GetRecordPktSizeBytes();
-            
             double average_delay;
             if (pkt_delay.empty()) {
 				average_delay = 0.0;
@@ -278,45 +401,25 @@ void SAGApplicationSchedulerUdp::WriteResults()
             jsonPathObject["path_change_times"] = path_change_number;
             jsonPathObject["path_hop_count"] = path_hop_count;
             jsonPathObject["path_hop_count_timestamp_us"] = route_timestamp;
+            jsonPathObject["path_node_ids"] = routes;
             jsonObject["path_info"] = jsonPathObject;
 
-			std::ofstream pathRecord(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/udp_" + std::to_string(info.GetBurstId())+"/udp_" + std::to_string(info.GetBurstId())+"_path_log.json", std::ofstream::out);
-			if (pathRecord.is_open()) {
-				pathRecord << jsonObject.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathRecord.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/udp_" + std::to_string(info.GetBurstId())+"/udp_" + std::to_string(info.GetBurstId())+"_path_log.json", jsonObject.dump(4));
 
 			nlohmann::ordered_json jsonObject1;
 			jsonObject1["name"] = "udp_" + std::to_string(info.GetBurstId());
             jsonObject1["average_delay_ms"] = average_delay;
 			jsonObject1["delay_sample_us"] = pkt_delay;
 			jsonObject1["time_stamp_us"] = record_timestamp;
-			jsonObject1["max_delay_us"] = sagApplicationUdpIncoming->GetMaxDelayUs();
-			jsonObject1["min_delay_us"] = sagApplicationUdpIncoming->GetMinDelayUs();
-			std::ofstream pathRecord1(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/udp_" + std::to_string(info.GetBurstId())+"/udp_" + std::to_string(info.GetBurstId())+"_delay_log.json", std::ofstream::out);
-			if (pathRecord1.is_open()) {
-				pathRecord1 << jsonObject1.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathRecord1.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			jsonObject1["max_delay_us"] = max_delay_us;
+			jsonObject1["min_delay_us"] = min_delay_us;
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/udp_" + std::to_string(info.GetBurstId())+"/udp_" + std::to_string(info.GetBurstId())+"_delay_log.json", jsonObject1.dump(4));
 
 			nlohmann::ordered_json jsonObject2;
 			jsonObject2["name"] = "udp_" + std::to_string(info.GetBurstId());
 			jsonObject2["flow_rate_mbps"] = flow_rate;
 			jsonObject2["time_stamp_us"] = record_timestamp;
-			std::ofstream pathRecord2(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/udp_" + std::to_string(info.GetBurstId())+"/udp_" + std::to_string(info.GetBurstId())+"_flow_rate_log.json", std::ofstream::out);
-			if (pathRecord2.is_open()) {
-				pathRecord2 << jsonObject2.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathRecord2.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/udp_" + std::to_string(info.GetBurstId())+"/udp_" + std::to_string(info.GetBurstId())+"_flow_rate_log.json", jsonObject2.dump(4));
 
 			// Route Record
 			nlohmann::ordered_json path_change;
@@ -402,14 +505,7 @@ void SAGApplicationSchedulerUdp::WriteResults()
 				path_change.push_back(jsonContent);
 			}
 
-			std::ofstream pathCzml(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/udp_" + std::to_string(info.GetBurstId())+"/udp_" + std::to_string(info.GetBurstId())+"_czml.json", std::ofstream::out);
-			if (pathCzml.is_open()) {
-				pathCzml << path_change.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				pathCzml.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/results/network_results/object_statistics/udp_" + std::to_string(info.GetBurstId())+"/udp_" + std::to_string(info.GetBurstId())+"_czml.json", path_change.dump(4));
         }
 
 
@@ -423,8 +519,9 @@ void SAGApplicationSchedulerUdp::WriteResults()
             // Fetch data from the application
             //uint32_t complete_packet_size = 1500;
             //uint32_t max_payload_size_byte = sagApplicationUdpOutgoing->GetMaxPayloadSizeByte();
-            uint64_t sent_counter = sagApplicationUdpOutgoing->GetSentCounterOf(info.GetBurstId());
-            uint64_t sent_counter_size = sagApplicationUdpOutgoing->GetSentCounterSizeOf(info.GetBurstId());
+            uint64_t sent_counter;
+            uint64_t sent_counter_size;
+            GetCounters(info, sagApplicationUdpOutgoing, true, sent_counter, sent_counter_size);
 
             // Calculate outgoing rate
             int64_t effective_duration_ns = info.GetStartTimeNs() + info.GetDurationNs() >= m_simulation_end_time_ns ? m_simulation_end_time_ns - info.GetStartTimeNs() : info.GetDurationNs();
@@ -490,14 +587,7 @@ void SAGApplicationSchedulerUdp::WriteResults()
             jsonUdpOutgoing.push_back(jsonObject);
 
         }
-		std::ofstream udpOutgoingRecord(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_udp_flows_outgoing.json", std::ofstream::out);
-		if (udpOutgoingRecord.is_open()) {
-			udpOutgoingRecord << jsonUdpOutgoing.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-			udpOutgoingRecord.close();
-			//std::cout << "JSON file created successfully." << std::endl;
-		} else {
-			std::cout << "Failed to create JSON file." << std::endl;
-		}
+		LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_udp_flows_outgoing.json", jsonUdpOutgoing.dump(4));
 
         // Incoming bursts
         std::cout << "  > Writing incoming log files" << std::endl;
@@ -509,8 +599,9 @@ void SAGApplicationSchedulerUdp::WriteResults()
             // Fetch data from the application
             //uint32_t complete_packet_size = 1500;
             //uint32_t max_payload_size_byte = sagApplicationUdpIncoming->GetMaxPayloadSizeByte();
-            uint64_t received_counter = sagApplicationUdpIncoming->GetReceivedCounterOf(info.GetBurstId());
-            uint64_t received_counter_size = sagApplicationUdpIncoming->GetReceivedCounterSizeOf(info.GetBurstId());
+            uint64_t received_counter;
+            uint64_t received_counter_size;
+            GetCounters(info, sagApplicationUdpIncoming, false, received_counter, received_counter_size);
 
 
             // Calculate incoming rate
@@ -577,14 +668,7 @@ void SAGApplicationSchedulerUdp::WriteResults()
             jsonUdpIncoming.push_back(jsonObject);
 
         }
-		std::ofstream udpIncomingRecord(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_udp_flows_incoming.json", std::ofstream::out);
-		if (udpIncomingRecord.is_open()) {
-			udpIncomingRecord << jsonUdpIncoming.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-			udpIncomingRecord.close();
-			//std::cout << "JSON file created successfully." << std::endl;
-		} else {
-			std::cout << "Failed to create JSON file." << std::endl;
-		}
+		LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_udp_flows_incoming.json", jsonUdpIncoming.dump(4));
 
         // Close files
         std::cout << "  > Closing SAG application log files:" << std::endl;
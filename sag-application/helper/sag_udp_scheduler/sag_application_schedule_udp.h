@@ -23,6 +23,8 @@
 #include "ns3/sag_application_schedule.h"
 #include "ns3/sag_application_layer_udp.h"
 #include "ns3/topology-satellite-network.h"
+#include "ns3/sag_flow_level_solver.h"
+#include <memory>
 
 
 namespace ns3 {
@@ -38,11 +40,36 @@ protected:
     std::vector<SAGBurstInfoUdp> m_schedule;
 
 private:
+    /**
+     * What the flow-level mode knows of a flow, in place of its sender and receiver applications
+     */
+    struct FlowLevelRecord {
+        double sent_bytes;
+        double received_bytes;
+        std::vector<std::vector<uint32_t>> routes;
+        std::vector<int64_t> route_timestamps_us;
+        std::vector<int64_t> timestamps_us;
+        std::vector<double> delays_us;
+        std::vector<uint64_t> received_bytes_log;
+    };
+
+    /**
+     * Allocate the rates of the active flows over the current paths, they hold until the next tick
+     */
+    void FlowLevelTick(double timeNs);
+    void GetCounters(const SAGBurstInfoUdp& info, Ptr<SAGApplicationLayerUdp> app, bool outgoing, uint64_t& packets, uint64_t& bytes);
+
     std::string m_sag_bursts_outgoing_csv_filename;
     std::string m_sag_bursts_outgoing_txt_filename;
     std::string m_sag_bursts_incoming_csv_filename;
     std::string m_sag_bursts_incoming_txt_filename;
 
+    bool m_enable_fluid_mode;           //!< Constant bit rate flows are sent as fluid with probes
+    double m_fluid_probe_fraction;      //!< Share of their datagrams sent as real packets
+
+    std::unique_ptr<SAGFlowLevelSolver> m_flow_level_solver;   //!< Set if flows are allocated rates instead of sending packets
+    std::vector<FlowLevelRecord> m_flow_level_records;         //!< Indexed by burst ID
+
     std::vector<std::pair<SAGBurstInfoUdp, Ptr<SAGApplicationLayerUdp>>> m_responsible_for_outgoing_bursts;
     std::vector<std::pair<SAGBurstInfoUdp, Ptr<SAGApplicationLayerUdp>>> m_responsible_for_incoming_bursts;
 
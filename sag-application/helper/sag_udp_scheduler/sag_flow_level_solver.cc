@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "sag_flow_level_solver.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+namespace ns3 {
+
+	static const double FLOW_LEVEL_EPSILON = 1e-9;
+	static const double PRICE_STEP = 0.5;				// exponent of the multiplicative price update
+	static const double PRICE_FLOOR_FACTOR = 1e-3;		// price never drops below this share of 1 / capacity
+
+	SAGFlowLevelSolver::SAGFlowLevelSolver (Fairness fairness, uint32_t iterations, uint32_t packetSizeBytes)
+		: m_fairness(fairness),
+		  m_iterations(iterations),
+		  m_packetSizeBytes(packetSizeBytes){
+
+		if(iterations == 0){
+			throw std::invalid_argument("Flow-level solver needs at least one iteration");
+		}
+	}
+
+	SAGFlowLevelSolver::~SAGFlowLevelSolver (){
+
+	}
+
+	SAGFlowLevelSolver::Fairness
+	SAGFlowLevelSolver::ParseFairness(std::string name){
+		if(name == "max_min"){
+			return MAX_MIN;
+		}
+		else if(name == "proportional_fair"){
+			return PROPORTIONAL_FAIR;
+		}
+		throw std::invalid_argument("Unknown flow-level fairness: " + name);
+	}
+
+	std::vector<SAGFlowLevelSolver::Allocation>
+	SAGFlowLevelSolver::Solve(const std::vector<TopologyLink>& links, const std::vector<Flow>& flows, uint32_t numSatellites){
+
+		std::vector<std::vector<uint32_t>> paths = Route(links, flows, numSatellites);
+
+		// one resource per transmitting device
+		std::map<Ptr<NetDevice>, uint32_t> resourceOf;
+		std::vector<Ptr<NetDevice>> devices;
+		std::vector<double> capacities;
+		std::vector<std::vector<uint32_t>> resources(flows.size());
+		for(uint32_t f = 0; f < flows.size(); f++){
+			for(uint32_t l : paths[f]){
+				auto it = resourceOf.find(links[l].m_device);
+				if(it == resourceOf.end()){
+					it = resourceOf.insert(std::make_pair(links[l].m_device, devices.size())).first;
+					devices.push_back(links[l].m_device);
+					capacities.push_back(links[l].m_capacityBps);
+				}
+				resources[f].push_back(it->second);
+			}
+		}
+
+		std::vector<double> rates(flows.size(), 0);
+		if(m_fairness == MAX_MIN){
+			AllocateMaxMin(capacities, resources, flows, rates);
+		}
+		else{
+			std::vector<double> prices(devices.size(), 0);
+			for(uint32_t r = 0; r < devices.size(); r++){
+				auto it = m_prices.find(devices[r]);
+				if(it != m_prices.end()){
+					prices[r] = it->second;
+				}
+			}
+			AllocateProportionalFair(capacities, resources, flows, prices, rates);
+			m_prices.clear();
+			for(uint32_t r = 0; r < devices.size(); r++){
+				m_prices[devices[r]] = prices[r];
+			}
+		}
+
+		std::vector<Allocation> allocations(flows.size());
+		for(uint32_t f = 0; f < flows.size(); f++){
+			Allocation& allocation = allocations[f];
+			allocation.m_rateBps = rates[f];
+			allocation.m_delayNs = 0;
+			if(paths[f].empty()){
+				continue;
+			}
+			allocation.m_path.push_back(flows[f].m_from);
+			for(uint32_t l : paths[f]){
+				allocation.m_path.push_back(links[l].m_to);
+				allocation.m_delayNs += links[l].m_delayNs;
+				if(links[l].m_capacityBps > 0){
+					allocation.m_delayNs += m_packetSizeBytes * 8.0 / links[l].m_capacityBps * 1e9;
+				}
+			}
+		}
+		return allocations;
+	}
+
+	std::vector<std::vector<uint32_t>>
+	SAGFlowLevelSolver::Route(const std::vector<TopologyLink>& links, const std::vector<Flow>& flows, uint32_t numSatellites){
+
+		uint32_t nNodes = 0;
+		for(const TopologyLink& link : links){
+			nNodes = std::max(nNodes, std::max(link.m_from, link.m_to) + 1);
+		}
+		std::vector<std::vector<uint32_t>> outgoing(nNodes);
+		for(uint32_t l = 0; l < links.size(); l++){
+			outgoing[links[l].m_from].push_back(l);
+		}
+
+		// flows of the same source share one shortest path tree
+		std::map<uint32_t, std::vector<uint32_t>> flowsOf;
+		for(uint32_t f = 0; f < flows.size(); f++){
+			flowsOf[flows[f].m_from].push_back(f);
+		}
+
+		std::vector<std::vector<uint32_t>> paths(flows.size());
+		std::vector<double> distance(nNodes);
+		std::vector<int64_t> via(nNodes);
+		typedef std::pair<double, uint32_t> QueueEntry;
+		for(auto& entry : flowsOf){
+			uint32_t src = entry.first;
+			if(src >= nNodes){
+				continue;
+			}
+			std::fill(distance.begin(), distance.end(), std::numeric_limits<double>::infinity());
+			std::fill(via.begin(), via.end(), -1);
+			std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+			distance[src] = 0;
+			queue.push(std::make_pair(0.0, src));
+			while(!queue.empty()){
+				QueueEntry top = queue.top();
+				queue.pop();
+				uint32_t u = top.second;
+				if(top.first > distance[u] || (u != src && u >= numSatellites)){
+					continue;
+				}
+				for(uint32_t l : outgoing[u]){
+					uint32_t v = links[l].m_to;
+					double d = distance[u] + links[l].m_delayNs;
+					if(d < distance[v]){
+						distance[v] = d;
+						via[v] = l;
+						queue.push(std::make_pair(d, v));
+					}
+				}
+			}
+
+			for(uint32_t f : entry.second){
+				uint32_t dst = flows[f].m_to;
+				if(dst >= nNodes || dst == src || via[dst] < 0){
+					continue;
+				}
+				for(uint32_t v = dst; v != src; v = links[via[v]].m_from){
+					paths[f].push_back(via[v]);
+				}
+				std::reverse(paths[f].begin(), paths[f].end());
+			}
+		}
+		return paths;
+	}
+
+	void
+	SAGFlowLevelSolver::AllocateMaxMin(const std::vector<double>& capacities, const std::vector<std::vector<uint32_t>>& resources,
+			const std::vector<Flow>& flows, std::vector<double>& rates){
+
+		std::vector<double> remaining = capacities;
+		std::vector<uint32_t> users(capacities.size(), 0);
+		std::vector<uint32_t> active;
+		for(uint32_t f = 0; f < flows.size(); f++){
+			if(resources[f].empty() || flows[f].m_demandBps <= 0){
+				continue;
+			}
+			active.push_back(f);
+			for(uint32_t r : resources[f]){
+				users[r]++;
+			}
+		}
+
+		// progressive filling: raise all unfrozen flows together until a link saturates or a demand is met
+		while(!active.empty()){
+			double increment = std::numeric_limits<double>::infinity();
+			for(uint32_t r = 0; r < remaining.size(); r++){
+				if(users[r] > 0){
+					increment = std::min(increment, remaining[r] / users[r]);
+				}
+			}
+			for(uint32_t f : active){
+				increment = std::min(increment, flows[f].m_demandBps - rates[f]);
+			}
+			increment = std::max(increment, 0.0);
+
+			for(uint32_t f : active){
+				rates[f] += increment;
+				for(uint32_t r : resources[f]){
+					remaining[r] -= increment;
+				}
+			}
+
+			uint32_t n = 0;
+			for(uint32_t f : active){
+				bool frozen = rates[f] >= flows[f].m_demandBps * (1 - FLOW_LEVEL_EPSILON);
+				for(uint32_t r : resources[f]){
+					frozen = frozen || remaining[r] <= capacities[r] * FLOW_LEVEL_EPSILON;
+				}
+				if(frozen){
+					for(uint32_t r : resources[f]){
+						users[r]--;
+					}
+				}
+				else{
+					active[n++] = f;
+				}
+			}
+			active.resize(n);
+		}
+	}
+
+	void
+	SAGFlowLevelSolver::AllocateProportionalFair(const std::vector<double>& capacities, const std::vector<std::vector<uint32_t>>& resources,
+			const std::vector<Flow>& flows, std::vector<double>& prices, std::vector<double>& rates){
+
+		std::vector<uint32_t> users(capacities.size(), 0);
+		std::vector<uint32_t> active;
+		for(uint32_t f = 0; f < flows.size(); f++){
+			if(resources[f].empty() || flows[f].m_demandBps <= 0){
+				continue;
+			}
+			bool blocked = false;
+			for(uint32_t r : resources[f]){
+				blocked = blocked || capacities[r] <= 0;
+			}
+			if(blocked){
+				continue;
+			}
+			active.push_back(f);
+			for(uint32_t r : resources[f]){
+				users[r]++;
+			}
+		}
+		for(uint32_t r = 0; r < capacities.size(); r++){
+			if(prices[r] <= 0 && users[r] > 0){
+				prices[r] = users[r] / capacities[r];
+			}
+		}
+
+		// each flow maximizes log(rate) - rate * path price, prices follow the load of their link
+		std::vector<double> load(capacities.size());
+		for(uint32_t it = 0; it <= m_iterations; it++){
+			std::fill(load.begin(), load.end(), 0);
+			for(uint32_t f : active){
+				double pathPrice = 0;
+				for(uint32_t r : resources[f]){
+					pathPrice += prices[r];
+				}
+				rates[f] = pathPrice > 0 ? std::min(flows[f].m_demandBps, 1 / pathPrice) : flows[f].m_demandBps;
+				for(uint32_t r : resources[f]){
+					load[r] += rates[f];
+				}
+			}
+			if(it == m_iterations){
+				break;
+			}
+			for(uint32_t r = 0; r < capacities.size(); r++){
+				if(users[r] == 0){
+					continue;
+				}
+				double ratio = std::min(std::max(load[r] / capacities[r], 0.5), 2.0);
+				prices[r] = std::max(prices[r] * std::pow(ratio, PRICE_STEP), PRICE_FLOOR_FACTOR / capacities[r]);
+			}
+		}
+
+		// the iteration stops before convergence, scale the flows of overloaded links back to capacity
+		for(uint32_t f : active){
+			double scale = 1;
+			for(uint32_t r : resources[f]){
+				if(load[r] > capacities[r]){
+					scale = std::min(scale, capacities[r] / load[r]);
+				}
+			}
+			rates[f] *= scale;
+		}
+	}
+
+}
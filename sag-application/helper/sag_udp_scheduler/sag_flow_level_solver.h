@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef SAG_FLOW_LEVEL_SOLVER_H
+#define SAG_FLOW_LEVEL_SOLVER_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/topology-satellite-network.h"
+
+namespace ns3 {
+
+/**
+ * \brief Rate allocation of flows over the links of one topology tick
+ *
+ * Flows follow the minimum propagation delay path, ground stations only
+ * being used as endpoints. The links of a device share its capacity. Rates
+ * are max-min fair (progressive filling) or proportionally fair (dual price
+ * iteration), and never exceed the demand of a flow.
+ */
+class SAGFlowLevelSolver
+{
+public:
+	enum Fairness
+	{
+		MAX_MIN,
+		PROPORTIONAL_FAIR
+	};
+
+	struct Flow {
+		uint32_t m_from;
+		uint32_t m_to;
+		double m_demandBps;
+	};
+
+	struct Allocation {
+		double m_rateBps;				//!< Zero if no path
+		std::vector<uint32_t> m_path;	//!< Nodes from source to destination, empty if no path
+		double m_delayNs;				//!< Propagation and transmission delay of a full packet
+	};
+
+	SAGFlowLevelSolver (Fairness fairness, uint32_t iterations, uint32_t packetSizeBytes);
+	virtual ~SAGFlowLevelSolver ();
+
+	static Fairness ParseFairness(std::string name);
+
+	/**
+	 * \param numSatellites	Nodes [0, numSatellites) are the satellites, the only nodes forwarding traffic
+	 */
+	std::vector<Allocation> Solve(const std::vector<TopologyLink>& links, const std::vector<Flow>& flows, uint32_t numSatellites);
+
+private:
+	/**
+	 * \brief Links of the shortest delay path of every flow, empty if unreachable
+	 */
+	std::vector<std::vector<uint32_t>> Route(const std::vector<TopologyLink>& links, const std::vector<Flow>& flows, uint32_t numSatellites);
+
+	void AllocateMaxMin(const std::vector<double>& capacities, const std::vector<std::vector<uint32_t>>& resources,
+			const std::vector<Flow>& flows, std::vector<double>& rates);
+	void AllocateProportionalFair(const std::vector<double>& capacities, const std::vector<std::vector<uint32_t>>& resources,
+			const std::vector<Flow>& flows, std::vector<double>& prices, std::vector<double>& rates);
+
+	Fairness m_fairness;
+	uint32_t m_iterations;				//!< Price updates of the proportional fair allocation
+	uint32_t m_packetSizeBytes;
+	std::map<Ptr<NetDevice>, double> m_prices;	//!< Link prices of the last tick, where the next iteration starts
+};
+
+}
+
+#endif /* SAG_FLOW_LEVEL_SOLVER_H */
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "fluid_rate_tag.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FluidRateTag");
+
+NS_OBJECT_ENSURE_REGISTERED (FluidRateTag);
+
+TypeId
+FluidRateTag::GetTypeId (void)
+{
+    static TypeId tid = TypeId ("ns3::FluidRateTag")
+            .SetParent<Tag> ()
+            .SetGroupName("BasicSim")
+            .AddConstructor<FluidRateTag> ()
+    ;
+    return tid;
+}
+
+FluidRateTag::FluidRateTag ()
+  : m_flowId (0),
+    m_rateBps (0),
+    m_validUntilNs (0),
+    m_packets (0),
+    m_bytes (0),
+    m_deliveredFraction (1.0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FluidRateTag::FluidRateTag (uint64_t flowId, uint64_t rateBps, int64_t validUntilNs, uint32_t packets, uint64_t bytes)
+  : m_flowId (flowId),
+    m_rateBps (rateBps),
+    m_validUntilNs (validUntilNs),
+    m_packets (packets),
+    m_bytes (bytes),
+    m_deliveredFraction (1.0)
+{
+  NS_LOG_FUNCTION (this << flowId << rateBps << validUntilNs);
+}
+
+uint64_t
+FluidRateTag::GetFlowId (void) const
+{
+  return m_flowId;
+}
+
+uint64_t
+FluidRateTag::GetRateBps (void) const
+{
+  return m_rateBps;
+}
+
+int64_t
+FluidRateTag::GetValidUntilNs (void) const
+{
+  return m_validUntilNs;
+}
+
+uint32_t
+FluidRateTag::GetPackets (void) const
+{
+  return m_packets;
+}
+
+uint64_t
+FluidRateTag::GetBytes (void) const
+{
+  return m_bytes;
+}
+
+void
+FluidRateTag::SetDeliveredFraction (double fraction)
+{
+  NS_LOG_FUNCTION (this << fraction);
+  m_deliveredFraction = fraction;
+}
+
+double
+FluidRateTag::GetDeliveredFraction (void) const
+{
+  return m_deliveredFraction;
+}
+
+TypeId
+FluidRateTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+FluidRateTag::Print (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  os << "(flow=" << m_flowId << ", rate=" << m_rateBps << "bps, until=" << m_validUntilNs
+     << "ns, packets=" << m_packets << ", delivered=" << m_deliveredFraction << ")";
+}
+
+uint32_t
+FluidRateTag::GetSerializedSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return 8+8+8+4+8+8;
+}
+
+void
+FluidRateTag::Serialize (TagBuffer start) const
+{
+  NS_LOG_FUNCTION (this << &start);
+  start.WriteU64 (m_flowId);
+  start.WriteU64 (m_rateBps);
+  start.WriteU64 (m_validUntilNs);
+  start.WriteU32 (m_packets);
+  start.WriteU64 (m_bytes);
+  start.WriteDouble (m_deliveredFraction);
+}
+
+void
+FluidRateTag::Deserialize (TagBuffer start)
+{
+  NS_LOG_FUNCTION (this << &start);
+  m_flowId = start.ReadU64 ();
+  m_rateBps = start.ReadU64 ();
+  m_validUntilNs = start.ReadU64 ();
+  m_packets = start.ReadU32 ();
+  m_bytes = start.ReadU64 ();
+  m_deliveredFraction = start.ReadDouble ();
+}
+
+} // namespace ns3
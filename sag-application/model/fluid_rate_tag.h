@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef FLUID_RATE_TAG_H
+#define FLUID_RATE_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \brief Carried by the probes of a fluid flow
+ *
+ * A probe stands for the datagrams of its flow sent until the next probe.
+ * Every link layer on the way registers the fluid rate until the validity
+ * ends and scales the delivered fraction down when the fluid overflows its
+ * queue, so the receiver counts what the fluid would have delivered.
+ */
+class FluidRateTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void);
+
+  FluidRateTag ();
+  FluidRateTag (uint64_t flowId, uint64_t rateBps, int64_t validUntilNs, uint32_t packets, uint64_t bytes);
+  uint64_t GetFlowId (void) const;
+  uint64_t GetRateBps (void) const;
+  int64_t GetValidUntilNs (void) const;
+  uint32_t GetPackets (void) const;
+  uint64_t GetBytes (void) const;
+  void SetDeliveredFraction (double fraction);
+  double GetDeliveredFraction (void) const;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer start) const;
+  virtual void Deserialize (TagBuffer start);
+
+private:
+  uint64_t m_flowId;            //!< Burst the fluid belongs to
+  uint64_t m_rateBps;           //!< Fluid rate, without the probes
+  int64_t m_validUntilNs;       //!< Absolute time the rate holds until unless refreshed
+  uint32_t m_packets;           //!< Datagrams the probe stands for
+  uint64_t m_bytes;             //!< Payload bytes the probe stands for
+  double m_deliveredFraction;   //!< Share of the fluid not dropped so far
+};
+
+} // namespace ns3
+
+#endif /* FLUID_RATE_TAG_H */
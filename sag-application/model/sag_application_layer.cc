@@ -33,6 +33,7 @@
 #include "ns3/abort.h"
 #include "ns3/route_trace_tag.h"
 #include "ns3/delay_trace_tag.h"
+#include "ns3/random-variable-stream.h"
 
 
 namespace ns3 {
@@ -66,7 +67,17 @@ SAGApplicationLayer::GetTypeId(void)
 			.AddAttribute("MaxPayloadSizeByte", "Total  payload size (byte) before it gets fragmented.",
 							UintegerValue(1472), // 1500 (point-to-point default) - 20 (IP) - 8 (UDP) = 1472
 							MakeUintegerAccessor(&SAGApplicationLayer::m_max_payload_size_byte),
-							MakeUintegerChecker<uint32_t>());
+							MakeUintegerChecker<uint32_t>())
+			.AddAttribute("SendBatchWindow",
+						  "Senders hand the packets due within this time to the socket in a single call, 0 batches only packets due at the same time.",
+						  TimeValue(Seconds(0)),
+						  MakeTimeAccessor(&SAGApplicationLayer::m_sendBatchWindow),
+						  MakeTimeChecker())
+			.AddAttribute("RandomTraceStart",
+						  "Trace-based codecs start at a random frame of their video traces instead of the first one.",
+						  BooleanValue(false),
+						  MakeBooleanAccessor(&SAGApplicationLayer::m_randomTraceStart),
+						  MakeBooleanChecker());
     return tid;
 }
 
@@ -74,7 +85,8 @@ SAGApplicationLayer::SAGApplicationLayer()
     :m_socket(0),
     m_isIPv4Networking(false),
     m_isIPv6Networking(false),
-	m_fps{30.}
+	m_fps{30.},
+	m_randomTraceStart(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -335,6 +347,9 @@ SAGApplicationLayer::SetCodecType (SyncodecType codecType)
 
         	m_fps = SYNCODEC_DEFAULT_FPS;
             auto innerCodec = new syncodecs::TraceBasedCodec(m_traceDir, m_filePrefix, m_fps);
+            if (m_randomTraceStart) {
+                innerCodec->setStartPosition(CreateObject<UniformRandomVariable>()->GetValue(0, 1));
+            }
             codec = new syncodecs::ShapedPacketizer{innerCodec, m_max_payload_size_byte};
             break;
         }
@@ -372,6 +387,9 @@ SAGApplicationLayer::SetCodecType (SyncodecType codecType)
                                     m_filePrefix,      // video filename
                                     SYNCODEC_DEFAULT_FPS,             // Default FPS: 30fps
                                     true};           // fixed mode: image resolution doesn't change
+            if (m_randomTraceStart) {
+                innerCodec->setStartPosition(CreateObject<UniformRandomVariable>()->GetValue(0, 1));
+            }
 	        m_fps = SYNCODEC_DEFAULT_FPS;
             codec = new syncodecs::ShapedPacketizer{innerCodec, m_max_payload_size_byte};
             break;
@@ -391,9 +409,9 @@ SAGApplicationLayer::SetCodecType (SyncodecType codecType)
 }
 
 void
-SAGApplicationLayer::RecordDetailsLog(Ptr<Packet> pkt){
+SAGApplicationLayer::RecordDetailsLog(Ptr<Packet> pkt, bool sampled){
 
-	if(m_totalRxPacketNumber % 100 != 1){
+	if(!sampled && m_totalRxPacketNumber % 100 != 1){
 		return;
 	}
 	m_recordTimeStampLog_us.push_back(Simulator::Now().GetMicroSeconds());
@@ -448,14 +466,14 @@ SAGApplicationLayer::RecordDetailsLogRouteOnly(Ptr<Packet> pkt){
 }
 
 void
-SAGApplicationLayer::RecordRouteDetailsLog(std::vector<uint32_t> route){
+SAGApplicationLayer::RecordRouteDetailsLog(const std::vector<uint32_t>& route){
 
 	if(m_routeDetailsLog.empty()){
 		m_routeDetailsLog.push_back(route);
 		m_routeDetailsTimeStampLog_us.push_back(Simulator::Now().GetMicroSeconds());
 	}
 	else{
-		std::vector<uint32_t> route_last = m_routeDetailsLog[m_routeDetailsLog.size() - 1];
+		const std::vector<uint32_t>& route_last = m_routeDetailsLog[m_routeDetailsLog.size() - 1];
 		if(route_last != route){
 			m_routeDetailsLog.push_back(route);
 			m_routeDetailsTimeStampLog_us.push_back(Simulator::Now().GetMicroSeconds());
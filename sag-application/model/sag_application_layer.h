@@ -82,8 +82,13 @@ public:
     	m_max_payload_size_byte = max_payload_size_byte;
     }
 
-    void RecordDetailsLog(Ptr<Packet> pkt);
-    void RecordRouteDetailsLog(std::vector<uint32_t> route);
+    /**
+     * \brief Log route, delay and received bytes of one received packet out of 100
+     *
+     * \param sampled	The packet is already a sample (fluid probe) and is always logged
+     */
+    void RecordDetailsLog(Ptr<Packet> pkt, bool sampled = false);
+    void RecordRouteDetailsLog(const std::vector<uint32_t>& route);
     void RecordDetailsLogRouteOnly(Ptr<Packet> pkt);
 
 
@@ -95,7 +100,7 @@ public:
     	return m_routeDetailsTimeStampLog_us;
     }
 
-    const std::vector<int64_t>& GetRecordTimeStampLogUs(){
+    virtual const std::vector<int64_t>& GetRecordTimeStampLogUs(){
     	return m_recordTimeStampLog_us;
     }
 
@@ -103,7 +108,7 @@ public:
     	return m_recordProcessTimeStampLog_us;
     }
 
-    const std::vector<double>& GetRecordDelaymsDetailsTimeStampLogUs(){
+    virtual const std::vector<double>& GetRecordDelaymsDetailsTimeStampLogUs(){
     	return m_delaymsDetailsTimeStampLog_us;
     }
 
@@ -115,7 +120,7 @@ public:
     	return m_maxDelay_us;
     }
 
-    const std::vector<uint64_t>& GetRecordPktSizeBytes(){
+    virtual const std::vector<uint64_t>& GetRecordPktSizeBytes(){
     	return m_pktSizeBytes;
     }
 
@@ -176,6 +181,10 @@ protected:
 
     bool m_enableDetailedLogging = false;
 
+    static const uint32_t MAX_SEND_BATCH_PACKETS = 256;
+    Time m_sendBatchWindow;         //!< Packets due within this time are handed to the socket together with the current one
+    bool m_randomTraceStart;        //!< Trace-based codecs start at a random frame
+
 private:
     virtual void StartApplication (void);
     virtual void StopApplication (void);
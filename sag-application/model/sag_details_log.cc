@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "sag_details_log.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+	const uint64_t SAGDetailsLog::NO_SLOT;
+
+	SAGDetailsLog::Sampler
+	SAGDetailsLog::ParseSampler(std::string name){
+		if(name == "every_n"){
+			return EVERY_N;
+		}
+		if(name == "reservoir"){
+			return RESERVOIR;
+		}
+		if(name == "time_stratified"){
+			return TIME_STRATIFIED;
+		}
+		throw std::invalid_argument("Unknown details log sampler: " + name);
+	}
+
+	SAGDetailsLog::SAGDetailsLog ()
+		: m_sampler(EVERY_N),
+		  m_n(100),
+		  m_stratumUs(1),
+		  m_offered(0),
+		  m_stratum(-1),
+		  m_stratumStart(0),
+		  m_sorted(true){
+
+	}
+
+	SAGDetailsLog::~SAGDetailsLog (){
+
+	}
+
+	void
+	SAGDetailsLog::Configure(Sampler sampler, uint64_t n, int64_t stratumUs){
+		if(n == 0){
+			throw std::invalid_argument("Details log sample size must be positive");
+		}
+		if(sampler == TIME_STRATIFIED && stratumUs <= 0){
+			throw std::invalid_argument("Details log stratum must be positive");
+		}
+		NS_ASSERT_MSG(m_timestampsUs.empty(), "Details log configured after the first record");
+		m_sampler = sampler;
+		m_n = n;
+		m_stratumUs = stratumUs;
+		m_offered = 0;
+		m_stratum = -1;
+		m_stratumStart = 0;
+		if(sampler != EVERY_N){
+			m_random = CreateObject<UniformRandomVariable>();
+		}
+		if(sampler == RESERVOIR){
+			m_timestampsUs.reserve(n);
+			m_delaysUs.reserve(n);
+			m_rxBytes.reserve(n);
+		}
+	}
+
+	uint64_t
+	SAGDetailsLog::Offer(int64_t timeUs, uint64_t count, bool force){
+		if(m_sampler == EVERY_N){
+			// per flow, a probe may skip several counts at once
+			return force || (count - 1) % m_n == 0 ? m_timestampsUs.size() : NO_SLOT;
+		}
+		if(m_sampler == TIME_STRATIFIED && timeUs / m_stratumUs != m_stratum){
+			m_stratum = timeUs / m_stratumUs;
+			m_stratumStart = m_timestampsUs.size();
+			m_offered = 0;
+		}
+
+		// algorithm R: the k-th record replaces a random one of the n kept with probability n / k
+		uint64_t rank = m_offered++;
+		if(rank < m_n){
+			return m_timestampsUs.size();
+		}
+		uint64_t j = std::min(uint64_t(m_random->GetValue(0, rank + 1)), rank);
+		if(j >= m_n){
+			return NO_SLOT;
+		}
+		m_sorted = false;
+		return m_stratumStart + j;
+	}
+
+	void
+	SAGDetailsLog::Store(uint64_t slot, int64_t timeUs){
+		NS_ASSERT_MSG(m_delaysUs.empty(), "Timestamp-only record in a log of full records");
+		if(slot == m_timestampsUs.size()){
+			m_timestampsUs.push_back(timeUs);
+		}
+		else{
+			m_timestampsUs[slot] = timeUs;
+		}
+	}
+
+	void
+	SAGDetailsLog::Store(uint64_t slot, int64_t timeUs, double delayUs, uint64_t rxBytes){
+		NS_ASSERT_MSG(m_delaysUs.size() == m_timestampsUs.size(), "Full record in a log of timestamp-only records");
+		if(slot == m_timestampsUs.size()){
+			m_timestampsUs.push_back(timeUs);
+			m_delaysUs.push_back(delayUs);
+			m_rxBytes.push_back(rxBytes);
+		}
+		else{
+			m_timestampsUs[slot] = timeUs;
+			m_delaysUs[slot] = delayUs;
+			m_rxBytes[slot] = rxBytes;
+		}
+	}
+
+	const std::vector<int64_t>&
+	SAGDetailsLog::GetTimestampsUs(){
+		Sort();
+		return m_timestampsUs;
+	}
+
+	const std::vector<double>&
+	SAGDetailsLog::GetDelaysUs(){
+		Sort();
+		return m_delaysUs;
+	}
+
+	const std::vector<uint64_t>&
+	SAGDetailsLog::GetRxBytes(){
+		Sort();
+		return m_rxBytes;
+	}
+
+	void
+	SAGDetailsLog::Sort(){
+		if(m_sorted){
+			return;
+		}
+		std::vector<uint64_t> order(m_timestampsUs.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [this](uint64_t a, uint64_t b){ return m_timestampsUs[a] < m_timestampsUs[b]; });
+
+		std::vector<int64_t> timestampsUs(order.size());
+		for(uint64_t i = 0; i < order.size(); i++){
+			timestampsUs[i] = m_timestampsUs[order[i]];
+		}
+		m_timestampsUs.swap(timestampsUs);
+		if(!m_delaysUs.empty()){
+			std::vector<double> delaysUs(order.size());
+			std::vector<uint64_t> rxBytes(order.size());
+			for(uint64_t i = 0; i < order.size(); i++){
+				delaysUs[i] = m_delaysUs[order[i]];
+				rxBytes[i] = m_rxBytes[order[i]];
+			}
+			m_delaysUs.swap(delaysUs);
+			m_rxBytes.swap(rxBytes);
+		}
+
+		// records of a stratum stay after those of the previous strata, so the slots of the current one are still its own
+		m_sorted = true;
+	}
+
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef SAG_DETAILS_LOG_H
+#define SAG_DETAILS_LOG_H
+
+#include <stdint.h>
+#include <limits>
+#include <string>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \brief Sampled per-packet records of a receiver, stored as one array per field
+ *
+ * Offer () is called for every received packet and tells whether and where
+ * the record is kept, so that the packet is only inspected for the samples.
+ * A log holds either timestamp-only records or full records.
+ *
+ * Samplers:
+ *  - every_n: the records whose flow count is 1 modulo n, the count being the packets
+ *    the flow delivered so far, fluid datagrams of a probe included
+ *  - reservoir: a uniform sample of at most n records of the whole run
+ *  - time_stratified: a uniform sample of at most n records of every stratum of time
+ *
+ * Reservoir slots are reused out of time order, records are sorted by time
+ * when the arrays are read.
+ */
+class SAGDetailsLog
+{
+public:
+	enum Sampler
+	{
+		EVERY_N,
+		RESERVOIR,
+		TIME_STRATIFIED
+	};
+
+	static const uint64_t NO_SLOT = std::numeric_limits<uint64_t>::max();
+
+	static Sampler ParseSampler(std::string name);
+
+	SAGDetailsLog ();
+	virtual ~SAGDetailsLog ();
+
+	/**
+	 * \param n			Interval of every_n, records kept per reservoir or per stratum otherwise
+	 * \param stratumUs	Length of a stratum of time_stratified
+	 */
+	void Configure(Sampler sampler, uint64_t n, int64_t stratumUs);
+
+	/**
+	 * \param count		Packets received so far in the flow of the record, this one included, used by every_n
+	 * \param force		Keep the record in every_n whatever its count, e.g. a packet which is already a sample
+	 * \return slot to store the record in, NO_SLOT if it is not kept
+	 */
+	uint64_t Offer(int64_t timeUs, uint64_t count, bool force = false);
+	void Store(uint64_t slot, int64_t timeUs);
+	void Store(uint64_t slot, int64_t timeUs, double delayUs, uint64_t rxBytes);
+
+	const std::vector<int64_t>& GetTimestampsUs();
+	const std::vector<double>& GetDelaysUs();
+	const std::vector<uint64_t>& GetRxBytes();
+
+private:
+	void Sort();
+
+	Sampler m_sampler;
+	uint64_t m_n;
+	int64_t m_stratumUs;
+	Ptr<UniformRandomVariable> m_random;
+
+	uint64_t m_offered;						//!< Records offered in the current stratum, or in total, unused by every_n
+	int64_t m_stratum;						//!< Index of the current stratum
+	uint64_t m_stratumStart;				//!< First slot of the current stratum
+	bool m_sorted;
+
+	std::vector<int64_t> m_timestampsUs;
+	std::vector<double> m_delaysUs;			//!< Empty for timestamp-only records
+	std::vector<uint64_t> m_rxBytes;		//!< Empty for timestamp-only records
+};
+
+}
+
+#endif /* SAG_DETAILS_LOG_H */
@@ -36,6 +36,7 @@
 #include "ns3/route_trace_tag.h"
 #include "ns3/delay_trace_tag.h"
 #include "ns3/id_seq_tag.h"
+#include "ns3/log_sink.h"
 
 namespace ns3 {
 
@@ -441,29 +442,20 @@ FTPSend::RttChange (Time oldRtt, Time newRtt)
 void
 FTPSend::InsertCwndLog(int64_t timestamp, uint32_t cwnd_byte)
 {
-    std::ofstream ofs;
-    ofs.open (m_baseLogsDir + "/" + format_string("ftp_flow_%" PRIu64 "_cwnd.csv", m_ftpFlowId), std::ofstream::out | std::ofstream::app);
-    ofs << m_ftpFlowId << "," << timestamp << "," << cwnd_byte << std::endl;
+    LogSink::Append(m_baseLogsDir + "/" + format_string("ftp_flow_%" PRIu64 "_cwnd.csv", m_ftpFlowId), std::to_string(m_ftpFlowId) + "," + std::to_string(timestamp) + "," + std::to_string(cwnd_byte) + "\n");
     m_current_cwnd_byte = cwnd_byte;
-    ofs.close();
 }
 
 void
 FTPSend::InsertRttLog (int64_t timestamp, int64_t rtt_ns)
 {
-    std::ofstream ofs;
-    ofs.open (m_baseLogsDir + "/" + format_string("ftp_flow_%" PRIu64 "_rtt.csv", m_ftpFlowId), std::ofstream::out | std::ofstream::app);
-    ofs << m_ftpFlowId << "," << timestamp << "," << rtt_ns << std::endl;
+    LogSink::Append(m_baseLogsDir + "/" + format_string("ftp_flow_%" PRIu64 "_rtt.csv", m_ftpFlowId), std::to_string(m_ftpFlowId) + "," + std::to_string(timestamp) + "," + std::to_string(rtt_ns) + "\n");
     m_current_rtt_ns = rtt_ns;
-    ofs.close();
 }
 
 void
 FTPSend::InsertProgressLog (int64_t timestamp, int64_t progress_byte) {
-    std::ofstream ofs;
-    ofs.open (m_baseLogsDir + "/" + format_string("ftp_flow_%" PRIu64 "_progress.csv", m_ftpFlowId), std::ofstream::out | std::ofstream::app);
-    ofs << m_ftpFlowId << "," << timestamp << "," << progress_byte << std::endl;
-    ofs.close();
+    LogSink::Append(m_baseLogsDir + "/" + format_string("ftp_flow_%" PRIu64 "_progress.csv", m_ftpFlowId), std::to_string(m_ftpFlowId) + "," + std::to_string(timestamp) + "," + std::to_string(progress_byte) + "\n");
 }
 
 void
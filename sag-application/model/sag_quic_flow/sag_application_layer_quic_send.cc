@@ -34,6 +34,7 @@
 #include <fstream>
 #include "ns3/route_trace_tag.h"
 #include "ns3/delay_trace_tag.h"
+#include "ns3/log_sink.h"
 
 namespace ns3 {
 
@@ -245,12 +246,28 @@ void SAGApplicationLayerQuicSend::SendData(void) {
 
 	float targetRate = m_entry.GetTargetRateMegabitPerSec()*1e6; // bps
 	codec.setTargetRate (targetRate); //m_rVin
-	++codec; // Advance codec/packetizer to next frame/packet
-	const auto bytesToSend = codec->first.size ();
+	// Packets due within the batch window are merged into one send, tNext is the time of the first one left
+	uint64_t now_ns = Simulator::Now().GetNanoSeconds();
+	uint64_t end_ns = (uint64_t) (m_entry.GetStartTimeNs() + m_entry.GetDurationNs());
+	uint32_t txAvailable = m_socket->GetTxAvailable ();
+	uint32_t bytesToSend = 0;
+	uint32_t nPackets = 0;
+	bool bufferFull = false;
+	Time tNext (0);
+	do {
+		++codec; // Advance codec/packetizer to next frame/packet
+		if (nPackets > 0 && bytesToSend + codec->first.size () > txAvailable) {
+			// it would not have fitted on its own either
+			bufferFull = true;
+			break;
+		}
+		bytesToSend += codec->first.size ();
+		nPackets++;
+		tNext += Seconds (codec->second);
+	} while (tNext <= m_sendBatchWindow && nPackets < MAX_SEND_BATCH_PACKETS && tNext.GetNanoSeconds() + now_ns < end_ns);
 
-	NS_LOG_LOGIC("sending packet at " << Simulator::Now());
+	NS_LOG_LOGIC("sending " << nPackets << " packet(s) at " << Simulator::Now());
 
-	//std::cout<<bytesToSend<<std::endl;
 	Ptr <Packet> packet = Create<Packet>(bytesToSend);
 
     // Tag for trace
@@ -270,18 +287,12 @@ void SAGApplicationLayerQuicSend::SendData(void) {
 	// We exit this loop when actual < toSend as the send side
 	// buffer is full. The "DataSent" callback will pop when
 	// some buffer space has freed up.
-	if ((unsigned) actual != bytesToSend) {
+	if (bufferFull || (unsigned) actual != bytesToSend) {
 		m_flowOnfly.Cancel();
 		return;
 	}
 
-	double secsToNextEnqPacket = codec->second;
-	//std::cout<<"SecsToNext: "<<codec->second<<std::endl;
-	Time tNext = Seconds (secsToNextEnqPacket);
-	//std::cout<<"tNext: "<<tNext<<std::endl;
-
-	uint64_t now_ns = Simulator::Now().GetNanoSeconds();
-	if (tNext.GetNanoSeconds() + now_ns < (uint64_t) (m_entry.GetStartTimeNs() + m_entry.GetDurationNs())) {
+	if (tNext.GetNanoSeconds() + now_ns < end_ns) {
 		m_flowOnfly = Simulator::Schedule(tNext, &SAGApplicationLayerQuicSend::SendData, this);
 
 	}
@@ -507,21 +518,15 @@ SAGApplicationLayerQuicSend::RttChange (Time oldRtt, Time newRtt)
 void
 SAGApplicationLayerQuicSend::InsertCwndLog(int64_t timestamp, uint32_t cwnd_byte)
 {
-    std::ofstream ofs;
-    ofs.open (m_baseLogsDir + "/" + format_string("tcp_flow_%" PRIu64 "_cwnd.csv", m_tcpFlowId), std::ofstream::out | std::ofstream::app);
-    ofs << m_tcpFlowId << "," << timestamp << "," << cwnd_byte << std::endl;
+    LogSink::Append(m_baseLogsDir + "/" + format_string("tcp_flow_%" PRIu64 "_cwnd.csv", m_tcpFlowId), std::to_string(m_tcpFlowId) + "," + std::to_string(timestamp) + "," + std::to_string(cwnd_byte) + "\n");
     m_current_cwnd_byte = cwnd_byte;
-    ofs.close();
 }
 
 void
 SAGApplicationLayerQuicSend::InsertRttLog (int64_t timestamp, int64_t rtt_ns)
 {
-    std::ofstream ofs;
-    ofs.open (m_baseLogsDir + "/" + format_string("tcp_flow_%" PRIu64 "_rtt.csv", m_tcpFlowId), std::ofstream::out | std::ofstream::app);
-    ofs << m_tcpFlowId << "," << timestamp << "," << rtt_ns << std::endl;
+    LogSink::Append(m_baseLogsDir + "/" + format_string("tcp_flow_%" PRIu64 "_rtt.csv", m_tcpFlowId), std::to_string(m_tcpFlowId) + "," + std::to_string(timestamp) + "," + std::to_string(rtt_ns) + "\n");
     m_current_rtt_ns = rtt_ns;
-    ofs.close();
 }
 
 void
@@ -26,6 +26,68 @@ InterLossState::InterLossState()
     intervals.push_front(0);
 }
 
+SagRtpController::PacketRing::PacketRing()
+: m_slots(16)
+, m_head{0}
+, m_count{0}
+{}
+
+bool
+SagRtpController::PacketRing::empty() const {
+    return m_count == 0;
+}
+
+size_t
+SagRtpController::PacketRing::size() const {
+    return m_count;
+}
+
+const SagRtpController::PacketRecord&
+SagRtpController::PacketRing::front() const {
+    assert(m_count > 0);
+    return m_slots[m_head];
+}
+
+const SagRtpController::PacketRecord&
+SagRtpController::PacketRing::back() const {
+    assert(m_count > 0);
+    return (*this)[m_count - 1];
+}
+
+const SagRtpController::PacketRecord&
+SagRtpController::PacketRing::operator[](size_t i) const {
+    assert(i < m_count);
+    return m_slots[(m_head + i) & (m_slots.size() - 1)];
+}
+
+void
+SagRtpController::PacketRing::push_back(const PacketRecord& record) {
+    if (m_count == m_slots.size()) {
+        // Unwrap into a ring twice as large
+        std::vector<PacketRecord> slots(2 * m_slots.size());
+        for (size_t i = 0; i < m_count; ++i) {
+            slots[i] = (*this)[i];
+        }
+        m_slots.swap(slots);
+        m_head = 0;
+    }
+    m_slots[(m_head + m_count) & (m_slots.size() - 1)] = record;
+    ++m_count;
+}
+
+void
+SagRtpController::PacketRing::pop_front(size_t n) {
+    assert(n <= m_count);
+    m_head = (m_head + n) & (m_slots.size() - 1);
+    m_count -= n;
+}
+
+void
+SagRtpController::PacketRing::clear() {
+    m_head = 0;
+    m_count = 0;
+}
+
 
 NS_LOG_COMPONENT_DEFINE ("SagRtpController");
 
@@ -212,9 +274,15 @@ SagRtpController::processFeedback(uint64_t nowUs,
     assert(m_inTransitPackets.back().sequence == m_lastSequence-1);
     //std::cout << "SagRtpController::processFeedback" << m_inTransitPackets.back().sequence << m_lastSequence <<std::endl;
 
-    while (lessThan(m_inTransitPackets.front().sequence, sequence)) {
-        // Packet lost or out of order. Remove stale entry
-        m_inTransitPackets.pop_front();
+    if (lessThan(m_inTransitPackets.front().sequence, sequence)) {
+        // Packets lost or out of order. In-transit sequences are consecutive,
+        // so all stale entries are dropped at once
+        const uint16_t nStale = sequence - m_inTransitPackets.front().sequence;
+        if (nStale >= m_inTransitPackets.size()) {
+            m_inTransitPackets.clear();
+            return true;
+        }
+        m_inTransitPackets.pop_front(nStale);
         // Note: we can't tell whether the media (forward path) packet
         //     or the feedback (backward path) packet was lost.
         // Assuming media packet was lost for the time being
@@ -331,10 +399,9 @@ SagRtpController::getCurrentQdelay(uint64_t& qdelayUs) const {
 
     uint64_t qDelayMinUs = 0;
     size_t iter = 0;
-    for (auto rit = m_packetHistory.rbegin();
-            rit != m_packetHistory.rend();
-            ++rit) {
-        const uint64_t qDelayCurrentUs = rit->owdUs - m_baseDelayUs;
+    for (size_t i = m_packetHistory.size(); i-- > 0;) {
+        const PacketRecord& record = m_packetHistory[i];
+        const uint64_t qDelayCurrentUs = record.owdUs - m_baseDelayUs;
         if (iter > 0) {
             qDelayMinUs = std::min(qDelayMinUs, qDelayCurrentUs);
         } else {
@@ -361,10 +428,9 @@ SagRtpController::getCurrentRTT(uint64_t& rttUs) const {
 
     uint64_t rttMinUs = 0;
     size_t iter = 0;
-    for (auto rit = m_packetHistory.rbegin();
-            rit != m_packetHistory.rend();
-            ++rit) {
-        const uint64_t rttCurrentUs = rit->rttUs;
+    for (size_t i = m_packetHistory.size(); i-- > 0;) {
+        const PacketRecord& record = m_packetHistory[i];
+        const uint64_t rttCurrentUs = record.rttUs;
         if (iter > 0) {
             rttMinUs = std::min(rttMinUs, rttCurrentUs);
         } else {
@@ -93,6 +93,30 @@ public:
         uint64_t rttUs;
     };
 
+    /**
+     * Ring of packet records, oldest first, addressed by the position from
+     * the oldest record. The capacity is a power of two that doubles when
+     * the ring is full, so records are never moved on the hot path. Packets
+     * are recorded with consecutive sequences while in transit, so there the
+     * position of a sequence is its distance to the front's
+     */
+    class PacketRing {
+    public:
+        PacketRing();
+        bool empty() const;
+        size_t size() const;
+        const PacketRecord& front() const;
+        const PacketRecord& back() const;
+        const PacketRecord& operator[](size_t i) const;
+        void push_back(const PacketRecord& record);
+        void pop_front(size_t n = 1);
+        void clear();
+    private:
+        std::vector<PacketRecord> m_slots;
+        size_t m_head;
+        size_t m_count;
+    };
+
     /** Class constructor */
     SagRtpController();
 
@@ -351,13 +375,13 @@ protected:
     /**
      * Sent packets for which feedback has not been received yet
      */
-    std::deque<PacketRecord> m_inTransitPackets;
+    PacketRing m_inTransitPackets;
     /**
      * Packets for which feedback has already been received. Information
      * contained in these records will be used to calculate the different
      * metrics that congestion controllers use
      */
-    std::deque<PacketRecord> m_packetHistory;
+    PacketRing m_packetHistory;
     /**
      * Maintains the sum of the size of all packets in #m_packetHistory .
      * This is done for efficiency reasons
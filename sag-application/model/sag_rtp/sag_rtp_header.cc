@@ -12,6 +12,7 @@
 #include "ns3/header.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <set>
 
 namespace ns3 {
@@ -522,26 +523,112 @@ CCFeedbackHeader::GetInstanceTypeId () const
     return GetTypeId ();
 }
 
+static bool
+SsrcLess (const CCFeedbackHeader::ReportBlock& rb, uint32_t ssrc)
+{
+    return rb.m_ssrc < ssrc;
+}
+
+static bool
+SeqLess (const std::pair<uint16_t, CCFeedbackHeader::MetricBlock>& mb, uint16_t seq)
+{
+    return mb.first < seq;
+}
+
+static bool
+SeqOrder (const std::pair<uint16_t, CCFeedbackHeader::MetricBlock>& a,
+          const std::pair<uint16_t, CCFeedbackHeader::MetricBlock>& b)
+{
+    return a.first < b.first;
+}
+
+/** Index of a received sequence number in a report block */
+static size_t
+SeqIndex (const CCFeedbackHeader::ReportBlock_t& rb, uint16_t seq)
+{
+    const auto it = std::lower_bound (rb.begin (), rb.end (), seq, SeqLess);
+    NS_ASSERT (it != rb.end () && it->first == seq);
+    return it - rb.begin ();
+}
+
+static uint32_t
+SeqGap (uint16_t from, uint16_t to)
+{
+    // a single sequence number is followed by itself, all the way round
+    return from == to ? 0x10000 : uint16_t (to - from); //this wraps properly
+}
+
 CCFeedbackHeader::RejectReason
 CCFeedbackHeader::AddFeedback (uint32_t ssrc, uint16_t seq, uint64_t timestampUs, uint8_t ecn)
 {
     if (ecn > 0x03) {
         return CCFB_BAD_ECN;
     }
-    auto& rb = m_reportBlocks[ssrc];
-    if (rb.find (seq) != rb.end ()) {
-        return CCFB_DUPLICATE;
+    const auto it = std::lower_bound (m_reportBlocks.begin (), m_reportBlocks.end (), ssrc, SsrcLess);
+    const bool newBlock = (it == m_reportBlocks.end () || it->m_ssrc != ssrc);
+    // The minimal range leaves out the largest gap between two received
+    // sequence numbers; seq only splits the gap it falls into
+    size_t oldSize = 0;
+    size_t newSize = 1;
+    size_t pos = 0;
+    uint16_t prevSeq = seq;
+    uint32_t gapBefore = 0;
+    uint32_t gapAfter = 0;
+    if (!newBlock) {
+        const auto& metrics = it->m_metrics;
+        const auto next = std::lower_bound (metrics.begin (), metrics.end (), seq, SeqLess);
+        if (next != metrics.end () && next->first == seq) {
+            return CCFB_DUPLICATE;
+        }
+        pos = next - metrics.begin ();
+        prevSeq = (pos == 0 ? metrics.back () : metrics[pos - 1]).first;
+        const uint16_t nextSeq = (next == metrics.end () ? metrics.front () : *next).first;
+        gapBefore = SeqGap (prevSeq, seq);
+        gapAfter = SeqGap (seq, nextSeq);
+        auto& gaps = it->m_gaps;
+        PopStaleGaps (*it);
+        oldSize = 0x10001 - gaps.front ().first;
+        uint32_t maxGap = std::max (gapBefore, gapAfter);
+        if (gaps.front ().second == prevSeq) {
+            // the split gap is on top, the largest other one is below it
+            std::pop_heap (gaps.begin (), gaps.end ());
+            const auto split = gaps.back ();
+            gaps.pop_back ();
+            PopStaleGaps (*it);
+            if (!gaps.empty ()) {
+                maxGap = std::max (maxGap, gaps.front ().first);
+            }
+            gaps.push_back (split);
+            std::push_heap (gaps.begin (), gaps.end ());
+        } else {
+            maxGap = std::max (maxGap, gaps.front ().first);
+        }
+        newSize = 0x10001 - maxGap;
+    }
+    if (newSize > 0xffff) { // length of 65536 not supported
+        return CCFB_TOO_LONG;
     }
-    auto& mb = rb[seq];
+    const size_t len = size_t (m_length) + ReportBlockLength (newSize) - (newBlock ? 0 : ReportBlockLength (oldSize));
+    if (len > 0xffff) {
+        return CCFB_TOO_LONG;
+    }
+    m_length = len;
+
+    ReportBlock& rb = newBlock ? *m_reportBlocks.insert (it, ReportBlock{ssrc, {}, {}}) : *it;
+    MetricBlock mb;
     mb.m_timestampUs = timestampUs;
     mb.m_ecn = ecn;
-    if (!UpdateLength ()) {
-        rb.erase (seq);
-        if (rb.empty ()) {
-            m_reportBlocks.erase (ssrc);
-        }
-        return CCFB_TOO_LONG;
+    mb.m_ato = 0;
+    rb.m_metrics.insert (rb.m_metrics.begin () + pos, std::make_pair (seq, mb));
+    // the split gap stays in the heap, it is stale from now on
+    if (newBlock) {
+        rb.m_gaps.push_back (std::make_pair (SeqGap (seq, seq), seq));
+    } else {
+        rb.m_gaps.push_back (std::make_pair (gapBefore, prevSeq));
+        std::push_heap (rb.m_gaps.begin (), rb.m_gaps.end ());
+        rb.m_gaps.push_back (std::make_pair (gapAfter, seq));
     }
+    std::push_heap (rb.m_gaps.begin (), rb.m_gaps.end ());
     m_latestTsUs = std::max (m_latestTsUs, timestampUs);
     return CCFB_NONE;
 }
@@ -559,7 +646,7 @@ CCFeedbackHeader::GetSsrcList (std::set<uint32_t>& rv) const
 	NS_LOG_FUNCTION (this);
     rv.clear ();
     for (const auto& rb : m_reportBlocks) {
-        rv.insert (rb.first);
+        rv.insert (rv.end (), rb.m_ssrc);
     }
 }
 
@@ -568,24 +655,17 @@ CCFeedbackHeader::GetMetricList (uint32_t ssrc,
                                       std::vector<std::pair<uint16_t, MetricBlock> >& rv) const
 {
 	NS_LOG_FUNCTION (this << ssrc << &rv);
-    const auto it = m_reportBlocks.find (ssrc);
-    if (it == m_reportBlocks.end ()) {
+    const auto it = std::lower_bound (m_reportBlocks.begin (), m_reportBlocks.end (), ssrc, SsrcLess);
+    if (it == m_reportBlocks.end () || it->m_ssrc != ssrc) {
         return false;
     }
     rv.clear ();
-    const auto& rb = it->second;
+    const auto& rb = it->m_metrics;
     NS_ASSERT (!rb.empty ()); // at least one metric block
-    const auto beginStop = CalculateBeginStopSeq (rb);
-    const uint16_t beginSeq = beginStop.first;
-    const uint16_t stopSeq = beginStop.second;
-    for (uint16_t i = beginSeq; i != stopSeq; ++i) {
-        const auto& mb_it = rb.find (i);
-        const bool received = (mb_it != rb.end ());
-        if (received) {
-            const auto item = std::make_pair (i, mb_it->second);
-            rv.push_back (item);
-        }
-    }
+    // all received sequence numbers, from the begin of the range on
+    const size_t begin = SeqIndex (rb, CalculateBeginStopSeq (rb).first);
+    rv.insert (rv.end (), rb.begin () + begin, rb.end ());
+    rv.insert (rv.end (), rb.begin (), rb.begin () + begin);
     return true;
 }
 
@@ -606,26 +686,27 @@ CCFeedbackHeader::Serialize (Buffer::Iterator start) const
     SagRtcpHeader::SerializeCommon (start);
 
     NS_ASSERT (!m_reportBlocks.empty ()); // Empty reports are not allowed
+    const uint32_t ntpRef = UsToNtp (m_latestTsUs);
     for (const auto& rb : m_reportBlocks) {
-        start.WriteHtonU32 (rb.first);
-        const auto beginStop = CalculateBeginStopSeq (rb.second);
+        start.WriteHtonU32 (rb.m_ssrc);
+        NS_ASSERT (!rb.m_metrics.empty ()); // at least one metric block
+        const auto beginStop = CalculateBeginStopSeq (rb.m_metrics);
         const uint16_t beginSeq = beginStop.first;
         const uint16_t stopSeq = beginStop.second;
         start.WriteHtonU16 (beginSeq);
         start.WriteHtonU16 (uint16_t (stopSeq - 1));
-        NS_ASSERT (!rb.second.empty ()); // at least one metric block
+        size_t next = SeqIndex (rb.m_metrics, beginSeq);
         for (uint16_t i = beginSeq; i != stopSeq; ++i) {
-            const auto& mb_it = rb.second.find (i);
             uint8_t octet1 = 0;
             uint8_t octet2 = 0;
-            const bool received = (mb_it != rb.second.end ());
+            const bool received = (rb.m_metrics[next].first == i);
             RtpHdrSetBit (octet1, 7, received);
             if (received) {
-                const auto& mb = mb_it->second;
+                const auto& mb = rb.m_metrics[next].second;
+                next = (next + 1 == rb.m_metrics.size ()) ? 0 : next + 1;
                 NS_ASSERT (mb.m_ecn <= 0x03);
                 octet1 |= uint8_t ((mb.m_ecn & 0x03) << 5);
                 const uint32_t ntp = UsToNtp (mb.m_timestampUs);
-                const uint32_t ntpRef = UsToNtp (m_latestTsUs);
                 const uint16_t ato = NtpToAto (ntp, ntpRef);
                 NS_ASSERT (ato <= 0x1fff);
                 octet1 |= uint8_t (ato >> 8);
@@ -638,8 +719,7 @@ CCFeedbackHeader::Serialize (Buffer::Iterator start) const
             start.WriteHtonU16 (0); //padding
         }
     }
-    const uint32_t ntpTs = UsToNtp (m_latestTsUs);
-    start.WriteHtonU32 (ntpTs);
+    start.WriteHtonU32 (ntpRef);
 }
 
 uint32_t
@@ -655,7 +735,8 @@ CCFeedbackHeader::Deserialize (Buffer::Iterator start)
     while (len_left > 0) {
         NS_ASSERT (len_left >= 4); // SSRC + begin & end
         const auto ssrc = start.ReadNtohU32 ();
-        auto& rb = m_reportBlocks[ssrc];
+        auto& rb = GetReportBlock (ssrc);
+        NS_ASSERT (rb.m_metrics.empty ()); // one report block per SSRC
         const uint16_t beginSeq = start.ReadNtohU16 ();
         const uint16_t endSeq = start.ReadNtohU16 ();
         len_left -= 4;
@@ -673,13 +754,20 @@ CCFeedbackHeader::Deserialize (Buffer::Iterator start)
                 ato |= uint16_t (octet2);
                 // 'Unavailable' treated as a lost packet
                 if (ato != MetricBlock::m_unavailable) {
-                    auto &mb = rb[seq];
+                    MetricBlock mb;
                     mb.m_ecn = (octet1 >> 5) & 0x03;
                     mb.m_ato = ato;
+                    mb.m_timestampUs = 0;
+                    rb.m_metrics.push_back (std::make_pair (seq, mb));
                 }
             }
             ++seq;
         }
+        // the range is in order but may wrap, sort it
+        std::rotate (rb.m_metrics.begin (),
+                     std::is_sorted_until (rb.m_metrics.begin (), rb.m_metrics.end (), SeqOrder),
+                     rb.m_metrics.end ());
+        UpdateGaps (rb);
         len_left -= nMetricBlocks;
         if (nPaddingBlocks == 1) {
             start.ReadNtohU16 (); //skip padding
@@ -692,7 +780,7 @@ CCFeedbackHeader::Deserialize (Buffer::Iterator start)
     // Populate all timestamps once Report Timestamp is known
     // TODO (authors): Need second pass once RTS is deserialized
     for (auto& rb : m_reportBlocks) {
-        for (auto& mb : rb.second) {
+        for (auto& mb : rb.m_metrics) {
             const uint32_t ntp = AtoToNtp (mb.second.m_ato, ntpRef);
             mb.second.m_timestampUs = NtpToUs (ntp);
         }
@@ -708,22 +796,23 @@ CCFeedbackHeader::Print (std::ostream& os) const
 //	NS_LOG_FUNCTION (this >> &os);
     NS_ASSERT (m_length >= 2);
     SagRtcpHeader::PrintN (os);
+    const uint32_t ntpRef = UsToNtp (m_latestTsUs);
     size_t i = 0;
     for (const auto& rb : m_reportBlocks) {
-        const auto beginStop = CalculateBeginStopSeq (rb.second);
+        const auto beginStop = CalculateBeginStopSeq (rb.m_metrics);
         const uint16_t beginSeq = beginStop.first;
         const uint16_t stopSeq = beginStop.second;
         os << ", report block #" << i << " = "
-           << "{ SSRC = " << rb.first
+           << "{ SSRC = " << rb.m_ssrc
            << " [" << beginSeq << ".." << uint16_t (stopSeq - 1) << "] --> ";
+        size_t next = SeqIndex (rb.m_metrics, beginSeq);
         for (uint16_t j = beginSeq; j != stopSeq; ++j) {
-            const auto& mb_it = rb.second.find (j);
-            const bool received = (mb_it != rb.second.end ());
+            const bool received = (rb.m_metrics[next].first == j);
             os << "<L=" << int (received);
             if (received) {
-                const auto& mb = mb_it->second;
+                const auto& mb = rb.m_metrics[next].second;
+                next = (next + 1 == rb.m_metrics.size ()) ? 0 : next + 1;
                 const uint32_t ntp = UsToNtp (mb.m_timestampUs);
-                const uint32_t ntpRef = UsToNtp (m_latestTsUs);
                 os << ", ECN=0x" << std::hex << int (mb.m_ecn) << std::dec
                    << ", ATO=" << NtpToAto (ntp, ntpRef);
             }
@@ -732,7 +821,7 @@ CCFeedbackHeader::Print (std::ostream& os) const
         os << " }, ";
         ++i;
     }
-    os << "RTS = " << UsToNtp (m_latestTsUs) << std::endl;
+    os << "RTS = " << ntpRef << std::endl;
 }
 
 std::pair<uint16_t, uint16_t>
@@ -773,27 +862,53 @@ CCFeedbackHeader::CalculateBeginStopSeq (const ReportBlock_t& rb)
     return std::make_pair (max_hi, max_lo);
 }
 
-uint8_t
-CCFeedbackHeader::UpdateLength ()
+size_t
+CCFeedbackHeader::ReportBlockLength (size_t nMetricBlocks)
 {
-	NS_LOG_FUNCTION (this);
-    size_t len = 1; // SSRC of packet sender
-    for (const auto& rb : m_reportBlocks) {
-        ++len; // SSRC
-        ++len; // begin & end seq
-        const auto beginStop = CalculateBeginStopSeq (rb.second);
-        const uint16_t beginSeq = beginStop.first;
-        const uint16_t stopSeq = beginStop.second;
-        const uint16_t nMetricBlocks = stopSeq - beginSeq; //this wraps properly
-        const uint16_t nPaddingBlocks = nMetricBlocks % 2;
-        len += (nMetricBlocks + nPaddingBlocks) / 2; // metric blocks are 16 bits long
+    // SSRC, begin & end seq, then 16-bit metric blocks padded to 32 bits
+    return 2 + (nMetricBlocks + 1) / 2;
+}
+
+void
+CCFeedbackHeader::UpdateGaps (ReportBlock& rb)
+{
+    rb.m_gaps.clear ();
+    if (rb.m_metrics.empty ()) {
+        return;
     }
-    ++len; // report timestamp field
-    if (len > 0xffff) {
-        return false;
+    uint16_t prev = rb.m_metrics.back ().first;
+    for (const auto& mb : rb.m_metrics) {
+        rb.m_gaps.push_back (std::make_pair (SeqGap (prev, mb.first), prev));
+        prev = mb.first;
     }
-    m_length = len;
-    return true;
+    std::make_heap (rb.m_gaps.begin (), rb.m_gaps.end ());
+}
+
+void
+CCFeedbackHeader::PopStaleGaps (ReportBlock& rb)
+{
+    auto& gaps = rb.m_gaps;
+    const auto& metrics = rb.m_metrics;
+    while (!gaps.empty ()) {
+        // a gap is current as long as nothing was received within it
+        const size_t from = SeqIndex (metrics, gaps.front ().second);
+        const uint16_t to = metrics[from + 1 == metrics.size () ? 0 : from + 1].first;
+        if (SeqGap (gaps.front ().second, to) == gaps.front ().first) {
+            return;
+        }
+        std::pop_heap (gaps.begin (), gaps.end ());
+        gaps.pop_back ();
+    }
+}
+
+CCFeedbackHeader::ReportBlock&
+CCFeedbackHeader::GetReportBlock (uint32_t ssrc)
+{
+    auto it = std::lower_bound (m_reportBlocks.begin (), m_reportBlocks.end (), ssrc, SsrcLess);
+    if (it == m_reportBlocks.end () || it->m_ssrc != ssrc) {
+        it = m_reportBlocks.insert (it, ReportBlock{ssrc, {}, {}});
+    }
+    return *it;
 }
 
 uint16_t
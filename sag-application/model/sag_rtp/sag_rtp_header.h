@@ -12,6 +12,7 @@
 #include "ns3/type-id.h"
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -232,7 +233,20 @@ public:
         CCFB_BAD_ECN,   /**< ECN value takes more than two bits */
         CCFB_TOO_LONG,  /**< Adding this sequence number would make the packet too long */
     };
-    typedef std::map<uint64_t /* sequence */, MetricBlock> ReportBlock_t;
+    typedef std::vector<std::pair<uint16_t /* sequence */, MetricBlock> > ReportBlock_t;
+    /**
+     * Report block of one SSRC. The serialized range is the minimal one
+     * covering all received sequence numbers, i.e. it leaves out the largest
+     * circular gap between two of them. The received sequence numbers are
+     * kept sorted in a flat array and the gaps in a max-heap, so that the
+     * length of the range is known on every AddFeedback. A gap that has been
+     * split since it was pushed is stale and only dropped once it is on top.
+     */
+    struct ReportBlock {
+        uint32_t m_ssrc;
+        ReportBlock_t m_metrics;        /**< received sequence numbers, sorted */
+        std::vector<std::pair<uint32_t /* gap */, uint16_t /* from */> > m_gaps; /**< heap of the distances to the next received sequence number */
+    };
 
     CCFeedbackHeader ();
     virtual ~CCFeedbackHeader ();
@@ -262,13 +276,19 @@ public:
 
 protected:
     static std::pair<uint16_t, uint16_t> CalculateBeginStopSeq (const ReportBlock_t& rb);
+    /** Length in 32-bit words of a report block of nMetricBlocks, with padding */
+    static size_t ReportBlockLength (size_t nMetricBlocks);
+    /** Rebuild the gaps of a report block from its sequence numbers */
+    static void UpdateGaps (ReportBlock& rb);
+    /** Drop stale gaps from the top of the heap */
+    static void PopStaleGaps (ReportBlock& rb);
     static uint64_t NtpToUs (uint32_t ntp);
     static uint32_t UsToNtp (uint64_t tsUs);
     static uint16_t NtpToAto (uint32_t ntp, uint32_t ntpRef);
     static uint32_t AtoToNtp (uint16_t ato, uint32_t ntpRef);
 
-    uint8_t UpdateLength ();
-    std::map<uint32_t /* SSRC */, ReportBlock_t> m_reportBlocks;
+    ReportBlock& GetReportBlock (uint32_t ssrc);
+    std::vector<ReportBlock> m_reportBlocks; /**< sorted by SSRC */
     uint64_t m_latestTsUs;
 };
 
@@ -599,11 +599,9 @@ int SagNadaController::getRampUpMode() {
 
     /* check all raw queuing delay samples in
      * packet history log */
-    for (auto rit = m_packetHistory.rbegin();
-              rit != m_packetHistory.rend() && rmode == 0;
-              ++rit) {
+    for (size_t i = m_packetHistory.size(); i-- > 0 && rmode == 0;) {
 
-        const uint64_t qDelayCurrentUs = rit->owdUs - m_baseDelayUs;
+        const uint64_t qDelayCurrentUs = m_packetHistory[i].owdUs - m_baseDelayUs;
         if (qDelayCurrentUs > NADA_PARAM_QEPS_US ) {
             rmode = 1;  /* Gradual update if queuing delay exceeds threshold*/
         }
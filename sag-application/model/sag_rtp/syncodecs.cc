@@ -31,6 +31,8 @@
 #include <cassert>
 #include <algorithm>
 #include <sys/stat.h>
+#include <mutex>
+#include <sstream>
 
 #define INITIAL_RATE 100.  // Initial (very low) target rate set by default in codecs, in bps
 #define EPSILON 1e-10  // Used to check floats/doubles for zero
@@ -191,6 +193,50 @@ void SimpleFpsBasedCodec::nextPacketOrFrame() {
 
 
 
+std::shared_ptr<const TraceRepository::BitrateMap> TraceRepository::get(const std::string& path,
+                                                                      const std::string& filePrefix,
+                                                                      const std::string& resolution) {
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const BitrateMap> > traces;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::string key = path + "/" + filePrefix + "_" + resolution;
+    auto found = traces.find(key);
+    if (found != traces.end()) {
+        return found->second;
+    }
+
+    std::shared_ptr<BitrateMap> bitrates = std::make_shared<BitrateMap>();
+    for (Bitrate bitrate = TRACE_MIN_BITRATE;
+         bitrate < TRACE_MAX_BITRATE;
+         bitrate += TRACE_BITRATE_STEP) {
+        std::ostringstream fullName;
+        fullName << key << "_" << bitrate << ".txt";
+        struct stat buffer;
+        if (::stat(fullName.str().c_str(), &buffer) == 0) { //filename exists
+            //* 1000: from kbps to bps
+            readFrameSizes(fullName.str(), (*bitrates)[bitrate * 1000]);
+        }
+    }
+    traces[key] = bitrates;
+    return bitrates;
+}
+
+void TraceRepository::readFrameSizes(const std::string& filename, FrameSizes& sizes) {
+    std::ifstream fin(filename.c_str());
+    assert(fin);
+
+    FrameDataIterator it(fin);
+    while (it) {
+        const FrameDataIterator::value_type r = *it;
+        sizes.push_back(r.m_size);
+        ++it;
+    }
+    sizes.shrink_to_fit();
+}
+
+
+
 TraceBasedCodec::Labels2Res TraceBasedCodec::m_labels2Res;
 const float TraceBasedCodec::m_lowBppThresh = .091;
 const float TraceBasedCodec::m_highBppThresh = .175;
@@ -264,6 +310,14 @@ bool TraceBasedCodec::setResolutionForFixedMode(ResLabel resolution) {
     return true;
 }
 
+void TraceBasedCodec::setStartPosition(double position) {
+    assert(0. <= position && position < 1.);
+    // all the traces of a directory hold the same frames
+    const FrameSequence& seq = m_traceData.at(*m_currentResIt)->begin()->second;
+    assert(seq.size() > N_FRAMES_EXCLUDED);
+    m_currentFrameIdx = N_FRAMES_EXCLUDED + size_t(position * (seq.size() - N_FRAMES_EXCLUDED));
+}
+
 bool TraceBasedCodec::isValid() const {
     return traceDataIsValid() && CodecWithFps::isValid();
 }
@@ -321,12 +375,12 @@ void TraceBasedCodec::adjustResolution() {
 }
 
 unsigned long TraceBasedCodec::getFrameBytes(Bitrate rate) {
-    const FrameSequence& seq = m_traceData.at(*m_currentResIt)[rate];
+    const FrameSequence& seq = m_traceData.at(*m_currentResIt)->at(rate);
     assert(seq.size() > N_FRAMES_EXCLUDED);
     if (m_currentFrameIdx >= seq.size()) {
         m_currentFrameIdx = N_FRAMES_EXCLUDED;
     }
-    const unsigned long frameBytes = seq[m_currentFrameIdx++].m_size;
+    const unsigned long frameBytes = seq[m_currentFrameIdx++];
     assert(frameBytes > 0);
     return frameBytes;
 }
@@ -383,7 +437,7 @@ void TraceBasedCodec::printResolutionAndBitrate() const {
 void TraceBasedCodec::matchBitrate() {
     // Look up appropriate bitrate
     BitrateMap::const_reverse_iterator it;
-    const BitrateMap& currentMap = m_traceData.at(*m_currentResIt);
+    const BitrateMap& currentMap = *m_traceData.at(*m_currentResIt);
     // Find greatest rate less than the target rate
     // Both stored and target bitrates are in bps
     for (it = currentMap.rbegin();
@@ -395,21 +449,9 @@ void TraceBasedCodec::matchBitrate() {
 
 void TraceBasedCodec::readTraceDataFromDir(const std::string& path, const std::string& filePrefix) {
     for (Labels2Res::const_iterator it = m_labels2Res.begin(); it != m_labels2Res.end(); ++it) {
-        bool resolutionPresent = false;
-        for (Bitrate bitrate = TRACE_MIN_BITRATE;
-             bitrate < TRACE_MAX_BITRATE;
-             bitrate += TRACE_BITRATE_STEP) {
-            std::ostringstream fullName;
-            fullName << path << "/" << filePrefix << "_" << it->first << "_" << bitrate << ".txt";
-            struct stat buffer;
-            if (::stat(fullName.str().c_str(), &buffer) == 0) { //filename exists
-                //* 1000: from kbps to bps
-                readTraceDataFromFile(fullName.str(), it->first, bitrate * 1000);
-                resolutionPresent = true;
-                //std::cout << fullName.str() << std::endl;
-            }
-        }
-        if (resolutionPresent) {
+        std::shared_ptr<const BitrateMap> bitrates = TraceRepository::get(path, filePrefix, it->first);
+        if (!bitrates->empty()) {
+            m_traceData[it->first] = bitrates;
             m_resolutions.push_back(it->first);
         }
     }
@@ -418,20 +460,6 @@ void TraceBasedCodec::readTraceDataFromDir(const std::string& path, const std::s
     m_currentResIt = m_resolutions.begin();
 }
 
-void TraceBasedCodec::readTraceDataFromFile(const std::string& filename, const ResLabel& resolution, Bitrate bitrate) {
-    std::ifstream fin(filename.c_str());
-    assert(fin);
-
-    // std::cout << "Reading traces file " << filename << std::endl;
-    FrameDataIterator it(fin);
-
-    while (it) {
-        const FrameDataIterator::value_type r = *it;
-        m_traceData[resolution][bitrate].push_back(r);
-        ++it;
-    }
-}
-
 
 
 TraceBasedCodecWithScaling::TraceBasedCodecWithScaling(const std::string& path,
@@ -464,19 +492,19 @@ void TraceBasedCodecWithScaling::nextPacketOrFrame() {
         assert(m_lowRate <= m_targetRate);
         assert(m_targetRate < m_highRate);
 
-        const FrameSequence& lowSeq = m_traceData.at(*m_currentResIt)[m_lowRate];
+        const FrameSequence& lowSeq = m_traceData.at(*m_currentResIt)->at(m_lowRate);
         assert(lowSeq.size() > N_FRAMES_EXCLUDED);
         if (m_currentFrameIdx >= lowSeq.size()) {
             m_currentFrameIdx = N_FRAMES_EXCLUDED;
         }
 
-        const FrameSequence& highSeq = m_traceData.at(*m_currentResIt)[m_highRate];
+        const FrameSequence& highSeq = m_traceData.at(*m_currentResIt)->at(m_highRate);
         // Frame sequence should be the same, otherwise it doesn't make sense to interpolate
         assert(lowSeq.size() == highSeq.size());
 
-        const double lowSize = lowSeq[m_currentFrameIdx].m_size;
+        const double lowSize = lowSeq[m_currentFrameIdx];
         assert(0 < lowSize);
-        const double highSize = highSeq[m_currentFrameIdx++].m_size;
+        const double highSize = highSeq[m_currentFrameIdx++];
         if (lowSize > highSize) {
             /*
         	std::cout << "Warning: Frame size (" << lowSize << ")@" << m_lowRate <<
@@ -515,7 +543,7 @@ void TraceBasedCodecWithScaling::matchBitrate() {
     // m_highRate <- 0 if it cannot be greater than target rate
     // A rate set to 0 means "invalid"
     // All bitrates are in bps
-    const BitrateMap& currentMap = m_traceData.at(*m_currentResIt);
+    const BitrateMap& currentMap = *m_traceData.at(*m_currentResIt);
     assert(currentMap.size() > 0);
     m_lowRate = 0;
     BitrateMap::const_iterator it;
@@ -51,6 +51,7 @@
 #include <utility>
 #include <cstdint>
 #include <memory>
+#include <string>
 
 /**
  * @defgroup TraceBasedCodecConst These are defined as constants for the moment. Later on, they
@@ -359,12 +360,42 @@ protected:
 
 
 
+/**
+ * Process-wide store of the video traces read by #syncodecs::TraceBasedCodec and subclasses.
+ * The trace files of a directory, file prefix and resolution are read and parsed once, keeping
+ * only the frame sizes, and the result is shared read-only by every codec that uses them.
+ */
+class TraceRepository {
+public:
+    typedef unsigned long Bitrate;
+    typedef std::vector<uint32_t> FrameSizes; /**< Size in bytes of every frame of a trace file. */
+    typedef std::map<Bitrate, FrameSizes> BitrateMap;
+
+    /**
+     * Obtain the video traces of one resolution, reading and parsing them on first use.
+     *
+     * @param [in] path The path to the directory where the files containing video traces are
+     *                  located.
+     * @param [in] filePrefix The common prefix that all video trace files must have.
+     * @param [in] resolution The resolution label in the file names.
+     * @retval The frame sizes of the traces found for each bitrate (in bps), empty if there is no
+     *         trace of this resolution. The result is shared and never modified.
+     */
+    static std::shared_ptr<const BitrateMap> get(const std::string& path,
+                                                 const std::string& filePrefix,
+                                                 const std::string& resolution);
+
+private:
+    static void readFrameSizes(const std::string& filename, FrameSizes& sizes);
+};
+
 /**
  * This codec is an advanced synthetic codec implementation in the syncodecs family.
  * It produces a sequence of frames with realistic sizes. The sequence of frame sizes correspond
  * to real codec output from a video sequence obtained offline.
  *
- * Upon initialization, the codec parses a group of video trace files and loads them in memory.
+ * Upon initialization, the codec obtains a group of video trace files from
+ * #syncodecs::TraceRepository, which parses them once per process and shares them in memory.
  * Each trace file contains information on the sequence of frames produced by a real codec.
  * Each line of the file corresponds to a frame record, where several fields can be
  * found (see #FrameDataIterator for further information on the format of the trace file).
@@ -533,11 +564,19 @@ public:
      */
     bool setResolutionForFixedMode(ResLabel res);
 
+    /**
+     * Move the internal index to a frame of the video traces other than the ones excluded when
+     * the traces wrap around, so that codecs reading the same traces are not synchronized.
+     *
+     * @param [in] position Where to start, in [0, 1) of the frames not excluded.
+     */
+    void setStartPosition(double position);
+
 protected:
-    typedef unsigned long Bitrate;
-    typedef std::vector<LineRecord> FrameSequence;
-    typedef std::map<Bitrate, FrameSequence> BitrateMap;
-    typedef std::map<ResLabel, BitrateMap> ResolutionMap;
+    typedef TraceRepository::Bitrate Bitrate;
+    typedef TraceRepository::FrameSizes FrameSequence;
+    typedef TraceRepository::BitrateMap BitrateMap;
+    typedef std::map<ResLabel, std::shared_ptr<const BitrateMap> > ResolutionMap;
 
     /**
      * Internal implementation of the class's boolean cast. It extends its superclass's behavior
@@ -599,7 +638,7 @@ protected:
     static double getPixelsPerFrame(ResLabel resolution);
 
     bool m_fixedModeEnabled; /**< true if currently in fixed resolution mode. */
-    ResolutionMap m_traceData; /**< data structure that holds all video traces in memory. */
+    ResolutionMap m_traceData; /**< video traces of each resolution, shared with other codecs. */
     size_t m_currentFrameIdx; /**< Internal pointer to the current frame of the video trace. */
     /**
      * Number of pixels per frame for the resolution above which Waggoner's rule applies.
@@ -620,9 +659,6 @@ private:
     void increaseResolution();
     bool traceDataIsValid() const;
     void readTraceDataFromDir(const std::string& path, const std::string& filePrefix);
-    void readTraceDataFromFile(const std::string& filename,
-                               const ResLabel& resolution,
-                               Bitrate bitrate);
 
     Bitrate m_matchedRate;
 };
@@ -31,10 +31,13 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/string.h"
 #include "ns3/abort.h"
 #include "ns3/route_trace_tag.h"
 #include "ns3/delay_trace_tag.h"
 #include "ns3/id_seq_tag.h"
+#include <algorithm>
+#include <cmath>
 
 namespace ns3 {
 
@@ -53,7 +56,23 @@ SAGApplicationLayerUdp::GetTypeId(void)
             .AddAttribute("Port", "Port on which we listen for incoming packets.",
                             UintegerValue(9),
                             MakeUintegerAccessor(&SAGApplicationLayerUdp::m_port),
-                            MakeUintegerChecker<uint16_t>());
+                            MakeUintegerChecker<uint16_t>())
+            .AddAttribute("DetailsLogSampler", "Sampler of the details log of received packets: every_n, reservoir or time_stratified.",
+                            StringValue("every_n"),
+                            MakeStringAccessor(&SAGApplicationLayerUdp::m_details_log_sampler),
+                            MakeStringChecker())
+            .AddAttribute("DetailsLogSampleInterval", "The every_n sampler keeps one received packet out of this many.",
+                            UintegerValue(100),
+                            MakeUintegerAccessor(&SAGApplicationLayerUdp::m_details_log_sample_interval),
+                            MakeUintegerChecker<uint64_t>(1))
+            .AddAttribute("DetailsLogSampleSize", "Received packets kept by the reservoir sampler, or per stratum by the time_stratified sampler.",
+                            UintegerValue(10000),
+                            MakeUintegerAccessor(&SAGApplicationLayerUdp::m_details_log_sample_size),
+                            MakeUintegerChecker<uint64_t>(1))
+            .AddAttribute("DetailsLogStratum", "Stratum length of the time_stratified sampler.",
+                            TimeValue(Seconds(1)),
+                            MakeTimeAccessor(&SAGApplicationLayerUdp::m_details_log_stratum),
+                            MakeTimeChecker());
     return tid;
 }
 
@@ -61,6 +80,9 @@ SAGApplicationLayerUdp::SAGApplicationLayerUdp()
 {
     NS_LOG_FUNCTION(this);
     m_next_internal_burst_idx = 0;
+    m_fluid_mode = false;
+    m_probe_fraction = 1.0;
+    m_incoming_burst_id_base = 0;
 }
 
 SAGApplicationLayerUdp::~SAGApplicationLayerUdp() 
@@ -107,10 +129,27 @@ SAGApplicationLayerUdp::RegisterIncomingBurst(SAGBurstInfoUdp burstInfo, uint16_
 {
     NS_ABORT_MSG_IF(burstInfo.GetToNodeId() != this->GetNode()->GetId(), "Destination node identifier is not that of this node.");
     m_port = my_port_num;
+
+    // Burst IDs are dense in the schedule, the bursts received here are looked up by offset
+    int64_t burst_id = burstInfo.GetBurstId();
+    if (m_incoming_bursts.empty()) {
+        m_incoming_burst_id_base = burst_id;
+    } else if (burst_id < m_incoming_burst_id_base) {
+        m_incoming_flow_index.insert(m_incoming_flow_index.begin(), m_incoming_burst_id_base - burst_id, -1);
+        m_incoming_burst_id_base = burst_id;
+    }
+    if ((size_t) (burst_id - m_incoming_burst_id_base) >= m_incoming_flow_index.size()) {
+        m_incoming_flow_index.resize(burst_id - m_incoming_burst_id_base + 1, -1);
+    }
+    if (m_incoming_flow_index[burst_id - m_incoming_burst_id_base] != -1) {
+        throw std::runtime_error("Incoming burst registered twice: " + std::to_string(burst_id));
+    }
+    m_incoming_flow_index[burst_id - m_incoming_burst_id_base] = m_incoming_bursts.size();
+
     m_incoming_bursts.push_back(burstInfo);
-    m_incoming_bursts_received_counter[burstInfo.GetBurstId()] = 0;
-    m_incoming_bursts_size_received_counter[burstInfo.GetBurstId()] = 0;
-    m_incoming_bursts_enable_precise_logging[burstInfo.GetBurstId()] = enable_precise_logging;
+    m_incoming_bursts_received_counter.push_back(0);
+    m_incoming_bursts_size_received_counter.push_back(0);
+    m_incoming_bursts_enable_precise_logging.push_back(enable_precise_logging);
 //    if (enable_precise_logging) {
 //        std::ofstream ofs;
 //        ofs.open(m_baseLogsDir + "/" + format_string("burst_%" PRIu64 "_incoming_timestamp.csv", burstInfo.GetBurstId()));
@@ -118,6 +157,16 @@ SAGApplicationLayerUdp::RegisterIncomingBurst(SAGBurstInfoUdp burstInfo, uint16_
 //    }
 }
 
+void
+SAGApplicationLayerUdp::EnableFluidMode(double probeFraction)
+{
+    if (probeFraction <= 0 || probeFraction > 1) {
+        throw std::invalid_argument("Probe fraction of the fluid mode must be in (0, 1]");
+    }
+    m_fluid_mode = true;
+    m_probe_fraction = probeFraction;
+}
+
 void
 SAGApplicationLayerUdp::DoDispose(void) 
 {
@@ -161,6 +210,12 @@ SAGApplicationLayerUdp::StartApplication(void)
 
     // Receive of packets
     m_socket->SetRecvCallback(MakeCallback(&SAGApplicationLayerUdp::HandleRead, this));
+    SAGDetailsLog::Sampler sampler = SAGDetailsLog::ParseSampler(m_details_log_sampler);
+    m_details_log.Configure(
+            sampler,
+            sampler == SAGDetailsLog::EVERY_N ? m_details_log_sample_interval : m_details_log_sample_size,
+            m_details_log_stratum.GetMicroSeconds()
+    );
 
     // First process call is for the start of the first burst
     if (m_outgoing_bursts.size() > 0) {
@@ -183,7 +238,11 @@ SAGApplicationLayerUdp::StartNextBurst()
     }
 
     // Start the self-calling (and self-ending) process of sending out packets of the burst
-    BurstSendOut(m_next_internal_burst_idx);
+    if (m_fluid_mode) {
+        FluidSendOut(m_next_internal_burst_idx);
+    } else {
+        BurstSendOut(m_next_internal_burst_idx);
+    }
 
     // Schedule the start of the next burst if there are more
     m_next_internal_burst_idx += 1;
@@ -223,22 +282,25 @@ SAGApplicationLayerUdp::BurstSendOut(size_t internal_burst_idx)
     SAGBurstInfoUdp info = std::get<0>(m_outgoing_bursts[internal_burst_idx]);
     float targetRate = info.GetTargetRateMegabitPerSec()*1e6; // bps
 	codec.setTargetRate (targetRate); //m_rVin
-	++codec; // Advance codec/packetizer to next frame/packet
-	const auto bytesToSend = codec->first.size ();
-	//std::cout<<"BytesToSend: "<<codec->first.size()<<std::endl;
-	NS_ASSERT (bytesToSend > 0);
-	//NS_ASSERT (bytesToSend <= m_max_payload_size_byte);
-
-    // Send out the packet as desired
-    TransmitFullPacket(internal_burst_idx, bytesToSend);
-
-	double secsToNextEnqPacket = codec->second;
-	//std::cout<<"SecsToNext: "<<codec->second<<std::endl;
-	Time tNext = Seconds (secsToNextEnqPacket);
-	//std::cout<<"tNext: "<<tNext<<std::endl;
 
+	// Packets due within the batch window go out in this event, tNext is the time of the first one left
 	uint64_t now_ns = Simulator::Now().GetNanoSeconds();
-	if (tNext.GetNanoSeconds() + now_ns < (uint64_t) (info.GetStartTimeNs() + info.GetDurationNs())) {
+	uint64_t end_ns = (uint64_t) (info.GetStartTimeNs() + info.GetDurationNs());
+	std::vector<uint32_t> payload_sizes_byte;
+	Time tNext (0);
+	do {
+		++codec; // Advance codec/packetizer to next frame/packet
+		const auto bytesToSend = codec->first.size ();
+		NS_ASSERT (bytesToSend > 0);
+		//NS_ASSERT (bytesToSend <= m_max_payload_size_byte);
+		payload_sizes_byte.push_back(bytesToSend);
+		tNext += Seconds (codec->second);
+	} while (tNext <= m_sendBatchWindow && payload_sizes_byte.size() < MAX_SEND_BATCH_PACKETS && tNext.GetNanoSeconds() + now_ns < end_ns);
+
+    // Send out the packets as desired
+    TransmitBurst(internal_burst_idx, payload_sizes_byte);
+
+	if (tNext.GetNanoSeconds() + now_ns < end_ns) {
 		m_outgoing_bursts_event_id.at(internal_burst_idx) = Simulator::Schedule(tNext, &SAGApplicationLayerUdp::BurstSendOut, this, internal_burst_idx);
 	}
 
@@ -246,7 +308,59 @@ SAGApplicationLayerUdp::BurstSendOut(size_t internal_burst_idx)
 }
 
 void
-SAGApplicationLayerUdp::TransmitFullPacket(size_t internal_burst_idx, uint32_t payload_size_byte)
+SAGApplicationLayerUdp::FluidSendOut(size_t internal_burst_idx)
+{
+    NS_LOG_FUNCTION(this);
+
+    // Full payload datagrams at the target rate, one probe per packet train
+    SAGBurstInfoUdp info = std::get<0>(m_outgoing_bursts[internal_burst_idx]);
+    double rate_bps = info.GetTargetRateMegabitPerSec() * 1e6;
+    uint32_t payload_size_byte = m_max_payload_size_byte;
+    double packet_gap_ns = payload_size_byte * 8.0 / rate_bps * 1e9;
+    uint32_t train_packets = std::max<int64_t>(1, std::llround(1.0 / m_probe_fraction));
+    int64_t train_ns = std::ceil(train_packets * packet_gap_ns);
+
+    // The train is cut at the end of the burst
+    int64_t now_ns = Simulator::Now().GetNanoSeconds();
+    int64_t end_ns = info.GetStartTimeNs() + info.GetDurationNs();
+    uint32_t fluid_packets = 0;
+    while (fluid_packets + 1 < train_packets && now_ns + (fluid_packets + 1) * packet_gap_ns < end_ns) {
+        fluid_packets++;
+    }
+
+    // The rate holds until the next probe, with a margin for its delay variation
+    FluidRateTag fluidTag(
+            info.GetBurstId(),
+            (uint64_t) (rate_bps * (train_packets - 1) / train_packets),
+            std::min(now_ns + 2 * train_ns, end_ns),
+            fluid_packets,
+            (uint64_t) fluid_packets * payload_size_byte
+    );
+    TransmitFullPacket(internal_burst_idx, payload_size_byte, ResolveDestinationAddress(internal_burst_idx), &fluidTag);
+
+    // The datagrams of the fluid count as sent
+    m_outgoing_bursts_packets_sent_counter[internal_burst_idx] += fluid_packets;
+    m_outgoing_bursts_packets_size_sent_counter[internal_burst_idx] += (uint64_t) fluid_packets * payload_size_byte;
+    m_totalTxBytes = m_outgoing_bursts_packets_size_sent_counter[internal_burst_idx];
+    m_totalTxPacketNumber = m_outgoing_bursts_packets_sent_counter[internal_burst_idx];
+
+    if (now_ns + train_ns < end_ns) {
+        m_outgoing_bursts_event_id.at(internal_burst_idx) = Simulator::Schedule(NanoSeconds(train_ns), &SAGApplicationLayerUdp::FluidSendOut, this, internal_burst_idx);
+    }
+}
+
+void
+SAGApplicationLayerUdp::TransmitBurst(size_t internal_burst_idx, const std::vector<uint32_t>& payload_sizes_byte)
+{
+    NS_LOG_FUNCTION(this);
+    Address destination = ResolveDestinationAddress(internal_burst_idx);
+    for (uint32_t payload_size_byte : payload_sizes_byte) {
+        TransmitFullPacket(internal_burst_idx, payload_size_byte, destination);
+    }
+}
+
+void
+SAGApplicationLayerUdp::TransmitFullPacket(size_t internal_burst_idx, uint32_t payload_size_byte, const Address& destination, const FluidRateTag* fluidTag)
 {
 	NS_LOG_FUNCTION(this);
 //    // Header with (burst_id, seq_no)
@@ -280,6 +394,11 @@ SAGApplicationLayerUdp::TransmitFullPacket(size_t internal_burst_idx, uint32_t p
 //    p->AddHeader(idSeq);
     p->AddPacketTag(idSeq);
 
+    // Probe of a fluid flow
+    if (fluidTag != nullptr) {
+        p->AddPacketTag(*fluidTag);
+    }
+
 
     // Tag for trace
     if (m_outgoing_bursts_enable_precise_logging[internal_burst_idx]){
@@ -291,6 +410,16 @@ SAGApplicationLayerUdp::TransmitFullPacket(size_t internal_burst_idx, uint32_t p
     }
 
 
+    // Send out the packet to the target address
+    if (m_isIPv4Networking || m_isIPv6Networking) {
+        m_socket->SendTo(p, 0, destination);
+    }
+
+}
+
+Address
+SAGApplicationLayerUdp::ResolveDestinationAddress(size_t internal_burst_idx)
+{
     // first up interface
     Ptr<Node> dstNode = std::get<1>(m_outgoing_bursts[internal_burst_idx]);
 
@@ -308,9 +437,7 @@ SAGApplicationLayerUdp::TransmitFullPacket(size_t internal_burst_idx, uint32_t p
         }
 
         NS_LOG_LOGIC ("Send IPv4 address " << Ipv4Address(adr.GetIpv4()) << " to node " << dstNode->GetId());
-
-        // Send out the packet to the target address
-        m_socket->SendTo(p, 0, adr);
+        return adr;
     }
     else if(m_isIPv6Networking){
         Inet6SocketAddress adr(m_dstPort);
@@ -330,10 +457,9 @@ SAGApplicationLayerUdp::TransmitFullPacket(size_t internal_burst_idx, uint32_t p
         // adr.SetIpv6(dstAddress);
 
         NS_LOG_LOGIC ("Send IPv6 address " << Ipv6Address(adr.GetIpv6()) << " to node " << dstNode->GetId());
-
-        // Send out the packet to the target address
-        m_socket->SendTo(p, 0, adr);
+        return adr;
     }
+    return Address();
 
 }
 
@@ -366,20 +492,82 @@ SAGApplicationLayerUdp::HandleRead(Ptr <Socket> socket)
 //    	std::cout<<incomingIdSeq.GetId()<<"  "<<packet->GetSize ()<<std::endl;
 
         // Count packets from incoming bursts
-        m_incoming_bursts_received_counter.at(incomingIdSeq.GetId()) += 1;
-        m_incoming_bursts_size_received_counter.at(incomingIdSeq.GetId()) += packet->GetSize ();
-        m_totalRxBytes = m_incoming_bursts_size_received_counter.at(incomingIdSeq.GetId());
-        m_totalRxPacketNumber = m_incoming_bursts_received_counter.at(incomingIdSeq.GetId());
+        size_t flow = GetIncomingFlowIndex(incomingIdSeq.GetId());
+        uint64_t& received = m_incoming_bursts_received_counter[flow];
+        uint64_t& received_size = m_incoming_bursts_size_received_counter[flow];
+        received += 1;
+        received_size += packet->GetSize ();
+
+        // A probe also delivers the datagrams of its fluid that were not dropped on the way
+        FluidRateTag fluidTag;
+        bool is_probe = packet->PeekPacketTag(fluidTag);
+        if (is_probe) {
+            received += std::llround(fluidTag.GetPackets() * fluidTag.GetDeliveredFraction());
+            received_size += std::llround(fluidTag.GetBytes() * fluidTag.GetDeliveredFraction());
+        }
+
+        m_totalRxBytes = received_size;
+        m_totalRxPacketNumber = received;
 
 
         // Log precise trace
-		if (m_incoming_bursts_enable_precise_logging[incomingIdSeq.GetId()]) {
-			RecordDetailsLog(packet);
+		if (m_incoming_bursts_enable_precise_logging[flow]) {
+			RecordReceiveDetails(packet, is_probe);
 		}
 
     }
 }
 
+size_t
+SAGApplicationLayerUdp::GetIncomingFlowIndex(int64_t burst_id) const
+{
+    if (burst_id < m_incoming_burst_id_base
+            || (size_t) (burst_id - m_incoming_burst_id_base) >= m_incoming_flow_index.size()
+            || m_incoming_flow_index[burst_id - m_incoming_burst_id_base] == -1) {
+        throw std::out_of_range("Burst is not received by this application: " + std::to_string(burst_id));
+    }
+    return m_incoming_flow_index[burst_id - m_incoming_burst_id_base];
+}
+
+void
+SAGApplicationLayerUdp::RecordReceiveDetails(Ptr<Packet> packet, bool is_probe)
+{
+    int64_t now_us = Simulator::Now().GetMicroSeconds();
+    uint64_t slot = m_details_log.Offer(now_us, m_totalRxPacketNumber, is_probe);
+    if (slot == SAGDetailsLog::NO_SLOT) {
+        return;
+    }
+
+    RouteTraceTag rtTrTag;
+    NS_ABORT_MSG_UNLESS(packet->PeekPacketTag(rtTrTag), "No Route Trace Packet Tag");
+    DelayTraceTag delayTag;
+    NS_ABORT_MSG_UNLESS(packet->PeekPacketTag(delayTag), "No Delay Trace Packet Tag");
+
+    RecordRouteDetailsLog(rtTrTag.GetRouteTrace());
+    double delay_us = ((uint64_t) Simulator::Now().GetNanoSeconds() - delayTag.GetStartTime()) / 1e3;
+    m_minDelay_us = std::min(m_minDelay_us, delay_us);
+    m_maxDelay_us = std::max(m_maxDelay_us, delay_us);
+    m_details_log.Store(slot, now_us, delay_us, m_totalRxBytes);
+}
+
+const std::vector<int64_t>&
+SAGApplicationLayerUdp::GetRecordTimeStampLogUs()
+{
+    return m_details_log.GetTimestampsUs();
+}
+
+const std::vector<double>&
+SAGApplicationLayerUdp::GetRecordDelaymsDetailsTimeStampLogUs()
+{
+    return m_details_log.GetDelaysUs();
+}
+
+const std::vector<uint64_t>&
+SAGApplicationLayerUdp::GetRecordPktSizeBytes()
+{
+    return m_details_log.GetRxBytes();
+}
+
 //void
 //SAGApplicationLayerUdp::DoSomeThingBeforeStartApplication(void)
 //{
@@ -424,7 +612,7 @@ SAGApplicationLayerUdp::GetIncomingBurstsInformation()
 {
     std::vector<std::tuple<SAGBurstInfoUdp, uint64_t>> result;
     for (size_t i = 0; i < m_incoming_bursts.size(); i++) {
-        result.push_back(std::make_tuple(m_incoming_bursts[i], m_incoming_bursts_received_counter.at(m_incoming_bursts[i].GetBurstId())));
+        result.push_back(std::make_tuple(m_incoming_bursts[i], m_incoming_bursts_received_counter[i]));
     }
     return result;
 }
@@ -444,7 +632,7 @@ SAGApplicationLayerUdp::GetSentCounterOf(int64_t burst_id)
 uint64_t
 SAGApplicationLayerUdp::GetReceivedCounterOf(int64_t burst_id) 
 {
-    return m_incoming_bursts_received_counter.at(burst_id);
+    return m_incoming_bursts_received_counter[GetIncomingFlowIndex(burst_id)];
 }
 
 
@@ -461,7 +649,7 @@ SAGApplicationLayerUdp::GetSentCounterSizeOf(int64_t burst_id){
 
 uint64_t
 SAGApplicationLayerUdp::GetReceivedCounterSizeOf(int64_t burst_id){
-	return m_incoming_bursts_size_received_counter.at(burst_id);
+	return m_incoming_bursts_size_received_counter[GetIncomingFlowIndex(burst_id)];
 }
 
 
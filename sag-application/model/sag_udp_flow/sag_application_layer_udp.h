@@ -21,6 +21,8 @@
 #define SAG_APPLICATION_LAYER_UDP_H
 
 #include "ns3/sag_application_layer.h"
+#include "ns3/fluid_rate_tag.h"
+#include "ns3/sag_details_log.h"
 
 
 namespace ns3 {
@@ -46,6 +48,19 @@ public:
     uint64_t GetSentCounterSizeOf(int64_t burst_id);
     uint64_t GetReceivedCounterSizeOf(int64_t burst_id);
 
+    /**
+     * \brief Send the outgoing bursts as fluid, with one real probe packet out of 1 / probeFraction
+     *
+     * Only meant for constant bit rate codecs: the probes carry the rate of
+     * the datagrams they stand for to the link layers on their route and
+     * the receiver counts those datagrams when the probe arrives.
+     */
+    void EnableFluidMode(double probeFraction);
+
+    virtual const std::vector<int64_t>& GetRecordTimeStampLogUs();
+    virtual const std::vector<double>& GetRecordDelaymsDetailsTimeStampLogUs();
+    virtual const std::vector<uint64_t>& GetRecordPktSizeBytes();
+
 
 protected:
     virtual void DoDispose (void);
@@ -57,10 +72,29 @@ private:
 
     void StartNextBurst();
     void BurstSendOut(size_t internal_burst_idx);
-    void TransmitFullPacket(size_t internal_burst_idx, uint32_t payload_size_byte);
+    void FluidSendOut(size_t internal_burst_idx);
+    /**
+     * \brief Send back-to-back datagrams of a burst, the destination address is looked up once
+     */
+    void TransmitBurst(size_t internal_burst_idx, const std::vector<uint32_t>& payload_sizes_byte);
+    void TransmitFullPacket(size_t internal_burst_idx, uint32_t payload_size_byte, const Address& destination, const FluidRateTag* fluidTag = nullptr);
+    /**
+     * \brief Address of the first up interface of the destination, empty without IPv4 or IPv6 networking
+     */
+    Address ResolveDestinationAddress(size_t internal_burst_idx);
 
     void SetSocketType(TypeId tid, TypeId socketTid);
     void HandleRead (Ptr<Socket> socket);
+    /**
+     * \brief Index of a burst in the incoming burst arrays, throws std::out_of_range if it is not received here
+     */
+    size_t GetIncomingFlowIndex(int64_t burst_id) const;
+    /**
+     * \brief Offer a received packet of a logged burst to the details log
+     *
+     * \param is_probe  The packet is a fluid probe, which is kept by the every_n sampler whatever its rank
+     */
+    void RecordReceiveDetails(Ptr<Packet> packet, bool is_probe);
 
     //virtual void DoSomeThingBeforeStartApplication(void);
     virtual void DoSomeThingWhenSendPkt(Ptr<Packet> packet);
@@ -81,13 +115,24 @@ private:
     std::vector<EventId> m_outgoing_bursts_event_id; //!< Event ID of the outgoing burst send loop
     std::vector<bool> m_outgoing_bursts_enable_precise_logging; //!< True iff enable precise logging for each burst
     size_t m_next_internal_burst_idx; //!< Next burst index to send out
+    bool m_fluid_mode; //!< True iff the outgoing bursts are sent as fluid
+    double m_probe_fraction; //!< Share of the datagrams sent as real packets in fluid mode
 
 
-    // Incoming bursts
+    // Incoming bursts, in the order they were registered
     std::vector<SAGBurstInfoUdp> m_incoming_bursts;
-    std::map<int64_t, uint64_t> m_incoming_bursts_received_counter;       //!< Counter for how many packets received
-    std::map<int64_t, uint64_t> m_incoming_bursts_size_received_counter;       //!< Counter for how many packets received
-    std::map<int64_t, uint64_t> m_incoming_bursts_enable_precise_logging; //!< True iff enable precise logging for each burst
+    std::vector<uint64_t> m_incoming_bursts_received_counter;       //!< Counter for how many packets received
+    std::vector<uint64_t> m_incoming_bursts_size_received_counter;       //!< Counter for how many bytes received
+    std::vector<bool> m_incoming_bursts_enable_precise_logging; //!< True iff enable precise logging for each burst
+    int64_t m_incoming_burst_id_base; //!< Lowest incoming burst ID
+    std::vector<int64_t> m_incoming_flow_index; //!< Index of burst m_incoming_burst_id_base + i, -1 if it is not received here
+
+    // Details log of the logged incoming bursts
+    SAGDetailsLog m_details_log;
+    std::string m_details_log_sampler; //!< every_n, reservoir or time_stratified
+    uint64_t m_details_log_sample_interval; //!< One record out of this many with every_n
+    uint64_t m_details_log_sample_size; //!< Records kept by reservoir, or per stratum by time_stratified
+    Time m_details_log_stratum; //!< Stratum length of time_stratified
 
 };
 
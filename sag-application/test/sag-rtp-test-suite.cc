@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/sag_rtp_header.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup SAGApplication
+ *
+ * \brief A CCFB report block spans the minimal circular range of its sequence numbers
+ *
+ * The feedback is compared with a block of every sequence number of the
+ * expected range: both must have the same length, and the sparse one must
+ * list its sequence numbers in range order after a round trip.
+ */
+class CCFeedbackRangeTestCase : public TestCase
+{
+public:
+	CCFeedbackRangeTestCase (std::string name, std::vector<uint16_t> seqs, uint16_t beginSeq, uint16_t endSeq);
+
+private:
+	virtual void DoRun (void);
+
+	std::vector<uint16_t> m_seqs;	//!< sequence numbers in the order they are added
+	uint16_t m_beginSeq;	//!< first sequence number of the minimal range
+	uint16_t m_endSeq;	//!< last sequence number of the minimal range
+};
+
+CCFeedbackRangeTestCase::CCFeedbackRangeTestCase (std::string name, std::vector<uint16_t> seqs, uint16_t beginSeq, uint16_t endSeq)
+	: TestCase ("Minimal CCFB range: " + name),
+	  m_seqs (seqs),
+	  m_beginSeq (beginSeq),
+	  m_endSeq (endSeq)
+{
+}
+
+void
+CCFeedbackRangeTestCase::DoRun (void)
+{
+	const uint32_t ssrc = 7;
+	const uint64_t timestampUs = 1000000;
+
+	CCFeedbackHeader sparse;
+	for (uint16_t seq : m_seqs) {
+		NS_TEST_ASSERT_MSG_EQ(sparse.AddFeedback(ssrc, seq, timestampUs), CCFeedbackHeader::CCFB_NONE, "Feedback of " << seq << " rejected");
+	}
+	NS_TEST_EXPECT_MSG_EQ(sparse.AddFeedback(ssrc, m_seqs.front(), timestampUs), CCFeedbackHeader::CCFB_DUPLICATE, "Duplicate accepted");
+
+	CCFeedbackHeader full;
+	for (uint16_t seq = m_beginSeq; seq != uint16_t (m_endSeq + 1); ++seq) {
+		full.AddFeedback(ssrc, seq, timestampUs);
+	}
+	NS_TEST_EXPECT_MSG_EQ(sparse.GetSerializedSize(), full.GetSerializedSize(),
+			"Range of the report block is not [" << m_beginSeq << ".." << m_endSeq << "]");
+
+	Ptr<Packet> packet = Create<Packet> ();
+	packet->AddHeader(sparse);
+	CCFeedbackHeader received;
+	packet->RemoveHeader(received);
+	std::vector<std::pair<uint16_t, CCFeedbackHeader::MetricBlock> > metrics;
+	NS_TEST_ASSERT_MSG_EQ(received.GetMetricList(ssrc, metrics), true, "Report block of " << ssrc << " lost");
+	NS_TEST_ASSERT_MSG_EQ(metrics.size(), m_seqs.size(), "Received sequence numbers lost");
+	NS_TEST_EXPECT_MSG_EQ(metrics.front().first, m_beginSeq, "Report block starts elsewhere");
+	NS_TEST_EXPECT_MSG_EQ(metrics.back().first, m_endSeq, "Report block ends elsewhere");
+}
+
+/**
+ * \ingroup SAGApplication
+ *
+ * \brief Unit tests of the RTP headers
+ */
+class SagRtpTestSuite : public TestSuite
+{
+public:
+	SagRtpTestSuite ();
+};
+
+SagRtpTestSuite::SagRtpTestSuite ()
+	: TestSuite ("sag-rtp", TestSuite::UNIT)
+{
+	// The largest gap is 0..30000, so the range runs from 30000 over the wrap to 0
+	AddTestCase (new CCFeedbackRangeTestCase ("sparse", {0, 30000, 50000}, 30000, 0), TestCase::QUICK);
+	AddTestCase (new CCFeedbackRangeTestCase ("wrapped", {65530, 3, 65535}, 65530, 3), TestCase::QUICK);
+	AddTestCase (new CCFeedbackRangeTestCase ("out of order", {200, 100, 40000, 150, 300}, 40000, 300), TestCase::QUICK);
+}
+
+static SagRtpTestSuite g_sagRtpTestSuite;
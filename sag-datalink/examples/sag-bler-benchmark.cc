@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+/**
+ * Benchmark of the BLER lookups of the link layer
+ *
+ * - bler_table_load: SatLookUpTable construction from a link result file,
+ *   parsed and resampled once per process
+ * - bler_lookup: SatLookUpTable::GetBler over SINRs spread across and beyond
+ *   the table, as called for every received frame
+ * - esno_lookup: SatLookUpTable::GetEsNoDb over BLER targets, as called
+ *   when MODCOD tables are built
+ *
+ * Without --link_result_file a DVB-S2 like waterfall curve is generated, so
+ * that the benchmark needs no data files. SINRs and targets come from a fixed
+ * seed. Results are JSON lines, see BenchmarkReport.
+ *
+ * ./waf --run="sag-bler-benchmark --lookups=10000000 --output=benchmark.jsonl"
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <unistd.h>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/benchmark_report.h"
+#include "ns3/sag_lookup_table.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SagBlerBenchmark");
+
+/**
+ * Waterfall of a code with a threshold at 1.5 dB, 0.05 dB apart from -3 to 6 dB
+ */
+static std::string
+WriteSyntheticLinkResults(uint32_t& rows){
+	char filename[] = "/tmp/sag-bler-benchmark-XXXXXX";
+	int fd = mkstemp(filename);
+	if(fd < 0){
+		throw std::runtime_error("Cannot create a link result file in /tmp");
+	}
+	close(fd);
+	std::ofstream ofs(filename, std::ofstream::out | std::ofstream::trunc);
+	rows = 0;
+	for(int32_t i = -60; i <= 120; i++){
+		double esNoDb = i * 0.05;
+		double bler = std::max(0.5 * std::erfc((esNoDb - 1.5) / 0.6), 1e-6);
+		ofs << esNoDb << " " << bler << std::endl;
+		rows++;
+	}
+	if(!ofs){
+		throw std::runtime_error(std::string("Cannot write link result file ") + filename);
+	}
+	return filename;
+}
+
+int
+main (int argc, char *argv[])
+{
+	std::string linkResultFile;
+	uint32_t lookups = 10000000;
+	uint32_t esNoLookups = 100000;
+	uint32_t seed = 1;
+	std::string output;
+
+	CommandLine cmd;
+	cmd.AddValue ("link_result_file", "Link result file (Es/No in dB, BLER per line), a synthetic one if empty", linkResultFile);
+	cmd.AddValue ("lookups", "BLER lookups", lookups);
+	cmd.AddValue ("esno_lookups", "Es/No lookups", esNoLookups);
+	cmd.AddValue ("seed", "Seed of the SINR and BLER target sequences", seed);
+	cmd.AddValue ("output", "File the JSON lines are appended to, stdout only if empty", output);
+	cmd.Parse (argc, argv);
+
+	uint32_t rows = 0;
+	bool synthetic = linkResultFile.empty();
+	if(synthetic){
+		linkResultFile = WriteSyntheticLinkResults(rows);
+	}
+	nlohmann::json parameters = {{"link_result_file", synthetic ? "synthetic" : linkResultFile}, {"seed", seed}};
+	BenchmarkReport report("sag-bler", output);
+
+	int64_t start = BenchmarkReport::NowNs();
+	Ptr<SatLookUpTable> table = CreateObject<SatLookUpTable>(linkResultFile);
+	report.Record("bler_table_load", parameters, 1, BenchmarkReport::NowNs() - start, 1, {{"rows", rows}});
+	if(synthetic){
+		std::remove(linkResultFile.c_str());
+	}
+
+	// edges included: below the first and above the last Es/No of the curve
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> sinrDb(-5.0, 10.0);
+	std::vector<double> sinrs(lookups);
+	for(auto& sinr : sinrs){
+		sinr = sinrDb(rng);
+	}
+	double blerSum = 0;
+	start = BenchmarkReport::NowNs();
+	for(double sinr : sinrs){
+		blerSum += table->GetBler(sinr);
+	}
+	report.Record("bler_lookup", parameters, lookups, BenchmarkReport::NowNs() - start, lookups, {{"bler_sum", blerSum}});
+
+	std::uniform_real_distribution<double> log10Bler(-5.0, std::log10(0.5));
+	std::vector<double> targets(esNoLookups);
+	for(auto& target : targets){
+		target = std::pow(10.0, log10Bler(rng));
+	}
+	double esNoSum = 0;
+	start = BenchmarkReport::NowNs();
+	for(double target : targets){
+		esNoSum += table->GetEsNoDb(target);
+	}
+	report.Record("esno_lookup", parameters, esNoLookups, BenchmarkReport::NowNs() - start, esNoLookups, {{"esno_sum_db", esNoSum}});
+
+	Simulator::Destroy ();
+	return 0;
+}
@@ -78,7 +78,7 @@ PointToPointLaserHelper::PointToPointLaserHelper (Ptr<ns3::BasicSimulation> basi
 		if(hdlc){
 			netdevice_Type = "ns3::HdlcNetDevice";
 			channel_Type = "ns3::HdlcChannel";
-			remote_channel_Type = "ns3::PointToPointLaserRemoteChannel";
+			remote_channel_Type = "ns3::HdlcRemoteChannel";
 			break;
 		}
 
@@ -86,10 +86,6 @@ PointToPointLaserHelper::PointToPointLaserHelper (Ptr<ns3::BasicSimulation> basi
 	if(netdevice_Type == "" || channel_Type == ""){
 		throw std::runtime_error("No Link Layer Protocol Set");
 	}
-	bool hdlc = parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_hdlc_protocol", "false"));
-	if(hdlc && MpiInterface::IsEnabled ()){
-		throw std::runtime_error("Todo: test hdlc in distributed mode");
-	}
 
 	m_deviceFactory.SetTypeId (netdevice_Type);
 	m_channelFactory.SetTypeId (channel_Type);
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include "sag_acm_controller.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+	NS_LOG_COMPONENT_DEFINE ("SatAcmController");
+
+	SatAcmModcodTable::SatAcmModcodTable(Ptr<SatBbFrameConf> conf, Ptr<SatLinkResultsFwd> linkResults,
+			SatEnums::SatBbFrameType_t frameType, double targetBler, double symbolRate)
+		: m_return(false)
+	{
+
+		std::vector<std::pair<double, std::pair<uint64_t, std::pair<SatEnums::SatModcod_t, uint32_t>>>> entries;
+		// rates scale with the symbol rate of the configuration
+		double scale = symbolRate / conf->GetSymbolRate();
+		for(SatEnums::SatModcod_t modcod : conf->GetModCodsUsed()){
+			double esNoDb = linkResults->GetEsNoDb(modcod, frameType, targetBler);
+			double bps = conf->GetBbFramePayloadBits(modcod, frameType) / conf->GetBbFrameDuration(modcod, frameType).GetSeconds();
+			entries.push_back(std::make_pair(esNoDb, std::make_pair((uint64_t) (bps * scale), std::make_pair(modcod, (uint32_t) 0))));
+		}
+		Build(entries);
+	}
+
+	SatAcmModcodTable::SatAcmModcodTable(Ptr<SatWaveformConf> conf, Ptr<SatLinkResultsRtn> linkResults,
+			uint32_t burstLength, double targetBler, double symbolRate)
+		: m_return(true)
+	{
+
+		std::vector<std::pair<double, std::pair<uint64_t, std::pair<SatEnums::SatModcod_t, uint32_t>>>> entries;
+		for(uint32_t wfId = conf->GetMinWfId(); wfId <= conf->GetMaxWfId(); wfId++){
+			Ptr<SatWaveform> wf = conf->GetWaveform(wfId);
+			if(wf->GetBurstLengthInSymbols() != burstLength){
+				continue;
+			}
+			double ebNoDb = linkResults->GetEbNoDb(wfId, targetBler);
+			double bps = wf->GetThroughputInBitsPerSecond(symbolRate);
+			entries.push_back(std::make_pair(ebNoDb, std::make_pair((uint64_t) bps, std::make_pair(wf->GetModCod(), wfId))));
+		}
+		Build(entries);
+	}
+
+	void
+	SatAcmModcodTable::Build(std::vector<std::pair<double, std::pair<uint64_t, std::pair<SatEnums::SatModcod_t, uint32_t>>>>& entries){
+
+		std::sort(entries.begin(), entries.end());
+		for(auto& entry : entries){
+			if(!m_rate.empty() && entry.second.first <= m_rate.back()){
+				continue;
+			}
+			m_esNoDb.push_back(entry.first);
+			m_rate.push_back(entry.second.first);
+			m_modcod.push_back(entry.second.second.first);
+			m_waveformId.push_back(entry.second.second.second);
+		}
+		if(m_modcod.empty()){
+			throw std::runtime_error("No MODCOD available for adaptive coding and modulation.");
+		}
+	}
+
+	uint32_t
+	SatAcmModcodTable::GetN() const{
+		return m_modcod.size();
+	}
+
+	SatEnums::SatModcod_t
+	SatAcmModcodTable::GetModcod(uint32_t i) const{
+		return m_modcod[i];
+	}
+
+	uint32_t
+	SatAcmModcodTable::GetWaveformId(uint32_t i) const{
+		return m_waveformId[i];
+	}
+
+	bool
+	SatAcmModcodTable::IsReturn() const{
+		return m_return;
+	}
+
+	double
+	SatAcmModcodTable::GetEsNoRequirementDb(uint32_t i) const{
+		return m_esNoDb[i];
+	}
+
+	uint64_t
+	SatAcmModcodTable::GetDataRate(uint32_t i) const{
+		return m_rate[i];
+	}
+
+	uint32_t
+	SatAcmModcodTable::Select(double sinrDb) const{
+		// first entry whose requirement is not met
+		uint32_t i = std::upper_bound(m_esNoDb.begin(), m_esNoDb.end(), sinrDb) - m_esNoDb.begin();
+		return i == 0 ? 0 : i - 1;
+	}
+
+	SatAcmController::SatAcmController()
+		: m_hysteresisDb(0),
+		  m_started(false),
+		  m_current(0),
+		  m_switches(0)
+	{
+	}
+
+	SatAcmController::SatAcmController(Ptr<SAGLinkLayerGSL> device, Ptr<const SatAcmModcodTable> table, double hysteresisDb)
+		: m_device(device),
+		  m_table(table),
+		  m_hysteresisDb(hysteresisDb),
+		  m_started(false),
+		  m_current(0),
+		  m_residency(table->GetN(), Time(0)),
+		  m_switches(0)
+	{
+		NS_ASSERT_MSG(hysteresisDb >= 0, "ACM hysteresis must not be negative");
+	}
+
+	bool
+	SatAcmController::Update(double sinrDb){
+		NS_ASSERT_MSG(m_table != nullptr, "ACM controller without MODCOD table");
+		m_lastUpdate = Simulator::Now();
+		uint32_t target = m_table->Select(sinrDb);
+		if(!m_started){
+			m_started = true;
+			m_since = Simulator::Now();
+			Apply(target);
+			return true;
+		}
+		if(target > m_current){
+			target = m_table->Select(sinrDb - m_hysteresisDb);
+			if(target <= m_current){
+				return false;
+			}
+		}
+		else if(target == m_current){
+			return false;
+		}
+		m_residency[m_current] += Simulator::Now() - m_since;
+		m_since = Simulator::Now();
+		m_switches++;
+		NS_LOG_INFO("SINR " << sinrDb << " dB: " << SatEnums::GetModcodTypeName(m_table->GetModcod(m_current))
+				<< " -> " << SatEnums::GetModcodTypeName(m_table->GetModcod(target)));
+		Apply(target);
+		return true;
+	}
+
+	void
+	SatAcmController::Apply(uint32_t i){
+		m_current = i;
+		if(m_table->IsReturn()){
+			m_device->SetWaveformDataRate(m_table->GetWaveformId(i), DataRate(m_table->GetDataRate(i)));
+		}
+		else{
+			m_device->SetModcodDataRate(m_table->GetModcod(i), DataRate(m_table->GetDataRate(i)));
+		}
+	}
+
+	SatEnums::SatModcod_t
+	SatAcmController::GetModcod() const{
+		return m_started ? m_table->GetModcod(m_current) : SatEnums::SAT_NONVALID_MODCOD;
+	}
+
+	void
+	SatAcmController::Finalize(){
+		if(m_started){
+			m_residency[m_current] += Simulator::Now() - m_since;
+			m_since = Simulator::Now();
+		}
+	}
+
+	Ptr<const SatAcmModcodTable>
+	SatAcmController::GetTable() const{
+		return m_table;
+	}
+
+	const std::vector<Time>&
+	SatAcmController::GetResidency() const{
+		return m_residency;
+	}
+
+	uint32_t
+	SatAcmController::GetNSwitches() const{
+		return m_switches;
+	}
+
+	Time
+	SatAcmController::GetLastUpdate() const{
+		return m_lastUpdate;
+	}
+
+} // namespace ns3
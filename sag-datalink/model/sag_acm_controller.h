@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef SAG_ACM_CONTROLLER_H
+#define SAG_ACM_CONTROLLER_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/sag_enums.h"
+#include "ns3/sag_bbframe_conf.h"
+#include "ns3/sag_waveform_conf.h"
+#include "ns3/sag_link_results.h"
+#include "ns3/sag_link_layer_gsl.h"
+
+namespace ns3 {
+
+/**
+ * \brief MODCODs of one BBFrame or waveform configuration ordered by requirement
+ *
+ * Built once per link protocol and direction and shared by all controllers
+ * using it. Entries whose rate does not exceed the rate of a more robust one
+ * are dropped, so both the requirement and the rate increase with the index.
+ */
+class SatAcmModcodTable : public SimpleRefCount<SatAcmModcodTable>
+{
+public:
+	/**
+	 * \param conf			BBFrame configuration, frame durations are scaled to symbolRate
+	 * \param linkResults	Forward link results giving the Es/No requirement for targetBler
+	 * \param frameType		Frame type of the MODCODs
+	 * \param targetBler	BLER the requirement is computed for
+	 * \param symbolRate	Symbol rate of the carrier in baud
+	 */
+	SatAcmModcodTable(Ptr<SatBbFrameConf> conf, Ptr<SatLinkResultsFwd> linkResults,
+			SatEnums::SatBbFrameType_t frameType, double targetBler, double symbolRate);
+	/**
+	 * \brief Return direction table, one entry per DVB-RCS2 waveform of the burst length
+	 *
+	 * The requirement is the Eb/No of the return link results, compared against the
+	 * SINR the same way the return PER is evaluated.
+	 *
+	 * \param conf			Waveform configuration
+	 * \param linkResults	Return link results giving the Eb/No requirement for targetBler
+	 * \param burstLength	Burst length in symbols of the waveforms used
+	 * \param targetBler	BLER the requirement is computed for
+	 * \param symbolRate	Symbol rate of the carrier in baud
+	 */
+	SatAcmModcodTable(Ptr<SatWaveformConf> conf, Ptr<SatLinkResultsRtn> linkResults,
+			uint32_t burstLength, double targetBler, double symbolRate);
+
+	uint32_t GetN() const;
+	SatEnums::SatModcod_t GetModcod(uint32_t i) const;
+	/**
+	 * \return waveform id of a return direction entry, 0 for forward tables
+	 */
+	uint32_t GetWaveformId(uint32_t i) const;
+	bool IsReturn() const;
+	double GetEsNoRequirementDb(uint32_t i) const;
+	uint64_t GetDataRate(uint32_t i) const;
+
+	/**
+	 * \return highest entry whose requirement is met at sinrDb, 0 if none is
+	 */
+	uint32_t Select(double sinrDb) const;
+
+private:
+	/**
+	 * \brief Keep the entries that are faster than every more robust one
+	 *
+	 * \param entries (requirement, (rate, (MODCOD, waveform id)))
+	 */
+	void Build(std::vector<std::pair<double, std::pair<uint64_t, std::pair<SatEnums::SatModcod_t, uint32_t>>>>& entries);
+
+	bool m_return;
+	std::vector<SatEnums::SatModcod_t> m_modcod;
+	std::vector<uint32_t> m_waveformId;
+	std::vector<double> m_esNoDb;
+	std::vector<uint64_t> m_rate;
+};
+
+/**
+ * \brief Adaptive coding and modulation of one GSL pair
+ *
+ * Fed with the SINR of every link quality tick. The MODCOD steps down as
+ * soon as the SINR no longer meets its requirement and steps up only when
+ * the SINR exceeds the requirement of a faster MODCOD by the hysteresis.
+ * The rate is written to the transmitting device through its typed pointer,
+ * with a return direction table the waveform is switched as well.
+ */
+class SatAcmController
+{
+public:
+	SatAcmController();
+	SatAcmController(Ptr<SAGLinkLayerGSL> device, Ptr<const SatAcmModcodTable> table, double hysteresisDb);
+
+	/**
+	 * \return true if the MODCOD changed, the first update always selects one
+	 */
+	bool Update(double sinrDb);
+
+	SatEnums::SatModcod_t GetModcod() const;
+
+	/**
+	 * \brief Close the residency interval of the current MODCOD at the current time
+	 */
+	void Finalize();
+
+	Ptr<const SatAcmModcodTable> GetTable() const;
+	const std::vector<Time>& GetResidency() const;	//!< Index: table entry
+	uint32_t GetNSwitches() const;
+	Time GetLastUpdate() const;
+
+private:
+	void Apply(uint32_t i);
+
+	Ptr<SAGLinkLayerGSL> m_device;
+	Ptr<const SatAcmModcodTable> m_table;
+	double m_hysteresisDb;
+	bool m_started;
+	uint32_t m_current;					//!< Table entry in use
+	Time m_since;						//!< Start of the current residency interval
+	Time m_lastUpdate;
+	std::vector<Time> m_residency;
+	uint32_t m_switches;
+};
+
+} // namespace ns3
+
+#endif /* SAG_ACM_CONTROLLER_H */
@@ -22,6 +22,7 @@
 #include "ns3/abort.h"
 //#include "ns3/mpi-interface.h"
 #include <vector>
+#include <algorithm>
 #include "sag_aloha_channel.h"
 
 namespace ns3 {
@@ -37,13 +38,28 @@ SAGAlohaChannel::GetTypeId (void)
     .SetParent<SAGPhysicalLayerGSL> ()
     .SetGroupName ("GSL")
     .AddConstructor<SAGAlohaChannel> ()
+    .AddAttribute ("EnableCapture",
+                   "Whether the strongest of overlapping uplink packets can be received (needs the SINR of the GSL channel)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SAGAlohaChannel::m_enableCapture),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CaptureThresholdDb",
+                   "Minimum SINR in dB of a packet under interference to be captured",
+                   DoubleValue (6.0),
+                   MakeDoubleAccessor (&SAGAlohaChannel::m_captureThresholdDb),
+                   MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 SAGAlohaChannel::SAGAlohaChannel()
   :
-	SAGPhysicalLayerGSL ()
+	SAGPhysicalLayerGSL (),
+	m_enableCapture (false),
+	m_captureThresholdDb (6.0),
+	m_nextTransmissionId (0),
+	m_collisions (0),
+	m_captures (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -84,14 +100,13 @@ SAGAlohaChannel::TransmitTo(Ptr<const Packet> p, Ptr<SAGLinkLayerGSL> srcNetDevi
   else{
 
 	  // Uplink: maybe conflict
+	  uint64_t id = ConflictJudgment(delay, txTime, pktCopy, srcNetDevice);
 	  Simulator::Schedule(txTime + delay,
 	  					&SAGAlohaChannel::ReceivingJudgment,
 						this,
-						pktCopy,
-						srcNetDevice,
+						id,
 						destNetDevice
 	  );
-	  ConflictJudgment(txTime + delay, pktCopy, srcNetDevice);
 
 
   }
@@ -100,102 +115,110 @@ SAGAlohaChannel::TransmitTo(Ptr<const Packet> p, Ptr<SAGLinkLayerGSL> srcNetDevi
   return true;
 }
 
-void
-SAGAlohaChannel::ConflictJudgment (Time time, Ptr<Packet> packet, Ptr<SAGLinkLayerGSL> srcNetDevice){
-
-	if(m_channelConflictTime.first == m_channelConflictTime.second){
-
-		m_channelConflictTime.first = Simulator::Now();
-		m_channelConflictTime.second = Simulator::Now() + time;
-
-		// Record packet list
-		m_packetList[srcNetDevice].push_back(packet);
-		// Record packet conflict list
-		m_packetConflictList[packet] = false;
+double
+SAGAlohaChannel::GetUplinkSnr (Ptr<SAGLinkLayerGSL> srcNetDevice) const{
 
+	// SINRs are only computed when BER is enabled, and are stale once devices were attached or detached in the slot
+	if(m_SINRs.empty() || m_SINRs.size() != m_ground_net_devices.size()){
+		return -1;
 	}
-	else{
-		NS_ASSERT_MSG(m_channelConflictTime.second >= Simulator::Now(), "ChannelConflictTime has not been updated");
-		NS_ASSERT_MSG(m_channelConflictTime.first <= Simulator::Now(), "ChannelConflictTime has not been updated");
-		NS_ASSERT_MSG(m_packetConflictList.size() != 0, "ChannelConflictTime has not been updated");
-
-		auto pIter = m_packetList.find(srcNetDevice);
-		if(pIter != m_packetList.end() && m_packetList.size() == 1){
-			NS_ASSERT_MSG(m_packetList[srcNetDevice].size() != 0, "PacketList has not been updated");
-			// no conflict
-			// Record packet list
-			m_packetList[srcNetDevice].push_back(packet);
-			// Record packet conflict list
-			m_packetConflictList[packet] = false;
-
-			if(m_channelConflictTime.second < Simulator::Now() + time){
-				m_channelConflictTime.second = Simulator::Now() + time;
-			}
-			m_channelConflictTime.first = Simulator::Now();
-
-
-			return;
-		}
-
+	return DbToKp(GetSINR(srcNetDevice, m_sat_net_device));
 
-		// conflict occur
-		for(auto entry : m_packetConflictList){
-			m_packetConflictList[entry.first] = true;
-		}
-		m_packetConflictList[packet] = true;
-		m_packetList[srcNetDevice].push_back(packet);
+}
 
-		if(m_channelConflictTime.second < Simulator::Now() + time){
-			m_channelConflictTime.second = Simulator::Now() + time;
+uint64_t
+SAGAlohaChannel::ConflictJudgment (Time delay, Time txTime, Ptr<Packet> packet, Ptr<SAGLinkLayerGSL> srcNetDevice){
+
+	uint64_t id = m_nextTransmissionId++;
+	Transmission& tx = m_transmissions[id];
+	tx.m_start = Simulator::Now() + delay;
+	tx.m_end = tx.m_start + txTime;
+	tx.m_snr = m_enableCapture ? GetUplinkSnr(srcNetDevice) : -1;
+	tx.m_packet = packet;
+	tx.m_src = srcNetDevice;
+
+	// Active receptions ending after this one starts, those starting before it ends overlap
+	for(auto iter = m_endIndex.upper_bound(tx.m_start); iter != m_endIndex.end(); iter++){
+		Transmission& other = m_transmissions[iter->second];
+		if(other.m_start >= tx.m_end || other.m_src == srcNetDevice){
+			// packets of the same terminal are serialized by its device
+			continue;
 		}
-		m_channelConflictTime.first = Simulator::Now();
-
-
-
+		tx.m_interference.push_back({other.m_start, other.m_end, other.m_snr});
+		other.m_interference.push_back({tx.m_start, tx.m_end, tx.m_snr});
 	}
+	tx.m_endIter = m_endIndex.insert(std::make_pair(tx.m_end, id));
 
+	return id;
 
 }
 
 void
-SAGAlohaChannel::ReceivingJudgment (Ptr<Packet> packet, Ptr<SAGLinkLayerGSL> srcNetDevice, Ptr<SAGLinkLayerGSL> destNetDevice){
-
-	// update packet conflict list
-	auto iter = m_packetConflictList.find(packet);
-	NS_ASSERT_MSG(iter != m_packetConflictList.end(), "Logic Wrong");
-	if(iter->second){
-		// packet loss, some trace? todo
-		//std::cout<<srcNetDevice->GetNode()->GetId()<<"  "<<packet->GetUid()<<std::endl;
+SAGAlohaChannel::ReceivingJudgment (uint64_t id, Ptr<SAGLinkLayerGSL> destNetDevice){
+
+	auto iter = m_transmissions.find(id);
+	NS_ASSERT_MSG(iter != m_transmissions.end(), "Logic Wrong");
+	Transmission& tx = iter->second;
+
+	bool received = tx.m_interference.empty();
+	if(!received && m_enableCapture && tx.m_snr >= 0){
+		// Sweep the overlapping intervals inside this reception, ends before starts at equal times
+		std::vector<std::pair<Time, double>> events;
+		bool unknown = false;
+		for(const Interference& itf : tx.m_interference){
+			if(itf.m_snr < 0){
+				unknown = true;
+				break;
+			}
+			events.push_back(std::make_pair(std::max(itf.m_start, tx.m_start), itf.m_snr));
+			events.push_back(std::make_pair(std::min(itf.m_end, tx.m_end), -itf.m_snr));
+		}
+		if(!unknown){
+			std::sort(events.begin(), events.end());
+			double current = 0;
+			double maximum = 0;
+			for(const std::pair<Time, double>& e : events){
+				current += e.second;
+				maximum = std::max(maximum, current);
+			}
+			double sinrDb = KpToDb(tx.m_snr / (1 + maximum));
+			received = sinrDb >= m_captureThresholdDb;
+			if(received){
+				m_captures++;
+			}
+		}
 	}
-	else{
+
+	if(received){
 		// the other end of the link receiving
 		Simulator::ScheduleWithContext(
 				destNetDevice->GetNode()->GetId(),
 				Time(0),
 				&SAGAlohaNetDevice::Receive,
 				destNetDevice,
-				packet
+				tx.m_packet
 		);
-//		if(srcNetDevice->GetNode()->GetId() >= 100){
-//			std::cout<<Simulator::Now()<<"    "<<srcNetDevice->GetNode()->GetId()<<std::endl;
-//		}
-
 	}
-	m_packetConflictList.erase(iter);
-
-	// update packet list
-	auto pIter = find(m_packetList[srcNetDevice].begin(), m_packetList[srcNetDevice].end(), packet);
-	NS_ASSERT_MSG(pIter != m_packetList[srcNetDevice].end(), "Logic Wrong");
-	m_packetList[srcNetDevice].erase(pIter);
-	if(m_packetList[srcNetDevice].size() == 0){
-		m_packetList.erase(srcNetDevice);
+	else{
+		// packet loss, some trace? todo
+		m_collisions++;
+		NS_LOG_DEBUG("Collision of packet " << tx.m_packet->GetUid() << " from node " << tx.m_src->GetNode()->GetId()
+				<< " with " << tx.m_interference.size() << " overlapping transmission(s)");
 	}
 
-	if(Simulator::Now() == m_channelConflictTime.second && m_packetConflictList.size() == 0){
-		m_channelConflictTime = std::make_pair(Seconds(0), Seconds(0));
-	}
+	m_endIndex.erase(tx.m_endIter);
+	m_transmissions.erase(iter);
 
+}
+
+uint64_t
+SAGAlohaChannel::GetNCollisions () const{
+	return m_collisions;
+}
 
+uint64_t
+SAGAlohaChannel::GetNCaptures () const{
+	return m_captures;
 }
 
 } // namespace ns3
@@ -25,6 +25,8 @@
 #include "ns3/mac48-address.h"
 #include "sag_aloha_net_device.h"
 #include "ns3/sag_physical_layer_gsl.h"
+#include <map>
+#include <unordered_map>
 namespace ns3 {
 class Packet;
 class SAGAlohaChannel : public SAGPhysicalLayerGSL
@@ -45,40 +47,73 @@ public:
 	/**
 	 * \brief Maintain a Co-Channel Conflict Judgment Model
 	 *
-	 * When transmitting and propagating a data packet, if other data packet
-	 * transmission events occur, it is recorded that all current data packets
-	 * have co-channel conflicts.
+	 * Registers the reception interval [now + delay, now + delay + txTime) of an uplink
+	 * packet at the satellite and links it with every interval of another terminal that
+	 * overlaps it, even partially. Active intervals are indexed by their end time, so the
+	 * overlapping ones are found with one O(log n) lookup.
 	 *
-	 * \param time The sum of transmission delay and propagation delay
+	 * \param delay The propagation delay
+	 * \param txTime The transmission delay
 	 * \param packet The packet pointer
 	 * \param srcNetDevice Source netdevice
 	 *
+	 * \return Id of the transmission, to be passed to ReceivingJudgment
 	 */
-	void ConflictJudgment (Time time, Ptr<Packet> packet, Ptr<SAGLinkLayerGSL> srcNetDevice);
+	uint64_t ConflictJudgment (Time delay, Time txTime, Ptr<Packet> packet, Ptr<SAGLinkLayerGSL> srcNetDevice);
 
 	/**
 	 * \brief Receive event judgment
 	 *
-	 * Before triggering the data packet receiving event, it is first judged whether
-	 * a co-channel conflict occurs, and if so, the data packet is discarded, otherwise
-	 * the receiving event is triggered.
+	 * Called at the end of the reception interval. A packet without overlaps is received.
+	 * Otherwise it is only received if capture is enabled and its SINR stays above the
+	 * capture threshold while the interference is the largest, the interference being
+	 * swept over the overlapping intervals.
 	 *
-	 * \param packet The packet pointer
-	 * \param srcNetDevice Source netdevice
+	 * \param id The transmission id
 	 * \param destNetDevice Destination netdevice
 	 *
 	 */
-	void ReceivingJudgment (Ptr<Packet> packet, Ptr<SAGLinkLayerGSL> srcNetDevice, Ptr<SAGLinkLayerGSL> destNetDevice);
+	void ReceivingJudgment (uint64_t id, Ptr<SAGLinkLayerGSL> destNetDevice);
+
+	uint64_t GetNCollisions () const;
+	uint64_t GetNCaptures () const;
 
 
 private:
 
-	/// Conflict time
-	std::pair<Time, Time> m_channelConflictTime = std::make_pair(Seconds(0), Seconds(0));
-	/// Conflict list
-	std::map<Ptr<Packet>, bool> m_packetConflictList;
-	/// Packet list
-	std::map<Ptr<SAGLinkLayerGSL>, std::vector<Ptr<Packet>>> m_packetList;
+	/// Part of another transmission overlapping a reception
+	struct Interference {
+		Time m_start;
+		Time m_end;
+		double m_snr;				//!< Linear SNR at the satellite, negative if unknown
+	};
+
+	struct Transmission {
+		Time m_start;
+		Time m_end;
+		double m_snr;				//!< Linear SNR at the satellite, negative if unknown
+		Ptr<Packet> m_packet;
+		Ptr<SAGLinkLayerGSL> m_src;
+		std::multimap<Time, uint64_t>::iterator m_endIter;
+		std::vector<Interference> m_interference;
+	};
+
+	/**
+	 * \brief Linear SNR of an uplink from the values last set by the topology, negative if unknown
+	 */
+	double GetUplinkSnr (Ptr<SAGLinkLayerGSL> srcNetDevice) const;
+
+	bool m_enableCapture;						//!< Whether the strongest of overlapping packets can survive
+	double m_captureThresholdDb;				//!< Minimum SINR for capture
+
+	/// Transmissions still being received, key: transmission id
+	std::unordered_map<uint64_t, Transmission> m_transmissions;
+	/// Active transmissions ordered by end of reception
+	std::multimap<Time, uint64_t> m_endIndex;
+	uint64_t m_nextTransmissionId;
+
+	uint64_t m_collisions;
+	uint64_t m_captures;
 
 
 };
@@ -37,6 +37,11 @@ SAGCsmaChannel::GetTypeId (void)
     .SetParent<SAGPhysicalLayerGSL> ()
     .SetGroupName ("GSL")
     .AddConstructor<SAGCsmaChannel> ()
+    .AddAttribute ("BackoffSlotTime",
+                   "Length of one backoff slot of the uplink contention",
+                   TimeValue (MicroSeconds (1)),
+                   MakeTimeAccessor (&SAGCsmaChannel::m_backoffSlotTime),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -47,6 +52,33 @@ SAGCsmaChannel::SAGCsmaChannel()
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_state = IDLE;
+  m_backoffSlotTime = MicroSeconds (1);
+}
+
+void
+SAGCsmaChannel::SetState (WireState state)
+{
+  bool wasIdle = (m_state == IDLE);
+  m_state = state;
+  if (wasIdle && state != IDLE)
+    {
+      m_contention.NotifyBusy ();
+    }
+  else if (!wasIdle && state == IDLE)
+    {
+      m_contention.NotifyIdle ();
+    }
+}
+
+void
+SAGCsmaChannel::WaitForIdle (Ptr<SAGCsmaNetDevice> device, Ptr<Packet> packet, Address address, Time backoff)
+{
+  NS_LOG_FUNCTION (this << device << packet);
+  if (m_contention.GetNWaiting () == 0 && m_contention.GetSlotTime () != m_backoffSlotTime)
+    {
+      m_contention.SetSlotTime (m_backoffSlotTime);
+    }
+  m_contention.Enqueue (device, packet, address, backoff);
 }
 
 bool
@@ -88,7 +120,7 @@ SAGCsmaChannel::TransmitStart (
   }
   else if(find(m_ground_net_devices.begin(), m_ground_net_devices.end(), src) != m_ground_net_devices.end())
   {
-    m_state = TRANSMITTING;
+    SetState (TRANSMITTING);
     
     Ptr<SAGLinkLayerGSL> dst = m_sat_net_device;
     bool sameSystem = (src->GetNode()->GetSystemId() == dst->GetNode()->GetSystemId());
@@ -150,7 +182,7 @@ SAGCsmaChannel::PacketReceiving (Ptr<Packet> packet,  Ptr<SAGLinkLayerGSL> destN
 				packet
 		);
 		//state convert
-		m_state = IDLE;
+		SetState (IDLE);
 
 
 
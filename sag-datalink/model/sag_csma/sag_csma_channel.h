@@ -25,7 +25,7 @@
 #include "ns3/mac48-address.h"
 #include "sag_csma_net_device.h"
 #include "ns3/sag_physical_layer_gsl.h"
-#include "sag_csma_channel.h"
+#include "sag_csma_contention.h"
 #include <map>
 
 namespace ns3 {
@@ -69,6 +69,26 @@ public:
 	 */
 	void PacketReceiving (Ptr<Packet> packet, Ptr<SAGLinkLayerGSL> destNetDevice);
 
+	/**
+	 * \brief Let an uplink device wait until it wins a backoff slot of an idle channel
+	 *
+	 * \param device The device that found the channel busy
+	 * \param packet The packet to retry
+	 * \param address The destination address
+	 * \param backoff The backoff drawn by the device
+	 *
+	 */
+	void WaitForIdle (Ptr<SAGCsmaNetDevice> device, Ptr<Packet> packet, Address address, Time backoff);
+
+private:
+
+	/**
+	 * \brief Change the wire state, the contention manager is told about busy/idle transitions
+	 */
+	void SetState (WireState state);
+
+	SAGCsmaContentionManager m_contention;			//!< Waiting uplink devices
+	Time m_backoffSlotTime;
 
 
 
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "sag_csma_contention.h"
+#include "sag_csma_net_device.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SAGCsmaContentionManager");
+
+SAGCsmaContentionManager::SAGCsmaContentionManager ()
+  : m_slotTime (MicroSeconds (1)),
+	m_waiting (0),
+	m_cursor (0),
+	m_idle (true),
+	m_idleSince (Seconds (0))
+{
+	m_buckets.resize(1024);
+	m_occupied.resize(1024 / 64, 0);
+}
+
+SAGCsmaContentionManager::~SAGCsmaContentionManager ()
+{
+}
+
+void
+SAGCsmaContentionManager::SetSlotTime(Time slotTime){
+	NS_ASSERT_MSG(slotTime.IsStrictlyPositive(), "Backoff slot time must be positive");
+	NS_ASSERT_MSG(m_waiting == 0, "Cannot change the slot time while devices are waiting");
+	m_slotTime = slotTime;
+}
+
+Time
+SAGCsmaContentionManager::GetSlotTime() const{
+	return m_slotTime;
+}
+
+uint32_t
+SAGCsmaContentionManager::GetNWaiting() const{
+	return m_waiting;
+}
+
+void
+SAGCsmaContentionManager::Enqueue(Ptr<SAGCsmaNetDevice> device, Ptr<Packet> packet, Address address, Time backoff){
+
+	uint64_t slots = (backoff.GetTimeStep() + m_slotTime.GetTimeStep() - 1) / m_slotTime.GetTimeStep();
+	if(m_idle){
+		// slots already elapsed in the current idle period count for the new device too
+		slots += (Simulator::Now() - m_idleSince).GetTimeStep() / m_slotTime.GetTimeStep();
+	}
+	if(slots >= m_buckets.size()){
+		Grow(slots + 1);
+	}
+
+	Waiting w;
+	w.m_device = device;
+	w.m_packet = packet;
+	w.m_address = address;
+	w.m_slot = m_cursor + slots;
+	uint64_t index = w.m_slot & (m_buckets.size() - 1);
+	m_buckets[index].push_back(w);
+	m_occupied[index / 64] |= (uint64_t(1) << (index % 64));
+	m_waiting++;
+
+	NS_LOG_LOGIC("Device waits " << slots << " slot(s), " << m_waiting << " device(s) waiting");
+
+	if(m_idle){
+		ScheduleNext();
+	}
+
+}
+
+void
+SAGCsmaContentionManager::NotifyBusy(){
+
+	if(!m_idle){
+		return;
+	}
+	m_idle = false;
+	// slots before the wake slot are empty, so the clock just moves on
+	m_cursor += (Simulator::Now() - m_idleSince).GetTimeStep() / m_slotTime.GetTimeStep();
+	m_wakeEvent.Cancel();
+
+}
+
+void
+SAGCsmaContentionManager::NotifyIdle(){
+
+	if(m_idle){
+		return;
+	}
+	m_idle = true;
+	m_idleSince = Simulator::Now();
+	ScheduleNext();
+
+}
+
+void
+SAGCsmaContentionManager::ScheduleNext(){
+
+	m_wakeEvent.Cancel();
+	if(m_waiting == 0){
+		return;
+	}
+	uint64_t next = NextOccupied();
+	Time at = m_idleSince + TimeStep(m_slotTime.GetTimeStep() * (next - m_cursor));
+	m_wakeEvent = Simulator::Schedule(at - Simulator::Now(), &SAGCsmaContentionManager::Wake, this);
+
+}
+
+uint64_t
+SAGCsmaContentionManager::NextOccupied() const{
+
+	uint64_t size = m_buckets.size();
+	uint64_t words = m_occupied.size();
+	uint64_t start = m_cursor & (size - 1);
+	// first word, bits from the cursor on
+	uint64_t word = start / 64;
+	uint64_t bits = m_occupied[word] & (~uint64_t(0) << (start % 64));
+	for(uint64_t k = 0; k <= words; k++){
+		if(bits != 0){
+			uint64_t index = ((word * 64) + __builtin_ctzll(bits));
+			uint64_t offset = (index + size - start) & (size - 1);
+			return m_cursor + offset;
+		}
+		word = (word + 1) % words;
+		bits = m_occupied[word];
+		if(k + 1 == words){
+			// wrapped around to the first word, only bits before the cursor are left
+			bits &= ~(~uint64_t(0) << (start % 64));
+		}
+	}
+	NS_ASSERT_MSG(false, "Timer wheel is empty");
+	return m_cursor;
+
+}
+
+void
+SAGCsmaContentionManager::Grow(uint64_t span){
+
+	uint64_t size = m_buckets.size();
+	while(size < span){
+		size *= 2;
+	}
+	std::vector<std::vector<Waiting>> buckets(size);
+	std::vector<uint64_t> occupied(size / 64, 0);
+	for(std::vector<Waiting>& bucket : m_buckets){
+		for(Waiting& w : bucket){
+			uint64_t index = w.m_slot & (size - 1);
+			buckets[index].push_back(w);
+			occupied[index / 64] |= (uint64_t(1) << (index % 64));
+		}
+	}
+	m_buckets.swap(buckets);
+	m_occupied.swap(occupied);
+
+}
+
+void
+SAGCsmaContentionManager::Wake(){
+
+	NS_ASSERT_MSG(m_idle, "Woken while the channel is busy");
+	uint64_t slot = NextOccupied();
+	uint64_t index = slot & (m_buckets.size() - 1);
+	std::vector<Waiting> winners;
+	winners.swap(m_buckets[index]);
+	m_occupied[index / 64] &= ~(uint64_t(1) << (index % 64));
+	m_waiting -= winners.size();
+	m_cursor = slot;
+	m_idleSince = Simulator::Now();
+
+	// The first winner takes the channel, the others find it busy and back off again
+	for(Waiting& w : winners){
+		w.m_device->BackoffExpired(w.m_packet, w.m_address);
+	}
+	if(m_idle){
+		ScheduleNext();
+	}
+
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef SAG_CSMA_CONTENTION_H
+#define SAG_CSMA_CONTENTION_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/address.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class SAGCsmaNetDevice;
+
+/**
+ * \brief Channel-level backoff bookkeeping for the uplink of a CSMA GSL channel
+ *
+ * Devices that found the channel busy wait in a timer wheel whose buckets are
+ * backoff slots. Slots only elapse while the channel is idle, so backoff
+ * counters are frozen during transmissions. A single simulator event is
+ * pending at most: the end of the first occupied slot after the channel went
+ * idle. Only the devices of that slot are woken, they retry in turn and the
+ * ones finding the channel busy again draw a new backoff.
+ *
+ * Busy and idle notifications cost the same whatever the number of waiting
+ * devices: busy cancels the event and advances the virtual slot clock, idle
+ * scans the occupancy bitmap of the wheel for the next slot.
+ */
+class SAGCsmaContentionManager
+{
+public:
+	SAGCsmaContentionManager ();
+	virtual ~SAGCsmaContentionManager ();
+
+	void SetSlotTime(Time slotTime);
+	Time GetSlotTime() const;
+
+	/**
+	 * \brief Make a device wait for backoff idle slots
+	 * \param device			Device that found the channel busy
+	 * \param packet			Packet to retry
+	 * \param address			Destination of the packet
+	 * \param backoff			Backoff drawn by the device, rounded up to slots
+	 */
+	void Enqueue(Ptr<SAGCsmaNetDevice> device, Ptr<Packet> packet, Address address, Time backoff);
+
+	void NotifyBusy();
+	void NotifyIdle();
+
+	uint32_t GetNWaiting() const;
+
+private:
+	struct Waiting {
+		Ptr<SAGCsmaNetDevice> m_device;
+		Ptr<Packet> m_packet;
+		Address m_address;
+		uint64_t m_slot;				//!< Virtual idle slot the device wins at
+	};
+
+	void Grow(uint64_t span);
+	void ScheduleNext();
+	/**
+	 * \return first occupied virtual slot at or after the cursor, the wheel must not be empty
+	 */
+	uint64_t NextOccupied() const;
+	void Wake();
+
+	Time m_slotTime;
+	std::vector<std::vector<Waiting>> m_buckets;	//!< Index: virtual slot modulo wheel size
+	std::vector<uint64_t> m_occupied;				//!< Bitmap of non-empty buckets
+	uint32_t m_waiting;
+
+	uint64_t m_cursor;								//!< Virtual slot clock, counts idle slots only
+	bool m_idle;
+	Time m_idleSince;								//!< Time the cursor slot started
+	EventId m_wakeEvent;
+};
+
+} // namespace ns3
+
+#endif /* SAG_CSMA_CONTENTION_H */
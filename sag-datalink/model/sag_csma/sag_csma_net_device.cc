@@ -104,7 +104,10 @@ SAGCsmaNetDevice::TransmitStart(Ptr<Packet> p, const Address address)
 
 				NS_LOG_LOGIC("Channel busy, backing off for " << backoffTime.GetSeconds () << " sec");
 
-				Simulator::Schedule(backoffTime, &SAGCsmaNetDevice::TransmitStart, this, p, address);
+				// Backoff slots only elapse while the channel is idle, the channel wakes this device when it wins
+				Ptr<SAGCsmaChannel> channel = DynamicCast<SAGCsmaChannel>(m_channel);
+				NS_ASSERT_MSG(channel != nullptr, "SAGCsmaNetDevice must be attached to a SAGCsmaChannel");
+				channel->WaitForIdle(this, p, address, backoffTime);
 			}
 			return true;
 		}
@@ -170,6 +173,13 @@ SAGCsmaNetDevice::TransmitStart(Ptr<Packet> p, const Address address)
 }
 
 
+void
+SAGCsmaNetDevice::BackoffExpired (Ptr<Packet> p, const Address address)
+{
+	NS_LOG_FUNCTION (this << p);
+	TransmitStart (p, address);
+}
+
 void
 SAGCsmaNetDevice::TransmitComplete (const Address destination){
 
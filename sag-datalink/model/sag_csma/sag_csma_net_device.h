@@ -80,6 +80,14 @@ public:
   void SetBackoffParams (Time slotTime, uint32_t minSlots, uint32_t maxSlots,
                          uint32_t maxRetries, uint32_t ceiling);
 
+  /**
+   * \brief Called by the channel contention manager when the backoff of the device ended
+   *
+   * \param p The packet waiting for the channel
+   * \param address The destination address
+   */
+  void BackoffExpired (Ptr<Packet> p, const Address address);
+
 
 
 private:
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include <algorithm>
+#include "sag_fluid_load.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/fluid_rate_tag.h"
+
+namespace ns3 {
+
+	NS_LOG_COMPONENT_DEFINE ("SAGFluidLoad");
+
+	/// Real packets are never served at less than this share of the capacity
+	static const double MIN_RESIDUAL_CAPACITY = 0.05;
+
+	SAGFluidLoad::SAGFluidLoad()
+		: m_rateBps(0),
+		  m_capacityBps(0),
+		  m_maxBacklogBytes(0),
+		  m_backlogBytes(0),
+		  m_lastAdvanceNs(0)
+	{
+	}
+
+	SAGFluidLoad::~SAGFluidLoad(){
+		Simulator::Cancel(m_expireEvent);
+	}
+
+	void
+	SAGFluidLoad::SetChangeCallback(Callback<void> cb){
+		m_changeCallback = cb;
+	}
+
+	void
+	SAGFluidLoad::Register(Ptr<Packet> packet, uint64_t capacityBps, uint64_t maxBacklogBytes){
+		FluidRateTag tag;
+		if(!packet->PeekPacketTag(tag)){
+			return;
+		}
+		if(!m_changeCallback.IsNull()){
+			m_changeCallback();
+		}
+		Advance();
+		m_capacityBps = capacityBps;
+		m_maxBacklogBytes = maxBacklogBytes;
+
+		// the fluid above the capacity is lost once the backlog is full
+		if(m_rateBps > m_capacityBps && m_backlogBytes >= m_maxBacklogBytes){
+			packet->RemovePacketTag(tag);
+			tag.SetDeliveredFraction(tag.GetDeliveredFraction() * m_capacityBps / m_rateBps);
+			packet->AddPacketTag(tag);
+		}
+
+		if(tag.GetValidUntilNs() > Simulator::Now().GetNanoSeconds()){
+			m_flows[tag.GetFlowId()] = {tag.GetRateBps(), tag.GetValidUntilNs()};
+		}
+		else{
+			m_flows.erase(tag.GetFlowId());
+		}
+		Update();
+	}
+
+	bool
+	SAGFluidLoad::IsActive() const{
+		return m_rateBps > 0;
+	}
+
+	double
+	SAGFluidLoad::GetLoad() const{
+		if(m_rateBps == 0 || m_capacityBps == 0){
+			return 0;
+		}
+		return (double) m_rateBps / m_capacityBps;
+	}
+
+	Time
+	SAGFluidLoad::Stretch(Time txTime) const{
+		if(m_rateBps == 0){
+			return txTime;
+		}
+		return txTime / std::max(1 - GetLoad(), MIN_RESIDUAL_CAPACITY);
+	}
+
+	double
+	SAGFluidLoad::GetBacklogBytes(){
+		Advance();
+		return m_backlogBytes;
+	}
+
+	Time
+	SAGFluidLoad::GetQueueingDelay(){
+		Advance();
+		if(m_backlogBytes <= 0 || m_capacityBps == 0){
+			return Time(0);
+		}
+		return Seconds(m_backlogBytes * 8 / m_capacityBps);
+	}
+
+	void
+	SAGFluidLoad::Advance(){
+		int64_t now = Simulator::Now().GetNanoSeconds();
+		if(now > m_lastAdvanceNs && (m_rateBps > 0 || m_backlogBytes > 0)){
+			double delta = ((double) m_rateBps - (double) m_capacityBps) * (now - m_lastAdvanceNs) / 8e9;
+			m_backlogBytes = std::min(std::max(m_backlogBytes + delta, 0.0), (double) m_maxBacklogBytes);
+		}
+		m_lastAdvanceNs = now;
+	}
+
+	void
+	SAGFluidLoad::Expire(){
+		if(!m_changeCallback.IsNull()){
+			m_changeCallback();
+		}
+		Advance();
+		int64_t now = Simulator::Now().GetNanoSeconds();
+		for(auto it = m_flows.begin(); it != m_flows.end();){
+			if(it->second.m_validUntilNs <= now){
+				NS_LOG_LOGIC("Fluid flow " << it->first << " expired");
+				it = m_flows.erase(it);
+			}
+			else{
+				it++;
+			}
+		}
+		Update();
+	}
+
+	void
+	SAGFluidLoad::Update(){
+		m_rateBps = 0;
+		int64_t next = 0;
+		for(auto& flow : m_flows){
+			m_rateBps += flow.second.m_rateBps;
+			if(next == 0 || flow.second.m_validUntilNs < next){
+				next = flow.second.m_validUntilNs;
+			}
+		}
+		Simulator::Cancel(m_expireEvent);
+		if(next != 0){
+			m_expireEvent = Simulator::Schedule(NanoSeconds(next) - Simulator::Now(), &SAGFluidLoad::Expire, this);
+		}
+	}
+
+} // namespace ns3
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef SAG_FLUID_LOAD_H
+#define SAG_FLUID_LOAD_H
+
+#include <stdint.h>
+#include <map>
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+
+namespace ns3 {
+
+/**
+ * \brief Fluid traffic crossing one link layer device
+ *
+ * Fluid flows are only seen through their probes (FluidRateTag): a probe
+ * sets the rate of its flow until the validity it carries, after which the
+ * flow is dropped unless a newer probe refreshed it. The summed rate loads
+ * the device: its share of the capacity counts as busy time, real packets
+ * are served with what is left and the rate above the capacity builds a
+ * fluid backlog bounded by the queue size, which real packets wait for
+ * before they are sent.
+ */
+class SAGFluidLoad
+{
+public:
+	SAGFluidLoad();
+	~SAGFluidLoad();
+
+	/**
+	 * \brief Called just before the fluid rate changes, so that busy time is accounted with the old load
+	 */
+	void SetChangeCallback(Callback<void> cb);
+
+	/**
+	 * \brief Register the fluid of a probe and scale its delivered fraction if the backlog is full
+	 * \param capacityBps		Current data rate of the device
+	 * \param maxBacklogBytes	Size of the device queue
+	 */
+	void Register(Ptr<Packet> packet, uint64_t capacityBps, uint64_t maxBacklogBytes);
+
+	bool IsActive() const;
+
+	/**
+	 * \return fluid rate over capacity, not capped
+	 */
+	double GetLoad() const;
+
+	/**
+	 * \brief Transmission time of a real packet with the capacity left over by the fluid
+	 */
+	Time Stretch(Time txTime) const;
+
+	/**
+	 * \brief Fluid bytes queued at the current time
+	 */
+	double GetBacklogBytes();
+
+	/**
+	 * \brief Time a real packet starting now waits for the fluid backlog ahead of it
+	 */
+	Time GetQueueingDelay();
+
+private:
+	struct Flow {
+		uint64_t m_rateBps;
+		int64_t m_validUntilNs;
+	};
+
+	void Advance();
+	void Expire();
+	void Update();
+
+	Callback<void> m_changeCallback;
+	std::map<uint64_t, Flow> m_flows;		//!< Key: flow id
+	uint64_t m_rateBps;						//!< Sum of the flow rates
+	uint64_t m_capacityBps;
+	uint64_t m_maxBacklogBytes;
+	double m_backlogBytes;
+	int64_t m_lastAdvanceNs;
+	EventId m_expireEvent;
+};
+
+} // namespace ns3
+
+#endif /* SAG_FLUID_LOAD_H */
@@ -57,7 +57,7 @@ public:
    * \param txTime transmission time
    * \returns true if successful (always true)
    */
-  bool TransmitStart (Ptr<const Packet> p, Ptr<HdlcNetDevice> src, Ptr<Node> node_other_end, Time txTime);
+  virtual bool TransmitStart (Ptr<const Packet> p, Ptr<HdlcNetDevice> src, Ptr<Node> node_other_end, Time txTime);
 
   /**
   connection establishment
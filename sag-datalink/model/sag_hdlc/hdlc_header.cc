@@ -5,6 +5,7 @@
  */
 #include<ns3/hdlc_header.h>
 #include "ns3/address-utils.h"
+#include "ns3/assert.h"
 
 namespace ns3 {
 
@@ -32,6 +33,10 @@ HdlcHeader::HdlcHeader()
 	recv_seq=0;
 	send_seq=0;
 	m_protocol=0x0800;
+	m_frameType=HDLC_U_frame;
+	utype=SNRM;
+	stype=RR;
+	m_extended=false;
 }
 
 HdlcHeader::~HdlcHeader()
@@ -100,17 +105,46 @@ void HdlcHeader::SetHDLCSendseq(int send)
 	send_seq=send;
 }
 
+void HdlcHeader::SetHDLCModulus(uint32_t modulus)
+{
+	NS_ASSERT_MSG(modulus==8||modulus==128, "HDLC modulus must be 8 or 128");
+	m_extended=(modulus==128);
+}
+
+uint32_t HdlcHeader::GetHDLCModulus() const
+{
+	return m_extended ? 128 : 8;
+}
+
 uint32_t
 HdlcHeader::GetSerializedSize (void) const
 {
-  return 4;
+  return m_extended ? 5 : 4;
 }
 
 void
 HdlcHeader::Serialize (Buffer::Iterator start) const
 {
-	//address field unicast
-	start.WriteU8(0x0F);
+	//address field unicast, high bit marks the extended control field
+	start.WriteU8(m_extended ? 0x8F : 0x0F);
+	if(m_extended){
+		//extended control field, first octet: I-frame  N(S) 0
+		//S-frame 0000 S S 0 1, U-frame 000 M M 1 1; second octet N(R) p/f
+		if(m_frameType==HDLC_I_frame){
+			start.WriteU8((send_seq & 0x7F) << 1);
+			start.WriteU8((recv_seq & 0x7F) << 1);
+		}
+		else if(m_frameType==HDLC_S_frame){
+			start.WriteU8((stype << 2) | 0b01);
+			start.WriteU8((recv_seq & 0x7F) << 1);
+		}
+		else{
+			start.WriteU8((utype << 2) | 0b11);
+			start.WriteU8(0);
+		}
+		start.WriteHtonU16(m_protocol);
+		return;
+	}
 	//control field
 	//uframe  11 mn(S) p/f mn(r)
 	if(m_frameType==HDLC_U_frame){
@@ -129,9 +163,9 @@ HdlcHeader::Serialize (Buffer::Iterator start) const
 			break;
 	}}
 	if(m_frameType==HDLC_I_frame){
-	    uint8_t bits_1_to_3 = send_seq;
+	    uint8_t bits_1_to_3 = send_seq & 0b111;
 	    uint8_t bits_4 = 0b1;
-	    uint8_t bits_5_to_7 = recv_seq;
+	    uint8_t bits_5_to_7 = recv_seq & 0b111;
 	    uint8_t bits_8 = 0b0;
 	    uint8_t data = 0;
 	    data |= bits_1_to_3;
@@ -141,30 +175,31 @@ HdlcHeader::Serialize (Buffer::Iterator start) const
 	    start.WriteU8(data);
 	}
 	if(m_frameType==HDLC_S_frame){
-		if(stype==RR){
-		//RR 10001recv_seq
-	    uint8_t bits_1_to_3 = recv_seq;
+		//RR 10001recv_seq, REJ 10011recv_seq, RNR 10101recv_seq, SREJ 10111recv_seq
+	    uint8_t bits_1_to_3 = recv_seq & 0b111;
 	    uint8_t bits_4 = 0b1;
 	    uint8_t bits_5_to_7 = 0;
+	    switch (stype) {
+	    case RR:
+	    	bits_5_to_7 = 0b000;
+	    	break;
+	    case REJ:
+	    	bits_5_to_7 = 0b001;
+	    	break;
+	    case RNR:
+	    	bits_5_to_7 = 0b010;
+	    	break;
+	    case SREJ:
+	    	bits_5_to_7 = 0b011;
+	    	break;
+	    }
 	    uint8_t bits_8 = 0b1;
 	    uint8_t data = 0;
 	    data |= bits_1_to_3;
 	    data |= ( bits_4 << 3);
 	    data |= (bits_5_to_7 << 4);
 	    data |= (bits_8 << 7);
-	    start.WriteU8(data);}
-		if(stype==RNR){
-		//RNR 10101recv_seq
-	    uint8_t bits_1_to_3 = recv_seq;
-	    uint8_t bits_4 = 0b1;
-	    uint8_t bits_5_to_7 = 0b010;
-	    uint8_t bits_8 = 0b1;
-	    uint8_t data = 0;
-	    data |= bits_1_to_3;
-	    data |= ( bits_4 << 3);
-	    data |= (bits_5_to_7 << 4);
-	    data |= (bits_8 << 7);
-	    start.WriteU8(data);}
+	    start.WriteU8(data);
 	}
 	start.WriteHtonU16(m_protocol);
 }
@@ -173,7 +208,27 @@ uint32_t
 HdlcHeader::Deserialize (Buffer::Iterator start)
 {
 	uint8_t addressValue=start.ReadU8();
-	if(addressValue){}
+	m_extended=(addressValue & 0x80)!=0;
+	if(m_extended){
+		uint8_t first=start.ReadU8();
+		uint8_t second=start.ReadU8();
+		if((first & 0b1)==0){
+			m_frameType=HDLC_I_frame;
+			send_seq=first >> 1;
+			recv_seq=second >> 1;
+		}
+		else if((first & 0b11)==0b01){
+			m_frameType=HDLC_S_frame;
+			stype=SS_t((first >> 2) & 0b11);
+			recv_seq=second >> 1;
+		}
+		else{
+			m_frameType=HDLC_U_frame;
+			utype=COMMAND_t((first >> 2) & 0b11);
+		}
+		m_protocol=start.ReadNtohU16();
+		return GetSerializedSize ();
+	}
 	uint8_t receivedValue=start.ReadU8();
 	switch(receivedValue){
 	case 0b11001001:
@@ -203,21 +258,33 @@ HdlcHeader::Deserialize (Buffer::Iterator start)
 		send_seq=bit_1_3;
 		recv_seq=bit_5_7;
 	}
-	if(bit_8==1&&bit_5_7==0&&bit_4==1){
-		m_frameType=HDLC_S_frame;
-		stype=RR;
-		recv_seq=bit_1_3;
-	}
-	if(bit_8==1&&bit_5_7==0b010 &&bit_4==1){
+	if(bit_8==1&&bit_4==1&&bit_5_7<=0b011){
 		m_frameType=HDLC_S_frame;
-		stype=RNR;
+		stype=SS_t(bit_5_7);
 		recv_seq=bit_1_3;
 	}
-	uint16_t protocolvalue=start.ReadNtohU16();
-	if(protocolvalue){}
+	m_protocol=start.ReadNtohU16();
 	 return GetSerializedSize ();
 }
 
+void
+HdlcHeader::Print (std::ostream &os) const
+{
+	os << "modulus=" << GetHDLCModulus ();
+	if(m_frameType==HDLC_I_frame){
+		os << " I N(S)=" << int(send_seq) << " N(R)=" << int(recv_seq);
+	}
+	else if(m_frameType==HDLC_S_frame){
+		static const char* names[] = {"RR", "REJ", "RNR", "SREJ"};
+		os << " S " << names[stype] << " N(R)=" << int(recv_seq);
+	}
+	else{
+		static const char* names[] = {"SNRM", "DISC", "UA", "DM"};
+		os << " U " << names[utype];
+	}
+	os << " protocol=" << m_protocol;
+}
+
 void
 HdlcHeader::SetProtocol (uint16_t protocol)
 {
@@ -225,7 +292,7 @@ HdlcHeader::SetProtocol (uint16_t protocol)
 }
 
 uint16_t
-HdlcHeader::GetProtocol (void)
+HdlcHeader::GetProtocol (void) const
 {
   return m_protocol;
 }
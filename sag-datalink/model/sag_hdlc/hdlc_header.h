@@ -46,6 +46,15 @@ public:
   int GetHDLCSendseq() const;
   void SetHDLCSendseq(int send);
 
+  /**
+   * Sequence number modulus, 8 (basic, one control octet) or 128
+   * (extended, two control octets). The mode travels in the high bit of the
+   * address octet so that a frame can be decoded without link state, e.g.
+   * after crossing an MPI boundary.
+   */
+  void SetHDLCModulus(uint32_t modulus);
+  uint32_t GetHDLCModulus() const;
+
   static TypeId GetTypeId();
   virtual TypeId GetInstanceTypeId() const;
   virtual uint32_t GetSerializedSize() const;
@@ -54,17 +63,15 @@ public:
   * Serialize control field based on HDLC frame type
   * For HDLC U-frame, set control field based on utype
   * For HDLC I-frame, set control field with send_seq and recv_seq
-  * For HDLC S-frame, set control field with recv_seq
+  * For HDLC S-frame, set control field with stype and recv_seq
   * Serialize protocol field
      */
   virtual void Serialize(Buffer::Iterator start) const;
   virtual uint32_t Deserialize(Buffer::Iterator start);
 
   void SetProtocol (uint16_t protocol);
-  uint16_t GetProtocol (void);
-  void Print(std::ostream &os) const {
-      os << "HDLC Header Information";
-  };
+  uint16_t GetProtocol (void) const;
+  void Print(std::ostream &os) const;
 
 private:
   int m_saddr;
@@ -76,6 +83,7 @@ private:
   uint8_t send_seq;
   COMMAND_t utype;
   SS_t stype;
+  bool m_extended;
 };
 }
 #endif
@@ -7,6 +7,7 @@
 
 #include "hdlc_netdevice.h"
 
+#include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
@@ -25,7 +26,7 @@
 #include "hdlc_channel.h"
 #include "ns3/header.h"
 #include "ns3/timer.h"
-#define  wnd_ 10
+#include <stdexcept>
 
 namespace ns3 {
 
@@ -65,6 +66,42 @@ HdlcNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&HdlcNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("Modulus",
+                   "Sequence number modulus of the ARQ, 8 or 128 (extended control field)",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&HdlcNetDevice::SetModulus,
+                                         &HdlcNetDevice::GetModulus),
+                   MakeUintegerChecker<uint32_t> (8, 128))
+    .AddAttribute ("WindowSize",
+                   "Maximum number of outstanding I-frames, at most half the modulus",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&HdlcNetDevice::m_window),
+                   MakeUintegerChecker<uint32_t> (1, 64))
+    .AddAttribute ("ReceiveBufferSize",
+                   "Out-of-order I-frames the receiver holds before it answers RNR",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&HdlcNetDevice::m_rxBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("RetransmissionTimeout",
+                   "Time an I-frame may stay unacknowledged before it is sent again",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&HdlcNetDevice::m_retransmissionTimeout),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxRetransmissions",
+                   "Retransmissions of one I-frame before the link is reset with SNRM",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&HdlcNetDevice::m_maxRetransmissions),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("TimerTick",
+                   "Granularity of the retransmission timer wheel",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&HdlcNetDevice::m_timerTick),
+                   MakeTimeChecker ())
+    .AddAttribute ("DisconnectTimeout",
+                   "Idle time after the last send before DISC is sent",
+                   TimeValue (Seconds (20)),
+                   MakeTimeAccessor (&HdlcNetDevice::m_disconnectTimeout),
+                   MakeTimeChecker ())
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -176,18 +213,24 @@ HdlcNetDevice::HdlcNetDevice ()
     m_p2pLinkState (NORMAL),
     m_channel (0),
     m_linkUp (false),
-    m_currentPkt (0)//	m_ARQstate()//	m_ARQstate(0,0,0,0,0)
+    m_currentPkt (0),
+    m_modulus (8),
+    m_window (4),
+    m_rxBufferSize (64),
+    m_maxRetransmissions (10),
+    m_vs (0),
+    m_va (0),
+    m_vr (0),
+    m_rxBuffered (0),
+    m_peerBusy (false),
+    m_localBusy (false),
+    m_ackPending (false),
+    m_nRetransmissions (0),
+    m_nTimeouts (0)
 {
   NS_LOG_FUNCTION (this);
   m_metaData[P2PInterruptionType::Unpredictable] = false;
   m_metaData[P2PInterruptionType::Predictable] = false;
-  m_ARQstate = new ARQstate;  // 分配内存并初始化结构体实例
-  m_ARQstate->recv_seqno_ = 0;
-  m_ARQstate->SNRM_req_ = 0;
-  m_ARQstate->receive_ack=0;
-  m_ARQstate->m_packet=0;
-  m_ARQstate->rece=0;
-  m_ARQstate->m_Event=EventId();
 }
 
 HdlcNetDevice::~HdlcNetDevice ()
@@ -216,6 +259,12 @@ HdlcNetDevice::DoDispose ()
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
   m_queue = 0;
+  m_timers.Clear ();
+  m_discEvent.Cancel ();
+  m_txSlots.clear ();
+  m_rxSlots.clear ();
+  m_controlQueue.clear ();
+  m_retxQueue.clear ();
   NetDevice::DoDispose ();
 }
 
@@ -274,6 +323,20 @@ HdlcNetDevice::SetInterframeGap (Time t)
   m_tInterframeGap = t;
 }
 
+void
+HdlcNetDevice::SetModulus (uint32_t modulus)
+{
+  NS_LOG_FUNCTION (this << modulus);
+  NS_ABORT_MSG_UNLESS (modulus == 8 || modulus == 128, "HDLC modulus must be 8 or 128, not " << modulus);
+  m_modulus = modulus;
+}
+
+uint32_t
+HdlcNetDevice::GetModulus (void) const
+{
+  return m_modulus;
+}
+
 bool
 HdlcNetDevice::TransmitStart (Ptr<Packet> p)
 {
@@ -327,21 +390,207 @@ HdlcNetDevice::TransmitComplete (void)
   TrackUtilization(false);
   m_currentPkt = 0;
 
-  //std::cout<<m_queue->GetNPackets()<<std::endl;
-  Ptr<Packet> p = m_queue->Dequeue ();
-  //std::cout<<m_queue->GetNPackets()<<std::endl;
-  if (p == 0)
+  TransmitNext ();
+}
+
+void
+HdlcNetDevice::TransmitNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_txMachineState != READY)
     {
-      NS_LOG_LOGIC ("No pending packets in device queue after tx complete");
       return;
     }
 
-  //
-  // Got another packet off of the queue, so start the transmit process again.
-  //
-//  m_snifferTrace (p);
-//  m_promiscSnifferTrace (p);
-  TransmitStart (p);
+  Ptr<Packet> frame = 0;
+  if (!m_controlQueue.empty ())
+    {
+      frame = m_controlQueue.front ();
+      m_controlQueue.pop_front ();
+    }
+  else if (m_p2pLinkState == TRANSMIT && !m_txSlots.empty ())
+    {
+      while (frame == 0 && !m_retxQueue.empty ())
+        {
+          uint32_t ns = m_retxQueue.front ();
+          m_retxQueue.pop_front ();
+          m_txSlots[ns].m_retxQueued = false;
+          if (m_txSlots[ns].m_packet != 0)
+            {
+              NS_LOG_LOGIC ("Retransmit I-frame " << ns);
+              frame = CreateIFrame (ns);
+              m_nRetransmissions++;
+            }
+        }
+      if (frame == 0 && !m_peerBusy && SeqDistance (m_va, m_vs) < m_window && !m_queue->IsEmpty ())
+        {
+          // The protocol number travels in the header added by Send ()
+          Ptr<Packet> packet = m_queue->Dequeue ();
+          HdlcHeader queued;
+          packet->RemoveHeader (queued);
+          TxSlot& slot = m_txSlots[m_vs];
+          slot.m_packet = packet;
+          slot.m_protocol = queued.GetProtocol ();
+          slot.m_retries = 0;
+          slot.m_retxQueued = false;
+          frame = CreateIFrame (m_vs);
+          m_vs = SeqNext (m_vs);
+        }
+      if (frame == 0 && m_ackPending)
+        {
+          frame = CreateSupervisory (m_localBusy ? RNR : RR, m_vr);
+          m_ackPending = false;
+        }
+    }
+
+  if (frame == 0)
+    {
+      NS_LOG_LOGIC ("Nothing to send after tx complete");
+      return;
+    }
+  m_snifferTrace (frame);
+  m_promiscSnifferTrace (frame);
+  TransmitStart (frame);
+}
+
+Ptr<Packet>
+HdlcNetDevice::CreateIFrame (uint32_t ns)
+{
+  TxSlot& slot = m_txSlots[ns];
+  Ptr<Packet> frame = slot.m_packet->Copy ();
+  HdlcHeader hdlc;
+  hdlc.SetHDLCModulus (m_modulus);
+  hdlc.SetHDLCFrameType (HDLC_I_frame);
+  hdlc.SetHDLCSendseq (ns);
+  hdlc.SetHDLCReceseq (m_vr);
+  hdlc.SetProtocol (slot.m_protocol);
+  frame->AddHeader (hdlc);
+  // N(R) is piggybacked
+  m_ackPending = false;
+  m_timers.Arm (ns, m_retransmissionTimeout);
+  return frame;
+}
+
+Ptr<Packet>
+HdlcNetDevice::CreateSupervisory (SS_t stype, uint32_t nr) const
+{
+  Ptr<Packet> frame = Create<Packet> ();
+  HdlcHeader hdlc;
+  hdlc.SetHDLCModulus (m_modulus);
+  hdlc.SetHDLCFrameType (HDLC_S_frame);
+  hdlc.SetHDLCFrameSType (stype);
+  hdlc.SetHDLCReceseq (nr);
+  frame->AddHeader (hdlc);
+  return frame;
+}
+
+void
+HdlcNetDevice::SendUnnumbered (COMMAND_t utype)
+{
+  NS_LOG_FUNCTION (this << utype);
+  Ptr<Packet> frame = Create<Packet> ();
+  HdlcHeader hdlc;
+  hdlc.SetHDLCModulus (m_modulus);
+  hdlc.SetHDLCFrameType (HDLC_U_frame);
+  hdlc.SetHDLCFrameUType (utype);
+  frame->AddHeader (hdlc);
+  m_controlQueue.push_back (frame);
+  TransmitNext ();
+}
+
+void
+HdlcNetDevice::ResetArq (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_modulus == 8 || m_modulus == 128);
+  if (m_window == 0 || m_window > m_modulus / 2)
+    {
+      throw std::runtime_error ("HDLC window size must be between 1 and half the modulus for selective repeat");
+    }
+
+  for (auto& slot : m_txSlots)
+    {
+      if (slot.m_packet != 0)
+        {
+          m_macTxDropTrace (slot.m_packet);
+        }
+    }
+  m_txSlots.assign (m_modulus, TxSlot ());
+  m_rxSlots.assign (m_modulus, RxSlot ());
+  m_retxQueue.clear ();
+  m_vs = 0;
+  m_va = 0;
+  m_vr = 0;
+  m_rxBuffered = 0;
+  m_peerBusy = false;
+  m_localBusy = false;
+  m_ackPending = false;
+  m_timers.Configure (m_modulus, m_timerTick, m_retransmissionTimeout,
+                      MakeCallback (&HdlcNetDevice::RetransmissionTimeout, this));
+}
+
+void
+HdlcNetDevice::ProcessAck (uint32_t nr)
+{
+  if (SeqDistance (m_va, nr) > SeqDistance (m_va, m_vs))
+    {
+      NS_LOG_WARN ("N(R) " << nr << " outside of the send window [" << m_va << ", " << m_vs << "]");
+      return;
+    }
+  while (m_va != nr)
+    {
+      TxSlot& slot = m_txSlots[m_va];
+      slot.m_packet = 0;
+      slot.m_retries = 0;
+      m_timers.Disarm (m_va);
+      m_va = SeqNext (m_va);
+    }
+}
+
+void
+HdlcNetDevice::QueueRetransmission (uint32_t ns)
+{
+  TxSlot& slot = m_txSlots[ns];
+  if (slot.m_packet == 0 || slot.m_retxQueued || SeqDistance (m_va, ns) >= SeqDistance (m_va, m_vs))
+    {
+      return;
+    }
+  slot.m_retxQueued = true;
+  m_retxQueue.push_back (ns);
+}
+
+void
+HdlcNetDevice::RetransmissionTimeout (uint32_t ns)
+{
+  NS_LOG_FUNCTION (this << ns);
+  if (m_p2pLinkState != TRANSMIT || m_txSlots[ns].m_packet == 0)
+    {
+      return;
+    }
+  m_nTimeouts++;
+  if (++m_txSlots[ns].m_retries > m_maxRetransmissions)
+    {
+      // Both sides resynchronize on SNRM, the outstanding frames are lost
+      NS_LOG_WARN ("I-frame " << ns << " not acknowledged after " << m_maxRetransmissions << " retransmissions, resetting the link");
+      ResetArq ();
+      SendUnnumbered (SNRM);
+      SetLinkState (ESTABLISH);
+      return;
+    }
+  QueueRetransmission (ns);
+  TransmitNext ();
+}
+
+uint64_t
+HdlcNetDevice::GetNRetransmissions (void) const
+{
+  return m_nRetransmissions;
+}
+
+uint64_t
+HdlcNetDevice::GetNTimeouts (void) const
+{
+  return m_nTimeouts;
 }
 
 bool
@@ -379,127 +628,162 @@ HdlcNetDevice::SetReceiveErrorModel (Ptr<ErrorModel> em)
 void
 HdlcNetDevice::Receive (Ptr<Packet> packet)
 {
-//	std::cout<<"receive p"<<std::endl;
   NS_LOG_FUNCTION (this << packet);
   HdlcHeader hdlc;
   packet->RemoveHeader(hdlc);
   if(hdlc.GetHDLCFrameType()==HDLC_U_frame){
-  if(hdlc.GetHDLCFrameType()==HDLC_U_frame && hdlc.GetHDLCFrameUType()==SNRM){
-	//If no link is established, cache data and send SNRM frames to establish a link
-	  SetLinkState (ESTABLISH);
-	  Ptr<Packet> p = Create<Packet>();
-	  HdlcHeader hdlcn;
-	  hdlcn.SetHDLCFrameUType(UA);
-	  hdlcn.SetHDLCFrameType(HDLC_U_frame);
-	   p->AddHeader(hdlcn);
-		if (m_txMachineState == READY && m_p2pLinkState == ESTABLISH)
-		{
-		  m_snifferTrace (p);
-		  m_promiscSnifferTrace (p);
-		  if(TransmitStart (p)){
-		  SetLinkState (TRANSMIT);
-		  std::cout<<"receive SNRM and send UA"<<std::endl;}
-		}
-		return;
+    switch (hdlc.GetHDLCFrameUType ())
+      {
+      case SNRM:
+        if (hdlc.GetHDLCModulus () != m_modulus)
+          {
+            throw std::runtime_error ("HDLC modulus differs between the two ends of a link");
+          }
+        // The peer (re)starts the link, both directions begin at zero
+        ResetArq ();
+        SetLinkState (ESTABLISH);
+        SendUnnumbered (UA);
+        SetLinkState (TRANSMIT);
+        NS_LOG_INFO ("Receive SNRM and send UA");
+        break;
+      case UA:
+        SetLinkState (TRANSMIT);
+        NS_LOG_INFO ("Receive UA, transmit start");
+        break;
+      case DISC:
+        SendUnnumbered (DM);
+        SetLinkState (DISABLE);
+        NS_LOG_INFO ("Receive DISC and send DM");
+        break;
+      case DM:
+        SetLinkState (DISABLE);
+        NS_LOG_INFO ("Receive DM, transmit disable");
+        break;
+      }
+  }
+  else if (m_p2pLinkState == DISABLE || m_rxSlots.empty ()){
+    NS_LOG_LOGIC ("Numbered frame outside of a link, dropped");
+    return;
   }
-  if(hdlc.GetHDLCFrameType()==HDLC_U_frame && hdlc.GetHDLCFrameUType()==UA){
-  	  SetLinkState (TRANSMIT);
-  	  std::cout<<"receive  UA : transmit start"<<std::endl;
-  	return;}
-
-  if(hdlc.GetHDLCFrameType()==HDLC_U_frame && hdlc.GetHDLCFrameUType()==DISC){
-	//If no link is established, cache data and send SNRM frames to establish a link
-	  Ptr<Packet> p = Create<Packet>();
-	  HdlcHeader hdlcn;
-	  hdlcn.SetHDLCFrameUType(DM);
-	  hdlcn.SetHDLCFrameType(HDLC_U_frame);
-	   p->AddHeader(hdlcn);
-	m_snifferTrace (p);
-	m_promiscSnifferTrace (p);
-	if(TransmitStart (p)){
-	std::cout<<"receive DISC and send DM"<<std::endl;}
-	 SetLinkState (DISABLE);
-	 return;}
-
-  if(hdlc.GetHDLCFrameType()==HDLC_U_frame && hdlc.GetHDLCFrameUType()==DM){
-	  SetLinkState (DISABLE);
-  	  std::cout<<"receive DM : transmit disable"<<std::endl;
-  	return;}}
-
   else if(hdlc.GetHDLCFrameType()==HDLC_I_frame){
-//	  std::cout<<"receive i packet"<<std::endl;
-  if (m_p2pLinkState == DISABLE) return;
+    if (m_receiveErrorModel && m_receiveErrorModel->IsCorrupt (packet) )
+      {
+        //
+        // If we have an error model and it indicates that it is time to lose a
+        // corrupted packet, drop it; the gap is recovered by SREJ or by the
+        // retransmission timer of the sender.
+        //
+//        m_phyRxDropTrace (packet);
+      }
+    else
+      {
+        ReceiveIFrame (packet, hdlc);
+      }
+  }
+  else{
+    ReceiveSupervisory (hdlc);
+  }
+  TransmitNext ();
+}
 
-  uint16_t protocol = 0x0800;
+void
+HdlcNetDevice::ReceiveIFrame (Ptr<Packet> packet, const HdlcHeader& hdlc)
+{
+  ProcessAck (hdlc.GetHDLCReceseq () % m_modulus);
 
-  if (m_receiveErrorModel && m_receiveErrorModel->IsCorrupt (packet) )
+  uint32_t ns = hdlc.GetHDLCSendseq () % m_modulus;
+  uint16_t protocol = hdlc.GetProtocol ();
+  uint32_t offset = SeqDistance (m_vr, ns);
+  if (offset >= m_window)
     {
-      //
-      // If we have an error model and it indicates that it is time to lose a
-      // corrupted packet, don't forward this packet up, let it go.
-      //
-//      m_phyRxDropTrace (packet);
+      // Already delivered, the acknowledgement was probably lost
+      m_ackPending = true;
+      return;
     }
-  else
+
+  if (offset == 0)
     {
-      //
-      // Hit the trace hooks.  All of these hooks are in the same place in this
-      // device because it is so simple, but this is not usually the case in
-      // more complicated devices.
-      //
-//      m_snifferTrace (packet);
-//      m_promiscSnifferTrace (packet);
-//      m_phyRxEndTrace (packet);
-
-      //
-      // Trace sinks will expect complete packets, not packets without some of the
-      // headers.
-      //
-      Ptr<Packet> originalPacket = packet->Copy ();
-
-      //
-      // Strip off the point-to-point protocol header and forward this packet
-      // up the protocol stack.  Since this is a simple point-to-point link,
-      // there is no difference in what the promisc callback sees and what the
-      // normal receive callback sees.
-      //
-	Ptr<Packet> p = Create<Packet>();
-	HdlcHeader hdlcn;
-	hdlcn.SetHDLCFrameType(HDLC_S_frame);
-	int seq;
-	seq=m_ARQstate->recv_seqno_;
-	seq=seq%8;
-//	std::cout<<seq<<std::endl;
-	hdlcn.SetHDLCReceseq(seq);
-	hdlcn.SetHDLCFrameSType(RR);
-	std::cout<<"receive packet "<<m_ARQstate-> recv_seqno_<<" send RR"<<std::endl;
-	m_ARQstate->recv_seqno_++;
-	p->AddHeader(hdlcn);
-	m_snifferTrace (p);
-	m_promiscSnifferTrace (p);
-	if(TransmitStart (p)){}
-      SAGLinkDoSomethingWhenReceive(packet);
-
-
-//      }
-      //std::cout<<m_node->GetId()<<"  "<<m_destination_node->GetId()<<std::endl;
-      if (!m_promiscCallback.IsNull ())
+      Deliver (packet, protocol);
+      m_rxSlots[m_vr].m_srejSent = false;
+      m_vr = SeqNext (m_vr);
+      while (m_rxSlots[m_vr].m_packet != 0)
         {
-//          m_macPromiscRxTrace (originalPacket);
-          m_promiscCallback (this, packet, protocol, GetRemote (), GetAddress (), NetDevice::PACKET_HOST);
+          RxSlot& slot = m_rxSlots[m_vr];
+          Deliver (slot.m_packet, slot.m_protocol);
+          slot.m_packet = 0;
+          slot.m_srejSent = false;
+          m_rxBuffered--;
+          m_vr = SeqNext (m_vr);
         }
+      m_localBusy = m_rxBuffered >= m_rxBufferSize;
+      m_ackPending = true;
+      return;
+    }
 
-//      m_macRxTrace (originalPacket);
-      m_rxCallback (this, packet, protocol, GetRemote ());
+  RxSlot& slot = m_rxSlots[ns];
+  if (slot.m_packet != 0)
+    {
+      return;
     }
-  return;
-  }
-  else{
-  if(hdlc.GetHDLCFrameType()==HDLC_S_frame && hdlc.GetHDLCFrameSType()==RR) {
-	  std::cout<<"receive RR of packet"<<m_ARQstate->recv_seqno_<<std::endl;
-	  m_ARQstate->recv_seqno_++;
-	  }}
+  if (m_rxBuffered >= m_rxBufferSize)
+    {
+      // No room to reorder, only the frame at V(R) is accepted until the gap closes
+      m_localBusy = true;
+      m_ackPending = true;
+      return;
+    }
+  slot.m_packet = packet;
+  slot.m_protocol = protocol;
+  m_rxBuffered++;
+  for (uint32_t seq = m_vr; seq != ns; seq = SeqNext (seq))
+    {
+      if (m_rxSlots[seq].m_packet == 0 && !m_rxSlots[seq].m_srejSent)
+        {
+          m_rxSlots[seq].m_srejSent = true;
+          m_controlQueue.push_back (CreateSupervisory (SREJ, seq));
+        }
+    }
+}
+
+void
+HdlcNetDevice::ReceiveSupervisory (const HdlcHeader& hdlc)
+{
+  uint32_t nr = hdlc.GetHDLCReceseq () % m_modulus;
+  switch (hdlc.GetHDLCFrameSType ())
+    {
+    case RR:
+      m_peerBusy = false;
+      ProcessAck (nr);
+      break;
+    case RNR:
+      m_peerBusy = true;
+      ProcessAck (nr);
+      break;
+    case REJ:
+      m_peerBusy = false;
+      ProcessAck (nr);
+      for (uint32_t seq = m_va; seq != m_vs; seq = SeqNext (seq))
+        {
+          QueueRetransmission (seq);
+        }
+      break;
+    case SREJ:
+      QueueRetransmission (nr);
+      break;
+    }
+}
+
+void
+HdlcNetDevice::Deliver (Ptr<Packet> packet, uint16_t protocol)
+{
+  SAGLinkDoSomethingWhenReceive(packet);
+  if (!m_promiscCallback.IsNull ())
+    {
+      m_promiscCallback (this, packet, protocol, GetRemote (), GetAddress (), NetDevice::PACKET_HOST);
+    }
+  m_rxCallback (this, packet, protocol, GetRemote ());
 }
+
 Ptr<Queue<Packet>>
 HdlcNetDevice::GetQueue (void) const
 { 
@@ -651,17 +935,9 @@ HdlcNetDevice::IsBridge (void) const
 void
 HdlcNetDevice::SendDISC ()
 {
-		Ptr<Packet> p = Create<Packet>();
-		HdlcHeader hdlcn;
-		hdlcn.SetHDLCFrameUType(DISC);
-		hdlcn.SetHDLCFrameType(HDLC_U_frame);
-		p->AddHeader(hdlcn);
-		  m_snifferTrace (p);
-		  m_promiscSnifferTrace (p);
-		  std::cout << "send DISC" << std::endl;
-		  bool ret = TransmitStart (p);
-		  if(ret){;}
-		  SetLinkState(TERMINATE);
+  NS_LOG_FUNCTION (this);
+  SendUnnumbered (DISC);
+  SetLinkState (TERMINATE);
 }
 
 bool
@@ -670,105 +946,46 @@ HdlcNetDevice::Send (
   const Address &dest, 
   uint16_t protocolNumber)
 {
-
-//	std::cout << "send p" << std::endl;
   NS_LOG_FUNCTION (this << packet << dest << protocolNumber);
   NS_LOG_LOGIC ("p=" << packet << ", dest=" << &dest);
   NS_LOG_LOGIC ("UID is " << packet->GetUid ());
 
-  m_ARQstate->m_Event.Cancel();
-  m_ARQstate->m_Event=Simulator::Schedule(Seconds(20),&HdlcNetDevice::SendDISC,this);
-
-	if(m_ARQstate->SNRM_req_==0)
-	{
-		bool enq = m_queue->Enqueue (packet);
-		if (enq){
-		Ptr<Packet> p = Create<Packet>();
-		HdlcHeader hdlcn;
-		hdlcn.SetHDLCFrameUType(SNRM);
-		hdlcn.SetHDLCFrameType(HDLC_U_frame);
-		hdlcn.SetProtocol(protocolNumber);
-		p->AddHeader(hdlcn);
-		if (m_txMachineState == READY && m_p2pLinkState == NORMAL)
-		{
-		  m_snifferTrace (p);
-		  m_promiscSnifferTrace (p);
-		  m_ARQstate->SNRM_req_=1;
-		  std::cout << "send SNRM!" << std::endl;
-		  bool ret = TransmitStart (p);
-		  SetLinkState(ESTABLISH);
-		  return ret;}
-		else{
-			 return false;
-		}
-		}
-		  else{
-			  m_macTxDropTrace (packet);
-			  return false;
-		  }
-	}
-
-		if(m_p2pLinkState==TRANSMIT){
-//		  m_macTxTrace (packet);;
-
-		  SAGLinkDoSomethingWhenSend(packet);
-		  //
-		  // We should enqueue and dequeue the packet to hit the tracing hooks.
-		  //
-
-		  bool enq = m_queue->Enqueue (packet);
-		  if (enq)
-		    {
-		    	  if(m_ARQstate->seqno_==m_ARQstate->recv_seqno_){
-					packet = m_queue->Dequeue ();
-					HdlcHeader hdlcn;
-					hdlcn.SetHDLCFrameType(HDLC_I_frame);
-					int seq;
-					seq=m_ARQstate->seqno_;
-					seq=seq%8;
-					hdlcn.SetHDLCSendseq(seq);
-					hdlcn.SetProtocol(protocolNumber);
-					std::cout<<"send Iframe seqno:"<<m_ARQstate->seqno_<<std::endl;
-					packet->AddHeader(hdlcn);
-					m_snifferTrace (packet);
-					m_promiscSnifferTrace (packet);
-					bool ret = TransmitStart (packet);
-					m_ARQstate->seqno_++;
-					if(ret){
-					m_ARQstate->m_packet=packet;
-					return true;}
-		  		}
-//		    	  else{
-//			    	  std::cout<<"no send m_ARQstate->seqno_ is"<<m_ARQstate->seqno_<<"m_ARQstate->recv_seqno_ is"<<m_ARQstate->recv_seqno_<<std::endl;}
-//		    	  	  std::cout<<"resend"<<std::endl;
-//						packet = m_ARQstate->m_packet;
-//						HdlcHeader hdlcn;
-//						hdlcn.SetHDLCFrameType(HDLC_I_frame);
-//						hdlcn.SetHDLCSendseq(m_ARQstate->seqno_-1);
-//						hdlcn.SetProtocol(protocolNumber);
-//						std::cout<<"send Iframe seqno:"<<m_ARQstate->seqno_-1<<std::endl;
-//						packet->AddHeader(hdlcn);
-//						m_snifferTrace (packet);
-//						m_promiscSnifferTrace (packet);
-//						bool ret = TransmitStart (packet);
-////						m_ARQstate->seqno_++;
-//						if(ret){;}
-////						m_ARQstate->m_packet=packet;
-////						return true;}
-//		        }
-		      return true;
-		  	std::cout << m_queue->GetNPackets() << std::endl;
-		    }
-		  else{
-			  std::cout<<"m_p2pLinkState is not TRANSMIT"<<std::endl;
-//			  m_macTxDropTrace (packet);
-			  return false;
-		  }
-		}
-
-////   Stick a point to point protocol header on the packet in preparation for
-////   shoving it out the door.
-		return false;
+  m_discEvent.Cancel ();
+  m_discEvent = Simulator::Schedule (m_disconnectTimeout, &HdlcNetDevice::SendDISC, this);
+
+  if (m_p2pLinkState == DISABLE || m_p2pLinkState == TERMINATE)
+    {
+      m_macTxDropTrace (packet);
+      return false;
+    }
+
+  SAGLinkDoSomethingWhenSend(packet);
+
+  //
+  // The header only keeps the protocol number while the packet is queued,
+  // the sequence numbers are set when the I-frame leaves.
+  //
+  HdlcHeader hdlc;
+  hdlc.SetHDLCModulus (m_modulus);
+  hdlc.SetHDLCFrameType (HDLC_I_frame);
+  hdlc.SetProtocol (protocolNumber);
+  packet->AddHeader (hdlc);
+  if (!m_queue->Enqueue (packet))
+    {
+      m_macTxDropTrace (packet);
+      return false;
+    }
+
+  if (m_p2pLinkState == NORMAL)
+    {
+      // If no link is established, keep the data queued and send SNRM first
+      ResetArq ();
+      SendUnnumbered (SNRM);
+      SetLinkState (ESTABLISH);
+      NS_LOG_INFO ("Send SNRM");
+    }
+  TransmitNext ();
+  return true;
 }
 
 uint32_t
@@ -20,9 +20,11 @@
 #include "ns3/mac48-address.h"
 #include <map>
 #include "ns3/network-module.h" // 用于 Packet 类
+#include <deque>
 #include<ns3/hdlc_header.h>
 #include "ns3/header.h"
 #include "ns3/sag_link_layer.h"
+#include "hdlc_timer_wheel.h"
 namespace ns3 {
 
 template <typename Item> class Queue;
@@ -32,15 +34,6 @@ class ErrorModel;
 class HdlcHeader;
 
 
-struct ARQstate {
-	int seqno_;
-	int recv_seqno_;
-	int receive_ack=0;
-	Ptr<Packet> m_packet;// Cached packet
-	int rece=0;
-	int SNRM_req_;     // whether a SNRM request has been sent or not
-	EventId m_Event;
-};
 /**
  * This HdlcNetDevice class specializes the NetDevice abstract
  * base class.  Together with a HdlcChannel (and a peer
@@ -49,6 +42,16 @@ struct ARQstate {
  * Key parameters or objects that can be specified for this device 
  * include a queue, data rate, and interframe transmission gap (the 
  * propagation delay is set in the HdlcChannel).
+ *
+ * Data frames are protected by a selective-repeat ARQ: up to WindowSize
+ * I-frames are outstanding, the receiver buffers out-of-order frames and asks
+ * for the missing ones with SREJ, acknowledges cumulatively with RR (or
+ * piggybacked N(R)) and answers RNR while its reorder buffer is full. RNR
+ * only pauses new I-frames, retransmissions still go out so that the gap
+ * holding the reorder buffer can be filled. All
+ * retransmission timers of the link live in one HdlcTimerWheel. Every frame
+ * carries its own header state, so the same machine runs over an
+ * HdlcRemoteChannel in distributed runs.
  */
 class HdlcNetDevice : public SAGLinkLayer
 {
@@ -93,6 +96,18 @@ public:
    */
   void SetInterframeGap (Time t);
 
+  /**
+   * Set the sequence number modulus of the ARQ, aborts unless it is 8 or 128
+   *
+   * \param modulus the sequence number modulus
+   */
+  void SetModulus (uint32_t modulus);
+
+  /**
+   * \returns the sequence number modulus of the ARQ
+   */
+  uint32_t GetModulus (void) const;
+
   /**
    * Attach the device to a channel.
    *
@@ -119,6 +134,9 @@ public:
   Ptr<Queue<Packet> > GetQueue (void) const;
 
   void SendDISC ();
+
+  uint64_t GetNRetransmissions (void) const;
+  uint64_t GetNTimeouts (void) const;
   /**
    * Attach a receive ErrorModel to the HdlcNetDevice.
    *
@@ -281,6 +299,39 @@ private:
    */
   void TransmitComplete (void);
 
+  /**
+   * \brief Start the next frame if the transmitter is idle
+   *
+   * Order: pending U and S frames, requested retransmissions, new I-frames
+   * while the send window is open, then a standalone RR/RNR if an
+   * acknowledgement could not be piggybacked.
+   */
+  void TransmitNext (void);
+
+  void SendUnnumbered (COMMAND_t utype);
+  Ptr<Packet> CreateSupervisory (SS_t stype, uint32_t nr) const;
+  /**
+   * \brief Frame the payload of send slot ns with the current N(R) and start its timer
+   */
+  Ptr<Packet> CreateIFrame (uint32_t ns);
+
+  /**
+   * \brief Reset both halves of the ARQ, outstanding frames are dropped
+   */
+  void ResetArq (void);
+  void ReceiveIFrame (Ptr<Packet> packet, const HdlcHeader& hdlc);
+  void ReceiveSupervisory (const HdlcHeader& hdlc);
+  /**
+   * \brief Release the frames acknowledged by N(R)
+   */
+  void ProcessAck (uint32_t nr);
+  void QueueRetransmission (uint32_t ns);
+  void RetransmissionTimeout (uint32_t ns);
+  void Deliver (Ptr<Packet> packet, uint16_t protocol);
+
+  uint32_t SeqNext (uint32_t seq) const { return (seq + 1) % m_modulus; }
+  uint32_t SeqDistance (uint32_t from, uint32_t to) const { return (to + m_modulus - from) % m_modulus; }
+
   /**
    * \brief Make the link up and running
    *
@@ -479,8 +530,42 @@ private:
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
 
-  //add
-   ARQstate* m_ARQstate;
+  struct TxSlot {
+    Ptr<Packet> m_packet;     //!< Payload without HDLC header, 0 once acknowledged
+    uint16_t m_protocol;
+    uint32_t m_retries;
+    bool m_retxQueued;        //!< Already waiting in m_retxQueue
+  };
+  struct RxSlot {
+    Ptr<Packet> m_packet;     //!< Buffered out-of-order payload
+    uint16_t m_protocol;
+    bool m_srejSent;          //!< Frame was asked for with SREJ
+  };
+
+  uint32_t m_modulus;         //!< Sequence number modulus, 8 or 128
+  uint32_t m_window;          //!< Maximum outstanding I-frames, at most m_modulus / 2
+  uint32_t m_rxBufferSize;    //!< Out-of-order frames held before answering RNR
+  uint32_t m_maxRetransmissions;
+  Time m_retransmissionTimeout;
+  Time m_timerTick;
+  Time m_disconnectTimeout;
+
+  uint32_t m_vs;              //!< V(S), next new sequence number
+  uint32_t m_va;              //!< V(A), oldest unacknowledged sequence number
+  uint32_t m_vr;              //!< V(R), next in-order sequence number expected
+  uint32_t m_rxBuffered;
+  bool m_peerBusy;            //!< Peer answered RNR
+  bool m_localBusy;           //!< RNR is being advertised
+  bool m_ackPending;          //!< N(R) changed since it was last sent
+  std::vector<TxSlot> m_txSlots;
+  std::vector<RxSlot> m_rxSlots;
+  std::deque<Ptr<Packet> > m_controlQueue;  //!< U and S frames, sent first
+  std::deque<uint32_t> m_retxQueue;
+  HdlcTimerWheel m_timers;
+  EventId m_discEvent;
+
+  uint64_t m_nRetransmissions;
+  uint64_t m_nTimeouts;
 
 
 public:
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include <algorithm>
+#include "hdlc_timer_wheel.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+	NS_LOG_COMPONENT_DEFINE ("HdlcTimerWheel");
+
+	HdlcTimerWheel::HdlcTimerWheel ()
+		: m_tickNs(1000000),
+		  m_armed(0),
+		  m_entries(0),
+		  m_cursor(0),
+		  m_scheduledTick(0),
+		  m_generation(0)
+	{
+	}
+
+	HdlcTimerWheel::~HdlcTimerWheel ()
+	{
+		m_event.Cancel();
+	}
+
+	void
+	HdlcTimerWheel::Configure(uint32_t keys, Time tick, Time horizon, Callback<void, uint32_t> expire){
+		NS_ASSERT_MSG(tick.IsStrictlyPositive(), "Timer wheel tick must be positive");
+		NS_ASSERT_MSG(horizon.IsPositive(), "Timer wheel horizon must not be negative");
+		Clear();
+		m_tickNs = tick.GetNanoSeconds();
+		// An armed tick lies at most one horizon after the current tick, which
+		// itself lies at most one horizon after the cursor
+		uint64_t span = 2 * (horizon.GetNanoSeconds() / m_tickNs + 2);
+		uint64_t size = 1;
+		while(size < span){
+			size <<= 1;
+		}
+		m_buckets.assign(size, std::vector<std::pair<uint32_t, uint64_t>>());
+		m_deadline.assign(keys, 0);
+		m_expire = expire;
+		m_cursor = CurrentTick();
+	}
+
+	uint64_t
+	HdlcTimerWheel::CurrentTick() const{
+		return Simulator::Now().GetNanoSeconds() / m_tickNs;
+	}
+
+	void
+	HdlcTimerWheel::Arm(uint32_t key, Time timeout){
+		NS_ASSERT_MSG(key < m_deadline.size(), "Timer key out of range");
+		if(m_entries == 0){
+			m_cursor = CurrentTick();
+		}
+		int64_t expiryNs = (Simulator::Now() + timeout).GetNanoSeconds();
+		uint64_t tick = (expiryNs + m_tickNs - 1) / m_tickNs;
+		if(tick <= m_cursor){
+			tick = m_cursor + 1;
+		}
+		NS_ASSERT_MSG(tick - m_cursor < m_buckets.size(), "Timeout beyond the horizon of the timer wheel");
+
+		if(m_deadline[key] == 0){
+			m_armed++;
+		}
+		m_deadline[key] = tick;
+		m_buckets[tick & (m_buckets.size() - 1)].push_back(std::make_pair(key, tick));
+		m_entries++;
+
+		if(!m_event.IsRunning() || tick < m_scheduledTick){
+			m_event.Cancel();
+			m_scheduledTick = tick;
+			m_event = Simulator::Schedule(NanoSeconds(tick * m_tickNs) - Simulator::Now(), &HdlcTimerWheel::Expire, this);
+		}
+	}
+
+	void
+	HdlcTimerWheel::Disarm(uint32_t key){
+		NS_ASSERT_MSG(key < m_deadline.size(), "Timer key out of range");
+		if(m_deadline[key] != 0){
+			m_deadline[key] = 0;
+			m_armed--;
+		}
+	}
+
+	bool
+	HdlcTimerWheel::IsArmed(uint32_t key) const{
+		return key < m_deadline.size() && m_deadline[key] != 0;
+	}
+
+	void
+	HdlcTimerWheel::Clear(){
+		m_event.Cancel();
+		for(auto& bucket : m_buckets){
+			bucket.clear();
+		}
+		std::fill(m_deadline.begin(), m_deadline.end(), 0);
+		m_armed = 0;
+		m_entries = 0;
+		m_generation++;
+	}
+
+	uint32_t
+	HdlcTimerWheel::GetNArmed() const{
+		return m_armed;
+	}
+
+	void
+	HdlcTimerWheel::ScheduleNext(){
+		m_event.Cancel();
+		if(m_entries == 0){
+			return;
+		}
+		uint64_t mask = m_buckets.size() - 1;
+		for(uint64_t tick = m_cursor + 1; tick <= m_cursor + m_buckets.size(); tick++){
+			if(!m_buckets[tick & mask].empty()){
+				m_scheduledTick = tick;
+				m_event = Simulator::Schedule(NanoSeconds(tick * m_tickNs) - Simulator::Now(), &HdlcTimerWheel::Expire, this);
+				return;
+			}
+		}
+		NS_ASSERT_MSG(false, "Timer wheel entries outside of the wheel");
+	}
+
+	void
+	HdlcTimerWheel::Expire(){
+		uint64_t now = m_scheduledTick;
+		uint64_t mask = m_buckets.size() - 1;
+		uint64_t generation = m_generation;
+		std::vector<std::pair<uint32_t, uint64_t>> due;
+		for(uint64_t tick = m_cursor + 1; tick <= now; tick++){
+			// Expiry callbacks may arm new timers in the bucket being processed
+			due.clear();
+			due.swap(m_buckets[tick & mask]);
+			m_cursor = tick;
+			for(auto& entry : due){
+				m_entries--;
+				if(m_deadline[entry.first] != entry.second){
+					continue;
+				}
+				m_deadline[entry.first] = 0;
+				m_armed--;
+				m_expire(entry.first);
+				if(m_generation != generation){
+					// Cleared by the callback, timers armed since then scheduled their own event
+					return;
+				}
+			}
+		}
+		ScheduleNext();
+	}
+
+} // namespace ns3
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef HDLC_TIMER_WHEEL_H
+#define HDLC_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \brief Retransmission timers of one HDLC link
+ *
+ * Timers are keyed by sequence number and rounded up to a tick. Every bucket
+ * of the wheel holds the keys expiring at the ticks congruent to its index, so
+ * arming a timer is a push_back and disarming it only clears the deadline of
+ * the key; stale bucket entries are skipped when their tick is reached. At
+ * most one simulator event is pending, at the first occupied tick.
+ */
+class HdlcTimerWheel
+{
+public:
+	HdlcTimerWheel ();
+	virtual ~HdlcTimerWheel ();
+
+	/**
+	 * \param keys			Number of keys, i.e. the sequence number modulus
+	 * \param tick			Timer granularity
+	 * \param horizon		Longest timeout that will be armed
+	 * \param expire		Called with the key of every timer that runs out
+	 */
+	void Configure(uint32_t keys, Time tick, Time horizon, Callback<void, uint32_t> expire);
+
+	/**
+	 * \brief Start or restart the timer of key
+	 */
+	void Arm(uint32_t key, Time timeout);
+	void Disarm(uint32_t key);
+	bool IsArmed(uint32_t key) const;
+
+	/**
+	 * \brief Disarm all timers and cancel the pending event
+	 */
+	void Clear();
+
+	uint32_t GetNArmed() const;
+
+private:
+	uint64_t CurrentTick() const;
+	void ScheduleNext();
+	void Expire();
+
+	int64_t m_tickNs;
+	std::vector<std::vector<std::pair<uint32_t, uint64_t>>> m_buckets;	//!< Index: tick modulo wheel size, entries (key, tick)
+	std::vector<uint64_t> m_deadline;		//!< Tick every key expires at, 0 when disarmed
+	uint32_t m_armed;
+	uint32_t m_entries;						//!< Bucket entries, stale ones included
+	uint64_t m_cursor;						//!< Tick of the last processed bucket
+	uint64_t m_scheduledTick;
+	uint64_t m_generation;					//!< Incremented by Clear ()
+	EventId m_event;
+	Callback<void, uint32_t> m_expire;
+};
+
+} // namespace ns3
+
+#endif /* HDLC_TIMER_WHEEL_H */
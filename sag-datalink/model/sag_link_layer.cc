@@ -20,6 +20,7 @@
  * 
  */
 
+#include <algorithm>
 #include "sag_link_layer.h"
 
 #include "ns3/log.h"
@@ -55,6 +56,7 @@ SAGLinkLayer::GetTypeId (void)
 SAGLinkLayer::SAGLinkLayer ()
 {
     NS_LOG_FUNCTION (this);
+    m_fluidLoad.SetChangeCallback(MakeCallback(&SAGLinkLayer::CheckpointFluidUtilization, this));
 }
 
 SAGLinkLayer::~SAGLinkLayer ()
@@ -329,6 +331,18 @@ SAGLinkLayer::GetMtu (void) const
 }
 
 
+void
+SAGLinkLayer::SetScheduledUpUntil(Time until)
+{
+  m_scheduledUpUntil = until;
+}
+
+Time
+SAGLinkLayer::GetScheduledUpUntil() const
+{
+  return m_scheduledUpUntil;
+}
+
 void
 SAGLinkLayer::EnableUtilizationTracking(int64_t interval_ns) {
     m_utilization_tracking_enabled = true;
@@ -351,7 +365,7 @@ SAGLinkLayer::TrackUtilization(bool next_state_is_on) {
 
             // Add everything until the end of the interval
             if (next_state_is_on) {
-                m_idle_time_counter_ns += m_current_interval_end - m_prev_time_ns;
+                AccountIdleTime(m_current_interval_end - m_prev_time_ns);
             } else {
                 m_busy_time_counter_ns += m_current_interval_end - m_prev_time_ns;
             }
@@ -372,7 +386,7 @@ SAGLinkLayer::TrackUtilization(bool next_state_is_on) {
 
         // If not at the end of a new interval, just keep track of it all
         if (next_state_is_on) {
-            m_idle_time_counter_ns += now_ns - m_prev_time_ns;
+            AccountIdleTime(now_ns - m_prev_time_ns);
         } else {
             m_busy_time_counter_ns += now_ns - m_prev_time_ns;
         }
@@ -386,6 +400,27 @@ SAGLinkLayer::TrackUtilization(bool next_state_is_on) {
 
 
 
+void
+SAGLinkLayer::AccountIdleTime(int64_t duration_ns) {
+    // The fluid keeps its share of the idle time busy
+    int64_t fluid_ns = 0;
+    if (m_fluidLoad.IsActive()) {
+        fluid_ns = (int64_t) (duration_ns * std::min(m_fluidLoad.GetLoad(), 1.0));
+    }
+    m_busy_time_counter_ns += fluid_ns;
+    m_idle_time_counter_ns += duration_ns - fluid_ns;
+}
+
+void
+SAGLinkLayer::CheckpointFluidUtilization() {
+    if (!m_utilization_tracking_enabled) {
+        return;
+    }
+    bool current_state_is_on = m_current_state_is_on;
+    TrackUtilization(!current_state_is_on);
+    m_current_state_is_on = current_state_is_on;
+}
+
 const std::vector<double>&
 SAGLinkLayer::FinalizeUtilization() {
     TrackUtilization(!m_current_state_is_on);
@@ -34,6 +34,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
+#include "ns3/sag_fluid_load.h"
 
 
 namespace ns3
@@ -213,9 +214,26 @@ public:
     void EnableUtilizationTracking(int64_t interval_ns);
     const std::vector<double>& FinalizeUtilization();
 
+    /**
+     * \brief Time up to which the regular ISL schedule keeps this link up
+     *
+     * Set by the topology for links whose disconnection it can predict, zero
+     * when the link may go down at any time. Routing protocols use it to stop
+     * probing a link whose liveness is already known.
+     */
+    void SetScheduledUpUntil(Time until);
+    Time GetScheduledUpUntil() const;
+
 protected:
     void TrackUtilization(bool next_state_is_on);
 
+    /**
+     * \brief Account the time since the last call with the fluid load it had
+     */
+    void CheckpointFluidUtilization();
+
+    SAGFluidLoad m_fluidLoad;		//!< Fluid flows crossing this device
+
 private:
   bool m_utilization_tracking_enabled = false;
   int64_t m_interval_ns;
@@ -226,6 +244,9 @@ private:
   int64_t m_busy_time_counter_ns;
   bool m_current_state_is_on;
   std::vector<double> m_utilization;
+  void AccountIdleTime(int64_t duration_ns);
+
+  Time m_scheduledUpUntil = Time(0);		//!< Zero when the disconnection is unpredictable
 
 };
 
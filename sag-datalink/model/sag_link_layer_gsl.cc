@@ -18,6 +18,7 @@
  */
 
 
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
@@ -218,9 +219,11 @@ SAGLinkLayerGSL::SAGLinkLayerGSL ()
     m_txMachineState (READY),
     m_channel (0),
     m_linkUp (false),
-    m_currentPkt (0)
+    m_currentPkt (0),
+    m_modCodfwd (SatEnums::SAT_NONVALID_MODCOD)
 {
   NS_LOG_FUNCTION (this);
+  m_fluidLoad.SetChangeCallback (MakeCallback (&SAGLinkLayerGSL::CheckpointFluidUtilization, this));
 }
 
 SAGLinkLayerGSL::~SAGLinkLayerGSL ()
@@ -300,7 +303,8 @@ SAGLinkLayerGSL::DoDispose ()
 }
 
 void SAGLinkLayerGSL::UpdateDataRate (){
-	if(this->GetInstanceTypeId() == TypeId::LookupByName ("ns3::SAGLinkLayerGSL")){
+	static const TypeId gslTid = SAGLinkLayerGSL::GetTypeId ();
+	if(this->GetInstanceTypeId() == gslTid){
 		// just for fdma
 		SetDataRate(m_bps.GetBitRate() / m_maxFeederLinkNumber);
 //		if(m_channel->GetDevice(0)->GetNode()->GetId() != m_node->GetId()){
@@ -322,6 +326,40 @@ SAGLinkLayerGSL::SetDataRate (DataRate bps)
   m_bps = bps;
 }
 
+void
+SAGLinkLayerGSL::SetModcodDataRate (SatEnums::SatModcod_t modcod, DataRate bps)
+{
+  NS_LOG_FUNCTION (this << modcod);
+  static const TypeId gslTid = SAGLinkLayerGSL::GetTypeId ();
+  m_modCodfwd = modcod;
+  // same fdma share as UpdateDataRate ()
+  if (this->GetInstanceTypeId () == gslTid)
+    {
+      SetDataRate (bps.GetBitRate () / m_maxFeederLinkNumber);
+    }
+  else
+    {
+      SetDataRate (bps);
+    }
+}
+
+void
+SAGLinkLayerGSL::SetWaveformDataRate (uint32_t waveformId, DataRate bps)
+{
+  NS_LOG_FUNCTION (this << waveformId);
+  static const TypeId gslTid = SAGLinkLayerGSL::GetTypeId ();
+  m_waveformId = std::to_string (waveformId);
+  // same fdma share as UpdateDataRate ()
+  if (this->GetInstanceTypeId () == gslTid)
+    {
+      SetDataRate (bps.GetBitRate () / m_maxFeederLinkNumber);
+    }
+  else
+    {
+      SetDataRate (bps);
+    }
+}
+
 void
 SAGLinkLayerGSL::SetInterframeGap (Time t)  //frame interval ?
 {
@@ -354,7 +392,8 @@ SAGLinkLayerGSL::TransmitStart (Ptr<Packet> p, const Address dest)
 //  else{
 //	  txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
 //  }
-  Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+  // the fluid backlog ahead of the packet is sent first
+  Time txTime = m_fluidLoad.GetQueueingDelay () + m_fluidLoad.Stretch (m_bps.CalculateBytesTxTime (p->GetSize ()));
   Time txCompleteTime = txTime + m_tInterframeGap;         //transmit delay
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
@@ -574,7 +613,9 @@ SAGLinkLayerGSL::GetQueueOccupancyRate(){
 	NS_LOG_FUNCTION (this);
 	auto npkt = this->GetQueue()->GetNPackets();
 	auto tkpt = this->GetQueue()->GetMaxSize().GetValue();
-	return (double)npkt / tkpt * 100.0;
+	// fluid backlog in MTU sized packets
+	double fluid = m_fluidLoad.GetBacklogBytes() / GetMtu();
+	return std::min((npkt + fluid) / tkpt * 100.0, 100.0);
 }
 
 uint32_t
@@ -726,6 +767,8 @@ SAGLinkLayerGSL::Send (
 
   m_macTxTrace (packet);
 
+  m_fluidLoad.Register (packet, m_bps.GetBitRate (), (uint64_t) GetMaxsize () * GetMtu ());
+
   //
   // We should enqueue and dequeue the packet to hit the tracing hooks.
   //
@@ -876,7 +919,7 @@ SAGLinkLayerGSL::TrackUtilization(bool next_state_is_on) {
 
             // Add everything until the end of the interval
             if (next_state_is_on) {
-                m_idle_time_counter_ns += m_current_interval_end - m_prev_time_ns;
+                AccountIdleTime(m_current_interval_end - m_prev_time_ns);
             } else {
                 m_busy_time_counter_ns += m_current_interval_end - m_prev_time_ns;
             }
@@ -897,7 +940,7 @@ SAGLinkLayerGSL::TrackUtilization(bool next_state_is_on) {
 
         // If not at the end of a new interval, just keep track of it all
         if (next_state_is_on) {
-            m_idle_time_counter_ns += now_ns - m_prev_time_ns;
+            AccountIdleTime(now_ns - m_prev_time_ns);
         } else {
             m_busy_time_counter_ns += now_ns - m_prev_time_ns;
         }
@@ -911,6 +954,27 @@ SAGLinkLayerGSL::TrackUtilization(bool next_state_is_on) {
 
 
 
+void
+SAGLinkLayerGSL::AccountIdleTime(int64_t duration_ns) {
+    // The fluid keeps its share of the idle time busy
+    int64_t fluid_ns = 0;
+    if (m_fluidLoad.IsActive()) {
+        fluid_ns = (int64_t) (duration_ns * std::min(m_fluidLoad.GetLoad(), 1.0));
+    }
+    m_busy_time_counter_ns += fluid_ns;
+    m_idle_time_counter_ns += duration_ns - fluid_ns;
+}
+
+void
+SAGLinkLayerGSL::CheckpointFluidUtilization() {
+    if (!m_utilization_tracking_enabled) {
+        return;
+    }
+    bool current_state_is_on = m_current_state_is_on;
+    TrackUtilization(!current_state_is_on);
+    m_current_state_is_on = current_state_is_on;
+}
+
 const std::vector<double>&
 SAGLinkLayerGSL::FinalizeUtilization() {
     TrackUtilization(!m_current_state_is_on);
@@ -979,12 +1043,16 @@ void
 SAGLinkLayerGSL::SetTxMCS (std::string modCodStringfwd)
 {
 	m_modCodStringfwd = modCodStringfwd;
+	m_modCodfwd = SatEnums::SAT_NONVALID_MODCOD;
 }
 SatEnums::SatModcod_t
 SAGLinkLayerGSL::GetTxMCS (void)
 {
-	//SatEnums::GetModcodFromName(m_modCodStringfwd)
-	return SatEnums::GetModcodFromName(m_modCodStringfwd);
+	// resolved once, the name lookup is a long chain of string comparisons
+	if (m_modCodfwd == SatEnums::SAT_NONVALID_MODCOD){
+		m_modCodfwd = SatEnums::GetModcodFromName(m_modCodStringfwd);
+	}
+	return m_modCodfwd;
 }
 Ptr<CircularApertureAntennaModel>
 SAGLinkLayerGSL::GetAntennaModel (){
@@ -995,16 +1063,22 @@ SAGLinkLayerGSL::GetAntennaModel (){
 Ptr<SatLinkResultsRtn>
 SAGLinkLayerGSL::GetLinkResultsRTN (void)
 {
-	m_linkresultrtn = CreateObject<SatLinkResultsDvbRcs2>();
-	m_linkresultrtn->SetBaseDir(m_baseDir);
-	m_linkresultrtn->Initialize();
+	if (m_linkresultrtn == nullptr){
+		m_linkresultrtn = CreateObject<SatLinkResultsDvbRcs2>();
+		m_linkresultrtn->SetBaseDir(m_baseDir);
+		m_linkresultrtn->Initialize();
+	}
 	return m_linkresultrtn;
 }
 Ptr<SatLinkResultsFwd>
 SAGLinkLayerGSL::GetLinkResultsFWD (void)
 {
-	SetProtocol(m_protocolString);
-	m_linkresultfwd->Initialize();
+	// rebuilt only when the protocol changed since the last call
+	if (m_linkresultfwd == nullptr || m_linkresultfwdProtocol != m_protocolString){
+		SetProtocol(m_protocolString);
+		m_linkresultfwd->Initialize();
+		m_linkresultfwdProtocol = m_protocolString;
+	}
 	return m_linkresultfwd;
 }
 void
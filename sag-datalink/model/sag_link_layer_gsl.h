@@ -34,6 +34,7 @@
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
 #include "ns3/node-container.h"
+#include "ns3/sag_fluid_load.h"
 #include "ns3/satellite-position-mobility-model.h"
 
 #include "ns3/propagation-loss-model.h"
@@ -522,6 +523,14 @@ protected:
   bool m_current_state_is_on;
   std::vector<double> m_utilization;
   void TrackUtilization(bool next_state_is_on);
+  void AccountIdleTime(int64_t duration_ns);
+
+  /**
+   * \brief Account the time since the last call with the fluid load it had
+   */
+  void CheckpointFluidUtilization();
+
+  SAGFluidLoad m_fluidLoad;		//!< Fluid flows crossing this device
 
 public:
     void EnableUtilizationTracking(int64_t interval_ns);
@@ -547,6 +556,7 @@ protected:
     Ptr<CircularApertureAntennaModel> m_AntennaModel = CreateObject<CircularApertureAntennaModel>();//CircularApertureAntennaModel
     Ptr<SatLinkResultsRtn> m_linkresultrtn;//from sat to gs
     Ptr<SatLinkResultsFwd> m_linkresultfwd; //from gs to satellite  dvb_s2/s2x
+    std::string m_linkresultfwdProtocol; //protocol m_linkresultfwd was built for
 
     std::string m_baseDir;
 
@@ -574,6 +584,18 @@ public:
     std::string SetTxProtocol (void);
     void SetTxMCS (std::string modCodStringfwd);
     SatEnums::SatModcod_t GetTxMCS (void);
+    /**
+     * \brief Switch the transmit MODCOD and the data rate it yields, used by SatAcmController
+     *
+     * \param bps Rate of the MODCOD on the whole carrier, shared like in UpdateDataRate ()
+     */
+    void SetModcodDataRate (SatEnums::SatModcod_t modcod, DataRate bps);
+    /**
+     * \brief Switch the return waveform and the data rate it yields, used by SatAcmController
+     *
+     * \param bps Rate of the waveform on the whole carrier, shared like in UpdateDataRate ()
+     */
+    void SetWaveformDataRate (uint32_t waveformId, DataRate bps);
     SatEnums::SatBbFrameType_t GetFrameType(void);
     Ptr<CircularApertureAntennaModel> GetAntennaModel (void);
     Ptr<SatLinkResultsRtn> GetLinkResultsRTN (void);
@@ -4,6 +4,7 @@
  *  Created on: 2023年9月21日
  *      Author: kolimn
  */
+#include <string.h>
 #include "sag_lldp.h"
 #include "sag_lldp_port.h"
 #include "sag_rx_sm.h"
@@ -19,6 +20,7 @@
 #include "ns3/callback.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-interface.h"
+#include "ns3/simulator.h"
 
 namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("SAGLLDP");
@@ -48,6 +50,7 @@ SAGLLDP::SAGLLDP ()
 {
 	m_node = 0;
 	m_if_no = 4;
+	m_last_lldp_port = NULL;
     NS_LOG_FUNCTION (this);
     InitializeLLDP();
 }
@@ -57,6 +60,7 @@ SAGLLDP::SAGLLDP (Ptr<Node> node, int if_no)
     NS_LOG_FUNCTION (this);
     m_node = node;
     m_if_no = if_no;
+    m_last_lldp_port = NULL;
     InitializeLLDP();
 }
 
@@ -64,6 +68,14 @@ SAGLLDP::~SAGLLDP ()
 {
 
   NS_LOG_FUNCTION (this);
+  while(m_last_lldp_port != NULL)
+  {
+	  struct lldp_port* next = m_last_lldp_port->next;
+	  m_last_lldp_port->tx.txEvent.Cancel();
+	  delete[] m_last_lldp_port->if_name;
+	  delete m_last_lldp_port;
+	  m_last_lldp_port = next;
+  }
 }
 
 void
@@ -101,8 +113,6 @@ void
 SAGLLDP::Send(Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber, struct lldp_port* lldp_port)
 {
 
-	mibConstrInfoLLDPDU(lldp_port,packet);
-
 	uint32_t device_index = lldp_port->if_index;
 	struct lldp_port* lldp_port_temp = m_last_lldp_port;
 	while(m_last_lldp_port -> next != NULL)
@@ -114,7 +124,7 @@ SAGLLDP::Send(Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber,
 		m_last_lldp_port = m_last_lldp_port -> next;
 	}
 
-	std::cout<<"Node_"<<lldp_port->netdevice->GetNode()->GetId()<<"_Dev_"<<lldp_port->netdevice->GetIfIndex()<<":Send a Packet!"<<std::endl;
+	NS_LOG_LOGIC("Node_"<<lldp_port->netdevice->GetNode()->GetId()<<"_Dev_"<<lldp_port->netdevice->GetIfIndex()<<":Send a Packet!");
 	SAGLLDP::DoSend(packet, dest, protocolNumber, device_index);
 
 	m_last_lldp_port = lldp_port_temp;
@@ -125,7 +135,9 @@ void
 SAGLLDP::RunTx(struct lldp_port* lldp_port)
 {
 	txStatemachineRun(lldp_port,this);
-	Simulator::Schedule(Seconds(1.0),
+	//只在下一个发送计时器到期时运行状态机，而不是每秒运行一次
+	lldp_port->tx.txEvent.Cancel();
+	lldp_port->tx.txEvent = Simulator::Schedule(Seconds(txNextRunDelay(lldp_port)),
 						&SAGLLDP::RunTx,this, lldp_port);
 }
 
@@ -152,7 +164,8 @@ SAGLLDP::InitializeLLDP()
 		char real_name[IF_NAME_SIZE + 10];
 		std::sprintf(real_name, "%s_%d", name, i);
 
-		lldp_port -> if_name = real_name;
+		lldp_port -> if_name = new char[strlen(real_name) + 1];
+		strcpy(lldp_port -> if_name, real_name);
 		lldp_port -> portEnabled = 1;
 		lldp_port -> mtu = 1500;
 
@@ -177,18 +190,11 @@ SAGLLDP::InitializeLLDP()
 		//initializeTLVFunctionValidators();
 
 		//5. 更新链表
-		if(i == 0)
-		{
-			lldp_port -> next = NULL;
-		}
-		else
-		{
-			lldp_port -> next = m_last_lldp_port;
-		}
+		lldp_port -> next = m_last_lldp_port;
 		m_last_lldp_port = lldp_port;
 
 		//6. 发送数据包
-		Ptr<Packet> packet = Create<Packet>();
+		Ptr<Packet> packet = mibCachedInfoLLDPDU(lldp_port);
 		SAGLLDP::Send(packet, device->GetBroadcast(), PROT_NUMBER, lldp_port);
 
 		//7. 驱动发送状态机以及时出发定时器。在这里面设置每一秒进行一次定时器更新（及tick的周期为1s）
@@ -209,8 +215,7 @@ SAGLLDP::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol
 
 	struct lldp_port* lldp_port =  m_last_lldp_port;
 
-	bool stop = false;
-	while(!stop)
+	while(true)
 	{
 		if(lldp_port->netdevice == device)
 		{
@@ -224,8 +229,8 @@ SAGLLDP::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol
 		}
 		else
 		{
-			stop = true;
-			std::cout<<"no lldp_port match with the device!"<<std::endl;
+			NS_LOG_WARN("no lldp_port match with the device!");
+			return;
 		}
 
 	}
@@ -234,11 +239,19 @@ SAGLLDP::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol
 
 	lldp_port->rx.rcvFrame = 1;
 
-	std::cout<<"Node_"<<lldp_port->netdevice->GetNode()->GetId()<<"_Dev_"<<lldp_port->netdevice->GetIfIndex()<<":Receive a Packet!"<<std::endl;;
+	NS_LOG_LOGIC("Node_"<<lldp_port->netdevice->GetNode()->GetId()<<"_Dev_"<<lldp_port->netdevice->GetIfIndex()<<":Receive a Packet!");
 
 	ns3::Ptr<ns3::Packet> packet = ns3::ConstCast<ns3::Packet>(p);
 	rxStatemachineRun(lldp_port,packet);
 
+	//新邻居：发送端进入快速发送，立即运行发送状态机
+	if(lldp_port->rx.newNeighbor)
+	{
+		lldp_port->rx.newNeighbor = 0;
+		txStartFast(lldp_port);
+		RunTx(lldp_port);
+	}
+
 
 }
 
@@ -13,6 +13,8 @@
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/net-device.h"
+#include "ns3/packet.h"
+#include "ns3/event-id.h"
 
 
 
@@ -23,6 +25,7 @@ namespace ns3 {
 
 struct lldp_tx_port_statistics {
     uint64_t statsFramesOutTotal; //tx_port发出frame的统计数量
+    uint64_t statsFramesRebuiltTotal; //重新构造LLDPDU的次数，其余的帧直接复用缓存
 };
 
 //这个用于存储source_mac des_mac和ethertype
@@ -48,6 +51,11 @@ struct lldp_tx_port_timers {
 
     //Mengy's::
     uint16_t update_time;
+
+    uint16_t msgFastTx;        /**< IEEE 802.1AB-2009 10.5.3, interval while txFast > 0 */
+    uint16_t txFastInit;       /**< IEEE 802.1AB-2009 10.5.3, fast frames after a change */
+    uint16_t msgTxIntervalMax; /**< Longest interval a stable port is suppressed to */
+    uint16_t txSuppressAfter;  /**< Unchanged frames before the interval doubles */
 };
 
 
@@ -58,6 +66,13 @@ struct lldp_tx_port {
     uint8_t state;     /**< The tx state for this interface */
     uint8_t somethingChangedLocal; /**< IEEE 802.1AB var (from where?) */
     uint16_t txTTL;/**< IEEE 802.1AB var (from where?) */
+    uint8_t txFast;       /**< IEEE 802.1AB-2009 var, fast frames still to send */
+    uint16_t txInterval;  /**< Current interval, between msgTxInterval and msgTxIntervalMax */
+    uint16_t txUnchanged; /**< Frames sent since the last change or interval step */
+    uint64_t localSignature; /**< Hash of the local TLV values, TTL excluded */
+    uint16_t cachedTTL;      /**< TTL written in cachedLLDPDU */
+    Ptr<Packet> cachedLLDPDU; /**< Serialized info LLDPDU, resent until a TLV value changes */
+    EventId txEvent;          /**< Next run of the tx state machine */
     struct lldp_tx_port_timers timers; /**< The lldp tx state machine timers for this interface */
     struct lldp_tx_port_statistics statistics; /**< The lldp tx statistics for this interface */
 };
@@ -91,6 +106,7 @@ struct lldp_rx_port {
     uint8_t rxInfoAge;//当有msap过期时，这个设置为true
     uint8_t somethingChangedRemote;
     uint8_t tooManyNeighbors;
+    uint8_t newNeighbor; //有新的msap加入缓存，发送端需要进入快速发送
     struct lldp_rx_port_timers timers;
     struct lldp_rx_port_statistics statistics;
   //    struct lldp_msap_cache *msap;
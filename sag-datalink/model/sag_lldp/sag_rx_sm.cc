@@ -16,9 +16,12 @@
 #include "sag_tlv_content.h"
 #include "ns3/simulator.h"
 #include "ns3/node.h"
+#include "ns3/log.h"
 
 namespace ns3 {
 
+NS_LOG_COMPONENT_DEFINE ("SAGLLDPRx");
+
 uint8_t rxInitializeLLDP(struct lldp_port *lldp_port) {
     /* As per IEEE 802.1AB section 10.5.5.3 */
     lldp_port->rx.rcvFrame        = 0;
@@ -28,6 +31,8 @@ uint8_t rxInitializeLLDP(struct lldp_port *lldp_port) {
 
     lldp_port->rx.rxInfoAge = 0;
 
+    lldp_port->rx.newNeighbor = 0;
+
     lldp_port -> rx.frame = new uint8_t[lldp_port->mtu];
 
     lldp_port->rx.timers.update_time = (uint16_t)Simulator::Now().GetSeconds();
@@ -65,7 +70,7 @@ void rxChangeToState(struct lldp_port *lldp_port, uint8_t state) {
 
     if(lldp_port->rx.state != state)
     {
-    	std::cout<<"Node_"<<lldp_port->netdevice->GetNode()->GetId()<<"_Dev_"<<lldp_port->netdevice->GetIfIndex()<<":RX from "<<rxStateFromID(lldp_port->rx.state)<<" to "<<rxStateFromID(state)<<std::endl;
+    	NS_LOG_LOGIC("Node_"<<lldp_port->netdevice->GetNode()->GetId()<<"_Dev_"<<lldp_port->netdevice->GetIfIndex()<<":RX from "<<rxStateFromID(lldp_port->rx.state)<<" to "<<rxStateFromID(state));
     }
     lldp_port->rx.state = state;
 
@@ -117,21 +122,21 @@ int rxProcessFrame(struct lldp_port *lldp_port,LLDPHeader header, LLDPPDU pdu) {
 	    struct lldp_msap *msap_cache = NULL;
 
 
-	    std::cout<<"Valiadate LLDP Header!"<<std::endl;
+	    NS_LOG_LOGIC("Valiadate LLDP Header!");
 	    //1. 验证Destination MAC
 	    uint8_t* des_mac = header.GetDesMacAddress();
 	    if(des_mac[0] != 0x01 || des_mac[1] != 0x80 || des_mac[2] != 0xc2 || des_mac[3] != 0x00 ||des_mac[4] != 0x00 || des_mac[5] != 0x0e)
 	    {
-	    	std::cout<<"The Destination MAC Address is Error!"<<std::endl;
+	    	NS_LOG_WARN("The Destination MAC Address is Error!");
 	    	badFrame ++;
 	    }
 
 	    //2. 验证以太类型
-	    std::cout<<"Valiadate Ethertype!"<<std::endl;
+	    NS_LOG_LOGIC("Valiadate Ethertype!");
 	    uint16_t ethertype = header.GetEtherType();
 	    if(ethertype != 0x88cc)
 	    {
-	    	std::cout<<"The Ethertype is Error!"<<std::endl;
+	    	NS_LOG_WARN("The Ethertype is Error!");
 	    	badFrame ++;
 	    }
 
@@ -141,13 +146,13 @@ int rxProcessFrame(struct lldp_port *lldp_port,LLDPHeader header, LLDPPDU pdu) {
 	    }
 
 	    //3. 处理各个TLV
-	    std::cout<<"Process received TLV!"<<std::endl;
+	    NS_LOG_LOGIC("Process received TLV!");
 	    tlv_list = pdu.GetTLVList();
 	    do{
 	    	num_tlvs ++;//处理的tlv数量加1
 	    	if(tlv_offset > pdu.GetSerializedSize())
 	    	{
-	    		std::cout<<"Error! Offset is Larger than Receive Size!"<<std::endl;
+	    		NS_LOG_WARN("Error! Offset is Larger than Receive Size!");
 	    		badFrame++;
 	    		break;
 	    	}
@@ -160,19 +165,19 @@ int rxProcessFrame(struct lldp_port *lldp_port,LLDPHeader header, LLDPPDU pdu) {
 	    	if(num_tlvs<=3)
 	    	{
 	    		if(num_tlvs != tlv_type) {
-	    			std::cout<<"Error! TLV number "<<num_tlvs<<" should have tlv_type" <<num_tlvs<<" , but is actually "<<tlv_type<<std::endl;
+	    			NS_LOG_WARN("Error! TLV number "<<num_tlvs<<" should have tlv_type" <<num_tlvs<<" , but is actually "<<tlv_type);
 	                lldp_port->rx.statistics.statsFramesDiscardedTotal++;
 	                lldp_port->rx.statistics.statsFramesInErrorsTotal++;
 	                badFrame++;
 	    		}
 	    	}
-	    	std::cout<<"TLV type: "<<tlv_typetoname(tlv_type) <<", Length: "<<tlv_length<<std::endl;
+	    	NS_LOG_LOGIC("TLV type: "<<tlv_typetoname(tlv_type) <<", Length: "<<tlv_length);
 
 	    	//提取这个tlv
 	    	tlv = initialize_tlv();
 	    	if(!tlv)
 	    	{
-	    		std::cout<<"Unable to malloc buffer for struct tlv!"<<std::endl;
+	    		NS_LOG_WARN("Unable to malloc buffer for struct tlv!");
 	    	}
 
 	    	tlv ->type = tlv_type;
@@ -189,12 +194,12 @@ int rxProcessFrame(struct lldp_port *lldp_port,LLDPHeader header, LLDPPDU pdu) {
 	    	{
 	    		if(tlv_length != 2)
 	    		{
-	    			std::cout<<"The TTL TlV Should Have Length: 2, But is "<<tlv_length<<std::endl;
+	    			NS_LOG_WARN("The TTL TlV Should Have Length: 2, But is "<<tlv_length);
 	    		}
 	    		else
 	    		{
-	    			lldp_port->rx.timers.rxTTL = tlv_info_string[0];
-	    			std::cout<<"the TTL info is "<<lldp_port->rx.timers.rxTTL<<std::endl;
+	    			lldp_port->rx.timers.rxTTL = (tlv_info_string[0] << 8) | tlv_info_string[1];
+	    			NS_LOG_LOGIC("the TTL info is "<<lldp_port->rx.timers.rxTTL);
 	    			msap_ttl_tlv = tlv;
 	    		}
 	    	}
@@ -220,7 +225,7 @@ int rxProcessFrame(struct lldp_port *lldp_port,LLDPHeader header, LLDPPDU pdu) {
 	    	//将这个tlv加入到msap维护的tlv_list中
 	    	cached_tlv = initialize_tlv();
 	    	if(tlvcpy(cached_tlv, tlv) != 0) {
-	    	  std::cout<<"Error copying TLV for MSAP cache!"<<std::endl;
+	    	  NS_LOG_WARN("Error copying TLV for MSAP cache!");
 	    	  }
 	    	add_tlv(cached_tlv,&tlv_list);
 
@@ -238,7 +243,7 @@ int rxProcessFrame(struct lldp_port *lldp_port,LLDPHeader header, LLDPPDU pdu) {
 				msap_id = new uint8_t[msap_tlv1->length - 1  + msap_tlv2->length - 1];
 				if(!msap_id)
 				{
-					std::cout<<"Error！Unable to malloc buffer for masp_id!"<<std::endl;
+					NS_LOG_WARN("Error！Unable to malloc buffer for masp_id!");
 				}
 
 				memcpy(msap_id, &msap_tlv1->info_string[1], msap_tlv1->length - 1);
@@ -300,7 +305,7 @@ int rxProcessFrame(struct lldp_port *lldp_port,LLDPHeader header, LLDPPDU pdu) {
 	      }
 	      else
 	      {
-	    		std::cout<< "ERROR! No MSAP for TLVs in Frame!"<<std::endl;
+	    		NS_LOG_WARN("ERROR! No MSAP for TLVs in Frame!");
 	      }
 
 	    /* Report frame errors */
@@ -313,7 +318,7 @@ int rxProcessFrame(struct lldp_port *lldp_port,LLDPHeader header, LLDPPDU pdu) {
 }
 
 void rxBadFrameInfo(uint8_t frameErrors) {
-    std::cout<<"WARNING! This frame had "<<frameErrors<<" errors!"<<std::endl;
+    NS_LOG_WARN("WARNING! This frame had "<<frameErrors<<" errors!");
 }
 
 uint8_t mibUpdateObjects(struct lldp_port *lldp_port) {
@@ -405,7 +410,6 @@ uint8_t rxGlobalStatemachineRun(struct lldp_port *lldp_port)
 
     case RX_FRAME:
       {
-    	  std::cout<<"坏了"<<std::endl<<std::endl;
 			if(lldp_port->rx.timers.rxTTL == 0)
 				rxChangeToState(lldp_port, DELETE_INFO);
 			if((lldp_port->rx.timers.rxTTL != 0) && (lldp_port->rxChanges == true))
@@ -421,7 +425,7 @@ uint8_t rxGlobalStatemachineRun(struct lldp_port *lldp_port)
       }break;*/
 
     default:
-            std::cout<<"The RX Global State Machine is broken!"<<std::endl;
+            NS_LOG_WARN("The RX Global State Machine is broken!");
     };
 
   return 0;
@@ -466,7 +470,7 @@ void rxStatemachineRun(struct lldp_port *lldp_port,Ptr<ns3::Packet> packet)
 		rx_do_rx_update_info(lldp_port,packet);
 		  }break;
 		  default:
-		std::cout<< "The RX State Machine is broken!"<<std::endl;
+		NS_LOG_WARN("The RX State Machine is broken!");
 		};
     }
 
@@ -26,11 +26,14 @@
 
 #include "sag_lldp_port.h"
 #include "ns3/node.h"
+#include "ns3/log.h"
 #include "sag_tlv_content.h"
 #include "sag_tlv_struct.h"
 //#include "lldp_neighbor.h"
 
 namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SAGLLDPTlvContent");
 /* There are a max of 128 TLV validators (types 0 through 127), so we'll stick them in a static array indexed by their tlv type */
 uint8_t (*validate_tlv[128])(struct lldp_tlv *tlv) = {
     validate_end_of_lldpdu_tlv,        /* 0 End of LLDPU TLV        */
@@ -236,8 +239,10 @@ struct lldp_tlv *create_port_id_tlv(struct lldp_port *lldp_port) {
 		std::sprintf(name,"%s_%d","node",node->GetId());
 		char real_name[20 + 10];
 		std::sprintf(real_name, "%s_%d", name, lldp_port -> if_index);
-		lldp_port -> if_name = real_name;
-    	std::cout<<"the interface name is "<<lldp_port->if_name<<std::endl;
+		delete[] lldp_port -> if_name;
+		lldp_port -> if_name = new char[strlen(real_name) + 1];
+		strcpy(lldp_port -> if_name, real_name);
+		NS_LOG_LOGIC("the interface name is "<<lldp_port->if_name);
     }
 
     tlv->length = 1 + strlen(lldp_port->if_name); //The length of the interface name + the size of the subtype (1 byte)
@@ -273,7 +278,9 @@ struct lldp_tlv *create_ttl_tlv(struct lldp_port *lldp_port) {
 
     tlv->info_string = new uint8_t[tlv->length];
 
-    memcpy(tlv->info_string, &ttl, tlv->length);
+    // Network byte order, TTLs of suppressed ports exceed one octet
+    tlv->info_string[0] = ttl >> 8;
+    tlv->info_string[1] = ttl & 0xFF;
 
 
     return tlv;
@@ -148,6 +148,9 @@ void update_msap_cache(struct lldp_port *lldp_port, struct lldp_msap* msap_cache
 
     	  	  destroy_tlv_list(&old_cache->tlv_list);
     	  	  old_cache->tlv_list = new_cache->tlv_list;
+    	  	  // Refresh the age of a known neighbor, otherwise it expires while still advertising
+    	  	  old_cache->rxInfoTTL = new_cache->rxInfoTTL;
+    	  	  old_cache->update_time = new_cache->update_time;
     	  	  delete(new_cache->id);
     	  	  delete(new_cache);
 
@@ -161,6 +164,7 @@ void update_msap_cache(struct lldp_port *lldp_port, struct lldp_msap* msap_cache
 
   new_cache->next = lldp_port->msap_cache;
   lldp_port->msap_cache = new_cache;
+  lldp_port->rx.newNeighbor = 1;
 
 }
 
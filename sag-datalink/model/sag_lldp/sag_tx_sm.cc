@@ -85,6 +85,45 @@ void mibConstrInfoLLDPDU(struct lldp_port *lldp_port, Ptr<Packet> p)
     destroy_tlv_list(&tlv_list);
 }
 
+static void signature_mix(uint64_t *hash, const uint8_t *data, size_t length)
+{
+    for(size_t i = 0; i < length; i++)
+    {
+        *hash ^= data[i];
+        *hash *= 1099511628211ULL;
+    }
+}
+
+uint64_t mibLocalSignature(struct lldp_port *lldp_port)
+{
+    // FNV-1a over everything mibConstrInfoLLDPDU reads from the port except
+    // the TTL, the other TLVs are constant
+    uint64_t hash = 14695981039346656037ULL;
+    signature_mix(&hash, lldp_port->source_mac, 6);
+    signature_mix(&hash, lldp_port->source_ipaddr, 4);
+    signature_mix(&hash, (const uint8_t *)&lldp_port->if_index, sizeof(lldp_port->if_index));
+    signature_mix(&hash, (const uint8_t *)lldp_port->if_name, strlen(lldp_port->if_name));
+    return hash;
+}
+
+Ptr<Packet> mibCachedInfoLLDPDU(struct lldp_port *lldp_port)
+{
+    uint64_t signature = mibLocalSignature(lldp_port);
+    if(lldp_port->tx.cachedLLDPDU == 0
+            || lldp_port->tx.localSignature != signature
+            || lldp_port->tx.cachedTTL != lldp_port->tx.txTTL)
+    {
+        Ptr<Packet> packet = Create<Packet>();
+        mibConstrInfoLLDPDU(lldp_port, packet);
+        lldp_port->tx.cachedLLDPDU = packet;
+        lldp_port->tx.localSignature = signature;
+        lldp_port->tx.cachedTTL = lldp_port->tx.txTTL;
+        lldp_port->tx.statistics.statsFramesRebuiltTotal++;
+    }
+    // Packet copies share the buffer, no TLV is built or serialized again
+    return lldp_port->tx.cachedLLDPDU->Copy();
+}
+
 uint8_t txInitializeLLDP(struct lldp_port *lldp_port)
 {
     /* As per IEEE 802.1AB section 10.1.1 */
@@ -92,6 +131,7 @@ uint8_t txInitializeLLDP(struct lldp_port *lldp_port)
 
     /* Defined in 10.5.2.1 */
     lldp_port->tx.statistics.statsFramesOutTotal = 0;
+    lldp_port->tx.statistics.statsFramesRebuiltTotal = 0;
 
     lldp_port->tx.timers.reinitDelay   = 2;  // Recommended minimum by 802.1AB 10.5.3.3
     lldp_port->tx.timers.msgTxHold     = 4;  // Recommended minimum by 802.1AB 10.5.3.3
@@ -101,13 +141,28 @@ uint8_t txInitializeLLDP(struct lldp_port *lldp_port)
 
     // Unsure what to set these to...
     lldp_port->tx.timers.txShutdownWhile = 0;
+    lldp_port->tx.timers.txDelayWhile = 0;
+    lldp_port->tx.timers.txTTR = 0;
+
+    lldp_port->tx.timers.msgFastTx        = 1;  // Default of 802.1AB-2009 10.5.3
+    lldp_port->tx.timers.txFastInit       = 4;  // Default of 802.1AB-2009 10.5.3
+    lldp_port->tx.timers.msgTxIntervalMax = 32;
+    lldp_port->tx.timers.txSuppressAfter  = 4;
+
+    // A (re)initialized port starts fast, like one with a new neighbor
+    lldp_port->tx.txInterval  = lldp_port->tx.timers.msgTxInterval;
+    lldp_port->tx.txFast      = lldp_port->tx.timers.txFastInit;
+    lldp_port->tx.txUnchanged = 0;
+    lldp_port->tx.cachedLLDPDU = 0;
+    lldp_port->tx.localSignature = 0;
+    lldp_port->tx.cachedTTL = 0;
+    lldp_port->tx.txTTL = min(65535, (lldp_port->tx.txInterval * lldp_port->tx.timers.msgTxHold));
 
     lldp_port->tx.frame = new uint8_t[lldp_port->mtu];
 
     //Mengy's::TODO 这里需要获取设备的mac地址，但是我不知道怎么将netdevice转换为PointToPointNetDevice然后获取MACaddress
     Address address = lldp_port->netdevice->GetAddress();
     address.CopyFrom(lldp_port->source_mac,6);
-    std::cout<<"the address is "<<(int)lldp_port->source_mac[0]<<(int)lldp_port->source_mac[1]<<lldp_port->source_mac[2]<<std::endl;
 
 
 
@@ -117,6 +172,7 @@ uint8_t txInitializeLLDP(struct lldp_port *lldp_port)
     lldp_port->source_ipaddr[3] = 1;
 
     lldp_port->tx.timers.update_time = (uint16_t)Simulator::Now().GetSeconds();
+    lldp_port->tx.localSignature = mibLocalSignature(lldp_port);
     return 0;
 }
 
@@ -264,6 +320,32 @@ void tx_decrement_timer(uint16_t *timer) {
     (*timer)--;
 }
 
+void txStartFast(struct lldp_port *lldp_port)
+{
+    lldp_port->tx.txFast = lldp_port->tx.timers.txFastInit;
+    lldp_port->tx.txInterval = lldp_port->tx.timers.msgTxInterval;
+    lldp_port->tx.txUnchanged = 0;
+    // Next frame as soon as txDelayWhile allows
+    lldp_port->tx.timers.txTTR = 0;
+}
+
+uint16_t txNextRunDelay(struct lldp_port *lldp_port)
+{
+    uint16_t delay = 0;
+    uint16_t timers[3] = {lldp_port->tx.timers.txTTR,
+                          lldp_port->tx.timers.txDelayWhile,
+                          lldp_port->tx.timers.txShutdownWhile};
+    for(uint16_t timer : timers)
+    {
+        if(timer > 0 && (delay == 0 || timer < delay))
+        {
+            delay = timer;
+        }
+    }
+    // Timers count whole seconds, so the machine never needs to run more often
+    return delay == 0 ? 1 : delay;
+}
+
 void tx_do_update_timers(struct lldp_port *lldp_port) {
 
 	uint16_t current_time = (uint16_t)Simulator::Now().GetSeconds();
@@ -276,6 +358,15 @@ void tx_do_update_timers(struct lldp_port *lldp_port) {
 	}
 
 	lldp_port->tx.timers.update_time = (uint16_t)Simulator::Now().GetSeconds();
+
+	// A changed TLV value is advertised at once and restarts fast transmission
+	uint64_t signature = mibLocalSignature(lldp_port);
+	if(lldp_port->tx.localSignature != signature)
+	{
+		lldp_port->tx.localSignature = signature;
+		lldp_port->tx.somethingChangedLocal = 1;
+		txStartFast(lldp_port);
+	}
     //tx_display_timers(lldp_port);
 }
 
@@ -296,8 +387,9 @@ void tx_do_tx_lldp_initialize(struct lldp_port *lldp_port,SAGLLDP* lldp) {
 }
 
 void tx_do_tx_idle(struct lldp_port *lldp_port,SAGLLDP* lldp) {
-    lldp_port->tx.txTTL = min(65535, (lldp_port->tx.timers.msgTxInterval * lldp_port->tx.timers.msgTxHold));
-    lldp_port->tx.timers.txTTR = lldp_port->tx.timers.msgTxInterval;
+    // The TTL follows the suppressed interval, so neighbors keep the entry
+    lldp_port->tx.txTTL = min(65535, (lldp_port->tx.txInterval * lldp_port->tx.timers.msgTxHold));
+    lldp_port->tx.timers.txTTR = lldp_port->tx.txFast > 0 ? lldp_port->tx.timers.msgFastTx : lldp_port->tx.txInterval;
     lldp_port->tx.somethingChangedLocal = 0;
     lldp_port->tx.timers.txDelayWhile = lldp_port->tx.timers.txDelay;
 
@@ -330,8 +422,21 @@ void tx_do_tx_shutdown_frame(struct lldp_port *lldp_port,SAGLLDP* lldp) {
 
 void tx_do_tx_info_frame(struct lldp_port *lldp_port,SAGLLDP* lldp) {
     /* As per 802.1AB 10.5.4.3 */
-	Ptr<Packet> packet = Create<Packet>();
+	Ptr<Packet> packet = mibCachedInfoLLDPDU(lldp_port);
 	lldp->Send(packet, lldp_port->netdevice->GetBroadcast(), SAGLLDP::PROT_NUMBER, lldp_port);
+	lldp_port->tx.statistics.statsFramesOutTotal++;
+
+	if(lldp_port->tx.txFast > 0)
+	{
+		lldp_port->tx.txFast--;
+	}
+	else if(++lldp_port->tx.txUnchanged >= lldp_port->tx.timers.txSuppressAfter
+			&& lldp_port->tx.txInterval < lldp_port->tx.timers.msgTxIntervalMax)
+	{
+		// Stable port: double the interval, the TTL grows with it
+		lldp_port->tx.txInterval = min(lldp_port->tx.timers.msgTxIntervalMax, 2 * lldp_port->tx.txInterval);
+		lldp_port->tx.txUnchanged = 0;
+	}
     txChangeToState(lldp_port, TX_IDLE);
     tx_do_tx_idle(lldp_port,lldp);
 }
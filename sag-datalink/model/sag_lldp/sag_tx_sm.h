@@ -36,6 +36,21 @@ uint8_t txInitializeLLDP(struct lldp_port *lldp_port);
  */
 void mibConstrInfoLLDPDU(struct lldp_port *lldp_port, Ptr<Packet> p);
 
+/**
+ * Get the info LLDPDU of a port, it is only rebuilt when a TLV value changed
+ * \param lldp_port, lldp port
+ *
+ * \return a copy of the cached frame
+ */
+Ptr<Packet> mibCachedInfoLLDPDU(struct lldp_port *lldp_port);
+
+/**
+ * Hash of the local values the info TLVs are built from, TTL excluded
+ * \param lldp_port, lldp port
+ *
+ */
+uint64_t mibLocalSignature(struct lldp_port *lldp_port);
+
 /**
  * Construct a shutdown LLDP PDU
  * \param lldp_port, lldp port
@@ -74,6 +89,22 @@ void tx_do_tx_shutdown_frame(struct lldp_port *lldp_port,SAGLLDP* lldp);
 
 void tx_decrement_timer(uint16_t *timer);
 
+/**
+ * Enter fast transmission (IEEE 802.1AB-2009 10.5.4.3) and undo the
+ * suppression of a stable port
+ * \param lldp_port, lldp port
+ *
+ */
+void txStartFast(struct lldp_port *lldp_port);
+
+/**
+ * Seconds until one of the tx timers expires, the state machine has nothing
+ * to do before
+ * \param lldp_port, lldp port
+ *
+ */
+uint16_t txNextRunDelay(struct lldp_port *lldp_port);
+
 
 
 
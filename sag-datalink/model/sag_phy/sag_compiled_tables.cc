@@ -0,0 +1,283 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "sag_compiled_tables.h"
+
+#include <ns3/fatal-error.h>
+#include <ns3/log.h>
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+NS_LOG_COMPONENT_DEFINE("SatTableCompiler");
+
+namespace ns3
+{
+
+namespace
+{
+
+const uint32_t MAX_SAMPLES = 4096;
+const uint32_t MAX_DIVISOR = 16;
+const double GRID_TOLERANCE = 1e-6; //!< In steps
+
+struct ParsedTable
+{
+    std::string name;
+    std::vector<double> samples;
+    std::vector<double> x;
+    SatCompiledTable table;
+};
+
+bool g_useCompiled = true;
+
+// function-local, tables may be loaded during static initialization of other modules
+std::map<std::string, ParsedTable>&
+GetParsedTables()
+{
+    static std::map<std::string, ParsedTable> tables;
+    return tables;
+}
+
+std::vector<const SatCompiledTable*>&
+GetSeenTables()
+{
+    static std::vector<const SatCompiledTable*> seen;
+    return seen;
+}
+
+const std::unordered_map<std::string, const SatCompiledTable*>&
+GetCompiledTables()
+{
+    static std::unordered_map<std::string, const SatCompiledTable*> compiled;
+    static bool built = false;
+    if (!built)
+    {
+        for (const SatCompiledTable* t = g_satCompiledTables; t->name != nullptr; ++t)
+        {
+            compiled.insert(std::make_pair(std::string(t->name), t));
+        }
+        built = true;
+    }
+    return compiled;
+}
+
+void
+MarkSeen(const SatCompiledTable* table)
+{
+    std::vector<const SatCompiledTable*>& seen = GetSeenTables();
+    for (const SatCompiledTable* t : seen)
+    {
+        if (std::string(t->name) == table->name)
+        {
+            return;
+        }
+    }
+    seen.push_back(table);
+}
+
+} // namespace
+
+void
+SatTableCompiler::SetUseCompiled(bool useCompiled)
+{
+    g_useCompiled = useCompiled;
+}
+
+std::string
+SatTableCompiler::GetFileName(std::string path)
+{
+    size_t pos = path.find_last_of('/');
+    return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+
+const SatCompiledTable*
+SatTableCompiler::Find(std::string path)
+{
+    NS_LOG_FUNCTION(path);
+
+    if (g_useCompiled)
+    {
+        auto it = GetCompiledTables().find(GetFileName(path));
+        if (it != GetCompiledTables().end())
+        {
+            NS_LOG_INFO("Compiled table for " << path);
+            MarkSeen(it->second);
+            return it->second;
+        }
+    }
+
+    auto it = GetParsedTables().find(path);
+    if (it != GetParsedTables().end())
+    {
+        return &it->second.table;
+    }
+    return nullptr;
+}
+
+const SatCompiledTable*
+SatTableCompiler::Add(std::string path, const std::vector<double>& x, const std::vector<double>& y)
+{
+    NS_LOG_FUNCTION(path << x.size());
+    NS_ASSERT(!x.empty() && x.size() == y.size());
+
+    ParsedTable& parsed = GetParsedTables()[path];
+    parsed.name = GetFileName(path);
+    Resample(x, y, parsed.table.x0, parsed.table.step, parsed.samples, parsed.x);
+    parsed.table.name = parsed.name.c_str();
+    parsed.table.n = parsed.samples.size();
+    parsed.table.y = parsed.samples.data();
+    parsed.table.x = parsed.x.empty() ? nullptr : parsed.x.data();
+    MarkSeen(&parsed.table);
+    return &parsed.table;
+}
+
+void
+SatTableCompiler::Resample(const std::vector<double>& x,
+                           const std::vector<double>& y,
+                           double& x0,
+                           double& step,
+                           std::vector<double>& samples,
+                           std::vector<double>& xs)
+{
+    uint32_t n = x.size();
+    x0 = x[0];
+    xs.clear();
+    if (n == 1)
+    {
+        step = 1.0;
+        samples.assign(1, y[0]);
+        return;
+    }
+
+    double range = x[n - 1] - x[0];
+    double minSpacing = range;
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        minSpacing = std::min(minSpacing, x[i] - x[i - 1]);
+    }
+
+    for (uint32_t k = 1; k <= MAX_DIVISOR; ++k)
+    {
+        double candidate = minSpacing / k;
+        double count = std::round(range / candidate);
+        if (!(count + 1 <= MAX_SAMPLES))
+        {
+            break;
+        }
+        uint32_t intervals = count;
+        bool aligned = true;
+        for (uint32_t i = 1; i < n && aligned; ++i)
+        {
+            double pos = (x[i] - x0) / candidate;
+            aligned = std::fabs(pos - std::round(pos)) <= GRID_TOLERANCE;
+        }
+        if (!aligned)
+        {
+            continue;
+        }
+
+        step = range / intervals;
+        // GetLastX () must not fall short of the last breakpoint
+        while (x0 + intervals * step < x[n - 1])
+        {
+            step = std::nextafter(step, std::numeric_limits<double>::infinity());
+        }
+        samples.resize(intervals + 1);
+        uint32_t j = 1;
+        for (uint32_t i = 0; i < samples.size(); ++i)
+        {
+            double xi = i + 1 == samples.size() ? x[n - 1] : x0 + i * step;
+            while (j < n - 1 && xi > x[j])
+            {
+                j++;
+            }
+            samples[i] = y[j - 1] + (xi - x[j - 1]) * (y[j] - y[j - 1]) / (x[j] - x[j - 1]);
+        }
+        return;
+    }
+
+    NS_LOG_INFO("No uniform grid for the " << n << " source points, kept as they are");
+    step = 0.0;
+    samples = y;
+    xs = x;
+}
+
+void
+SatTableCompiler::Write(std::string outputPath)
+{
+    NS_LOG_FUNCTION(outputPath);
+
+    std::ofstream ofs(outputPath.c_str(), std::ofstream::out);
+    if (!ofs.is_open())
+    {
+        NS_FATAL_ERROR("The file " << outputPath << " could not be opened.");
+    }
+
+    const std::vector<const SatCompiledTable*>& seen = GetSeenTables();
+    ofs << "/* Generated by SatTableCompiler::Write (), do not edit */\n\n"
+        << "#include \"sag_compiled_tables.h\"\n\n"
+        << "namespace ns3\n{\n\n";
+    ofs << std::setprecision(17);
+    for (uint32_t k = 0; k < seen.size(); ++k)
+    {
+        ofs << "static constexpr double s_table" << k << "[] = {";
+        for (uint32_t i = 0; i < seen[k]->n; ++i)
+        {
+            ofs << (i % 8 == 0 ? "\n    " : " ") << seen[k]->y[i] << ",";
+        }
+        ofs << "\n};\n\n";
+        if (seen[k]->x != nullptr)
+        {
+            ofs << "static constexpr double s_x" << k << "[] = {";
+            for (uint32_t i = 0; i < seen[k]->n; ++i)
+            {
+                ofs << (i % 8 == 0 ? "\n    " : " ") << seen[k]->x[i] << ",";
+            }
+            ofs << "\n};\n\n";
+        }
+    }
+    ofs << "const SatCompiledTable g_satCompiledTables[] = {\n";
+    for (uint32_t k = 0; k < seen.size(); ++k)
+    {
+        ofs << "    {\"" << seen[k]->name << "\", " << seen[k]->x0 << ", " << seen[k]->step << ", "
+            << seen[k]->n << ", s_table" << k << ", ";
+        if (seen[k]->x != nullptr)
+        {
+            ofs << "s_x" << k << "},\n";
+        }
+        else
+        {
+            ofs << "nullptr},\n";
+        }
+    }
+    ofs << "    {nullptr, 0.0, 0.0, 0, nullptr, nullptr},\n};\n\n"
+        << "} // end of namespace ns3\n";
+    ofs.close();
+
+    std::cout << "  > Wrote " << seen.size() << " compiled link result table(s) to " << outputPath
+              << std::endl;
+}
+
+} // end of namespace ns3
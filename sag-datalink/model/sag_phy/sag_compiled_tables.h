@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef SATELLITE_COMPILED_TABLES_H
+#define SATELLITE_COMPILED_TABLES_H
+
+#include <algorithm>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup satellite
+ *
+ * \brief Piecewise linear table, sampled on a uniform grid where the source allows it
+ *
+ * Plain aggregate, so that generated tables are constant-initialized arrays
+ * linked into the module and need no parsing at start-up. Tables whose
+ * breakpoints fit on no grid keep their abscissae in x and are searched.
+ */
+struct SatCompiledTable
+{
+    const char* name; //!< File name of the source table, without directory
+    double x0;        //!< First abscissa in dB
+    double step;      //!< Spacing of the samples in dB, unused if x is set
+    uint32_t n;       //!< Number of samples, the last one lies at GetX (n - 1)
+    const double* y;  //!< Samples
+    const double* x;  //!< Abscissae of a non-uniform table, nullptr on a uniform grid
+
+    /**
+     * \brief Linear interpolation, O(1) on a uniform grid and O(log n) otherwise
+     * \param v abscissa, expected within [x0, GetLastX ()]
+     */
+    inline double Sample(double v) const
+    {
+        if (x != nullptr)
+        {
+            uint32_t j = std::upper_bound(x, x + n, v) - x;
+            if (j >= n)
+            {
+                return y[n - 1];
+            }
+            if (j == 0)
+            {
+                return y[0];
+            }
+            return y[j - 1] + (v - x[j - 1]) * (y[j] - y[j - 1]) / (x[j] - x[j - 1]);
+        }
+        double pos = (v - x0) / step;
+        uint32_t i = pos > 0 ? static_cast<uint32_t>(pos) : 0;
+        if (i + 1 >= n)
+        {
+            return y[n - 1];
+        }
+        return y[i] + (pos - i) * (y[i + 1] - y[i]);
+    }
+
+    inline double GetX(uint32_t i) const
+    {
+        return x != nullptr ? x[i] : x0 + i * step;
+    }
+
+    inline double GetLastX() const
+    {
+        return GetX(n - 1);
+    }
+};
+
+/**
+ * \brief Tables generated by SatTableCompiler::Write (), terminated by an entry with null name
+ */
+extern const SatCompiledTable g_satCompiledTables[];
+
+/**
+ * \ingroup satellite
+ *
+ * \brief Source of the link result and mutual information tables
+ *
+ * A table is looked up by file name in the tables compiled into the module,
+ * then by path in the tables already parsed by this process; only tables found
+ * in neither are read from disk, resampled and kept for later lookups. Write ()
+ * turns every table seen by the process into the source of the compiled
+ * tables, i.e. the content of sag_compiled_tables_data.cc.
+ */
+class SatTableCompiler
+{
+  public:
+    /**
+     * \brief Whether compiled tables take precedence over the files, true by default
+     *
+     * Disable it to use custom tables named like the shipped ones.
+     */
+    static void SetUseCompiled(bool useCompiled);
+
+    /**
+     * \return the table for path, or nullptr if it still has to be read
+     */
+    static const SatCompiledTable* Find(std::string path);
+
+    /**
+     * \brief Resample a sorted table read from path and keep it for later lookups
+     * \return the resampled table, valid until the end of the process
+     */
+    static const SatCompiledTable* Add(std::string path,
+                                       const std::vector<double>& x,
+                                       const std::vector<double>& y);
+
+    /**
+     * \brief Write the C++ source of all tables seen so far
+     */
+    static void Write(std::string outputPath);
+
+  private:
+    /**
+     * \brief Coarsest uniform grid holding every source abscissa, found among the
+     *        smallest source spacing divided by 1 to MAX_DIVISOR
+     *
+     * Every breakpoint being a sample, the table is reproduced exactly. If no
+     * such grid fits in MAX_SAMPLES, the source points are kept in xs.
+     */
+    static void Resample(const std::vector<double>& x,
+                         const std::vector<double>& y,
+                         double& x0,
+                         double& step,
+                         std::vector<double>& samples,
+                         std::vector<double>& xs);
+
+    static std::string GetFileName(std::string path);
+};
+
+} // end of namespace ns3
+
+#endif /* SATELLITE_COMPILED_TABLES_H */
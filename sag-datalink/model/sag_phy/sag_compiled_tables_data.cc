@@ -0,0 +1,18 @@
+/* Generated by SatTableCompiler::Write (), do not edit */
+
+/*
+ * No table compiled in yet: run a scenario once with
+ * ns3::SatLinkResults::CompiledTablesOutput pointing at this file, then
+ * rebuild. Until then every table is read from the linkresults directory.
+ */
+
+#include "sag_compiled_tables.h"
+
+namespace ns3
+{
+
+const SatCompiledTable g_satCompiledTables[] = {
+    {nullptr, 0.0, 0.0, 0, nullptr, nullptr},
+};
+
+} // end of namespace ns3
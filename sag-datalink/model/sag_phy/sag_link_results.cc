@@ -28,6 +28,7 @@
 #include <ns3/object.h>
 #include <ns3/singleton.h>
 #include <ns3/string.h>
+#include <ns3/boolean.h>
 #include <sstream>
 #include <cmath>
 
@@ -52,7 +53,17 @@ SatLinkResults::GetTypeId()
 					        "Directory (trace file will be placed here",
 				            StringValue (""),
 				            MakeStringAccessor (&SatLinkResults::m_baseDir),
-				            MakeStringChecker ());
+				            MakeStringChecker ())
+			.AddAttribute ("UseCompiledTables",
+					        "Use the tables compiled into the module instead of the files of the same name",
+					        BooleanValue (true),
+					        MakeBooleanAccessor (&SatLinkResults::m_useCompiledTables),
+					        MakeBooleanChecker ())
+			.AddAttribute ("CompiledTablesOutput",
+					        "If not empty, the C++ source of all tables loaded so far is written here after initialization",
+					        StringValue (""),
+					        MakeStringAccessor (&SatLinkResults::m_compiledTablesOutput),
+					        MakeStringChecker ());
     return tid;
 }
 
@@ -70,8 +81,13 @@ void
 SatLinkResults::Initialize()
 {
     NS_LOG_FUNCTION(this);
+    SatTableCompiler::SetUseCompiled(m_useCompiledTables);
     DoInitialize();
     m_isInitialized = true;
+    if (!m_compiledTablesOutput.empty())
+    {
+        SatTableCompiler::Write(m_compiledTablesOutput);
+    }
 }
 
 void
@@ -101,6 +101,8 @@ class SatLinkResults : public Object
 
   private:
     std::string m_baseDir;
+    bool m_useCompiledTables;
+    std::string m_compiledTablesOutput;
 };
 
 /**
@@ -35,9 +35,15 @@ namespace ns3
 NS_OBJECT_ENSURE_REGISTERED(SatLookUpTable);
 
 SatLookUpTable::SatLookUpTable(std::string linkResultPath)
+    : m_table(0),
+      m_ifs(0)
 {
     NS_LOG_FUNCTION(this << linkResultPath);
-    Load(linkResultPath);
+    m_table = SatTableCompiler::Find(linkResultPath);
+    if (m_table == 0)
+    {
+        Load(linkResultPath);
+    }
 }
 
 SatLookUpTable::~SatLookUpTable()
@@ -50,8 +56,7 @@ SatLookUpTable::DoDispose()
 {
     NS_LOG_FUNCTION(this);
 
-    m_esNoDb.clear();
-    m_bler.clear();
+    m_table = 0;
 
     if (m_ifs != 0)
     {
@@ -79,58 +84,33 @@ SatLookUpTable::GetBler(double esNoDb) const
 {
     NS_LOG_FUNCTION(this << esNoDb);
 
-    uint16_t n = m_esNoDb.size();
+    NS_ASSERT(m_table != 0 && m_table->n > 0);
 
-    NS_ASSERT(n > 0);
-    NS_ASSERT(m_bler.size() == n);
-
-    if (esNoDb < m_esNoDb[0])
+    if (esNoDb < m_table->x0)
     {
         // edge case: very low SINR, return maximum BLER (100% error rate)
         NS_LOG_INFO(this << " Very low SINR -> BLER = 1.0");
         return 1.0;
     }
 
-    uint16_t i = 1;
-
-    while ((i < n) && (esNoDb > m_esNoDb[i]))
+    if (m_table->n == 1)
     {
-        i++;
+        NS_LOG_INFO(this << " Very high SINR -> BLER = " << m_table->y[0]);
+        return m_table->y[0];
     }
 
-    NS_LOG_DEBUG(this << " i=" << i << " esno[i]=" << m_esNoDb[i] << " bler[i]=" << m_bler[i]);
-
-    if (i >= n)
+    if (esNoDb > m_table->GetLastX())
     {
         // edge case: very high SINR, return minimum BLER (100% success rate)
-        if (n == 1)
-        {
-            NS_LOG_INFO(this << " Very high SINR -> BLER = " << m_bler[0]);
-            return m_bler[0];
-        }
-        else
-        {
-            NS_LOG_INFO(this << " Very high SINR -> BLER = 0.0");
-            return 0.0;
-        }
-    }
-    else // sinrDb <= m_esNoDb[i]
-    {
-        // normal case
-        NS_ASSERT(i > 0);
-        NS_ASSERT(i < n);
-
-        double esno = esNoDb;
-        double esno0 = m_esNoDb[i - 1];
-        double esno1 = m_esNoDb[i];
-        double bler = SatUtils::Interpolate(esno, esno0, esno1, m_bler[i - 1], m_bler[i]);
-        NS_LOG_INFO(this << " Interpolate: " << esno << " to BLER = " << bler << "(sinr0: " << esno0
-                         << ", sinr1: " << esno1 << ", bler0: " << m_bler[i - 1]
-                         << ", bler1: " << m_bler[i] << ")");
-
-        return bler;
+        NS_LOG_INFO(this << " Very high SINR -> BLER = 0.0");
+        return 0.0;
     }
 
+    // normal case
+    double bler = m_table->Sample(esNoDb);
+    NS_LOG_INFO(this << " Interpolate: " << esNoDb << " to BLER = " << bler);
+    return bler;
+
 } // end of double SatLookUpTable::GetBler (double sinrDb) const
 
 double
@@ -138,40 +118,40 @@ SatLookUpTable::GetEsNoDb(double blerTarget) const
 {
     NS_LOG_FUNCTION(this << blerTarget);
 
-    uint16_t n = m_bler.size();
+    NS_ASSERT(m_table != 0 && m_table->n > 0);
 
-    NS_ASSERT(n > 0);
-    NS_ASSERT(m_esNoDb.size() == n);
+    uint32_t n = m_table->n;
+    const double* bler = m_table->y;
 
     // If the requested BLER is smaller than the smallest BLER entry
     // in the look-up-table
-    if (blerTarget <= m_bler[n - 1])
+    if (blerTarget <= bler[n - 1])
     {
-        return m_esNoDb[n - 1];
+        return m_table->GetLastX();
     }
 
     // The requested BLER is higher than the highest BLER entry
     // in the look-up-table
-    if (blerTarget > m_bler[0])
+    if (blerTarget > bler[0])
     {
         NS_FATAL_ERROR("The BLER target is set to be too high!");
     }
 
     double sinr = 0.0;
     // Go through the list from end to beginning
-    for (uint32_t i = 0; i < n; ++i)
+    for (uint32_t i = 1; i < n; ++i)
     {
-        if (blerTarget >= m_bler[i])
+        if (blerTarget >= bler[i])
         {
             sinr = SatUtils::Interpolate(blerTarget,
-                                         m_bler[i - 1],
-                                         m_bler[i],
-                                         m_esNoDb[i - 1],
-                                         m_esNoDb[i]);
+                                         bler[i - 1],
+                                         bler[i],
+                                         m_table->GetX(i - 1),
+                                         m_table->GetX(i));
             NS_LOG_INFO(this << " Interpolate: " << blerTarget << " to SINR = " << sinr
-                             << "(bler0: " << m_bler[i - 1] << ", bler1: " << m_bler[i]
-                             << ", sinr0: " << m_esNoDb[i - 1] << ", sinr1: " << m_esNoDb[i]
-                             << ")");
+                             << "(bler0: " << bler[i - 1] << ", bler1: " << bler[i]
+                             << ", sinr0: " << m_table->GetX(i - 1)
+                             << ", sinr1: " << m_table->GetX(i) << ")");
             return sinr;
         }
     }
@@ -186,6 +166,7 @@ SatLookUpTable::Load(std::string linkResultPath)
 
     // READ FROM THE SPECIFIED INPUT FILE
 
+    std::string requestedPath = linkResultPath;
     m_ifs = new std::ifstream(linkResultPath.c_str(), std::ifstream::in);
 
     if (!m_ifs->is_open())
@@ -204,6 +185,8 @@ SatLookUpTable::Load(std::string linkResultPath)
     double lastEsNoDb = -100.0; // very low value
     double lastBler = 1.0;      // maximum value
 
+    std::vector<double> esNoDbs;
+    std::vector<double> blers;
     double esNoDb, bler;
     *m_ifs >> esNoDb >> bler;
 
@@ -218,8 +201,8 @@ SatLookUpTable::Load(std::string linkResultPath)
         }
 
         // record the values
-        m_esNoDb.push_back(esNoDb);
-        m_bler.push_back(bler);
+        esNoDbs.push_back(esNoDb);
+        blers.push_back(bler);
         lastEsNoDb = esNoDb;
         lastBler = bler;
 
@@ -234,13 +217,15 @@ SatLookUpTable::Load(std::string linkResultPath)
     // SANITY CHECK PART II
 
     // at least contains one row
-    if (m_esNoDb.empty())
+    if (esNoDbs.empty())
     {
         NS_FATAL_ERROR("Error reading data from file " << linkResultPath << ".");
     }
 
     // SINR and BLER have same size
-    NS_ASSERT(m_esNoDb.size() == m_bler.size());
+    NS_ASSERT(esNoDbs.size() == blers.size());
+
+    m_table = SatTableCompiler::Add(requestedPath, esNoDbs, blers);
 
 } // end of void Load (std::string linkResultPath)
 
@@ -22,6 +22,8 @@
 #ifndef SATELLITE_LOOK_UP_TABLE_H
 #define SATELLITE_LOOK_UP_TABLE_H
 
+#include "sag_compiled_tables.h"
+
 #include <ns3/object.h>
 
 #include <fstream>
@@ -34,6 +36,9 @@ namespace ns3
  * \ingroup satellite
  *
  * \brief Loads a link result file and provide query service for BLER.
+ *
+ * The table comes from SatTableCompiler, so that identical files are parsed at
+ * most once per process and BLER lookups take constant time.
  */
 class SatLookUpTable : public Object
 {
@@ -78,8 +83,7 @@ class SatLookUpTable : public Object
      */
     void Load(std::string linkResultPath);
 
-    std::vector<double> m_esNoDb;
-    std::vector<double> m_bler;
+    const SatCompiledTable* m_table;
     std::ifstream* m_ifs;
 };
 
@@ -36,10 +36,16 @@ namespace ns3
 NS_OBJECT_ENSURE_REGISTERED(SatMutualInformationTable);
 
 SatMutualInformationTable::SatMutualInformationTable(std::string mutualInformationPath)
-    : m_beta(1.0)
+    : m_table(0),
+      m_ifs(0),
+      m_beta(1.0)
 {
     NS_LOG_FUNCTION(this << mutualInformationPath);
-    Load(mutualInformationPath);
+    m_table = SatTableCompiler::Find(mutualInformationPath);
+    if (m_table == 0)
+    {
+        Load(mutualInformationPath);
+    }
 }
 
 SatMutualInformationTable::~SatMutualInformationTable()
@@ -52,8 +58,7 @@ SatMutualInformationTable::DoDispose()
 {
     NS_LOG_FUNCTION(this);
 
-    m_snirDb.clear();
-    m_symbolInformation.clear();
+    m_table = 0;
 
     if (m_ifs != 0)
     {
@@ -88,55 +93,27 @@ SatMutualInformationTable::GetNormalizedSymbolInformation(double snirDb) const
     NS_LOG_FUNCTION(this << snirDb);
     NS_LOG_INFO("SatMutualInformationTable::GetNormalizedSymbolInformation - SNIR dB=" << snirDb);
 
-    uint16_t n = m_snirDb.size();
-
-    NS_ASSERT(n > 0);
-    NS_ASSERT(m_symbolInformation.size() == n);
+    NS_ASSERT(m_table != 0 && m_table->n > 0);
 
-    if (snirDb < m_snirDb[0])
+    if (snirDb < m_table->x0)
     {
         // edge case: very low SNIR, return minimum Symbol Information
         NS_LOG_INFO(this << " Very low SNIR -> Symbol Information = 0.0");
         return 0.0;
     }
 
-    uint16_t i = 1;
-
-    while ((i < n) && (snirDb > m_snirDb[i]))
-    {
-        i++;
-    }
-
-    NS_LOG_DEBUG(this << " i=" << i << " snir[i]=" << m_snirDb[i]
-                      << " symbolInformation[i]=" << m_symbolInformation[i]);
-
-    if (i >= n)
+    if (m_table->n == 1 || snirDb > m_table->GetLastX())
     {
         // edge case: very high SNIR, return maximum Symbol Information
         NS_LOG_INFO(this << " Very high SNIR -> Symbol Information = 1.0");
         return 1.0;
     }
-    else // snirDb <= m_snirDb[i]
-    {
-        // normal case
-        NS_ASSERT(i > 0);
-        NS_ASSERT(i < n);
-
-        double snir = snirDb;
-        double snir0 = m_snirDb[i - 1];
-        double snir1 = m_snirDb[i];
-        double symbolInformation = SatUtils::Interpolate(snir,
-                                                         snir0,
-                                                         snir1,
-                                                         m_symbolInformation[i - 1],
-                                                         m_symbolInformation[i]);
-        NS_LOG_INFO(this << " Interpolate: " << snir << " to Symbol Information = "
-                         << symbolInformation << "(snir0: " << snir0 << ", snir1: " << snir1
-                         << ", symbolInformation0: " << m_symbolInformation[i - 1]
-                         << ", symbolInformation1: " << m_symbolInformation[i] << ")");
-
-        return symbolInformation;
-    }
+
+    // normal case
+    double symbolInformation = m_table->Sample(snirDb);
+    NS_LOG_INFO(this << " Interpolate: " << snirDb << " to Symbol Information = "
+                     << symbolInformation);
+    return symbolInformation;
 
 } // end of double SatMutualInformationTable::GetNormalizedSymbolInformation (double snirDb) const
 
@@ -147,14 +124,14 @@ SatMutualInformationTable::GetSnirDb(double symbolInformationTarget) const
     NS_LOG_INFO("SatMutualInformationTable::GetSnirDb - Symbol Information Target="
                 << symbolInformationTarget);
 
-    uint16_t n = m_symbolInformation.size();
+    NS_ASSERT(m_table != 0 && m_table->n > 0);
 
-    NS_ASSERT(n > 0);
-    NS_ASSERT(m_snirDb.size() == n);
+    uint32_t n = m_table->n;
+    const double* symbolInformation = m_table->y;
 
     // If the requested Symbol Information is smaller than the smallest Symbol Information entry
     // in the look-up-table. Return small value
-    if (symbolInformationTarget <= m_symbolInformation[0])
+    if (symbolInformationTarget <= symbolInformation[0])
     {
         NS_LOG_INFO("SatMutualInformationTable::GetSnirDb - SNIR dB=" << -1.0e10);
         return -1.0e10;
@@ -169,27 +146,27 @@ SatMutualInformationTable::GetSnirDb(double symbolInformationTarget) const
 
     // The requested Symbol Information is higher than the highest Symbol Information entry
     // in the look-up-table
-    if (symbolInformationTarget > m_symbolInformation[n - 1])
+    if (symbolInformationTarget > symbolInformation[n - 1])
     {
-        NS_LOG_INFO("SatMutualInformationTable::GetSnirDb - SNIR dB=" << m_snirDb[n - 1]);
-        return m_snirDb[n - 1];
+        NS_LOG_INFO("SatMutualInformationTable::GetSnirDb - SNIR dB=" << m_table->GetLastX());
+        return m_table->GetLastX();
     }
 
     double snir = 0.0;
     // Go through the list from end to beginning
-    for (uint32_t i = 0; i < n; ++i)
+    for (uint32_t i = 1; i < n; ++i)
     {
-        if (symbolInformationTarget <= m_symbolInformation[i])
+        if (symbolInformationTarget <= symbolInformation[i])
         {
             snir = SatUtils::Interpolate(symbolInformationTarget,
-                                         m_symbolInformation[i - 1],
-                                         m_symbolInformation[i],
-                                         m_snirDb[i - 1],
-                                         m_snirDb[i]);
+                                         symbolInformation[i - 1],
+                                         symbolInformation[i],
+                                         m_table->GetX(i - 1),
+                                         m_table->GetX(i));
             NS_LOG_INFO(this << " Interpolate: " << symbolInformationTarget << " to snir = " << snir
-                             << "(symbolInformation0: " << m_symbolInformation[i - 1]
-                             << ", symbolInformation1: " << m_symbolInformation[i] << ", snir0: "
-                             << m_snirDb[i - 1] << ", snir1: " << m_snirDb[i] << ")");
+                             << "(symbolInformation0: " << symbolInformation[i - 1]
+                             << ", symbolInformation1: " << symbolInformation[i] << ", snir0: "
+                             << m_table->GetX(i - 1) << ", snir1: " << m_table->GetX(i) << ")");
             return snir;
         }
     }
@@ -204,6 +181,7 @@ SatMutualInformationTable::Load(std::string mutualInformationPath)
 
     // READ FROM THE SPECIFIED INPUT FILE
 
+    std::string requestedPath = mutualInformationPath;
     m_ifs = new std::ifstream(mutualInformationPath.c_str(), std::ifstream::in);
 
     if (!m_ifs->is_open())
@@ -222,6 +200,8 @@ SatMutualInformationTable::Load(std::string mutualInformationPath)
     double lastSnirDb = -100.0;         //-1.0e100; // very low value
     double lastSymbolInformation = 0.0; // minimum value
 
+    std::vector<double> snirDbs;
+    std::vector<double> symbolInformations;
     double snirDb, symbolInformation;
     *m_ifs >> snirDb >> symbolInformation;
 
@@ -236,8 +216,8 @@ SatMutualInformationTable::Load(std::string mutualInformationPath)
         }
 
         // record the values
-        m_snirDb.push_back(snirDb);
-        m_symbolInformation.push_back(symbolInformation);
+        snirDbs.push_back(snirDb);
+        symbolInformations.push_back(symbolInformation);
         lastSnirDb = snirDb;
         lastSymbolInformation = symbolInformation;
 
@@ -252,13 +232,15 @@ SatMutualInformationTable::Load(std::string mutualInformationPath)
     // SANITY CHECK PART II
 
     // at least contains one row
-    if (m_snirDb.empty())
+    if (snirDbs.empty())
     {
         NS_FATAL_ERROR("Error reading data from file " << mutualInformationPath << ".");
     }
 
     // SNIR and BLER have same size
-    NS_ASSERT(m_snirDb.size() == m_symbolInformation.size());
+    NS_ASSERT(snirDbs.size() == symbolInformations.size());
+
+    m_table = SatTableCompiler::Add(requestedPath, snirDbs, symbolInformations);
 
 } // end of void Load (std::string mutualInformationPath)
 
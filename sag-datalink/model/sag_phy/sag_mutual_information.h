@@ -22,6 +22,8 @@
 #ifndef SATELLITE_MUTUAL_INFORMATION_TABLE_H
 #define SATELLITE_MUTUAL_INFORMATION_TABLE_H
 
+#include "sag_compiled_tables.h"
+
 #include <ns3/object.h>
 
 #include <fstream>
@@ -34,6 +36,8 @@ namespace ns3
  * \ingroup satellite
  *
  * \brief Loads a mutual information file and provide query service.
+ *
+ * The table comes from SatTableCompiler, see SatLookUpTable.
  */
 class SatMutualInformationTable : public Object
 {
@@ -86,8 +90,7 @@ class SatMutualInformationTable : public Object
      */
     void Load(std::string mutualInformationPath);
 
-    std::vector<double> m_snirDb;
-    std::vector<double> m_symbolInformation;
+    const SatCompiledTable* m_table;
     std::ifstream* m_ifs;
 
     /**
@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/simulator.h"
+#include "ns3/log_sink.h"
 
 NS_LOG_COMPONENT_DEFINE ("SatOutputFileStreamStringContainer");
 
@@ -37,9 +38,7 @@ SatOutputFileStreamStringContainer::GetTypeId (void)
 }
 
 SatOutputFileStreamStringContainer::SatOutputFileStreamStringContainer (std::string filename, std::ios::openmode filemode)
-  : m_outputFileStreamWrapper (),
-  m_outputFileStream (),
-  m_container (),
+  : m_container (),
   m_fileName (filename),
   m_fileMode (filemode)
 {
@@ -47,9 +46,7 @@ SatOutputFileStreamStringContainer::SatOutputFileStreamStringContainer (std::str
 }
 
 SatOutputFileStreamStringContainer::SatOutputFileStreamStringContainer ()
-  : m_outputFileStreamWrapper (),
-  m_outputFileStream (),
-  m_container (),
+  : m_container (),
   m_fileName (),
   m_fileMode ()
 {
@@ -78,21 +75,17 @@ SatOutputFileStreamStringContainer::WriteContainerToFile ()
 {
   NS_LOG_FUNCTION (this);
 
-  OpenStream ();
-
-  if (m_outputFileStream->is_open ())
-    {
-      for (uint32_t i = 0; i < m_container.size (); i++)
-        {
-          *m_outputFileStream <<  m_container[i] << std::endl;
-        }
-      m_outputFileStream->close ();
-    }
-  else
+  std::string content;
+  for (uint32_t i = 0; i < m_container.size (); i++)
     {
-      NS_ABORT_MSG ("Output stream is not valid for writing.");
+      content += m_container[i];
+      content += '\n';
     }
 
+  // written by the log sink thread, open failures surface at LogSink::Flush ()
+  uint32_t file = LogSink::Open (m_fileName, !(m_fileMode & std::ios::app));
+  LogSink::Write (file, std::move (content));
+
   Reset ();
 }
 
@@ -104,15 +97,6 @@ SatOutputFileStreamStringContainer::AddToContainer (std::string newLine)
   m_container.push_back (newLine);
 }
 
-void
-SatOutputFileStreamStringContainer::OpenStream ()
-{
-  NS_LOG_FUNCTION (this);
-
-  m_outputFileStreamWrapper = new SatOutputFileStreamWrapper (m_fileName, m_fileMode);
-  m_outputFileStream = m_outputFileStreamWrapper->GetStream ();
-}
-
 void
 SatOutputFileStreamStringContainer::Reset ()
 {
@@ -127,13 +111,6 @@ SatOutputFileStreamStringContainer::ResetStream ()
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_outputFileStreamWrapper != NULL)
-    {
-      delete m_outputFileStreamWrapper;
-      m_outputFileStreamWrapper = 0;
-    }
-  m_outputFileStream = 0;
-
   m_fileName = "";
   m_fileMode = std::ofstream::out;
 }
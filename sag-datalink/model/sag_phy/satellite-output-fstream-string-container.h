@@ -62,7 +62,7 @@ public:
   ~SatOutputFileStreamStringContainer ();
 
   /**
-   * \brief Function for writing the container contents to file
+   * \brief Function for queueing the container contents to the log sink
    */
   void WriteContainerToFile ();
 
@@ -83,7 +83,7 @@ private:
   void Reset ();
 
   /**
-   * \brief Function for resetting the stream
+   * \brief Function for resetting the file name and mode
    */
   void ResetStream ();
 
@@ -92,21 +92,6 @@ private:
    */
   void ClearContainer ();
 
-  /**
-   * \brief Function for opening the output file stream
-   */
-  void OpenStream ();
-
-  /**
-   * \brief Pointer to output file stream wrapper
-   */
-  SatOutputFileStreamWrapper* m_outputFileStreamWrapper;
-
-  /**
-   * \brief Pointer to output file stream
-   */
-  std::ofstream* m_outputFileStream;
-
   /**
    * \brief Container for lines
    */
@@ -22,6 +22,7 @@
  */
 
 
+#include <algorithm>
 #include "ns3/log.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
@@ -352,7 +353,8 @@ PointToPointLaserNetDevice::TransmitStart (Ptr<Packet> p)
   m_phyTxBeginTrace (m_currentPkt);
   TrackUtilization(true);
 
-  Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+  // the fluid backlog ahead of the packet is sent first
+  Time txTime = m_fluidLoad.GetQueueingDelay () + m_fluidLoad.Stretch (m_bps.CalculateBytesTxTime (p->GetSize ()));
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
@@ -620,7 +622,9 @@ PointToPointLaserNetDevice::GetQueueOccupancyRate(){
 	auto tkpt = this->GetQueue()->GetMaxSize().GetValue();
 //	if(npkt>0)
 //	std::cout<<Simulator::Now().GetSeconds()<<"  "<<npkt<< "  "<< tkpt<<std::endl;
-	return (double)npkt / tkpt * 100.0;
+	// fluid backlog in MTU sized packets
+	double fluid = m_fluidLoad.GetBacklogBytes() / GetMtu();
+	return std::min((npkt + fluid) / tkpt * 100.0, 100.0);
 }
 
 bool
@@ -667,6 +671,8 @@ PointToPointLaserNetDevice::Send (
 
   SAGLinkDoSomethingWhenSend(packet);
 
+  m_fluidLoad.Register (packet, m_bps.GetBitRate (), (uint64_t) GetMaxsize () * GetMtu ());
+
   //
   // We should enqueue and dequeue the packet to hit the tracing hooks.
   //
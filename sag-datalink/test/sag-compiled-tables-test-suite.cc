@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include <fstream>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/sag_compiled_tables.h"
+#include "ns3/sag_lookup_table.h"
+#include "ns3/sag_utils.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup SAGDatalink
+ *
+ * \brief A compiled link result table answers like the parsed source table
+ *
+ * The source is written to a file and loaded through SatLookUpTable, which
+ * compiles it. BLER and Es/No lookups are compared with a linear scan of the
+ * source points, i.e. the lookup before tables were compiled.
+ */
+class CompiledTableAgreementTestCase : public TestCase
+{
+public:
+	CompiledTableAgreementTestCase (std::string name, std::vector<double> esNoDb, std::vector<double> bler, bool uniform);
+
+private:
+	virtual void DoRun (void);
+	double ParsedBler (double esNoDb) const;
+	double ParsedEsNoDb (double blerTarget) const;
+
+	std::string m_name;
+	std::vector<double> m_esNoDb;	//!< source abscissae, increasing
+	std::vector<double> m_bler;	//!< source BLERs, not increasing
+	bool m_uniform;	//!< whether the source fits on a uniform grid
+};
+
+CompiledTableAgreementTestCase::CompiledTableAgreementTestCase (std::string name, std::vector<double> esNoDb, std::vector<double> bler, bool uniform)
+	: TestCase ("Compiled link result table: " + name),
+	  m_name (name),
+	  m_esNoDb (esNoDb),
+	  m_bler (bler),
+	  m_uniform (uniform)
+{
+}
+
+double
+CompiledTableAgreementTestCase::ParsedBler (double esNoDb) const
+{
+	if (esNoDb < m_esNoDb.front ()) {
+		return 1.0;
+	}
+	for (uint32_t i = 1; i < m_esNoDb.size (); i++) {
+		if (esNoDb <= m_esNoDb[i]) {
+			return SatUtils::Interpolate (esNoDb, m_esNoDb[i - 1], m_esNoDb[i], m_bler[i - 1], m_bler[i]);
+		}
+	}
+	return 0.0;
+}
+
+double
+CompiledTableAgreementTestCase::ParsedEsNoDb (double blerTarget) const
+{
+	if (blerTarget <= m_bler.back ()) {
+		return m_esNoDb.back ();
+	}
+	for (uint32_t i = 1; i < m_bler.size (); i++) {
+		if (blerTarget >= m_bler[i]) {
+			return SatUtils::Interpolate (blerTarget, m_bler[i - 1], m_bler[i], m_esNoDb[i - 1], m_esNoDb[i]);
+		}
+	}
+	return m_esNoDb.back ();
+}
+
+void
+CompiledTableAgreementTestCase::DoRun (void)
+{
+	const double tolerance = 1e-9;
+
+	std::string path = CreateTempDirFilename ("compiled_table_" + m_name + ".txt");
+	std::ofstream ofs (path.c_str ());
+	ofs.precision (17);
+	for (uint32_t i = 0; i < m_esNoDb.size (); i++) {
+		ofs << m_esNoDb[i] << " " << m_bler[i] << std::endl;
+	}
+	ofs.close ();
+
+	Ptr<SatLookUpTable> table = CreateObject<SatLookUpTable> (path);
+	const SatCompiledTable* compiled = SatTableCompiler::Find (path);
+	NS_TEST_ASSERT_MSG_NE (compiled, 0, "Table of " << path << " not kept");
+	NS_TEST_EXPECT_MSG_EQ ((compiled->x == 0), m_uniform, "Unexpected grid");
+
+	double first = m_esNoDb.front () - 0.5;
+	double last = m_esNoDb.back () + 0.5;
+	for (double esNoDb = first; esNoDb <= last; esNoDb += 0.0137) {
+		NS_TEST_EXPECT_MSG_EQ_TOL (table->GetBler (esNoDb), ParsedBler (esNoDb), tolerance, "BLER at " << esNoDb << " dB");
+	}
+	for (double esNoDb : m_esNoDb) {
+		NS_TEST_EXPECT_MSG_EQ_TOL (table->GetBler (esNoDb), ParsedBler (esNoDb), tolerance, "BLER at breakpoint " << esNoDb << " dB");
+	}
+	for (double blerTarget = m_bler.front (); blerTarget > m_bler.back (); blerTarget *= 0.7) {
+		NS_TEST_EXPECT_MSG_EQ_TOL (table->GetEsNoDb (blerTarget), ParsedEsNoDb (blerTarget), tolerance, "Es/No at BLER " << blerTarget);
+	}
+}
+
+/**
+ * \ingroup SAGDatalink
+ *
+ * \brief Unit tests of the compiled link result tables
+ */
+class SagCompiledTablesTestSuite : public TestSuite
+{
+public:
+	SagCompiledTablesTestSuite ();
+};
+
+SagCompiledTablesTestSuite::SagCompiledTablesTestSuite ()
+	: TestSuite ("sag-compiled-tables", TestSuite::UNIT)
+{
+	AddTestCase (new CompiledTableAgreementTestCase ("even",
+			{-1.0, -0.8, -0.6, -0.4, -0.2, 0.0, 0.2},
+			{1.0, 0.9, 0.6, 0.2, 0.03, 0.001, 0.00001}, true), TestCase::QUICK);
+	// spacings 0.05, 0.1 and 0.35 share the 0.05 dB grid
+	AddTestCase (new CompiledTableAgreementTestCase ("uneven",
+			{2.0, 2.05, 2.15, 2.5, 2.55, 3.0},
+			{0.95, 0.7, 0.3, 0.01, 0.004, 0.00002}, true), TestCase::QUICK);
+	// no grid of the smallest spacing over at most 16 holds every breakpoint
+	AddTestCase (new CompiledTableAgreementTestCase ("irregular",
+			{0.0, 0.1, 0.1414213562, 0.3, 0.7071067812, 1.0},
+			{0.99, 0.8, 0.5, 0.1, 0.001, 0.0000001}, false), TestCase::QUICK);
+}
+
+static SagCompiledTablesTestSuite g_sagCompiledTablesTestSuite;
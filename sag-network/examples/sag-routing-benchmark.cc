@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+/**
+ * Benchmark of the routing hot paths on synthetic Walker constellations
+ *
+ * For every size PxS (planes x satellites per plane) a +Grid ISL topology is
+ * built in memory: each satellite links to its neighbours in the same plane
+ * and to the satellite of the same slot in the adjacent planes, shifted by
+ * the phase factor across the seam. Inter-plane links get cheaper towards
+ * the poles, so that the shortest paths are not all equal.
+ *
+ * - spf: OspfBuildRouting shortest path tree over the link state database,
+ *   from --spf_roots roots spread over the constellation
+ * - routing_table_lookup: SAGRoutingTable::LookupRoute with a route to every
+ *   interface address, 1/16 of the lookups miss
+ * - single_forward_decide: ArbiterSingleForward next hop of a node with a
+ *   forwarding state to every node, 1/16 of the lookups miss
+ *
+ * Lookup sequences come from a fixed seed. Results are JSON lines, see
+ * BenchmarkReport.
+ *
+ * ./waf --run="sag-routing-benchmark --sizes=6x11,24x48 --output=benchmark.jsonl"
+ */
+
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/benchmark_report.h"
+#include "ns3/ospf_link_state_packet.h"
+#include "ns3/ospf-lsa-identifier.h"
+#include "ns3/ospf-build-routing.h"
+#include "ns3/sag_routing_table.h"
+#include "ns3/arbiter-single-forward.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SagRoutingBenchmark");
+
+typedef std::unordered_map<ospf::OSPFLinkStateIdentifier, std::pair<ospf::LSAHeader, ospf::LSAPacket>, hash_ospfIdt, equal_ospfIdt> LinkStateDatabase;
+
+struct WalkerGrid
+{
+	uint32_t m_planes;
+	uint32_t m_sats;
+	uint32_t m_phase;
+	std::vector<std::vector<std::pair<uint32_t, uint8_t>>> m_links;		//!< Node -> (neighbour, metric), link k uses interface k + 1
+};
+
+static Ipv4Address
+InterfaceAddress(uint32_t node, uint32_t link){
+	// 10.0.0.0/8, four interfaces per satellite
+	return Ipv4Address((10u << 24) | (node << 2) | link);
+}
+
+static std::vector<std::pair<uint32_t, uint32_t>>
+ParseSizes(std::string sizes){
+	std::vector<std::pair<uint32_t, uint32_t>> result;
+	std::stringstream ss(sizes);
+	std::string item;
+	while(std::getline(ss, item, ',')){
+		uint32_t planes, sats;
+		char x;
+		std::stringstream is(item);
+		if(!(is >> planes >> x >> sats) || x != 'x' || planes < 3 || sats < 3){
+			throw std::invalid_argument("Invalid constellation size \"" + item + "\", expected PxS with P, S >= 3");
+		}
+		result.push_back(std::make_pair(planes, sats));
+	}
+	return result;
+}
+
+static WalkerGrid
+BuildWalkerGrid(uint32_t planes, uint32_t sats, uint32_t phase){
+	WalkerGrid grid = {planes, sats, phase, std::vector<std::vector<std::pair<uint32_t, uint8_t>>>(planes * sats)};
+	const uint8_t intraPlaneMetric = 10;
+	for(uint32_t p = 0; p < planes; p++){
+		for(uint32_t s = 0; s < sats; s++){
+			uint32_t node = p * sats + s;
+			uint32_t east = p + 1 == planes ? (s + phase) % sats : s;
+			uint32_t eastNode = (p + 1) % planes * sats + east;
+			// argument of latitude of the link, inter-plane distance shrinks with cos(latitude)
+			double u = 2 * M_PI * (s + double(p * phase) / planes) / sats;
+			uint8_t interPlaneMetric = 1 + uint8_t(std::lround(9 * std::fabs(std::cos(u))));
+
+			grid.m_links[node].push_back(std::make_pair(p * sats + (s + 1) % sats, intraPlaneMetric));
+			grid.m_links[p * sats + (s + 1) % sats].push_back(std::make_pair(node, intraPlaneMetric));
+			grid.m_links[node].push_back(std::make_pair(eastNode, interPlaneMetric));
+			grid.m_links[eastNode].push_back(std::make_pair(node, interPlaneMetric));
+		}
+	}
+	return grid;
+}
+
+static LinkStateDatabase
+BuildLinkStateDatabase(const WalkerGrid& grid){
+	LinkStateDatabase db;
+	for(uint32_t node = 0; node < grid.m_links.size(); node++){
+		std::vector<ospf::LSALinkData> links;
+		for(uint32_t k = 0; k < grid.m_links[node].size(); k++){
+			links.push_back(ospf::LSALinkData(Ipv4Address(grid.m_links[node][k].first), InterfaceAddress(node, k), grid.m_links[node][k].second));
+		}
+		Ipv4Address router(node);
+		db[ospf::OSPFLinkStateIdentifier(1, router, router)] =
+				std::make_pair(ospf::LSAHeader(0, 0, router, router, 1), ospf::LSAPacket(0, links.size(), links));
+	}
+	return db;
+}
+
+static void
+BenchmarkSpf(BenchmarkReport& report, const nlohmann::json& parameters, const WalkerGrid& grid, uint32_t roots){
+	LinkStateDatabase db = BuildLinkStateDatabase(grid);
+	uint32_t nodes = grid.m_links.size();
+	Ptr<ospf::OspfBuildRouting> spf = CreateObject<ospf::OspfBuildRouting>();
+	spf->CalculateShortestPathTree(&db, Ipv4Address(uint32_t(0)));		// warm-up
+
+	uint64_t reached = 0;
+	int64_t start = BenchmarkReport::NowNs();
+	for(uint32_t r = 0; r < roots; r++){
+		reached += spf->CalculateShortestPathTree(&db, Ipv4Address(uint32_t(uint64_t(r) * nodes / roots)));
+	}
+	int64_t wallclockNs = BenchmarkReport::NowNs() - start;
+	report.Record("spf", parameters, roots, wallclockNs, reached, {{"nodes", nodes}, {"lsas", db.size()}});
+}
+
+static void
+BenchmarkRoutingTableLookup(BenchmarkReport& report, const nlohmann::json& parameters, const WalkerGrid& grid, uint32_t lookups, uint32_t seed){
+	Ptr<SAGRoutingTable> table = CreateObject<SAGRoutingTable>();
+	for(uint32_t node = 0; node < grid.m_links.size(); node++){
+		for(uint32_t k = 0; k < grid.m_links[node].size(); k++){
+			SAGRoutingTableEntry entry(0, InterfaceAddress(node, k), Ipv4InterfaceAddress(InterfaceAddress(0, k % 4), Ipv4Mask("255.255.255.252")), InterfaceAddress(grid.m_links[0][k % 4].first, 0));
+			table->AddRoute(entry);
+		}
+	}
+
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<uint32_t> node(0, grid.m_links.size() - 1);
+	std::vector<Ipv4Address> destinations(lookups);
+	for(auto& destination : destinations){
+		// drawn one by one, the order of evaluation of arguments is unspecified
+		uint32_t to = node(rng);
+		uint32_t k = rng() % 4;
+		uint32_t address = InterfaceAddress(to, k).Get();
+		// 1/16 of the lookups miss, nothing outside 10.0.0.0/8 is routed
+		destination = Ipv4Address(rng() % 16 == 0 ? address ^ (1u << 24) : address);
+	}
+
+	SAGRoutingTableEntry entry;
+	uint64_t hits = 0;
+	int64_t start = BenchmarkReport::NowNs();
+	for(auto& destination : destinations){
+		hits += table->LookupRoute(destination, entry);
+	}
+	int64_t wallclockNs = BenchmarkReport::NowNs() - start;
+	report.Record("routing_table_lookup", parameters, lookups, wallclockNs, lookups, {{"routes", table->GetNRoute()}, {"hits", hits}});
+}
+
+static void
+BenchmarkSingleForwardDecide(BenchmarkReport& report, const nlohmann::json& parameters, const WalkerGrid& grid, uint32_t lookups, uint32_t seed){
+	uint32_t nodes = grid.m_links.size();
+	Ptr<ArbiterSingleForward> arbiter = CreateObject<ArbiterSingleForward>();
+	for(uint32_t target = 1; target < nodes; target++){
+		uint32_t k = target % grid.m_links[0].size();
+		arbiter->SetSingleForwardState(target, grid.m_links[0][k].first, k + 1, 1);
+	}
+
+	std::mt19937 rng(seed);
+	std::vector<int32_t> targets(lookups);
+	for(auto& target : targets){
+		// node 0 itself and the ids after the last satellite have no state
+		target = rng() % 16 == 0 ? nodes + rng() % nodes : 1 + rng() % (nodes - 1);
+	}
+
+	Ipv4Header header;
+	Ptr<const Packet> packet;
+	uint64_t hits = 0;
+	int64_t checksum = 0;
+	int64_t start = BenchmarkReport::NowNs();
+	for(int32_t target : targets){
+		std::tuple<int32_t, int32_t, int32_t> next = arbiter->TopologySatelliteNetworkDecide(0, target, packet, header, false);
+		hits += std::get<0>(next) >= 0;
+		checksum += std::get<1>(next);
+	}
+	int64_t wallclockNs = BenchmarkReport::NowNs() - start;
+	report.Record("single_forward_decide", parameters, lookups, wallclockNs, lookups, {{"states", nodes - 1}, {"hits", hits}, {"checksum", checksum}});
+}
+
+int
+main (int argc, char *argv[])
+{
+	std::string sizes = "6x11,12x24,24x48,40x40,72x22";
+	uint32_t phase = 1;
+	uint32_t spfRoots = 8;
+	uint32_t lookups = 1000000;
+	uint32_t seed = 1;
+	std::string output;
+
+	CommandLine cmd;
+	cmd.AddValue ("sizes", "Constellation sizes PxS, comma separated", sizes);
+	cmd.AddValue ("phase", "Walker phase factor", phase);
+	cmd.AddValue ("spf_roots", "Shortest path trees calculated per size", spfRoots);
+	cmd.AddValue ("lookups", "Lookups per size of the table and forwarding benchmarks", lookups);
+	cmd.AddValue ("seed", "Seed of the lookup sequences", seed);
+	cmd.AddValue ("output", "File the JSON lines are appended to, stdout only if empty", output);
+	cmd.Parse (argc, argv);
+
+	BenchmarkReport report("sag-routing", output);
+	for(auto& size : ParseSizes(sizes)){
+		WalkerGrid grid = BuildWalkerGrid(size.first, size.second, phase);
+		nlohmann::json parameters = {{"planes", size.first}, {"sats_per_plane", size.second}, {"phase", phase}, {"seed", seed}};
+		BenchmarkSpf(report, parameters, grid, spfRoots);
+		BenchmarkRoutingTableLookup(report, parameters, grid, lookups, seed);
+		BenchmarkSingleForwardDecide(report, parameters, grid, lookups, seed);
+	}
+
+	Simulator::Destroy ();
+	return 0;
+}
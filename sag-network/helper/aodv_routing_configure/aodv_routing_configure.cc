@@ -32,6 +32,9 @@ AodvRoutingConfigure::AodvRoutingConfigure(Ptr<BasicSimulation> basicSimulation,
 		std::cout << "  > Not enabled explicitly for aodv routing, so disabled" << std::endl;
 	}
 	else{
+		NS_ABORT_MSG_IF(parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_predictable_hello_suppression", "false")),
+				"AODV does not support enable_predictable_hello_suppression");
+
 		//<! ip_global_attribute.json
 		std::string filename = basicSimulation->GetRunDir() + "/config_protocol/ip_global_attribute.json";
 
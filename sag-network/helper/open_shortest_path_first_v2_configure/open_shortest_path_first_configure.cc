@@ -57,6 +57,7 @@ OpenShortestPathFirstConfigure::OpenShortestPathFirstConfigure(Ptr<BasicSimulati
 				m_routingHelper.Set("RouterDeadInterval", TimeValue (Seconds (vj.router_dead_interval_s)));
 				m_routingHelper.Set("RetransmitInterval", TimeValue (Seconds (vj.retransmit_interval_s)));
 				m_routingHelper.Set("LSRefreshTime", TimeValue (Seconds (vj.LSRefreshTime_s)));
+				m_routingHelper.Set("PredictableHelloSuppression", BooleanValue (parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_predictable_hello_suppression", "false"))));
 
 				sagRoutings.push_back(std::make_pair(m_routingHelper, priority));
 
@@ -28,6 +28,7 @@ Sag_Fybbr_Routing_Helper::Sag_Fybbr_Routing_Helper()
 Sag_Fybbr_Routing_Helper::Sag_Fybbr_Routing_Helper(Ptr<BasicSimulation> basicSimulation, NodeContainer nodes)
 {
 	m_factory.SetTypeId ("ns3::fybbr::Fybbr_Rout");
+	m_factory.Set ("PredictableHelloSuppression", BooleanValue (parse_boolean(basicSimulation->GetConfigParamOrDefault("enable_predictable_hello_suppression", "false"))));
     std::cout << "Set up sag_fybbr_routing_helper" << std::endl;
 }
 
@@ -431,7 +431,9 @@ Fybbr_Rout::HelloTimerExpire ()
 		return;
 	}
 	SendHello (m_helloTimeExpireRecord.at(0).first);
-	m_helloTimeExpireRecord.at(0).second += m_helloInterval;
+	// adjacent neighbors on links with a known schedule need no further hellos before the disconnection
+	Ipv4Address ad = m_helloTimeExpireRecord.at(0).first;
+	m_helloTimeExpireRecord.at(0).second = GetNextHelloTime (ad, m_nb.IsAdjacent (ad), m_helloInterval);
 	sort(m_helloTimeExpireRecord.begin(),m_helloTimeExpireRecord.end(),cmp);
 	m_htimer.Cancel ();
 	m_htimer.Schedule (m_helloTimeExpireRecord.at(0).second - Simulator::Now ());
@@ -769,7 +771,7 @@ Fybbr_Rout::RecvHELLO (Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src)
 	if(helloHeader.GetHelloInterval() == m_helloInterval && helloHeader.GetRouterDeadInterval() == m_rtrDeadInterval){
 		// judge whether this is the first time the neighbor has been detected, create a new data structure or update expireTime
 		m_nb.HelloReceived (Ipv4Address(m_ipv4->GetObject<Node>()->GetId()),fybbrHeader.GetAreaID(), receiver, fybbrHeader.GetRouterID(), src, 0,
-				Ipv4Address::GetZero(), Ipv4Address::GetZero(), m_rtrDeadInterval, helloHeader.GetNeighbors());
+				Ipv4Address::GetZero(), Ipv4Address::GetZero(), GetNeighborHoldTime (receiver, m_rtrDeadInterval), helloHeader.GetNeighbors());
 	}
 
 }
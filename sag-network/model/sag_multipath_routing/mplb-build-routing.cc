@@ -38,7 +38,7 @@ MplbBuildRouting::GetTypeId ()
 }
 
 MplbBuildRouting::MplbBuildRouting(){
-
+	m_pathGenerator = CreateObject<MplbPathGenerator>();
 }
 
 MplbBuildRouting::~MplbBuildRouting(){
@@ -60,12 +60,19 @@ MplbBuildRouting::SetTopology(Ptr<Constellation> walkerConstellation){
 	m_walkerConstellation = walkerConstellation;
 }
 
+std::string
+MplbBuildRouting::GetOutputDir (){
+	std::string dir = m_baseDir + "/config_topology/mplb";
+	mkdir_if_not_exists(dir);
+	return dir;
+}
+
 void
 MplbBuildRouting::RouterCalculate (){
 
     // record propagation delay
-    remove_file_if_exists("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/config_topology/propagation_delay.txt");
-    std::ofstream fileProp("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/config_topology/propagation_delay.txt");
+    remove_file_if_exists(GetOutputDir() + "/propagation_delay.txt");
+    std::ofstream fileProp(GetOutputDir() + "/propagation_delay.txt");
 
     auto nodes = m_walkerConstellation->GetNodes();
     for(auto nbs: m_walkerConstellation->GetAdjacency()){
@@ -81,10 +88,9 @@ MplbBuildRouting::RouterCalculate (){
     fileProp.close();
 
 
-	std::srand(500);
 	std::string algorithName = "SegmentRouting"; // "SMORE" "SegmentRouting"
 	m_nPath = 4;
-	m_filtering = "symmetry"; // 'ksp' 'symmetry' just for segmentrouting
+	m_filtering = "symmetry"; // 'ksp' 'ksp_yen' 'symmetry' just for segmentrouting
 	m_segments = 6; //  just for segmentrouting
 
 	m_hasLinkDwon = true;
@@ -213,7 +219,14 @@ MplbBuildRouting::UpdateRoute (){
 
 	NS_ASSERT_MSG(phaseFactor == 0, "Currently only supports 0 phase offset.");
 
+	// The MHBTs of different sources are independent: build them on the path generator's
+	// threads, each source only writing its own (pre-inserted) entry of the path database
+	std::vector<std::unordered_map<uint32_t,std::vector<std::vector<uint32_t>>>*> pathDateBaseFrom(totalSats);
 	for(uint32_t srcSatId = 0; srcSatId < totalSats; srcSatId++){
+		pathDateBaseFrom[srcSatId] = &m_pathDateBase[srcSatId];
+	}
+	m_pathGenerator->ParallelFor(totalSats, [&] (uint32_t srcSatId){
+		auto& srcPathDateBase = *pathDateBaseFrom[srcSatId];
 		// source id in CG
 		uint32_t orbitNumber = srcSatId / satsPerOrbit;
 		uint32_t satNumber = srcSatId % satsPerOrbit;
@@ -320,7 +333,6 @@ MplbBuildRouting::UpdateRoute (){
 					}
 				}
 				VH = VHTemp;
-				std::cout<<"::"<<VHTemp.size()<<std::endl;
 				//MHBT.push_back(VHTemp);
 
 				// calculate all path
@@ -329,8 +341,8 @@ MplbBuildRouting::UpdateRoute (){
 					//std::cout<<h<<std::endl;
 					// Duplicate paths are not re-added if they are already included in other regions.
 					if(curTreeNode.coordinate.first == srcTreeNode.coordinate.first || curTreeNode.coordinate.second == srcTreeNode.coordinate.second){
-						auto iter = m_pathDateBase[srcSatId].find(curTreeNode.nodeId);
-						if(iter != m_pathDateBase[srcSatId].end()){
+						auto iter = srcPathDateBase.find(curTreeNode.nodeId);
+						if(iter != srcPathDateBase.end()){
 							continue;
 						}
 					}
@@ -339,7 +351,7 @@ MplbBuildRouting::UpdateRoute (){
 						std::vector<uint32_t> path;
 						path.push_back(srcSatId);
 						path.push_back(curTreeNode.nodeId);
-						m_pathDateBase[srcSatId][curTreeNode.nodeId].push_back(path);
+						srcPathDateBase[curTreeNode.nodeId].push_back(path);
 					}
 					else{
 						auto iter = find(record[curTreeNode.fatherTreeNode->nodeId].begin(), record[curTreeNode.fatherTreeNode->nodeId].end(), curTreeNode.nodeId);
@@ -348,12 +360,11 @@ MplbBuildRouting::UpdateRoute (){
 							continue;
 						}
 						record[curTreeNode.fatherTreeNode->nodeId].push_back(curTreeNode.nodeId);
-						std::vector<std::vector<uint32_t>> paths = m_pathDateBase[srcSatId][curTreeNode.fatherTreeNode->nodeId];
+						std::vector<std::vector<uint32_t>> paths = srcPathDateBase[curTreeNode.fatherTreeNode->nodeId];
 						NS_ASSERT_MSG(paths.size() != 0, "No available paths.");
-						std::cout<<"--"<<paths.size()<<std::endl;
 						for(auto curPath : paths){
 							curPath.push_back(curTreeNode.nodeId);
-							m_pathDateBase[srcSatId][curTreeNode.nodeId].push_back(curPath);
+							srcPathDateBase[curTreeNode.nodeId].push_back(curPath);
 						}
 					}
 				}
@@ -369,13 +380,13 @@ MplbBuildRouting::UpdateRoute (){
 				MHBT.push_back(ft);
 
 			}
-			//std::cout<<m_pathDateBase[srcSatId].size()<<std::endl;
+			//std::cout<<srcPathDateBase.size()<<std::endl;
 		}
 
 
 
 
-	}
+	});
 
 	// Select N capacity-aware optimal paths between each node pair
 	//FilteringNPath(4);
@@ -669,8 +680,8 @@ MplbBuildRouting::FilteringNPath_symmetry (uint8_t nPath){
 
 
 	// 4. Print network and paths information for DRL training in a numerical environment
-	remove_file_if_exists("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/MPLB_mapping_"+std::to_string(0)+".txt");
-	std::ofstream mplb_txt("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/MPLB_mapping_"+std::to_string(0)+".txt");
+	remove_file_if_exists(GetOutputDir() + "/MPLB_mapping_"+std::to_string(0)+".txt");
+	std::ofstream mplb_txt(GetOutputDir() + "/MPLB_mapping_"+std::to_string(0)+".txt");
 
 	// m, n
 	// route1
@@ -905,8 +916,8 @@ MplbBuildRouting::FilteringNPath(uint8_t nPath){
 
 
 	// 4. Print network and paths information for DRL training in a numerical environment
-	remove_file_if_exists("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/config_topology/MPLB.txt");
-	std::ofstream mplb_txt("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/config_topology/MPLB.txt");
+	remove_file_if_exists(GetOutputDir() + "/MPLB.txt");
+	std::ofstream mplb_txt(GetOutputDir() + "/MPLB.txt");
 
 	// m, n
 	// route1
@@ -951,16 +962,40 @@ MplbBuildRouting::FilteringNPath_KSP(uint8_t nPath){
 
 
 	// 2. Randomly select the top K shortest paths
-	auto src2all = m_pathDateBase[0];
+	// Candidates come from the MHBT enumeration, or from the path generator's
+	// loopless k-shortest paths when the enumeration is skipped ('ksp_yen')
+	std::unordered_map<uint32_t, std::vector<std::vector<uint32_t>>> src2all;
+	if(m_filtering == "ksp_yen"){
+		std::vector<uint32_t> dsts;
+		for(auto t : m_adjacency){
+			dsts.push_back(t.first);
+		}
+		auto& candidates = m_pathGenerator->GetKShortestPaths({0}, dsts, nPath);
+		auto it = candidates.find(0);
+		if(it != candidates.end()){
+			for(auto& c : it->second){
+				src2all[c.first] = c.second;
+			}
+		}
+	}
+	else{
+		src2all = m_pathDateBase[0];
+	}
 	for(auto paths2dst: src2all){
+		if(paths2dst.second.size() == 0){
+			continue;
+		}
 		//std::cout<<src2all.first<<"  "<<paths2dst.first<<std::endl;
 		// for searching n path
 		if(paths2dst.second.size() > nPath){
 			uint32_t a = 0;
 			uint32_t b = paths2dst.second.size();
 			std::vector<uint32_t> pathsIndex;
+			// one stream per destination, independent of the map iteration order
+			std::mt19937_64 rng = m_pathGenerator->GetStream(0, paths2dst.first);
+			std::uniform_int_distribution<uint32_t> pick(a, b - 1);
 			while(pathsIndex.size() < nPath){
-				uint32_t index = rand() % (b-a) + a;
+				uint32_t index = pick(rng);
 				if(find(pathsIndex.begin(), pathsIndex.end(), index) == pathsIndex.end()){
 					pathsIndex.push_back(index);
 				}
@@ -987,25 +1022,31 @@ MplbBuildRouting::FilteringNPath_KSP(uint8_t nPath){
 	}
 
 	// Just calculate all the routes starting from one node, and copy them to other starting points.
+	// Every starting point only writes its own (pre-inserted) entry, so the copies run in parallel.
 	uint32_t curNodesId = 0;
+	std::vector<std::unordered_map<uint32_t,std::vector<std::vector<uint32_t>>>*> routesFrom(totalSats);
 	for(uint32_t nodeId = 0; nodeId < totalSats; nodeId++){
+		routesFrom[nodeId] = &m_routeAllPairs[nodeId];
+	}
+	const auto& routesFromCur = *routesFrom[curNodesId];
+	m_pathGenerator->ParallelFor(totalSats, [&] (uint32_t nodeId){
 		if(nodeId == curNodesId){
-			continue;
+			return;
 		}
 
-		for(auto paths2dstInAllInAll : m_routeAllPairs[curNodesId]){
+		for(auto& paths2dstInAllInAll : routesFromCur){
 			//uint32_t dstNodeId = paths2dstInAllInAll.first;
-			for(auto path : paths2dstInAllInAll.second){
+			for(auto& path : paths2dstInAllInAll.second){
 				auto newPath = MappingPath(curNodesId, nodeId, path, satsPerOrbit, orbits);
-				m_routeAllPairs[nodeId][*(newPath.end()-1)].push_back(newPath);
+				(*routesFrom[nodeId])[*(newPath.end()-1)].push_back(newPath);
 			}
 		}
-	}
+	});
 
 
 	// 3. Print network and paths information for DRL training in a numerical environment
-	remove_file_if_exists("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/config_topology/MPLB_KSP.txt");
-	std::ofstream mplb_txt("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/config_topology/MPLB_KSP.txt");
+	remove_file_if_exists(GetOutputDir() + "/MPLB_KSP.txt");
+	std::ofstream mplb_txt(GetOutputDir() + "/MPLB_KSP.txt");
 
 	// m, n
 	// route1
@@ -1045,7 +1086,7 @@ MplbBuildRouting::FilteringNPath_KSP(uint8_t nPath){
 void
 MplbBuildRouting::UpdateRouteSegment (){
 	uint8_t nPath = m_nPath;
-	std::string al = m_filtering; // 'ksp' 'symmetry'
+	std::string al = m_filtering; // 'ksp' 'ksp_yen' 'symmetry'
 	uint32_t segmentRouting = m_segments;
 	uint32_t satsPerOrbit = m_walkerConstellation->GetSatNum();
 	uint32_t orbits = m_walkerConstellation->GetOrbitNum();
@@ -1099,14 +1140,20 @@ MplbBuildRouting::UpdateRouteSegment (){
 	m_nodes = nodes;
 	m_initialAdjacency = m_adjacency;
 
-
+	// The MHBT candidates only depend on the ISL graph, keep them while the topology epoch is unchanged
+	if(m_pathGenerator->SetAdjacency(m_adjacency)){
+		m_pathDateBase.clear();
+		m_pathDateBaseSegmentNumber.clear();
+		m_pathDateBaseSegmentDirection.clear();
+	}
+	bool buildMHBT = al != "ksp_yen" && m_pathDateBase.find(0) == m_pathDateBase.end();
 
 
 	// 1. construct a minimum-hop binary tree (MHBT)
 
 	NS_ASSERT_MSG(phaseFactor == 0, "Currently only supports 0 phase offset.");
 
-	for(uint32_t srcSatId = 0; srcSatId < totalSats; srcSatId++){
+	for(uint32_t srcSatId = 0; buildMHBT && srcSatId < totalSats; srcSatId++){
 		// source id in CG
 		uint32_t orbitNumber = srcSatId / satsPerOrbit;
 		uint32_t satNumber = srcSatId % satsPerOrbit;
@@ -1310,7 +1357,7 @@ MplbBuildRouting::UpdateRouteSegment (){
 	if(al == "symmetry"){
 		FilteringNPath_symmetry(nPath); // 'ksp' 'symmetry'
 	}
-	else if(al == "ksp"){
+	else if(al == "ksp" || al == "ksp_yen"){
 		FilteringNPath_KSP(nPath);
 	}
 
@@ -1338,12 +1385,12 @@ bool MplbBuildRouting::UpdateRouteSegment (uint32_t curLinkDownNumber, uint32_t
     links.push_back(std::make_pair(tempNodeId, tempNodeId + satsPerOrbit));
 
     uint32_t linksSelected = 1;
-    std::srand(10*sampleIndex);
+    std::mt19937_64 rng = m_pathGenerator->GetStream(sampleIndex);
     while(linksSelected != curLinkDownNumber){
 		// [a,b]
 		uint32_t a = 0;
 		uint32_t b = nodes.size() - 1;
-		uint32_t randoxNumber = a + rand() % ( b -a +1 ) ;
+		uint32_t randoxNumber = std::uniform_int_distribution<uint32_t>(a, b)(rng);
 		uint32_t curnode = nodes[randoxNumber];
 		std::cout<<a<<" "<<b<<" randoxNumber: "<<randoxNumber<<std::endl;
 		if(find(links.begin(), links.end(), std::make_pair(curnode, curnode + satsPerOrbit)) == links.end()){
@@ -1436,8 +1483,8 @@ bool MplbBuildRouting::UpdateRouteSegment (uint32_t curLinkDownNumber, uint32_t
 
 
 	// 3. Print network and paths information for DRL training in a numerical environment
-	remove_file_if_exists("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/MPLB_mapping_"+std::to_string(sampleIndex)+".txt");
-	std::ofstream mplb_txt("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/MPLB_mapping_"+std::to_string(sampleIndex)+".txt");
+	remove_file_if_exists(GetOutputDir() + "/MPLB_mapping_"+std::to_string(sampleIndex)+".txt");
+	std::ofstream mplb_txt(GetOutputDir() + "/MPLB_mapping_"+std::to_string(sampleIndex)+".txt");
 	// m, n
 	// route1
 	// ...
@@ -1601,22 +1648,11 @@ MplbBuildRouting::UpdateRouteSMORE (){
 			for(auto ts : m_adjacency){
 				uint32_t curNode = ts.first;
 				// (1)Dijkstra
-				m_preNode.clear();
-				std::pair<double, double> res = std::make_pair(0.0, 100000000.0);
-				for(auto t : m_adjacency){
-
-					std::pair<double, double> res_temp = Dijkstra(t.first);
-					NS_ASSERT_MSG(res_temp.second != 0, "Wrong.");
-					if(res_temp.first > res.first){
-						res.first = res_temp.first;
-					}
-					if(res_temp.second < res.second){
-						res.second = res_temp.second;
-					}
-				}
+				std::pair<double, double> res = ShortestPathTrees();
 				// (2)Generate a randomized routing tree (RRT)
 				rrt.clear();
-				RandomizedRoutingTree (res.second, res.first);
+				std::mt19937_64 rng = m_pathGenerator->GetStream(0, p, curNode);
+				RandomizedRoutingTree (res.second, res.first, rng);
 	//			for(auto ts : m_adjacency){
 	//				uint32_t curNode = ts.first;
 	//				for(auto td : m_adjacency){
@@ -1665,22 +1701,11 @@ MplbBuildRouting::UpdateRouteSMORE (){
 		for(uint8_t p = 0; p < nPath; p++){
 			std::cout<<"Route: "<<p<<std::endl;
 			// (1)Dijkstra
-			m_preNode.clear();
-			std::pair<double, double> res = std::make_pair(0.0, 100000000.0);
-			for(auto t : m_adjacency){
-
-				std::pair<double, double> res_temp = Dijkstra(t.first);
-				NS_ASSERT_MSG(res_temp.second != 0, "Wrong.");
-				if(res_temp.first > res.first){
-					res.first = res_temp.first;
-				}
-				if(res_temp.second < res.second){
-					res.second = res_temp.second;
-				}
-			}
+			std::pair<double, double> res = ShortestPathTrees();
 			// (2)Generate a randomized routing tree (RRT)
 			rrt.clear();
-			RandomizedRoutingTree (res.second, res.first);
+			std::mt19937_64 rng = m_pathGenerator->GetStream(0, p, curNode);
+			RandomizedRoutingTree (res.second, res.first, rng);
 			for(auto td : m_adjacency){
 				uint32_t dstNode = td.first;
 	//			// (1)Dijkstra
@@ -1744,8 +1769,8 @@ MplbBuildRouting::UpdateRouteSMORE (){
 
 
 	// 3. Print network and paths information for DRL training in a numerical environment
-	remove_file_if_exists("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/MPLB_SMORE_"+std::to_string(0)+".txt");
-	std::ofstream mplb_txt("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/MPLB_SMORE_"+std::to_string(0)+".txt");
+	remove_file_if_exists(GetOutputDir() + "/MPLB_SMORE_"+std::to_string(0)+".txt");
+	std::ofstream mplb_txt(GetOutputDir() + "/MPLB_SMORE_"+std::to_string(0)+".txt");
 
 	// m, n
 	// route1
@@ -1841,8 +1866,8 @@ MplbBuildRouting::Vertify(std::vector<std::pair<uint32_t, uint32_t>> links, uint
 
 void
 MplbBuildRouting::WriteAdjacency(std::vector<std::pair<uint32_t, uint32_t>> links, uint32_t sampleIndex){
-	remove_file_if_exists("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/Adjacency_"+std::to_string(sampleIndex)+".txt");
-	std::ofstream fileISL("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/Adjacency_"+std::to_string(sampleIndex)+".txt");
+	remove_file_if_exists(GetOutputDir() + "/Adjacency_"+std::to_string(sampleIndex)+".txt");
+	std::ofstream fileISL(GetOutputDir() + "/Adjacency_"+std::to_string(sampleIndex)+".txt");
 	auto list_isls = m_walkerConstellation->GetIslFromToUnique();
 
 	for(auto lk : links){
@@ -1949,12 +1974,12 @@ MplbBuildRouting::UpdateRouteSMORE (uint32_t curLinkDownNumber, uint32_t sampleI
     links.push_back(std::make_pair(tempNodeId, tempNodeId + satsPerOrbit));
 
     uint32_t linksSelected = 1;
-    std::srand(10*sampleIndex);
+    std::mt19937_64 rng = m_pathGenerator->GetStream(sampleIndex);
     while(linksSelected != curLinkDownNumber){
 		// [a,b]
 		uint32_t a = 0;
 		uint32_t b = nodes.size() - 1;
-		uint32_t randoxNumber = a + rand() % ( b -a +1 ) ;
+		uint32_t randoxNumber = std::uniform_int_distribution<uint32_t>(a, b)(rng);
 		uint32_t curnode = nodes[randoxNumber];
 		std::cout<<a<<" "<<b<<" randoxNumber: "<<randoxNumber<<std::endl;
 		if(find(links.begin(), links.end(), std::make_pair(curnode, curnode + satsPerOrbit)) == links.end()){
@@ -2004,22 +2029,11 @@ MplbBuildRouting::UpdateRouteSMORE (uint32_t curLinkDownNumber, uint32_t sampleI
 		for(auto ts : reroutes){
 			uint32_t curNode = ts.first;
 			// (1)Dijkstra
-			m_preNode.clear();
-			std::pair<double, double> res = std::make_pair(0.0, 100000000.0);
-			for(auto t : m_adjacency){
-
-				std::pair<double, double> res_temp = Dijkstra(t.first);
-				NS_ASSERT_MSG(res_temp.second != 0, "Wrong.");
-				if(res_temp.first > res.first){
-					res.first = res_temp.first;
-				}
-				if(res_temp.second < res.second){
-					res.second = res_temp.second;
-				}
-			}
+			std::pair<double, double> res = ShortestPathTrees();
 			// (2)Generate a randomized routing tree (RRT)
 			rrt.clear();
-			RandomizedRoutingTree (res.second, res.first);
+			std::mt19937_64 rng = m_pathGenerator->GetStream(sampleIndex, p, ((uint64_t)curNode << 32) | ts.second);
+			RandomizedRoutingTree (res.second, res.first, rng);
 
 			uint32_t dstNode = ts.second;
 			// select routes
@@ -2046,8 +2060,8 @@ MplbBuildRouting::UpdateRouteSMORE (uint32_t curLinkDownNumber, uint32_t sampleI
 
 
 	// 3. Print network and paths information for DRL training in a numerical environment
-	remove_file_if_exists("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/MPLB_SMORE_"+std::to_string(sampleIndex)+".txt");
-	std::ofstream mplb_txt("/home/xiaoyuliu/sag_platform_v3/bake/source/ns-3.35/scratch/main_satnet/test_data/flexsate/MPLB_SMORE_"+std::to_string(sampleIndex)+".txt");
+	remove_file_if_exists(GetOutputDir() + "/MPLB_SMORE_"+std::to_string(sampleIndex)+".txt");
+	std::ofstream mplb_txt(GetOutputDir() + "/MPLB_SMORE_"+std::to_string(sampleIndex)+".txt");
 
 	// m, n
 	// route1
@@ -2167,8 +2181,41 @@ MplbBuildRouting::Dijkstra (uint32_t curNode){
 }
 
 
+std::pair<double,double>
+MplbBuildRouting::ShortestPathTrees (){
+
+	// Same result as running Dijkstra () from every node, computed on the path generator's threads
+	m_pathGenerator->SetAdjacency(m_adjacency);
+	m_preNode.clear();
+	m_dist.clear();
+	m_pathGenerator->ComputeShortestPathTrees(m_cost, m_preNode, m_dist);
+
+	std::pair<double, double> res = std::make_pair(0.0, 100000000.0);
+	for(auto t : m_adjacency){
+		auto& dist = m_dist[t.first];
+		double maxd = 0.0;
+		double mind = 100000000.0;
+		for(auto d : dist){
+			maxd = std::max(maxd, d.second);
+			if(d.first != t.first){
+				mind = std::min(mind, d.second);
+			}
+		}
+		NS_ASSERT_MSG(mind != 0, "Wrong.");
+		if(maxd > res.first){
+			res.first = maxd;
+		}
+		if(mind < res.second){
+			res.second = mind;
+		}
+	}
+	return res;
+
+}
+
+
 void
-MplbBuildRouting::RandomizedRoutingTree (uint32_t mindist, uint32_t maxdist){
+MplbBuildRouting::RandomizedRoutingTree (uint32_t mindist, uint32_t maxdist, std::mt19937_64& rng){
 	double k = 2 / mindist;
 	double temp = k;
 	if(k > 1){
@@ -2193,7 +2240,7 @@ MplbBuildRouting::RandomizedRoutingTree (uint32_t mindist, uint32_t maxdist){
 		delta++;
 	}
 	// Find U [1,2)       [0,100)/100 + 1
-	double U = ((rand() % (100-0))+ 0) / 100.0 + 1.0;
+	double U = std::uniform_int_distribution<uint32_t>(0, 99)(rng) / 100.0 + 1.0;
 
 	uint32_t i = delta - 1;
 	double R = std::pow(2, i-1) * U;
@@ -2203,7 +2250,7 @@ MplbBuildRouting::RandomizedRoutingTree (uint32_t mindist, uint32_t maxdist){
 //	for(std::map<uint32_t, uint32_t>::iterator it = m_mappingShuffle2NodeId.begin(); it != m_mappingShuffle2NodeId.end(); it++){
 //		S.push_back(it->first);
 //	}
-	random_shuffle(m_shuffle.begin(), m_shuffle.end());
+	std::shuffle(m_shuffle.begin(), m_shuffle.end(), rng);
 	S = m_shuffle;
 
 	//std::vector<std::vector<RandomizedRoutingTreeNode>> rrt;
@@ -27,6 +27,7 @@
 #include <map>
 #include <unordered_map>
 #include <vector>
+#include <random>
 
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-interface-address.h"
@@ -35,6 +36,7 @@
 #include "ns3/exp-util.h"
 #include "ns3/sag_routing_table.h"
 #include "ns3/walker-constellation-structure.h"
+#include "mplb-path-generator.h"
 
 
 namespace ns3 {
@@ -114,7 +116,8 @@ public:
 	void WriteAdjacency(std::vector<std::pair<uint32_t, uint32_t>> links, uint32_t sampleIndex);
 	bool Vertify(std::vector<std::pair<uint32_t, uint32_t>> links, uint32_t curLinkDownNumber);
 	std::pair<double,double> Dijkstra (uint32_t curNode);
-	void RandomizedRoutingTree (uint32_t mindist, uint32_t maxdist);
+	std::pair<double,double> ShortestPathTrees ();
+	void RandomizedRoutingTree (uint32_t mindist, uint32_t maxdist, std::mt19937_64& rng);
 	std::vector<RandomizedRoutingTreeNode> Clustering(uint32_t level, RandomizedRoutingTreeNode rrtNode, RandomizedRoutingTreeNode* rrtNodeFather, double R, uint32_t k);
 	bool Distance(uint32_t node1, uint32_t node2, double R, uint32_t k);
 	std::vector<uint32_t> SelectPath(uint32_t src, uint32_t dst);
@@ -130,6 +133,12 @@ public:
 	void SetRtrCalTimeEnable(bool rtrCalTimeConsidered){
 		m_rtrCalTimeConsidered = rtrCalTimeConsidered;
 	}
+	void SetBaseDir(std::string baseDir){
+		m_baseDir = baseDir;
+	}
+	Ptr<MplbPathGenerator> GetPathGenerator(){
+		return m_pathGenerator;
+	}
 
 
 private:
@@ -145,6 +154,10 @@ private:
 	  bool m_hasLinkDwon;
 	  std::unordered_map<std::pair<uint32_t, uint32_t>, std::set<std::pair<uint32_t, uint32_t>>, pairHash> m_link2Routes;
 	  std::unordered_map<uint32_t, std::vector<std::vector<std::pair<uint32_t, uint32_t>>>> m_downLinks;
+	  std::string m_baseDir;
+	  Ptr<MplbPathGenerator> m_pathGenerator;
+
+	  std::string GetOutputDir ();
 
 
 
@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "mplb-path-generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MplbPathGenerator");
+
+namespace mplb {
+
+NS_OBJECT_ENSURE_REGISTERED (MplbPathGenerator);
+
+TypeId
+MplbPathGenerator::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::mplb::MplbPathGenerator")
+    .SetParent<Object> ()
+    .SetGroupName ("MPLB")
+    .AddConstructor<MplbPathGenerator> ()
+	.AddAttribute ("Threads",
+			"Number of worker threads used for path generation (0: one per hardware thread).",
+			UintegerValue (0),
+			MakeUintegerAccessor (&MplbPathGenerator::m_threads),
+			MakeUintegerChecker<uint32_t> ())
+	.AddAttribute ("Seed",
+			"Base seed of the per-task random streams.",
+			UintegerValue (500),
+			MakeUintegerAccessor (&MplbPathGenerator::m_seed),
+			MakeUintegerChecker<uint64_t> ())
+  ;
+  return tid;
+}
+
+MplbPathGenerator::MplbPathGenerator ()
+	: m_threads (0),
+	  m_seed (500),
+	  m_epoch (0),
+	  m_cachedK (0)
+{
+}
+
+MplbPathGenerator::~MplbPathGenerator ()
+{
+}
+
+bool
+MplbPathGenerator::SetAdjacency (const std::unordered_map<uint32_t, std::vector<uint32_t>>& adjacency)
+{
+	// Canonical (sorted) dense form, so that two equal graphs compare equal
+	// regardless of the unordered_map iteration order
+	std::vector<uint32_t> nodeIds;
+	for(auto& it : adjacency){
+		nodeIds.push_back(it.first);
+	}
+	std::sort(nodeIds.begin(), nodeIds.end());
+	std::unordered_map<uint32_t, uint32_t> nodeIndex;
+	for(uint32_t i = 0; i < nodeIds.size(); i++){
+		nodeIndex[nodeIds[i]] = i;
+	}
+	std::vector<std::vector<uint32_t>> dense(nodeIds.size());
+	for(uint32_t i = 0; i < nodeIds.size(); i++){
+		for(auto nb : adjacency.at(nodeIds[i])){
+			auto it = nodeIndex.find(nb);
+			if(it != nodeIndex.end()){
+				dense[i].push_back(it->second);
+			}
+		}
+		std::sort(dense[i].begin(), dense[i].end());
+	}
+
+	if(m_epoch > 0 && nodeIds == m_nodeIds && dense == m_adjacency){
+		NS_LOG_LOGIC ("Topology unchanged, keeping epoch " << m_epoch);
+		return false;
+	}
+
+	m_nodeIds = nodeIds;
+	m_nodeIndex = nodeIndex;
+	m_adjacency = dense;
+	m_epoch++;
+	m_kspCache.clear();
+	m_cachedK = 0;
+	NS_LOG_LOGIC ("New topology epoch " << m_epoch);
+	return true;
+}
+
+uint64_t
+MplbPathGenerator::GetEpoch () const
+{
+	return m_epoch;
+}
+
+uint32_t
+MplbPathGenerator::GetThreadNumber () const
+{
+	if(m_threads > 0){
+		return m_threads;
+	}
+	uint32_t hw = std::thread::hardware_concurrency();
+	return hw > 0 ? hw : 1;
+}
+
+void
+MplbPathGenerator::ParallelFor (uint32_t n, std::function<void (uint32_t)> f) const
+{
+	uint32_t workers = std::min(GetThreadNumber(), n);
+	if(workers <= 1){
+		for(uint32_t i = 0; i < n; i++){
+			f(i);
+		}
+		return;
+	}
+
+	std::atomic<uint32_t> next (0);
+	std::exception_ptr error = nullptr;
+	std::mutex errorMutex;
+	auto work = [&] (){
+		while(true){
+			uint32_t i = next.fetch_add(1);
+			if(i >= n){
+				return;
+			}
+			try{
+				f(i);
+			}
+			catch(...){
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if(!error){
+					error = std::current_exception();
+				}
+				next.store(n);
+				return;
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for(uint32_t t = 0; t < workers; t++){
+		pool.emplace_back(work);
+	}
+	for(auto& th : pool){
+		th.join();
+	}
+	if(error){
+		std::rethrow_exception(error);
+	}
+}
+
+// splitmix64 finaliser, used to decorrelate the per-task seeds
+static uint64_t
+MixSeed (uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+std::mt19937_64
+MplbPathGenerator::GetStream (uint64_t a, uint64_t b, uint64_t c) const
+{
+	uint64_t s = MixSeed(m_seed);
+	s = MixSeed(s ^ a);
+	s = MixSeed(s ^ b);
+	s = MixSeed(s ^ c);
+	return std::mt19937_64(s);
+}
+
+std::vector<uint32_t>
+MplbPathGenerator::BfsPath (uint32_t src, uint32_t dst, const std::vector<bool>& blockedNode,
+		const std::vector<std::pair<uint32_t, uint32_t>>& blockedEdges) const
+{
+	uint32_t n = m_adjacency.size();
+	std::vector<int64_t> pre(n, -1);
+	std::vector<bool> visited(n, false);
+	std::queue<uint32_t> q;
+	q.push(src);
+	visited[src] = true;
+	while(!q.empty()){
+		uint32_t cur = q.front();
+		q.pop();
+		if(cur == dst){
+			break;
+		}
+		for(auto nb : m_adjacency[cur]){
+			if(visited[nb] || blockedNode[nb]){
+				continue;
+			}
+			if(find(blockedEdges.begin(), blockedEdges.end(), std::make_pair(cur, nb)) != blockedEdges.end()){
+				continue;
+			}
+			visited[nb] = true;
+			pre[nb] = cur;
+			q.push(nb);
+		}
+	}
+	std::vector<uint32_t> path;
+	if(!visited[dst]){
+		return path;
+	}
+	for(int64_t cur = dst; cur != -1; cur = pre[cur]){
+		path.push_back(cur);
+	}
+	std::reverse(path.begin(), path.end());
+	return path;
+}
+
+std::vector<std::vector<uint32_t>>
+MplbPathGenerator::KShortestPaths (uint32_t src, uint32_t dst, uint32_t k) const
+{
+	// Yen's algorithm on hop count, dense node indices
+	std::vector<std::vector<uint32_t>> A;
+	std::vector<std::vector<uint32_t>> B;
+	std::vector<bool> noBlockedNode(m_adjacency.size(), false);
+	auto first = BfsPath(src, dst, noBlockedNode, {});
+	if(first.empty()){
+		return A;
+	}
+	A.push_back(first);
+
+	while(A.size() < k){
+		const std::vector<uint32_t> prev = A.back();
+		for(uint32_t j = 0; j + 1 < prev.size(); j++){
+			uint32_t spurNode = prev[j];
+			std::vector<uint32_t> root(prev.begin(), prev.begin() + j + 1);
+
+			std::vector<std::pair<uint32_t, uint32_t>> blockedEdges;
+			for(auto& p : A){
+				if(p.size() > j + 1 && std::equal(root.begin(), root.end(), p.begin())){
+					blockedEdges.push_back(std::make_pair(p[j], p[j + 1]));
+				}
+			}
+			std::vector<bool> blockedNode(m_adjacency.size(), false);
+			for(uint32_t r = 0; r < j; r++){
+				blockedNode[root[r]] = true;
+			}
+
+			auto spur = BfsPath(spurNode, dst, blockedNode, blockedEdges);
+			if(spur.empty()){
+				continue;
+			}
+			std::vector<uint32_t> candidate(root.begin(), root.end() - 1);
+			candidate.insert(candidate.end(), spur.begin(), spur.end());
+			if(find(B.begin(), B.end(), candidate) == B.end() && find(A.begin(), A.end(), candidate) == A.end()){
+				B.push_back(candidate);
+			}
+		}
+		if(B.empty()){
+			break;
+		}
+		// shortest first, lexicographic order breaks ties deterministically
+		auto best = std::min_element(B.begin(), B.end(),
+				[](const std::vector<uint32_t>& l, const std::vector<uint32_t>& r){
+					return l.size() != r.size() ? l.size() < r.size() : l < r;
+				});
+		A.push_back(*best);
+		B.erase(best);
+	}
+	return A;
+}
+
+const MplbPathGenerator::PathDatabase&
+MplbPathGenerator::GetKShortestPaths (const std::vector<uint32_t>& srcs, const std::vector<uint32_t>& dsts, uint32_t k)
+{
+	NS_ASSERT_MSG(m_epoch > 0, "MplbPathGenerator: SetAdjacency must be called first.");
+	if(k != m_cachedK){
+		m_kspCache.clear();
+		m_cachedK = k;
+	}
+
+	// Collect the destinations that still have missing pairs
+	std::vector<uint32_t> todo;
+	for(auto dst : dsts){
+		for(auto src : srcs){
+			if(src == dst){
+				continue;
+			}
+			auto it = m_kspCache.find(src);
+			if(it == m_kspCache.end() || it->second.find(dst) == it->second.end()){
+				todo.push_back(dst);
+				break;
+			}
+		}
+	}
+	NS_LOG_LOGIC ("Epoch " << m_epoch << ": " << dsts.size() - todo.size() << " destinations cached, "
+			<< todo.size() << " to compute");
+
+	// One task per destination, each writes to its own slot
+	std::vector<std::vector<std::pair<uint32_t, PathSet>>> results(todo.size());
+	ParallelFor(todo.size(), [&] (uint32_t t){
+		uint32_t dst = todo[t];
+		auto dstIt = m_nodeIndex.find(dst);
+		for(auto src : srcs){
+			if(src == dst){
+				continue;
+			}
+			PathSet paths;
+			auto srcIt = m_nodeIndex.find(src);
+			if(srcIt != m_nodeIndex.end() && dstIt != m_nodeIndex.end()){
+				for(auto& p : KShortestPaths(srcIt->second, dstIt->second, k)){
+					std::vector<uint32_t> path;
+					for(auto idx : p){
+						path.push_back(m_nodeIds[idx]);
+					}
+					paths.push_back(path);
+				}
+			}
+			results[t].push_back(std::make_pair(src, paths));
+		}
+	});
+
+	for(uint32_t t = 0; t < todo.size(); t++){
+		for(auto& r : results[t]){
+			m_kspCache[r.first][todo[t]] = std::move(r.second);
+		}
+	}
+	return m_kspCache;
+}
+
+void
+MplbPathGenerator::ComputeShortestPathTrees (const CostMap& cost,
+		std::unordered_map<uint32_t, std::unordered_map<uint32_t, uint32_t>>& preNode,
+		std::unordered_map<uint32_t, std::unordered_map<uint32_t, double>>& dist)
+{
+	NS_ASSERT_MSG(m_epoch > 0, "MplbPathGenerator: SetAdjacency must be called first.");
+	uint32_t n = m_adjacency.size();
+
+	// Dense copy of the weights, aligned with m_adjacency
+	std::vector<std::vector<double>> weight(n);
+	for(uint32_t i = 0; i < n; i++){
+		auto costIt = cost.find(m_nodeIds[i]);
+		for(auto nb : m_adjacency[i]){
+			double w = 1;
+			if(costIt != cost.end()){
+				auto wIt = costIt->second.find(m_nodeIds[nb]);
+				if(wIt != costIt->second.end()){
+					w = wIt->second;
+				}
+			}
+			weight[i].push_back(w);
+		}
+	}
+
+	const double maxdist = 99999999.9;
+	std::vector<std::vector<int64_t>> pre(n);
+	std::vector<std::vector<double>> d(n);
+	ParallelFor(n, [&] (uint32_t s){
+		std::vector<double>& ds = d[s];
+		std::vector<int64_t>& ps = pre[s];
+		ds.assign(n, maxdist);
+		ps.assign(n, -1);
+		std::vector<bool> done(n, false);
+		typedef std::pair<double, uint32_t> QItem;
+		std::priority_queue<QItem, std::vector<QItem>, std::greater<QItem>> q;
+		ds[s] = 0;
+		q.push(std::make_pair(0.0, s));
+		while(!q.empty()){
+			uint32_t best = q.top().second;
+			q.pop();
+			if(done[best]){
+				continue;
+			}
+			done[best] = true;
+			for(uint32_t e = 0; e < m_adjacency[best].size(); e++){
+				uint32_t nb = m_adjacency[best][e];
+				double newdist = ds[best] + weight[best][e];
+				if(!done[nb] && newdist < ds[nb]){
+					ds[nb] = newdist;
+					ps[nb] = best;
+					q.push(std::make_pair(newdist, nb));
+				}
+			}
+		}
+	});
+
+	for(uint32_t s = 0; s < n; s++){
+		auto& p = preNode[m_nodeIds[s]];
+		auto& dm = dist[m_nodeIds[s]];
+		p.clear();
+		dm.clear();
+		for(uint32_t v = 0; v < n; v++){
+			dm[m_nodeIds[v]] = d[s][v];
+			if(pre[s][v] >= 0){
+				p[m_nodeIds[v]] = m_nodeIds[pre[s][v]];
+			}
+		}
+	}
+}
+
+}
+}
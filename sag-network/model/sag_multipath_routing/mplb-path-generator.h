@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef MPLB_PATH_GENERATOR_H
+#define MPLB_PATH_GENERATOR_H
+
+#include <stdint.h>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/object.h"
+
+namespace ns3 {
+namespace mplb {
+
+/**
+ * \ingroup MPLB
+ *
+ * \brief Candidate path generation for MPLB.
+ *
+ * Computes per-destination k-shortest-path candidates and shortest path trees
+ * on a pool of worker threads. The workers only touch plain adjacency and cost
+ * arrays, never ns-3 objects, so they can run while the simulator is paused
+ * inside a routing recomputation.
+ *
+ * Candidate sets only depend on the ISL graph, so they are cached under a
+ * topology epoch: the epoch is bumped whenever SetAdjacency () sees a graph
+ * that differs from the previous one, and the cache is kept as long as only
+ * link weights change.
+ *
+ * Every random decision is drawn from GetStream (), which derives an
+ * independent generator from the configured seed and the task identifiers, so
+ * results do not depend on thread count or scheduling order.
+ */
+class MplbPathGenerator : public Object
+{
+public:
+	typedef std::vector<std::vector<uint32_t>> PathSet;
+	typedef std::unordered_map<uint32_t, std::unordered_map<uint32_t, PathSet>> PathDatabase;
+	typedef std::unordered_map<uint32_t, std::unordered_map<uint32_t, uint32_t>> CostMap;
+
+	static TypeId GetTypeId ();
+	MplbPathGenerator ();
+	~MplbPathGenerator ();
+
+	/**
+	 * \brief Set the ISL graph the candidates are computed on.
+	 *
+	 * \param adjacency node id -> neighbour ids
+	 *
+	 * \return true if the graph differs from the previous one (new epoch)
+	 */
+	bool SetAdjacency (const std::unordered_map<uint32_t, std::vector<uint32_t>>& adjacency);
+	uint64_t GetEpoch () const;
+
+	/**
+	 * \brief Get up to k loopless minimum-hop paths for every (src, dst) pair.
+	 *
+	 * Pairs already computed in the current epoch with the same k are served
+	 * from the cache; the missing ones are computed per destination in parallel.
+	 */
+	const PathDatabase& GetKShortestPaths (const std::vector<uint32_t>& srcs, const std::vector<uint32_t>& dsts, uint32_t k);
+
+	/**
+	 * \brief Dijkstra from every node in the graph under the given link cost.
+	 *
+	 * \param cost link cost, cost[a][b] for every edge of the adjacency
+	 * \param preNode (out) per source predecessor map
+	 * \param dist (out) per source distance map
+	 */
+	void ComputeShortestPathTrees (const CostMap& cost,
+			std::unordered_map<uint32_t, std::unordered_map<uint32_t, uint32_t>>& preNode,
+			std::unordered_map<uint32_t, std::unordered_map<uint32_t, double>>& dist);
+
+	/**
+	 * \brief Run f(0) ... f(n-1) on the worker threads and wait for all of them.
+	 */
+	void ParallelFor (uint32_t n, std::function<void (uint32_t)> f) const;
+
+	/**
+	 * \brief Independent random stream for one task.
+	 *
+	 * The stream only depends on the seed attribute and the three task
+	 * identifiers (e.g. sample index, path index, node id).
+	 */
+	std::mt19937_64 GetStream (uint64_t a, uint64_t b = 0, uint64_t c = 0) const;
+
+	void SetSeed (uint64_t seed){
+		m_seed = seed;
+	}
+	uint32_t GetThreadNumber () const;
+
+private:
+	std::vector<std::vector<uint32_t>> KShortestPaths (uint32_t src, uint32_t dst, uint32_t k) const;
+	std::vector<uint32_t> BfsPath (uint32_t src, uint32_t dst, const std::vector<bool>& blockedNode,
+			const std::vector<std::pair<uint32_t, uint32_t>>& blockedEdges) const;
+
+	uint32_t m_threads;
+	uint64_t m_seed;
+
+	// dense copy of the adjacency
+	std::vector<uint32_t> m_nodeIds;
+	std::unordered_map<uint32_t, uint32_t> m_nodeIndex;
+	std::vector<std::vector<uint32_t>> m_adjacency;
+	uint64_t m_epoch;
+
+	// candidate cache of the current epoch
+	uint32_t m_cachedK;
+	PathDatabase m_kspCache;
+};
+
+}
+}
+
+#endif /* MPLB_PATH_GENERATOR_H */
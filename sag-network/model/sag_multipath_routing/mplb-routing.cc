@@ -293,6 +293,7 @@ MultiPathLoadBalance::DoInitialize (void)
 	NS_LOG_FUNCTION (this);
 
 	m_routeBuild->SetTopology(m_walkerConstellation);
+	m_routeBuild->SetBaseDir(m_baseDir);
 	m_routeBuild->RouterCalculate();
 	Ipv4RoutingProtocol::DoInitialize ();
 }
@@ -499,6 +499,16 @@ OspfBuildRouting::UpdateRoute (){
 
 }
 
+uint32_t
+OspfBuildRouting::CalculateShortestPathTree (std::unordered_map<OSPFLinkStateIdentifier, std::pair<LSAHeader,LSAPacket>, hash_ospfIdt, equal_ospfIdt>* db,
+		Ipv4Address rootRouterId){
+	m_db = db;
+	m_rootRouterId = rootRouterId;
+	ConstructAdjacency();
+	UpdateRoute();
+	return m_preNode.size();
+}
+
 void
 OspfBuildRouting::DoUpdateRoute (Time t){
 
@@ -61,6 +61,14 @@ public:
 	bool ConstructAdjacency ();
 	bool ConstructAdjacency (std::vector<std::pair<LSAHeader,LSAPacket>> lsaList);
 	void UpdateRoute ();
+	/**
+	 * \brief Shortest path tree of rootRouterId over db, without installing routes
+	 *
+	 * Needs no IPv4 stack, for benchmarks and tests of the SPF calculation.
+	 * \return number of routers reached from rootRouterId
+	 */
+	uint32_t CalculateShortestPathTree (std::unordered_map<OSPFLinkStateIdentifier, std::pair<LSAHeader,LSAPacket>, hash_ospfIdt, equal_ospfIdt>* db,
+			Ipv4Address rootRouterId);
 	void ReadRoute ();
 	void ReadUpdateRoute(uint32_t gs, uint32_t sat);
 
@@ -48,6 +48,8 @@ class OSPFLSDB {
     //std::map<OSPFLinkStateIdentifier, Time> m_addedTime; // LSA added time record
     std::unordered_map<OSPFLinkStateIdentifier, uint32_t, hash_ospfIdt, equal_ospfIdt> m_addedAge; // LSA Age
     std::unordered_map<OSPFLinkStateIdentifier, uint32_t, hash_ospfIdt, equal_ospfIdt> m_LsAddedTime; // LSA Generated time
+    std::unordered_map<OSPFLinkStateIdentifier, uint32_t, hash_ospfIdt, equal_ospfIdt> m_denseIndex; // LSA -> dense index, kept when the LSA is removed
+    std::vector<OSPFLinkStateIdentifier> m_denseId; // dense index -> LSA
 
 
     uint32_t m_maxAge = 36000;
@@ -137,6 +139,44 @@ public:
 
     void Add(std::pair<LSAHeader,LSAPacket> lsa);
 
+    // Dense index of an LSA, for the per-neighbor LSA bitmaps. Indices are
+    // assigned on first use and never reused, so a bit stays valid while
+    // the LSA is replaced by newer instances.
+    uint32_t GetDenseIndex(const OSPFLinkStateIdentifier& id) {
+    	auto it = m_denseIndex.find(id);
+    	if(it != m_denseIndex.end()){
+    		return it->second;
+    	}
+    	uint32_t index = m_denseId.size();
+    	m_denseIndex[id] = index;
+    	m_denseId.push_back(id);
+    	return index;
+    }
+
+    uint32_t GetDenseIndex(LSAHeader tempHeader) {
+    	OSPFLinkStateIdentifier id(tempHeader.GetLSAType(),tempHeader.GetLinkStateID(),tempHeader.GetAdvertisiongRouter());
+    	return GetDenseIndex(id);
+    }
+
+    bool FindDenseIndex(LSAHeader tempHeader, uint32_t& index) const {
+    	OSPFLinkStateIdentifier id(tempHeader.GetLSAType(),tempHeader.GetLinkStateID(),tempHeader.GetAdvertisiongRouter());
+    	auto it = m_denseIndex.find(id);
+    	if(it == m_denseIndex.end()){
+    		return false;
+    	}
+    	index = it->second;
+    	return true;
+    }
+
+    const OSPFLinkStateIdentifier& GetIdentifier(uint32_t index) const {
+    	return m_denseId.at(index);
+    }
+
+    // Header of the database copy, without updating its age
+    LSAHeader GetHeader(const OSPFLinkStateIdentifier& id) const {
+    	return m_db.at(id).first;
+    }
+
     void UpdateRoute();
 
     void LSAAgingEvent(OSPFLinkStateIdentifier IDForAgingEvent){
@@ -21,7 +21,9 @@
 #define OSPF_LS_IDENTIFIER_H
 
 #include <set>
+#include <vector>
 #include <iostream>
+#include <stdint.h>
 
 
 #include "ns3/ipv4-address.h"
@@ -71,6 +73,69 @@ struct OSPFLinkStateIdentifier {
 
 
 };
+
+/**
+ * \brief Set of LSAs, indexed by the dense LSA index of the LSDB
+ *
+ * Bits are grouped in 64-bit words so that set differences and scans handle
+ * 64 LSAs per operation.
+ */
+class LSABitmap {
+public:
+    LSABitmap() : m_count(0) {}
+
+    void Set(uint32_t index) {
+        uint32_t k = index >> 6;
+        if (k >= m_words.size()) {
+            m_words.resize(k + 1, 0);
+        }
+        uint64_t bit = (uint64_t)1 << (index & 63);
+        if (!(m_words[k] & bit)) {
+            m_words[k] |= bit;
+            m_count++;
+        }
+    }
+
+    void Reset(uint32_t index) {
+        uint32_t k = index >> 6;
+        uint64_t bit = (uint64_t)1 << (index & 63);
+        if (k < m_words.size() && (m_words[k] & bit)) {
+            m_words[k] &= ~bit;
+            m_count--;
+        }
+    }
+
+    bool Test(uint32_t index) const {
+        uint32_t k = index >> 6;
+        return k < m_words.size() && (m_words[k] >> (index & 63)) & 1;
+    }
+
+    void Clear() {
+        m_words.clear();
+        m_count = 0;
+    }
+
+    bool Empty() const {
+        return m_count == 0;
+    }
+
+    uint32_t GetCount() const {
+        return m_count;
+    }
+
+    uint32_t GetNWords() const {
+        return m_words.size();
+    }
+
+    // Bits 64 * k to 64 * k + 63, zero beyond the highest set bit
+    uint64_t GetWord(uint32_t k) const {
+        return k < m_words.size() ? m_words[k] : 0;
+    }
+
+private:
+    std::vector<uint64_t> m_words;
+    uint32_t m_count;
+};
 }
 }
 
@@ -69,6 +69,20 @@ Neighbors::IsNeighbor (Ipv4Address addr)
   return false;
 }
 
+bool
+Neighbors::IsAdjacent (Ipv4Address localAddress)
+{
+  for (std::vector<Neighbor>::const_iterator i = m_nb.begin ();
+       i != m_nb.end (); ++i)
+    {
+      if (i->m_localAddress == localAddress && i->m_state >= NeighborState_2Way)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
 std::vector<Ipv4Address>
 Neighbors::GetNeighbors ()
 {
@@ -188,7 +202,9 @@ Neighbors::OneWayReceived (std::vector<Neighbor>::iterator i)
 		 list and Link state request list are cleared of LSAs*/
 		NS_LOG_LOGIC ("Clear the link state retransmission list, database summary list and link state request list");
 		i->m_lsRequestList.clear();
-		i->m_lsRetransList.clear();
+		i->m_lsRetransList.Clear();
+		i->m_LSATransmitted.Clear();
+		i->m_lsRetransmitEvent.Cancel();
 		i->m_dbSummaryList.clear();
 	}
 	// update neighbors and expireTime
@@ -775,7 +791,7 @@ Neighbors::UpdateRetransmit (Ipv4Address localAddress, Ipv4Address neighborAddre
 	for (std::vector<Neighbor>::iterator i = m_nb.begin(); i != m_nb.end(); ++i) {
 		if (i->m_neighborAddress == neighborAddress && i->m_localAddress == localAddress) {
 			found = true;
-			i->m_LSATransmitted.clear();
+			i->m_LSATransmitted.Clear();
 			i->m_lsRetransmitEvent.Cancel();
 			SendFromRetransmissionList(i);
 			break;
@@ -890,7 +906,6 @@ Neighbors::LSRReceived (Ipv4Address myOwnrouterID, Ipv4Address nbAddress, LSRHea
 	}
 	else if(it->m_state == NeighborState_Exchange || it->m_state == NeighborState_Loading || it->m_state == NeighborState_Full){
 		std::vector<LSRPacket> LSRPackets = lsr.GetLSRs();
-		std::vector<std::pair<LSAHeader,LSAPacket>> lsas = {};
 		for (std::vector<LSRPacket>::iterator i = LSRPackets.begin(); i != LSRPackets.end(); ++i)
 		{
 			uint32_t LinkStateType = i->GetLSType();
@@ -901,9 +916,7 @@ Neighbors::LSRReceived (Ipv4Address myOwnrouterID, Ipv4Address nbAddress, LSRHea
 			if (Has == true)
 			{
 				///#Mengy: add lsa to the lsu, send lsu
-				std::pair<LSAHeader,LSAPacket> lsa = m_lsdb.Get(lsaidenti);
-				lsas.push_back(lsa);
-				it->m_lsRetransList.push_back(lsa);
+				AddToRetransmissionList(it, m_lsdb.GetDenseIndex(lsaidenti));
 			}
 			else
 			{
@@ -1325,6 +1338,7 @@ void
 Neighbors::Flood (std::vector<std::pair<LSAHeader,LSAPacket>> lsas, Ipv4Address myOwnrouterID, Ipv4Address nbAddress){
 
 	for(auto lsa : lsas){
+		uint32_t index = m_lsdb.GetDenseIndex(lsa.first);
 		for(std::vector<Neighbor>::iterator iter = m_nb.begin();iter!=m_nb.end();++iter)
 		{
 			if(iter->m_state < NeighborState_Exchange)
@@ -1356,7 +1370,7 @@ Neighbors::Flood (std::vector<std::pair<LSAHeader,LSAPacket>> lsas, Ipv4Address
 					}
 				}
 
-				iter->m_lsRetransList.push_back(lsa);
+				AddToRetransmissionList(iter, index);
 
 			}
 		}
@@ -1722,9 +1736,9 @@ Neighbors::DeleteNeighbor(std::vector<Neighbor>::iterator i){
 	i->m_requestRetransmitEvent.Cancel();
 	i->m_lsRetransmitEvent.Cancel();
 	i->m_requestTransmitted.clear();
-	i->m_LSATransmitted.clear();
+	i->m_LSATransmitted.Clear();
 	i->m_lsRequestList.clear();
-	i->m_lsRetransList.clear();
+	i->m_lsRetransList.Clear();
 	i->m_dbSummaryList.clear();
 
 }
@@ -1780,45 +1794,66 @@ Neighbors::SendFromRequestList(std::vector<Neighbor>::iterator i){
 			&Neighbors::RequestRetransmit, this, i->m_localAddress, i->m_neighborAddress);
 }
 
+void
+Neighbors::AddToRetransmissionList(std::vector<Neighbor>::iterator i, uint32_t index){
+	i->m_lsRetransList.Set(index);
+	// The instance sent before is superseded, send the database copy again
+	i->m_LSATransmitted.Reset(index);
+}
+
 void
 Neighbors::SendFromRetransmissionList(std::vector<Neighbor>::iterator i){
-	if(i->m_lsRetransmitEvent.IsRunning() || i->m_lsRetransList.empty()){
-		if(i->m_lsRetransList.empty()){
-			i->m_lsRetransmitEvent.Cancel();
-		}
-		return;
-	}
-	if(!i->m_LSATransmitted.empty()){
+	if(i->m_lsRetransList.Empty()){
+		i->m_lsRetransmitEvent.Cancel();
 		return;
 	}
 
 	// Ip header 20 bytes
-	// typeID 1 byte
 	// ospf header 10 bytes
 	OspfHeader ospfHeader = OspfHeader();
 	// LSU header 4 bytes
 	// LSUPacket
+	uint32_t emptyLSUSize = 20 + ospfHeader.GetSerializedSize() + 4;
+	uint32_t mtu = GetInterfaceMtu(i->m_localAddress);
 
 	std::vector<std::pair<LSAHeader,LSAPacket>> sentList;
-	std::vector<LSAHeader> sentHeader;
-	uint32_t LSUPacketSize = ospfHeader.GetSerializedSize() + 20 + 4;
-	for(auto lsa : i->m_lsRetransList){
-		LSUPacketSize += (lsa.first.GetSerializedSize() + lsa.second.GetSerializedSize());
-		if(LSUPacketSize <= 1500){
+	uint32_t LSUPacketSize = emptyLSUSize;
+	for(uint32_t k = 0; k < i->m_lsRetransList.GetNWords(); k++){
+		// LSAs on the retransmission list not sent since the last retransmission
+		uint64_t word = i->m_lsRetransList.GetWord(k) & ~i->m_LSATransmitted.GetWord(k);
+		while(word != 0){
+			uint32_t index = (k << 6) + __builtin_ctzll(word);
+			word &= word - 1;
+			OSPFLinkStateIdentifier id = m_lsdb.GetIdentifier(index);
+			if(!m_lsdb.Has(id)){
+				// Removed from the database, nothing to flood any more
+				i->m_lsRetransList.Reset(index);
+				continue;
+			}
+			std::pair<LSAHeader,LSAPacket> lsa = m_lsdb.Get(id);
+			uint32_t lsaSize = lsa.first.GetSerializedSize() + lsa.second.GetSerializedSize();
+			if(!sentList.empty() && LSUPacketSize + lsaSize > mtu){
+				m_handleLSUTriggering(i->m_localAddress, i->m_neighborAddress, sentList);
+				sentList.clear();
+				LSUPacketSize = emptyLSUSize;
+			}
 			sentList.push_back(lsa);
-			sentHeader.push_back(lsa.first);
-		}
-		else{
-			break;
+			LSUPacketSize += lsaSize;
+			i->m_LSATransmitted.Set(index);
 		}
 	}
-	i->m_LSATransmitted = sentHeader;
-	m_handleLSUTriggering(i->m_localAddress, i->m_neighborAddress, sentList);
+	if(!sentList.empty()){
+		m_handleLSUTriggering(i->m_localAddress, i->m_neighborAddress, sentList);
+	}
 
-	// retransmit schedule
-	i->m_lsRetransmitEvent.Cancel();
-	i->m_lsRetransmitEvent = Simulator::Schedule(m_rxmtInterval,
-			&Neighbors::UpdateRetransmit, this, i->m_localAddress, i->m_neighborAddress);
+	if(i->m_lsRetransList.Empty()){
+		i->m_lsRetransmitEvent.Cancel();
+	}
+	else if(!i->m_lsRetransmitEvent.IsRunning()){
+		// retransmit schedule
+		i->m_lsRetransmitEvent = Simulator::Schedule(m_rxmtInterval,
+				&Neighbors::UpdateRetransmit, this, i->m_localAddress, i->m_neighborAddress);
+	}
 
 }
 
@@ -1843,24 +1878,36 @@ void
 Neighbors::DeleteFromRetransmissionList(std::vector<Neighbor>::iterator i, std::vector<LSAHeader> lasack){
 
 	for(auto lsaHeader : lasack){
-		auto it = find(i->m_LSATransmitted.begin(), i->m_LSATransmitted.end(), lsaHeader);
-		if(it != i->m_LSATransmitted.end()){
-			i->m_LSATransmitted.erase(it);
-			for(std::vector<std::pair<LSAHeader,LSAPacket>>::iterator iter = i->m_lsRetransList.begin(); iter != i->m_lsRetransList.end(); iter++){
-				if(iter->first == lsaHeader){
-					i->m_lsRetransList.erase(iter);
-					break;
-				}
-			}
+		uint32_t index;
+		if(!m_lsdb.FindDenseIndex(lsaHeader, index) || !i->m_LSATransmitted.Test(index)){
+			continue;
+		}
+		OSPFLinkStateIdentifier id(lsaHeader.GetLSAType(), lsaHeader.GetLinkStateID(), lsaHeader.GetAdvertisiongRouter());
+		if(m_lsdb.Has(id) && m_lsdb.GetHeader(id).GetLSSequence() > lsaHeader.GetLSSequence()){
+			// Acknowledges an instance older than the one being flooded
+			continue;
 		}
+		i->m_LSATransmitted.Reset(index);
+		i->m_lsRetransList.Reset(index);
 	}
-	if(i->m_LSATransmitted.empty()){
+	if(i->m_lsRetransList.Empty()){
 		i->m_lsRetransmitEvent.Cancel();
-		SendFromRetransmissionList(i);
 	}
 
 }
 
+uint32_t
+Neighbors::GetInterfaceMtu(Ipv4Address ad){
+	if(m_ipv4 == nullptr){
+		return 1500;
+	}
+	int32_t itface = m_ipv4->GetInterfaceForAddress(ad);
+	if(itface < 0){
+		return 1500;
+	}
+	return m_ipv4->GetMtu(itface);
+}
+
 uint8_t
 Neighbors::GetLinkCost(Ipv4Address ad){
 
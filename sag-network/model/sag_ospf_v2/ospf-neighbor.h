@@ -109,8 +109,9 @@ public:
 		/// Last received Database Description packet's DD sequence
 		uint32_t m_ddSeqNumLast;
 
-		/// Link state retransmission list
-		std::vector<std::pair<LSAHeader,LSAPacket>> m_lsRetransList;
+		/// Link state retransmission list: LSAs flooded to the neighbor and not yet acknowledged, by dense LSDB index.
+		/// The database copy is sent, which is the instance that was flooded or a newer one replacing it.
+		LSABitmap m_lsRetransList;
 		/// Database summary list
 		std::vector<LSAHeader> m_dbSummaryList;
 		/// Link state request list
@@ -133,10 +134,10 @@ public:
 		EventId m_requestRetransmitEvent;
 		/// Requests transmitted
 		std::vector<LSAHeader> m_requestTransmitted;
-		/// The future request retransmit event scheduled
+		/// The future LSU retransmit event scheduled
 		EventId m_lsRetransmitEvent;
-		/// LSAs transmitted
-		std::vector<LSAHeader> m_LSATransmitted;
+		/// LSAs of the retransmission list sent since the last retransmission
+		LSABitmap m_LSATransmitted;
 
 
 		/**
@@ -165,7 +166,6 @@ public:
 			m_optionLast = 0;
 			m_ddSeqNumLast = 0;
 
-			m_lsRetransList = {};
 			m_lsRequestList = {};
 
 			m_DDRetransmitEvent = EventId();
@@ -190,6 +190,12 @@ public:
    * \returns true if the node with IP address is a neighbor
    */
   bool IsNeighbor (Ipv4Address addr);
+  /**
+   * Check that a neighbor heard on the interface with address localAddress has reached 2-Way
+   * \param localAddress the IP address of the local interface
+   * \returns true if the neighbor is at least in state 2-Way
+   */
+  bool IsAdjacent (Ipv4Address localAddress);
 
   std::vector<Ipv4Address> GetNeighbors ();
   /**
@@ -272,8 +278,12 @@ public:
   void DeleteTopOfDBSummaryList(std::vector<Neighbor>::iterator i);
   /// Send From Request List
   void SendFromRequestList(std::vector<Neighbor>::iterator i);
-  /// Send From Retransmission List
+  /// Send the LSAs of the retransmission list not sent yet, packed into LSUs up to the interface MTU
   void SendFromRetransmissionList(std::vector<Neighbor>::iterator i);
+  /// Add an LSA to the retransmission list, replacing an instance still waiting for acknowledgment
+  void AddToRetransmissionList(std::vector<Neighbor>::iterator i, uint32_t index);
+  /// MTU of the interface with address ad
+  uint32_t GetInterfaceMtu(Ipv4Address ad);
   /// Delete From Request List
   void DeleteFromRequestList(std::vector<Neighbor>::iterator i, std::vector<LSAHeader> lsaack);
   /// Delete From LSA Retransmission List
@@ -33,6 +33,7 @@
 #include "ns3/sag_routing_protocal.h"
 #include "ns3/arbiter-single-forward.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/sag_link_layer.h"
 
 namespace ns3 {
 
@@ -72,6 +73,10 @@ namespace ns3 {
 				StringValue (""),
 				MakeStringAccessor (&SAGRoutingProtocal::m_baseDir),
 				MakeStringChecker ())
+		.AddAttribute ("PredictableHelloSuppression", "Skip hellos to adjacent neighbors while the topology schedule guarantees the link is up.",
+				 BooleanValue (false),
+				 MakeBooleanAccessor (&SAGRoutingProtocal::m_helloSuppression),
+				 MakeBooleanChecker ())
 				;
         return tid;
     }
@@ -86,6 +91,41 @@ namespace ns3 {
         NS_LOG_FUNCTION(this);
     }
 
+    Time
+    SAGRoutingProtocal::GetScheduledUpUntil(Ipv4Address localAddress)
+    {
+    	if(!m_helloSuppression){
+    		return Time(0);
+    	}
+    	int32_t interface = m_ipv4->GetInterfaceForAddress(localAddress);
+    	if(interface < 0){
+    		return Time(0);
+    	}
+    	Ptr<SAGLinkLayer> link = m_ipv4->GetNetDevice(interface)->GetObject<SAGLinkLayer>();
+    	return link == nullptr ? Time(0) : link->GetScheduledUpUntil();
+    }
+
+    Time
+    SAGRoutingProtocal::GetNeighborHoldTime(Ipv4Address localAddress, Time rtrDeadInterval)
+    {
+    	// the scheduled disconnection takes the interface down, which removes the neighbor
+    	Time until = GetScheduledUpUntil(localAddress);
+    	if(until > Simulator::Now()){
+    		return until - Simulator::Now() + rtrDeadInterval;
+    	}
+    	return rtrDeadInterval;
+    }
+
+    Time
+    SAGRoutingProtocal::GetNextHelloTime(Ipv4Address localAddress, bool adjacent, Time helloInterval)
+    {
+    	Time until = GetScheduledUpUntil(localAddress);
+    	if(adjacent && until > Simulator::Now() + helloInterval){
+    		return until;
+    	}
+    	return Simulator::Now() + helloInterval;
+    }
+
     void
     SAGRoutingProtocal::NotifyInterfaceUp(uint32_t i) 
     {
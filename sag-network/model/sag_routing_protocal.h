@@ -190,6 +190,27 @@ public:
 
     void CalculationTimeLog(uint32_t nodeId, Time curTime, double calculationTime);
 
+    /**
+     * \brief Time up to which the link of a local interface is known to stay up
+     *
+     * \return zero if hello suppression is disabled or the disconnection is unpredictable
+     */
+    Time GetScheduledUpUntil(Ipv4Address localAddress);
+
+    /**
+     * \brief How long a neighbor heard on a local interface is kept without further hellos
+     *
+     * Extended to the scheduled disconnection plus rtrDeadInterval on predictable links.
+     */
+    Time GetNeighborHoldTime(Ipv4Address localAddress, Time rtrDeadInterval);
+
+    /**
+     * \brief When the next hello is due on a local interface
+     *
+     * Once the neighbor is adjacent, hellos are suppressed until the scheduled disconnection.
+     */
+    Time GetNextHelloTime(Ipv4Address localAddress, bool adjacent, Time helloInterval);
+
 
 
 
@@ -224,6 +245,7 @@ protected:
     uint32_t m_groundStationNumber;
     Ptr<Constellation> m_walkerConstellation;
     std::string m_baseDir;
+    bool m_helloSuppression;
 
 };
 
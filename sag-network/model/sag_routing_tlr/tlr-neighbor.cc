@@ -55,6 +55,20 @@ Neighbors::IsNeighbor (Ipv4Address addr)
   return false;
 }
 
+bool
+Neighbors::IsAdjacent (Ipv4Address localAddress)
+{
+  for (std::vector<Neighbor>::const_iterator i = m_nb.begin ();
+       i != m_nb.end (); ++i)
+    {
+      if (i->m_localAddress == localAddress && i->m_state >= NeighborState_2Way)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
 std::vector<Ipv4Address>
 Neighbors::GetNeighbors ()
 {
@@ -178,6 +178,12 @@ public:
    * \returns true if the node with IP address is a neighbor
    */
   bool IsNeighbor (Ipv4Address addr);
+  /**
+   * Check that a neighbor heard on the interface with address localAddress has reached 2-Way
+   * \param localAddress the IP address of the local interface
+   * \returns true if the neighbor is at least in state 2-Way
+   */
+  bool IsAdjacent (Ipv4Address localAddress);
 
   std::vector<Ipv4Address> GetNeighbors ();
   /**
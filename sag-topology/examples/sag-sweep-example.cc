@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+/**
+ * Sweep over variants of a run directory
+ *
+ * The basic simulation, the topology and the routing are built once from
+ * --run_dir. Every variant of the sweep file then installs the applications
+ * of its config_traffic, runs to the end of the simulation and writes its
+ * results into <run_dir>/<output_dir>/<name>, see SimulationSweep. For
+ * example, to compare two traffic loads four at a time:
+ *
+ * {"parallelism": 4, "output_dir": "sweep", "variants": [
+ *     {"name": "load_low", "inputs": {"config_traffic": "sweep_inputs/config_traffic_low"}},
+ *     {"name": "load_high", "inputs": {"config_traffic": "sweep_inputs/config_traffic_high"}}]}
+ *
+ * ./waf --run="sag-sweep-example --run_dir=/path/to/run --sweep=sweep.json"
+ */
+
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/basic-simulation.h"
+#include "ns3/simulation_sweep.h"
+#include "ns3/topology-satellite-network.h"
+#include "ns3/satellite_to_ground_routing_configure.h"
+#include "ns3/satellite_to_ground_routing_ipv6_configure.h"
+#include "ns3/open_shortest_path_first_configure.h"
+#include "ns3/aodv_routing_configure.h"
+#include "ns3/minimum_hop_routing_configure.h"
+#include "ns3/minimum_hop_routing_ipv6_configure.h"
+#include "ns3/bgp_routing_configure.h"
+#include "ns3/sag_application_schedule_udp.h"
+#include "ns3/sag_application_schedule_tcp.h"
+#include "ns3/sag_application_schedule_rtp.h"
+#include "ns3/sag_application_schedule_scps_tp.h"
+#include "ns3/sag_application_schedule_quic.h"
+#include "ns3/sag_application_schedule_3gpphttp.h"
+#include "ns3/sag_application_schedule_ftp.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+	std::string runDir;
+	std::string sweepFile = "sweep.json";
+
+	CommandLine cmd;
+	cmd.AddValue ("run_dir", "Run directory of the shared scenario", runDir);
+	cmd.AddValue ("sweep", "Sweep file, relative to the run directory", sweepFile);
+	cmd.Parse (argc, argv);
+
+	if(runDir.empty()){
+		std::cerr << "--run_dir is required" << std::endl;
+		cmd.PrintHelp (std::cerr);
+		return 1;
+	}
+
+	// Shared scenario
+	Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(runDir);
+
+	std::vector<std::pair<SAGRoutingHelper, int16_t>> ipv4Routing;
+	std::vector<std::pair<SAGRoutingHelperIPv6, int16_t>> ipv6Routing;
+	SatellitetoGroundRoutingConfigure satelliteToGround(basicSimulation, ipv4Routing);
+	OpenShortestPathFirstConfigure ospf(basicSimulation, ipv4Routing);
+	AodvRoutingConfigure aodv(basicSimulation, ipv4Routing);
+	MinimumHopRoutingConfigure minimumHop(basicSimulation, ipv4Routing);
+	BgpRoutingConfigure bgp(basicSimulation, ipv4Routing);
+	SatellitetoGroundRoutingIPv6Configure satelliteToGroundIPv6(basicSimulation, ipv6Routing);
+	MinimumHopRoutingIPv6Configure minimumHopIPv6(basicSimulation, ipv6Routing);
+
+	Ptr<TopologySatelliteNetwork> topology = CreateObject<TopologySatelliteNetwork>(basicSimulation, ipv4Routing, ipv6Routing);
+	satelliteToGround.Initialize(topology);
+	ospf.Initialize(topology);
+	aodv.Initialize(topology);
+	minimumHop.Initialize(topology);
+	bgp.Initialize(topology);
+	satelliteToGroundIPv6.Initialize(topology);
+	minimumHopIPv6.Initialize(topology);
+
+	// Variants
+	SimulationSweep sweep(basicSimulation);
+	sweep.ReadVariants(runDir + "/" + sweepFile);
+	uint32_t failed = sweep.Run([&](Ptr<BasicSimulation> simulation, const SimulationSweep::Variant& variant){
+		// each scheduler enables itself from the config_traffic of the variant
+		SAGApplicationSchedulerUdp udp(simulation, topology);
+		SAGApplicationSchedulerTcp tcp(simulation, topology);
+		SAGApplicationSchedulerRtp rtp(simulation, topology);
+		SAGApplicationSchedulerScpsTp scpsTp(simulation, topology);
+		SAGApplicationSchedulerQuic quic(simulation, topology);
+		SAGApplicationSchedulerThreeGppHttp http(simulation, topology);
+		SAGApplicationSchedulerFTP ftp(simulation, topology);
+
+		simulation->Run();
+
+		udp.WriteResults();
+		tcp.WriteResults();
+		rtp.WriteResults();
+		scpsTp.WriteResults();
+		quic.WriteResults();
+		http.WriteResults();
+		ftp.WriteResults();
+		topology->CollectUtilizationStatistics();
+		simulation->Finalize();
+	});
+
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+/**
+ * Benchmark of whole simulations built from a run directory
+ *
+ * - walker: for every size PxS (planes x satellites per plane) the first
+ *   constellation of the template run directory is resized and the topology
+ *   is built and run for --walker_duration_s without applications. Reports
+ *   the setup and the run, and every phase of the periodic topology update,
+ *   of which gsl_change is the GSL selection.
+ * - scenario: the template run directory end to end with its applications
+ *   for --duration_s, 10 minutes by default.
+ *
+ * The run directories are derived from --run_dir under <run_dir>/benchmark,
+ * see BenchmarkReport::DeriveRunDir, so the template is left untouched and
+ * the logs of the last benchmark run can be inspected. Every measurement
+ * runs in its own process. Results are JSON lines, see BenchmarkReport.
+ *
+ * ./waf --run="sag-topology-benchmark --run_dir=/path/to/run --sizes=6x11,24x48 --output=benchmark.jsonl"
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/benchmark_report.h"
+#include "ns3/basic-simulation.h"
+#include "ns3/topology-satellite-network.h"
+#include "ns3/satellite_to_ground_routing_configure.h"
+#include "ns3/satellite_to_ground_routing_ipv6_configure.h"
+#include "ns3/open_shortest_path_first_configure.h"
+#include "ns3/aodv_routing_configure.h"
+#include "ns3/minimum_hop_routing_configure.h"
+#include "ns3/minimum_hop_routing_ipv6_configure.h"
+#include "ns3/bgp_routing_configure.h"
+#include "ns3/sag_application_schedule_udp.h"
+#include "ns3/sag_application_schedule_tcp.h"
+#include "ns3/sag_application_schedule_rtp.h"
+#include "ns3/sag_application_schedule_scps_tp.h"
+#include "ns3/sag_application_schedule_quic.h"
+#include "ns3/sag_application_schedule_3gpphttp.h"
+#include "ns3/sag_application_schedule_ftp.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SagTopologyBenchmark");
+
+static std::vector<std::pair<uint32_t, uint32_t>>
+ParseSizes(std::string sizes){
+	std::vector<std::pair<uint32_t, uint32_t>> result;
+	std::stringstream ss(sizes);
+	std::string item;
+	while(std::getline(ss, item, ',')){
+		uint32_t planes, sats;
+		char x;
+		std::stringstream is(item);
+		if(!(is >> planes >> x >> sats) || x != 'x' || planes < 1 || sats < 2){
+			throw std::invalid_argument("Invalid constellation size \"" + item + "\", expected PxS");
+		}
+		result.push_back(std::make_pair(planes, sats));
+	}
+	return result;
+}
+
+static nlohmann::json
+ReadJson(std::string filename){
+	std::ifstream ifs(filename);
+	if(!ifs.is_open()){
+		throw std::runtime_error("Cannot open " + filename);
+	}
+	return nlohmann::json::parse(ifs);
+}
+
+/**
+ * One record per phase of the periodic topology update, as written by TopologyTickAggregator
+ */
+static void
+RecordTickTimings(BenchmarkReport& report, const nlohmann::json& parameters, std::string filename){
+	std::ifstream ifs(filename);
+	if(!ifs.is_open()){
+		// no periodic update, e.g. a simulation shorter than one interval
+		return;
+	}
+	std::string line;
+	std::getline(ifs, line);
+	while(std::getline(ifs, line)){
+		std::stringstream ss(line);
+		std::string phase, calls, totalS, meanMs, maxMs;
+		if(!std::getline(ss, phase, ',') || !std::getline(ss, calls, ',') || !std::getline(ss, totalS, ',')
+				|| !std::getline(ss, meanMs, ',') || !std::getline(ss, maxMs, ',')){
+			throw std::runtime_error("Invalid line in " + filename + ": " + line);
+		}
+		uint64_t n = std::stoull(calls);
+		report.Record("tick_" + phase, parameters, n, int64_t(std::stod(totalS) * 1e9), n, {{"max_ms", std::stod(maxMs)}});
+	}
+}
+
+/**
+ * Build the scenario of runDir, run it and record the setup and the run under prefix
+ */
+static void
+BenchmarkRun(BenchmarkReport& report, const nlohmann::json& parameters, std::string runDir, std::string prefix, bool applications){
+
+	int64_t start = BenchmarkReport::NowNs();
+	Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(runDir);
+
+	std::vector<std::pair<SAGRoutingHelper, int16_t>> ipv4Routing;
+	std::vector<std::pair<SAGRoutingHelperIPv6, int16_t>> ipv6Routing;
+	SatellitetoGroundRoutingConfigure satelliteToGround(basicSimulation, ipv4Routing);
+	OpenShortestPathFirstConfigure ospf(basicSimulation, ipv4Routing);
+	AodvRoutingConfigure aodv(basicSimulation, ipv4Routing);
+	MinimumHopRoutingConfigure minimumHop(basicSimulation, ipv4Routing);
+	BgpRoutingConfigure bgp(basicSimulation, ipv4Routing);
+	SatellitetoGroundRoutingIPv6Configure satelliteToGroundIPv6(basicSimulation, ipv6Routing);
+	MinimumHopRoutingIPv6Configure minimumHopIPv6(basicSimulation, ipv6Routing);
+
+	Ptr<TopologySatelliteNetwork> topology = CreateObject<TopologySatelliteNetwork>(basicSimulation, ipv4Routing, ipv6Routing);
+	satelliteToGround.Initialize(topology);
+	ospf.Initialize(topology);
+	aodv.Initialize(topology);
+	minimumHop.Initialize(topology);
+	bgp.Initialize(topology);
+	satelliteToGroundIPv6.Initialize(topology);
+	minimumHopIPv6.Initialize(topology);
+
+	if(!applications){
+		int64_t setupNs = BenchmarkReport::NowNs() - start;
+		report.Record(prefix + "_setup", parameters, 1, setupNs, 1, {{"nodes", topology->GetNumNodes()}});
+
+		start = BenchmarkReport::NowNs();
+		basicSimulation->Run();
+		report.Record(prefix + "_run", parameters, 1, BenchmarkReport::NowNs() - start, Simulator::GetEventCount(),
+				{{"simulated_s", basicSimulation->GetSimulationEndTimeNs() / 1e9}});
+	}
+	else{
+		// each scheduler enables itself from config_traffic
+		SAGApplicationSchedulerUdp udp(basicSimulation, topology);
+		SAGApplicationSchedulerTcp tcp(basicSimulation, topology);
+		SAGApplicationSchedulerRtp rtp(basicSimulation, topology);
+		SAGApplicationSchedulerScpsTp scpsTp(basicSimulation, topology);
+		SAGApplicationSchedulerQuic quic(basicSimulation, topology);
+		SAGApplicationSchedulerThreeGppHttp http(basicSimulation, topology);
+		SAGApplicationSchedulerFTP ftp(basicSimulation, topology);
+		int64_t setupNs = BenchmarkReport::NowNs() - start;
+		report.Record(prefix + "_setup", parameters, 1, setupNs, 1, {{"nodes", topology->GetNumNodes()}});
+
+		start = BenchmarkReport::NowNs();
+		basicSimulation->Run();
+		report.Record(prefix + "_run", parameters, 1, BenchmarkReport::NowNs() - start, Simulator::GetEventCount(),
+				{{"simulated_s", basicSimulation->GetSimulationEndTimeNs() / 1e9}});
+
+		start = BenchmarkReport::NowNs();
+		udp.WriteResults();
+		tcp.WriteResults();
+		rtp.WriteResults();
+		scpsTp.WriteResults();
+		quic.WriteResults();
+		http.WriteResults();
+		ftp.WriteResults();
+		topology->CollectUtilizationStatistics();
+		report.Record(prefix + "_write_results", parameters, 1, BenchmarkReport::NowNs() - start, 1);
+	}
+
+	RecordTickTimings(report, parameters, basicSimulation->GetLogsDir() + "/system_"
+			+ std::to_string(basicSimulation->GetSystemId()) + "_topology_tick_timings.csv");
+	basicSimulation->Finalize();
+}
+
+int
+main (int argc, char *argv[])
+{
+	std::string runDir;
+	std::string benchmarks = "walker,scenario";
+	std::string sizes = "6x11,12x24,24x48,40x40,72x22";
+	double walkerDurationS = 60;
+	double durationS = 600;
+	std::string topologyDir = "config_topology";
+	std::string output;
+
+	CommandLine cmd;
+	cmd.AddValue ("run_dir", "Template run directory", runDir);
+	cmd.AddValue ("benchmarks", "Comma separated benchmarks to run: walker, scenario", benchmarks);
+	cmd.AddValue ("sizes", "Comma separated constellation sizes PxS of the walker benchmark", sizes);
+	cmd.AddValue ("walker_duration_s", "Simulated time of every size of the walker benchmark", walkerDurationS);
+	cmd.AddValue ("duration_s", "Simulated time of the scenario benchmark", durationS);
+	cmd.AddValue ("topology_dir", "Directory of config_constellation.json in the run directory", topologyDir);
+	cmd.AddValue ("output", "File the JSON lines are appended to, stdout only if empty", output);
+	cmd.Parse (argc, argv);
+
+	if(runDir.empty()){
+		std::cerr << "--run_dir is required" << std::endl;
+		cmd.PrintHelp (std::cerr);
+		return 1;
+	}
+	std::string benchmarkDir = runDir + "/benchmark";
+	BenchmarkReport report("sag-topology", output);
+	uint32_t failed = 0;
+
+	if(("," + benchmarks + ",").find(",walker,") != std::string::npos){
+		std::string constellationFile = topologyDir + "/config_constellation.json";
+		nlohmann::json constellations = ReadJson(runDir + "/" + constellationFile)["constellations"];
+		if(!constellations.is_array() || constellations.empty()){
+			throw std::runtime_error("No constellation in " + runDir + "/" + constellationFile);
+		}
+		for(auto& size : ParseSizes(sizes)){
+			nlohmann::json& first = constellations[0];
+			first["number_of_planes"] = size.first;
+			first["number_of_sats_per_plane"] = size.second;
+			// a Walker phase factor lies in [0, P - 1]
+			first["phase_factor"] = std::min<uint32_t>(first.value("phase_factor", 0), size.first - 1);
+
+			std::string name = "walker_" + std::to_string(size.first) + "x" + std::to_string(size.second);
+			std::map<std::string, nlohmann::json> patches;
+			patches[constellationFile] = {{"constellations", constellations}};
+			patches["basic_attribute.json"] = {{"basic_simulation_set",
+					{{"simulation_end_time_ns", int64_t(walkerDurationS * 1e9)}}}};
+			BenchmarkReport::DeriveRunDir(runDir, benchmarkDir + "/" + name, patches);
+
+			nlohmann::json parameters = {{"planes", size.first}, {"sats_per_plane", size.second},
+					{"phase", first["phase_factor"]}, {"duration_s", walkerDurationS}};
+			failed += BenchmarkReport::RunIsolated([&](){
+				BenchmarkRun(report, parameters, benchmarkDir + "/" + name, "walker", false);
+			}) != 0;
+		}
+	}
+
+	if(("," + benchmarks + ",").find(",scenario,") != std::string::npos){
+		std::map<std::string, nlohmann::json> patches;
+		patches["basic_attribute.json"] = {{"basic_simulation_set",
+				{{"simulation_end_time_ns", int64_t(durationS * 1e9)}}}};
+		BenchmarkReport::DeriveRunDir(runDir, benchmarkDir + "/scenario", patches);
+
+		nlohmann::json parameters = {{"run_dir", runDir}, {"duration_s", durationS}};
+		failed += BenchmarkReport::RunIsolated([&](){
+			BenchmarkRun(report, parameters, benchmarkDir + "/scenario", "scenario", true);
+		}) != 0;
+	}
+
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "gsl_handover_recorder.h"
+#include <algorithm>
+#include <stdexcept>
+#include "ns3/log_sink.h"
+
+namespace ns3 {
+
+	static const char GSL_HANDOVER_MAGIC[8] = {'S', 'A', 'G', 'G', 'S', 'L', 'H', '1'};
+
+	GslHandoverRecorder::GslHandoverRecorder ()
+		: m_open(false),
+		  m_file(0),
+		  m_lastTimeNs(0){
+
+	}
+
+	GslHandoverRecorder::~GslHandoverRecorder (){
+		Close();
+	}
+
+	void
+	GslHandoverRecorder::Open(std::string filename){
+		m_file = LogSink::Open(filename, true);
+		LogSink::Write(m_file, std::string(GSL_HANDOVER_MAGIC, sizeof(GSL_HANDOVER_MAGIC)));
+		m_lastTimeNs = 0;
+		m_pendingReasons.clear();
+		m_open = true;
+	}
+
+	bool
+	GslHandoverRecorder::IsOpen() const{
+		return m_open;
+	}
+
+	void
+	GslHandoverRecorder::Close(){
+		m_open = false;
+	}
+
+	void
+	GslHandoverRecorder::NoteReason(uint32_t groundNode, uint32_t interface, GslHandoverReason reason){
+		if(!m_open){
+			return;
+		}
+		m_pendingReasons[std::make_pair(groundNode, interface)] = reason;
+	}
+
+	uint32_t
+	GslHandoverRecorder::RecordChanges(int64_t timeNs,
+			const std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecord,
+			const std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecordCopy){
+
+		if(!m_open){
+			return 0;
+		}
+
+		m_buffer.clear();
+		uint32_t written = 0;
+		for(uint32_t p = 0; p < gslRecord.size(); p++){
+			Ptr<Node> gnd = gslRecord[p].first;
+			if(gnd == nullptr){
+				continue;
+			}
+			// records are kept in ground station order, so the previous entry sits at the same index
+			const std::vector<std::pair<uint32_t, Ptr<Node>>>* past = nullptr;
+			if(p < gslRecordCopy.size() && gslRecordCopy[p].first != nullptr
+					&& gslRecordCopy[p].first->GetId() == gnd->GetId()){
+				past = &gslRecordCopy[p].second;
+			}
+
+			for(uint32_t j = 0; j < gslRecord[p].second.size(); j++){
+				uint32_t interface = gslRecord[p].second[j].first;
+				Ptr<Node> sat = gslRecord[p].second[j].second;
+				Ptr<Node> satPast = nullptr;
+				if(past != nullptr){
+					for(auto& entry : *past){
+						if(entry.first == interface){
+							satPast = entry.second;
+							break;
+						}
+					}
+				}
+
+				uint32_t newId = sat == nullptr ? GSL_HANDOVER_NO_SATELLITE : sat->GetId();
+				uint32_t oldId = satPast == nullptr ? GSL_HANDOVER_NO_SATELLITE : satPast->GetId();
+				if(newId == oldId){
+					continue;
+				}
+
+				GslHandoverEvent event;
+				event.m_timeNs = timeNs;
+				event.m_groundNode = gnd->GetId();
+				event.m_interface = interface;
+				event.m_oldSatellite = oldId;
+				event.m_newSatellite = newId;
+
+				auto iter = m_pendingReasons.find(std::make_pair(event.m_groundNode, interface));
+				if(iter != m_pendingReasons.end()){
+					event.m_reason = iter->second;
+				}
+				else if(oldId == GSL_HANDOVER_NO_SATELLITE){
+					event.m_reason = GSL_HANDOVER_ATTACH;
+				}
+				else if(newId == GSL_HANDOVER_NO_SATELLITE){
+					event.m_reason = GSL_HANDOVER_DETACH;
+				}
+				else{
+					event.m_reason = GSL_HANDOVER_OTHER;
+				}
+
+				Encode(event);
+				written++;
+			}
+		}
+		m_pendingReasons.clear();
+
+		if(written > 0){
+			LogSink::Write(m_file, m_buffer);
+		}
+		return written;
+	}
+
+	void
+	GslHandoverRecorder::Record(const GslHandoverEvent& event){
+		if(!m_open){
+			return;
+		}
+		m_buffer.clear();
+		Encode(event);
+		LogSink::Write(m_file, m_buffer);
+	}
+
+	void
+	GslHandoverRecorder::Encode(const GslHandoverEvent& event){
+		NS_ASSERT_MSG(event.m_timeNs >= m_lastTimeNs, "GSL handover log must be appended in time order");
+		WriteVarint(event.m_timeNs - m_lastTimeNs);
+		WriteVarint(event.m_groundNode);
+		WriteVarint(event.m_interface);
+		WriteVarint(event.m_oldSatellite == GSL_HANDOVER_NO_SATELLITE ? 0 : uint64_t(event.m_oldSatellite) + 1);
+		WriteVarint(event.m_newSatellite == GSL_HANDOVER_NO_SATELLITE ? 0 : uint64_t(event.m_newSatellite) + 1);
+		m_buffer.push_back(char(event.m_reason));
+		m_lastTimeNs = event.m_timeNs;
+	}
+
+	void
+	GslHandoverRecorder::WriteVarint(uint64_t value){
+		char buf[10];
+		uint32_t n = 0;
+		do{
+			uint8_t byte = value & 0x7F;
+			value >>= 7;
+			if(value != 0){
+				byte |= 0x80;
+			}
+			buf[n++] = char(byte);
+		} while(value != 0);
+		m_buffer.append(buf, n);
+	}
+
+
+	static bool
+	ReadVarint(std::ifstream& ifs, uint64_t& value){
+		value = 0;
+		for(uint32_t shift = 0; shift < 64; shift += 7){
+			int c = ifs.get();
+			if(c == EOF){
+				return false;
+			}
+			value |= uint64_t(c & 0x7F) << shift;
+			if((c & 0x80) == 0){
+				return true;
+			}
+		}
+		throw std::runtime_error("Corrupted GSL handover log: varint too long");
+	}
+
+	GslHandoverReader::GslHandoverReader (std::string filename){
+
+		std::ifstream ifs(filename, std::ifstream::in | std::ifstream::binary);
+		if(!ifs.is_open()){
+			throw std::runtime_error("Cannot open GSL handover log: " + filename);
+		}
+		char magic[sizeof(GSL_HANDOVER_MAGIC)];
+		ifs.read(magic, sizeof(magic));
+		if(ifs.gcount() != sizeof(magic) || !std::equal(magic, magic + sizeof(magic), GSL_HANDOVER_MAGIC)){
+			throw std::runtime_error("Not a GSL handover log: " + filename);
+		}
+
+		AssociationState state;
+		int64_t timeNs = 0;
+		uint64_t delta;
+		while(ReadVarint(ifs, delta)){
+			uint64_t gnd, interface, oldSat, newSat;
+			if(!ReadVarint(ifs, gnd) || !ReadVarint(ifs, interface) || !ReadVarint(ifs, oldSat) || !ReadVarint(ifs, newSat)){
+				// the simulation stopped in the middle of a record, keep what is complete
+				break;
+			}
+			int reason = ifs.get();
+			if(reason == EOF){
+				break;
+			}
+			timeNs += delta;
+
+			GslHandoverEvent event;
+			event.m_timeNs = timeNs;
+			event.m_groundNode = gnd;
+			event.m_interface = interface;
+			event.m_oldSatellite = oldSat == 0 ? GSL_HANDOVER_NO_SATELLITE : uint32_t(oldSat - 1);
+			event.m_newSatellite = newSat == 0 ? GSL_HANDOVER_NO_SATELLITE : uint32_t(newSat - 1);
+			event.m_reason = uint8_t(reason);
+
+			if(m_events.size() % SNAPSHOT_INTERVAL == 0){
+				m_snapshots.push_back(state);
+			}
+			Apply(state, event);
+			m_events.push_back(event);
+		}
+
+	}
+
+	GslHandoverReader::~GslHandoverReader (){
+
+	}
+
+	const std::vector<GslHandoverEvent>&
+	GslHandoverReader::GetEvents() const{
+		return m_events;
+	}
+
+	void
+	GslHandoverReader::Apply(AssociationState& state, const GslHandoverEvent& event){
+		std::pair<uint32_t, uint32_t> key = std::make_pair(event.m_groundNode, event.m_interface);
+		if(event.m_newSatellite == GSL_HANDOVER_NO_SATELLITE){
+			state.erase(key);
+		}
+		else{
+			state[key] = event.m_newSatellite;
+		}
+	}
+
+	GslHandoverReader::AssociationState
+	GslHandoverReader::GetAssociationAt(int64_t timeNs) const{
+
+		// number of events with time <= timeNs
+		uint32_t end = std::upper_bound(m_events.begin(), m_events.end(), timeNs,
+				[](int64_t t, const GslHandoverEvent& e){ return t < e.m_timeNs; }) - m_events.begin();
+		if(m_snapshots.empty()){
+			return AssociationState();
+		}
+
+		uint32_t snapshot = std::min<uint32_t>(end / SNAPSHOT_INTERVAL, m_snapshots.size() - 1);
+		AssociationState state = m_snapshots[snapshot];
+		for(uint32_t i = snapshot * SNAPSHOT_INTERVAL; i < end; i++){
+			Apply(state, m_events[i]);
+		}
+		return state;
+	}
+
+	std::vector<GslHandoverReader::Interval>
+	GslHandoverReader::GetConnectionIntervals(int64_t endTimeNs) const{
+
+		std::vector<Interval> intervals;
+		// key (ground node id, interface), value (index of the open interval)
+		std::map<std::pair<uint32_t, uint32_t>, uint32_t> open;
+		for(const GslHandoverEvent& event : m_events){
+			std::pair<uint32_t, uint32_t> key = std::make_pair(event.m_groundNode, event.m_interface);
+			auto iter = open.find(key);
+			if(iter != open.end()){
+				intervals[iter->second].m_endNs = event.m_timeNs;
+				open.erase(iter);
+			}
+			if(event.m_newSatellite != GSL_HANDOVER_NO_SATELLITE){
+				Interval interval;
+				interval.m_groundNode = event.m_groundNode;
+				interval.m_interface = event.m_interface;
+				interval.m_satellite = event.m_newSatellite;
+				interval.m_startNs = event.m_timeNs;
+				interval.m_endNs = endTimeNs;
+				open[key] = intervals.size();
+				intervals.push_back(interval);
+			}
+		}
+		return intervals;
+	}
+
+}
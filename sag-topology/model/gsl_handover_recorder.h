@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef GSL_HANDOVER_RECORDER_H
+#define GSL_HANDOVER_RECORDER_H
+
+#include <stdint.h>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/node.h"
+
+namespace ns3 {
+
+/// Suffix of the per-system handover log inside the logs directory (system_<id>_...)
+#define GSL_HANDOVER_LOG_FILE "gsl_handover.bin"
+/// Satellite id of an interface that is not associated
+#define GSL_HANDOVER_NO_SATELLITE 0xFFFFFFFF
+
+typedef enum {
+	GSL_HANDOVER_ATTACH = 0,		//!< First association of an idle interface
+	GSL_HANDOVER_INVISIBLE = 1,		//!< Previous satellite fell below the minimum elevation
+	GSL_HANDOVER_NEAREST = 2,		//!< A nearer satellite was preferred
+	GSL_HANDOVER_PARTITION = 3,		//!< Geographic partition mapping moved on
+	GSL_HANDOVER_DETACH = 4,		//!< No satellite in line of sight
+	GSL_HANDOVER_OTHER = 5
+} GslHandoverReason;
+
+struct GslHandoverEvent {
+	int64_t m_timeNs;
+	uint32_t m_groundNode;
+	uint32_t m_interface;
+	uint32_t m_oldSatellite;		//!< GSL_HANDOVER_NO_SATELLITE if the interface was idle
+	uint32_t m_newSatellite;		//!< GSL_HANDOVER_NO_SATELLITE if the interface becomes idle
+	uint8_t m_reason;
+};
+
+/**
+ * \ingroup SatelliteNetwork
+ *
+ * \brief Append-only binary log of ground-to-satellite association changes
+ *
+ * Only interfaces whose satellite actually changed are written, so the cost
+ * per GSL update is proportional to the number of handovers instead of the
+ * number of ground stations.
+ *
+ * Layout: the 8 byte magic "SAGGSLH1", then one record per handover made of
+ * LEB128 varints (time delta to the previous record in ns, ground node id,
+ * interface, old satellite id + 1, new satellite id + 1; 0 means none) and
+ * one reason byte.
+ *
+ * The log is written through the LogSink, so that a forked sweep variant
+ * writes it to its own run directory.
+ */
+class GslHandoverRecorder
+{
+public:
+	GslHandoverRecorder ();
+	virtual ~GslHandoverRecorder ();
+
+	void Open(std::string filename);
+	bool IsOpen() const;
+	void Close();
+
+	/**
+	 * \brief Store the reason of an association change decided by the strategy
+	 *
+	 * Changes without a noted reason are classified as attach, detach or other.
+	 */
+	void NoteReason(uint32_t groundNode, uint32_t interface, GslHandoverReason reason);
+
+	/**
+	 * \brief Compare two GSL records and append one event per changed interface
+	 * \param gslRecord		Adjacency between satellite and ground station
+	 * \param gslRecordCopy		Adjacency between satellite and ground station before switching
+	 *
+	 * \return number of events written
+	 */
+	uint32_t RecordChanges(int64_t timeNs,
+			const std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecord,
+			const std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecordCopy);
+
+	void Record(const GslHandoverEvent& event);
+
+private:
+	void Encode(const GslHandoverEvent& event);
+	void WriteVarint(uint64_t value);
+
+	bool m_open;
+	uint32_t m_file;					//!< LogSink file id
+	std::string m_buffer;				//!< Records of the current update
+	int64_t m_lastTimeNs;
+	std::map<std::pair<uint32_t, uint32_t>, uint8_t> m_pendingReasons;
+};
+
+/**
+ * \ingroup SatelliteNetwork
+ *
+ * \brief Reader of the GslHandoverRecorder log
+ *
+ * Association state at any time is rebuilt from the closest snapshot, which is
+ * taken every SNAPSHOT_INTERVAL events while loading.
+ */
+class GslHandoverReader
+{
+public:
+	struct Interval {
+		uint32_t m_groundNode;
+		uint32_t m_interface;
+		uint32_t m_satellite;
+		int64_t m_startNs;
+		int64_t m_endNs;
+	};
+	/// key (ground node id, interface), value (satellite id)
+	typedef std::map<std::pair<uint32_t, uint32_t>, uint32_t> AssociationState;
+
+	GslHandoverReader (std::string filename);
+	virtual ~GslHandoverReader ();
+
+	const std::vector<GslHandoverEvent>& GetEvents() const;
+
+	/**
+	 * \brief Association state after all events with time <= timeNs were applied
+	 */
+	AssociationState GetAssociationAt(int64_t timeNs) const;
+
+	/**
+	 * \brief Connected periods of every (ground node, interface, satellite), ordered by start time
+	 * \param endTimeNs		End of the periods still open at the end of the log
+	 */
+	std::vector<Interval> GetConnectionIntervals(int64_t endTimeNs) const;
+
+private:
+	static const uint32_t SNAPSHOT_INTERVAL = 1024;
+
+	static void Apply(AssociationState& state, const GslHandoverEvent& event);
+
+	std::vector<GslHandoverEvent> m_events;
+	std::vector<AssociationState> m_snapshots;		//!< m_snapshots[i]: state before event i * SNAPSHOT_INTERVAL
+};
+
+}
+
+#endif /* GSL_HANDOVER_RECORDER_H */
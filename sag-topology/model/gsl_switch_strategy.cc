@@ -19,6 +19,7 @@
 
 #include "gsl_switch_strategy.h"
 #include "ns3/sag_rtp_constants.h"
+#include "ns3/log_sink.h"
 #include <math.h>
 #define pi 3.14159265358979323846
 namespace ns3 {
@@ -87,6 +88,19 @@ namespace ns3 {
     	m_feederLinkNum = parse_positive_int64(m_basicSimulation->GetConfigParamOrDefault("maximum_feeder_link_number", "5"));
 
     	m_baseLogsDir = basicSimulation->GetLogsDir();
+
+    	// The trajectory output rebuilds its handover intervals from this log
+    	if(parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_gsl_handover_log", "false"))
+    			|| parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_trajectory_tracing", "false"))){
+    		m_handoverRecorder.Open(m_baseLogsDir + "/system_" + std::to_string(m_basicSimulation->GetSystemId()) + "_" + GSL_HANDOVER_LOG_FILE);
+    	}
+    }
+
+    void
+	SwitchStrategyGSL::RecordHandovers(const std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecord, const std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecordCopy){
+
+    	m_handoverRecorder.RecordChanges(Simulator::Now().GetNanoSeconds(), gslRecord, gslRecordCopy);
+
     }
 
     void
@@ -423,6 +437,7 @@ namespace ns3 {
 					else
 					{
 						// std::cout << "Time:" << timeNow << " ground station " << gsModel->GetGid() << " is sleeped" << std::endl;
+						m_handoverRecorder.NoteReason(groundStation->GetId(), interface, GSL_HANDOVER_INVISIBLE);
 						m_satelliteConnectionState[i][j_index] = sleep;
 						Topology_CHANGE_GSL = true;
 						// todo
@@ -797,6 +812,8 @@ namespace ns3 {
 		m_mapOfSatelliteAndAscendingPartition.clear();
 		m_mapOfDescendingPartitionAndSatellite.clear();
 		m_mapOfSatelliteAndDescendingPartition.clear();
+		m_ascendingPartitionCsv.str("");
+		m_descendingPartitionCsv.str("");
 
         uint32_t satNum = cons->GetSatNum();
         uint32_t orbitNum = cons->GetOrbitNum();
@@ -813,10 +830,7 @@ namespace ns3 {
             		std::cout<<"Ascending -> Time(s) "<<std::to_string(int(Simulator::Now().GetSeconds()))<<" Partition: "<< partitionId<<" has "<< m_mapOfAscendingPartitionAndSatellite[partitionId].size()<< " satellites!"<<std::endl;
             	}
             	NS_ASSERT_MSG(partitionId <= satNum * orbitNum / 2, "Wrong partition Id.");
-                std::ofstream ofs;
-                ofs.open(m_baseLogsDir + "/AscendingPartition_"+ std::to_string(int(Simulator::Now().GetSeconds()))+".csv", std::ofstream::out | std::ofstream::app);
-                ofs << satellite->GetId()<<","<<partitionId<< std::endl;
-                ofs.close();
+                m_ascendingPartitionCsv << satellite->GetId()<<","<<partitionId<< std::endl;
     		}
     		else if(satellite->GetObject<MobilityModel>()->GetVelocity().z < 0){
     			partitionId = DetermineWhichDescendingPartitionSatelliteBelongTo(satellite);
@@ -826,16 +840,25 @@ namespace ns3 {
             		std::cout<<"Descending -> Time(s) "<<std::to_string(int(Simulator::Now().GetSeconds()))<<" Partition: "<< partitionId<<" has "<< m_mapOfDescendingPartitionAndSatellite[partitionId].size()<< " satellites!"<<std::endl;
             	}
     			NS_ASSERT_MSG(partitionId <= satNum * orbitNum / 2, "Wrong partition Id.");
-    	        std::ofstream ofs;
-    	        ofs.open(m_baseLogsDir + "/DescendingPartition_"+ std::to_string(int(Simulator::Now().GetSeconds()))+".csv", std::ofstream::out | std::ofstream::app);
-    	        ofs << satellite->GetId()<<","<<partitionId<< std::endl;
-    	        ofs.close();
+    	        m_descendingPartitionCsv << satellite->GetId()<<","<<partitionId<< std::endl;
     		}
 
         }
 
         SupplementMappingForSomePartitions();
 
+        // Only dump the mapping when it differs from the last one written
+        std::string ascendingCsv = m_ascendingPartitionCsv.str();
+        std::string descendingCsv = m_descendingPartitionCsv.str();
+        if(ascendingCsv != m_lastAscendingPartitionCsv){
+            LogSink::Append(m_baseLogsDir + "/AscendingPartition_"+ std::to_string(int(Simulator::Now().GetSeconds()))+".csv", ascendingCsv);
+            m_lastAscendingPartitionCsv = ascendingCsv;
+        }
+        if(descendingCsv != m_lastDescendingPartitionCsv){
+            LogSink::Append(m_baseLogsDir + "/DescendingPartition_"+ std::to_string(int(Simulator::Now().GetSeconds()))+".csv", descendingCsv);
+            m_lastDescendingPartitionCsv = descendingCsv;
+        }
+
 //		// Plan the next update
 //        int64_t dynamicStateUpdateIntervalNs = 10 * 1e9;
 //		int64_t next_update_ns = Simulator::Now().GetNanoSeconds() + dynamicStateUpdateIntervalNs;
@@ -918,10 +941,7 @@ namespace ns3 {
         for(auto c : mapOfAscendingPartitionAndSatellite){
         	m_mapOfAscendingPartitionAndSatellite.insert(c);
             for(auto node: c.second){
-            	std::ofstream ofs;
-				ofs.open(m_baseLogsDir + "/AscendingPartition_"+ std::to_string(int(Simulator::Now().GetSeconds()))+".csv", std::ofstream::out | std::ofstream::app);
-				ofs << node->GetId()<<","<<c.first<<","<<0<< std::endl;
-				ofs.close();
+				m_ascendingPartitionCsv << node->GetId()<<","<<c.first<<","<<0<< std::endl;
             }
         }
 
@@ -977,10 +997,7 @@ namespace ns3 {
 		for(auto c : mapOfDescendingPartitionAndSatellite){
 			m_mapOfDescendingPartitionAndSatellite.insert(c);
             for(auto node: c.second){
-            	std::ofstream ofs;
-				ofs.open(m_baseLogsDir + "/DescendingPartition_"+ std::to_string(int(Simulator::Now().GetSeconds()))+".csv", std::ofstream::out | std::ofstream::app);
-				ofs << node->GetId()<<","<<c.first<<","<<0<< std::endl;
-				ofs.close();
+				m_descendingPartitionCsv << node->GetId()<<","<<c.first<<","<<0<< std::endl;
             }
 		}
 
@@ -23,12 +23,14 @@
 
 #include <vector>
 #include <cfloat>
+#include <sstream>
 #include "ns3/node-container.h"
 #include "ns3/mobility-model.h"
 #include "ns3/basic-simulation.h"
 #include "ns3/walker-constellation-structure.h"
 #include "ns3/satellite-position-mobility-model.h"
 #include "ns3/ground-station.h"
+#include "ns3/gsl_handover_recorder.h"
 //#include "ns3/sag_rtp_constants.h"
 
 namespace ns3 {
@@ -74,6 +76,13 @@ public:
 	 */
 	virtual void UpdateSwitch(std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecord, std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecordCopy);
 
+	/**
+	 * \brief Append the associations changed by the last UpdateSwitch to the handover log
+	 * \param gslRecord		Adjacency between satellite and ground station
+	 * \param gslRecordCopy		Adjacency between satellite and ground station before switching
+	 */
+	void RecordHandovers(const std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecord, const std::vector<std::pair<Ptr<Node>, std::vector<std::pair<uint32_t, Ptr<Node>>>>>& gslRecordCopy);
+
 	/**
 	 * \brief Get max visible distance at a certain ground minimum elevation and orbit height
 	 * \param orbitHeight		Orbit height
@@ -98,6 +107,7 @@ protected:
 	uint32_t m_feederLinkNum;		//<! Max number of FeederLinks of each satellite
 	std::unordered_map<uint32_t, std::vector<uint32_t>> m_feederLinkUnique;		//<! FeederLink number of each ground station
 	std::string m_baseLogsDir;
+	GslHandoverRecorder m_handoverRecorder;		//!< Log of association changes, only open if enabled
 
 	//<! ground-to-satellite connection state todo
 	std::vector<std::vector<SatelliteConnectState>> m_satelliteConnectionState;
@@ -195,6 +205,12 @@ private:
 	std::map<Ptr<Node>, uint32_t> m_mapOfGroundStationAndAscendingPartition;
 	/// Map: key (ground station node), value (the descending partition it belongs to)
 	std::map<Ptr<Node>, uint32_t> m_mapOfGroundStationAndDescendingPartition;
+
+	/// Partition mapping of the current update, written out only if it changed
+	std::ostringstream m_ascendingPartitionCsv;
+	std::ostringstream m_descendingPartitionCsv;
+	std::string m_lastAscendingPartitionCsv;
+	std::string m_lastDescendingPartitionCsv;
 };
 
 }
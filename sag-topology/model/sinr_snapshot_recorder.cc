@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "sinr_snapshot_recorder.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include "ns3/assert.h"
+#include "ns3/json.hpp"
+#include "ns3/log_sink.h"
+
+namespace ns3 {
+
+	static const char SINR_SNAPSHOT_MAGIC[8] = {'S', 'A', 'G', 'S', 'I', 'N', 'R', '1'};
+
+	static uint64_t
+	ZigZag(int64_t value){
+		return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+	}
+
+	static int64_t
+	UnZigZag(uint64_t value){
+		return int64_t(value >> 1) ^ -int64_t(value & 1);
+	}
+
+	SinrSnapshotRecorder::SinrSnapshotRecorder ()
+		: m_open(false),
+		  m_file(0),
+		  m_quantizationDb(0),
+		  m_lastTick(0),
+		  m_lastTimeNs(0){
+
+	}
+
+	SinrSnapshotRecorder::~SinrSnapshotRecorder (){
+
+	}
+
+	void
+	SinrSnapshotRecorder::Open(std::string filename, double quantizationDb){
+		if(quantizationDb <= 0){
+			throw std::runtime_error("SINR quantization step must be positive");
+		}
+		m_file = LogSink::Open(filename, true);
+		m_quantizationDb = quantizationDb;
+		m_lastTick = 0;
+		m_lastTimeNs = 0;
+		m_previous.clear();
+		m_current.clear();
+
+		std::string header(SINR_SNAPSHOT_MAGIC, sizeof(SINR_SNAPSHOT_MAGIC));
+		WriteVarint(header, uint64_t(std::llround(quantizationDb * 1e6)));
+		LogSink::Write(m_file, header);
+		m_open = true;
+	}
+
+	bool
+	SinrSnapshotRecorder::IsOpen() const{
+		return m_open;
+	}
+
+	void
+	SinrSnapshotRecorder::BeginFrame(uint64_t tick, int64_t timeNs){
+		if(!m_open){
+			return;
+		}
+		NS_ASSERT_MSG(tick >= m_lastTick && timeNs >= m_lastTimeNs, "SINR snapshots must be appended in time order");
+		m_buffer.clear();
+		WriteVarint(m_buffer, tick - m_lastTick);
+		WriteVarint(m_buffer, timeNs - m_lastTimeNs);
+		m_lastTick = tick;
+		m_lastTimeNs = timeNs;
+		m_current.clear();
+	}
+
+	void
+	SinrSnapshotRecorder::Add(uint32_t satellite, uint32_t groundStation, double sinrDb){
+		if(!m_open){
+			return;
+		}
+		m_current.push_back(std::make_pair(std::make_pair(satellite, groundStation), std::llround(sinrDb / m_quantizationDb)));
+	}
+
+	uint32_t
+	SinrSnapshotRecorder::EndFrame(){
+		if(!m_open){
+			return 0;
+		}
+
+		// the last value of a pair added twice wins
+		std::stable_sort(m_current.begin(), m_current.end(),
+				[](const std::pair<PairKey, int64_t>& a, const std::pair<PairKey, int64_t>& b){ return a.first < b.first; });
+		uint32_t n = 0;
+		for(uint32_t i = 0; i < m_current.size(); i++){
+			if(n > 0 && m_current[n - 1].first == m_current[i].first){
+				n--;
+			}
+			m_current[n++] = m_current[i];
+		}
+		m_current.resize(n);
+
+		// merge with the previous frame
+		std::vector<std::pair<PairKey, int64_t>> updated;
+		std::vector<PairKey> removed;
+		uint32_t p = 0;
+		for(auto& entry : m_current){
+			while(p < m_previous.size() && m_previous[p].first < entry.first){
+				removed.push_back(m_previous[p++].first);
+			}
+			if(p < m_previous.size() && m_previous[p].first == entry.first){
+				if(m_previous[p].second != entry.second){
+					updated.push_back(std::make_pair(entry.first, entry.second - m_previous[p].second));
+				}
+				p++;
+			}
+			else{
+				updated.push_back(entry);
+			}
+		}
+		for(; p < m_previous.size(); p++){
+			removed.push_back(m_previous[p].first);
+		}
+
+		WriteVarint(m_buffer, updated.size());
+		PairKey last(0, 0);
+		for(auto& entry : updated){
+			WritePair(m_buffer, entry.first, last);
+			WriteVarint(m_buffer, ZigZag(entry.second));
+			last = entry.first;
+		}
+		WriteVarint(m_buffer, removed.size());
+		last = PairKey(0, 0);
+		for(auto& pair : removed){
+			WritePair(m_buffer, pair, last);
+			last = pair;
+		}
+
+		m_previous.swap(m_current);
+		uint32_t size = m_buffer.size();
+		LogSink::Write(m_file, m_buffer);
+		return size;
+	}
+
+	void
+	SinrSnapshotRecorder::WriteVarint(std::string& buf, uint64_t value){
+		do{
+			uint8_t byte = value & 0x7F;
+			value >>= 7;
+			if(value != 0){
+				byte |= 0x80;
+			}
+			buf.push_back(char(byte));
+		} while(value != 0);
+	}
+
+	void
+	SinrSnapshotRecorder::WritePair(std::string& buf, const PairKey& pair, const PairKey& previous){
+		WriteVarint(buf, pair.first - previous.first);
+		WriteVarint(buf, pair.first == previous.first ? pair.second - previous.second : pair.second);
+	}
+
+
+	static bool
+	ReadVarint(std::ifstream& ifs, uint64_t& value){
+		value = 0;
+		for(uint32_t shift = 0; shift < 64; shift += 7){
+			int c = ifs.get();
+			if(c == EOF){
+				return false;
+			}
+			value |= uint64_t(c & 0x7F) << shift;
+			if((c & 0x80) == 0){
+				return true;
+			}
+		}
+		throw std::runtime_error("Corrupted SINR snapshot log: varint too long");
+	}
+
+	static bool
+	ReadPair(std::ifstream& ifs, std::pair<uint32_t, uint32_t>& pair){
+		uint64_t satDelta, gnd;
+		if(!ReadVarint(ifs, satDelta) || !ReadVarint(ifs, gnd)){
+			return false;
+		}
+		pair.second = satDelta == 0 ? pair.second + gnd : gnd;
+		pair.first += satDelta;
+		return true;
+	}
+
+	SinrSnapshotReader::SinrSnapshotReader (std::string filename){
+
+		std::ifstream ifs(filename, std::ifstream::in | std::ifstream::binary);
+		if(!ifs.is_open()){
+			throw std::runtime_error("Cannot open SINR snapshot log: " + filename);
+		}
+		char magic[sizeof(SINR_SNAPSHOT_MAGIC)];
+		ifs.read(magic, sizeof(magic));
+		uint64_t quantizationUdb;
+		if(ifs.gcount() != sizeof(magic) || !std::equal(magic, magic + sizeof(magic), SINR_SNAPSHOT_MAGIC)
+				|| !ReadVarint(ifs, quantizationUdb)){
+			throw std::runtime_error("Not a SINR snapshot log: " + filename);
+		}
+		m_quantizationDb = quantizationUdb / 1e6;
+
+		QuantizedState state;
+		uint64_t tick = 0;
+		int64_t timeNs = 0;
+		uint64_t tickDelta;
+		m_frameChanges.push_back(0);
+		while(ReadVarint(ifs, tickDelta)){
+			// the simulation may have stopped in the middle of a frame, keep what is complete
+			uint64_t timeDelta, n;
+			if(!ReadVarint(ifs, timeDelta) || !ReadVarint(ifs, n)){
+				break;
+			}
+			bool complete = true;
+			std::pair<uint32_t, uint32_t> pair(0, 0);
+			for(uint64_t k = 0; k < n && complete; k++){
+				uint64_t delta;
+				complete = ReadPair(ifs, pair) && ReadVarint(ifs, delta);
+				if(complete){
+					m_changes.push_back({pair, UnZigZag(delta), false});
+				}
+			}
+			complete = complete && ReadVarint(ifs, n);
+			pair = std::make_pair(0, 0);
+			for(uint64_t k = 0; k < n && complete; k++){
+				complete = ReadPair(ifs, pair);
+				if(complete){
+					m_changes.push_back({pair, 0, true});
+				}
+			}
+			if(!complete){
+				m_changes.resize(m_frameChanges.back());
+				break;
+			}
+
+			tick += tickDelta;
+			timeNs += timeDelta;
+			if(m_frames.size() % SNAPSHOT_INTERVAL == 0){
+				m_snapshots.push_back(state);
+			}
+			m_frames.push_back({tick, timeNs});
+			m_frameChanges.push_back(m_changes.size());
+			Apply(state, m_frames.size() - 1);
+		}
+
+	}
+
+	SinrSnapshotReader::~SinrSnapshotReader (){
+
+	}
+
+	double
+	SinrSnapshotReader::GetQuantizationDb() const{
+		return m_quantizationDb;
+	}
+
+	const std::vector<SinrSnapshotReader::Frame>&
+	SinrSnapshotReader::GetFrames() const{
+		return m_frames;
+	}
+
+	void
+	SinrSnapshotReader::Apply(QuantizedState& state, uint32_t i) const{
+		for(uint32_t c = m_frameChanges[i]; c < m_frameChanges[i + 1]; c++){
+			const Change& change = m_changes[c];
+			if(change.m_removed){
+				state.erase(change.m_pair);
+			}
+			else{
+				state[change.m_pair] += change.m_delta;
+			}
+		}
+	}
+
+	SinrSnapshotReader::SinrState
+	SinrSnapshotReader::GetSinrAt(uint32_t i) const{
+		NS_ASSERT_MSG(i < m_frames.size(), "No such SINR frame");
+		QuantizedState state = m_snapshots[i / SNAPSHOT_INTERVAL];
+		for(uint32_t f = i / SNAPSHOT_INTERVAL * SNAPSHOT_INTERVAL; f <= i; f++){
+			Apply(state, f);
+		}
+		SinrState sinr;
+		for(auto& entry : state){
+			sinr.emplace_hint(sinr.end(), entry.first, entry.second * m_quantizationDb);
+		}
+		return sinr;
+	}
+
+	void
+	SinrSnapshotReader::WriteJson(std::string filename) const{
+
+		std::ofstream ofs(filename, std::ofstream::out | std::ofstream::trunc);
+		if(!ofs.is_open()){
+			throw std::runtime_error("Cannot open SINR JSON export: " + filename);
+		}
+
+		// one frame at a time, so that the export does not hold the whole run in memory
+		ofs << "[";
+		QuantizedState state;
+		for(uint32_t i = 0; i < m_frames.size(); i++){
+			Apply(state, i);
+
+			std::vector<uint32_t> satellites, groundStations, averageSatellites;
+			std::vector<double> sinrs, averages;
+			double sum = 0;
+			uint32_t count = 0;
+			for(auto iter = state.begin(); iter != state.end(); iter++){
+				double sinr = iter->second * m_quantizationDb;
+				satellites.push_back(iter->first.first);
+				groundStations.push_back(iter->first.second);
+				sinrs.push_back(sinr);
+				sum += sinr;
+				count++;
+				auto next = std::next(iter);
+				if(next == state.end() || next->first.first != iter->first.first){
+					averageSatellites.push_back(iter->first.first);
+					averages.push_back(sum / count);
+					sum = 0;
+					count = 0;
+				}
+			}
+
+			nlohmann::ordered_json frame;
+			frame["tick"] = m_frames[i].m_tick;
+			frame["time_stamp_ns"] = m_frames[i].m_timeNs;
+			frame["satellite"] = satellites;
+			frame["ground_station"] = groundStations;
+			frame["sinr_db"] = sinrs;
+			frame["average_satellite"] = averageSatellites;
+			frame["sinr"] = averages;
+			ofs << (i == 0 ? "\n" : ",\n") << frame.dump();
+		}
+		ofs << "\n]\n";
+		ofs.close();
+	}
+
+	void
+	SinrSnapshotReader::ConvertToJson(std::string binFilename, std::string jsonFilename){
+		SinrSnapshotReader reader(binFilename);
+		reader.WriteJson(jsonFilename);
+	}
+
+}
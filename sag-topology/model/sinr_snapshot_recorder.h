@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef SINR_SNAPSHOT_RECORDER_H
+#define SINR_SNAPSHOT_RECORDER_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/// Suffix of the per-system SINR log inside the logs directory (system_<id>_...)
+#define SINR_SNAPSHOT_LOG_FILE "gsl_sinr.bin"
+
+/**
+ * \ingroup SatelliteNetwork
+ *
+ * \brief Streaming binary log of the SINR of every (satellite, ground station) pair
+ *
+ * SINR is quantized to a fixed step and every link quality tick appends one
+ * frame holding only the pairs whose quantized value changed, appeared or
+ * disappeared since the previous frame, so the cost of a tick is linear in
+ * the number of pairs and the file grows with the amount of change. Frames
+ * are queued to the LogSink.
+ *
+ * Layout: the 8 byte magic "SAGSINR1" and the quantization step in micro dB,
+ * then one frame per tick made of LEB128 varints: tick index delta, time
+ * delta in ns, number of updated pairs followed by the updated pairs, number
+ * of removed pairs followed by the removed pairs. Pairs are sorted; a pair is
+ * the satellite id delta to the previous pair of the list and the ground
+ * station id, itself a delta if the satellite id is unchanged. An updated
+ * pair is followed by the zigzag encoded change of its quantized SINR, a new
+ * pair starting from zero.
+ */
+class SinrSnapshotRecorder
+{
+public:
+	SinrSnapshotRecorder ();
+	virtual ~SinrSnapshotRecorder ();
+
+	void Open(std::string filename, double quantizationDb);
+	bool IsOpen() const;
+
+	/**
+	 * \brief Start the frame of a link quality tick, ticks and times must not decrease
+	 */
+	void BeginFrame(uint64_t tick, int64_t timeNs);
+	void Add(uint32_t satellite, uint32_t groundStation, double sinrDb);
+
+	/**
+	 * \brief Queue the changes to the previous frame
+	 * \return size of the frame in bytes
+	 */
+	uint32_t EndFrame();
+
+private:
+	typedef std::pair<uint32_t, uint32_t> PairKey;		//!< (satellite, ground station)
+
+	static void WriteVarint(std::string& buf, uint64_t value);
+	static void WritePair(std::string& buf, const PairKey& pair, const PairKey& previous);
+
+	bool m_open;
+	uint32_t m_file;
+	double m_quantizationDb;
+	uint64_t m_lastTick;
+	int64_t m_lastTimeNs;
+	std::vector<std::pair<PairKey, int64_t>> m_previous;	//!< Quantized SINR of the last frame, sorted
+	std::vector<std::pair<PairKey, int64_t>> m_current;
+	std::string m_buffer;
+};
+
+/**
+ * \ingroup SatelliteNetwork
+ *
+ * \brief Reader of the SinrSnapshotRecorder log and converter to JSON
+ *
+ * The state of any frame is rebuilt from the closest snapshot, which is taken
+ * every SNAPSHOT_INTERVAL frames while loading.
+ */
+class SinrSnapshotReader
+{
+public:
+	struct Frame {
+		uint64_t m_tick;
+		int64_t m_timeNs;
+	};
+	/// key (satellite id, ground station id), value SINR in dB
+	typedef std::map<std::pair<uint32_t, uint32_t>, double> SinrState;
+
+	SinrSnapshotReader (std::string filename);
+	virtual ~SinrSnapshotReader ();
+
+	double GetQuantizationDb() const;
+	const std::vector<Frame>& GetFrames() const;
+
+	/**
+	 * \brief SINR of all pairs present in frame i
+	 */
+	SinrState GetSinrAt(uint32_t i) const;
+
+	/**
+	 * \brief Export every frame as a JSON array, with the pair values and the per-satellite average
+	 */
+	void WriteJson(std::string filename) const;
+
+	static void ConvertToJson(std::string binFilename, std::string jsonFilename);
+
+private:
+	static const uint32_t SNAPSHOT_INTERVAL = 256;
+
+	typedef std::map<std::pair<uint32_t, uint32_t>, int64_t> QuantizedState;
+
+	struct Change {
+		std::pair<uint32_t, uint32_t> m_pair;
+		int64_t m_delta;
+		bool m_removed;
+	};
+
+	void Apply(QuantizedState& state, uint32_t i) const;
+
+	double m_quantizationDb;
+	std::vector<Frame> m_frames;
+	std::vector<Change> m_changes;
+	std::vector<uint32_t> m_frameChanges;				//!< Changes of frame i: [m_frameChanges[i], m_frameChanges[i + 1])
+	std::vector<QuantizedState> m_snapshots;			//!< m_snapshots[i]: state before frame i * SNAPSHOT_INTERVAL
+};
+
+}
+
+#endif /* SINR_SNAPSHOT_RECORDER_H */
@@ -24,10 +24,13 @@
 #include "ns3/sgp4coord.h"
 #include "ns3/satellite.h"
 #include <random>
+#include <cfloat>
+#include <sstream>
 #include "ns3/quic-helper.h"
 #include "ns3/scpstp-helper.h"
 #include "ns3/traffic-control-layer.h"
 #include "ns3/red-queue-disc.h"
+#include "ns3/log_sink.h"
 
 #define pi 3.14159265358979311599796346854
 
@@ -70,6 +73,8 @@ namespace ns3 {
         m_dynamicStateUpdateIntervalNs = parse_positive_int64(m_basicSimulation->GetConfigParamOrFail("dynamic_state_update_interval_ns"));
         //m_satellite_network_routes_dir =  m_basicSimulation->GetRunDir() + "/" + m_basicSimulation->GetConfigParamOrFail("satellite_network_routes_dir");
         m_satellite_network_force_static = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("satellite_network_force_static", "false"));
+        m_mpiLookaheadSafetyMargin = parse_double(m_basicSimulation->GetConfigParamOrDefault("mpi_lookahead_safety_margin", "0.05"));
+        NS_ASSERT_MSG(m_mpiLookaheadSafetyMargin >= 0 && m_mpiLookaheadSafetyMargin < 1, "mpi_lookahead_safety_margin must be in [0, 1)");
 		m_time_end = parse_positive_int64(m_basicSimulation->GetConfigParamOrFail("simulation_end_time_ns"));
 
         if(parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_distance_nearest_first", "false"))){
@@ -190,6 +195,8 @@ namespace ns3 {
 		InstallGSLInterfaceForAllSatellites();  // just install net devices, and initialize address
 		InstallGSLInterfaceForAllGroundStations();  // just install net devices
 		MakeGSLChangeEvent(0);
+		m_tickAggregator.AddPhase("gsl_change", TOPOLOGY_TICK_GSL,
+				MakeCallback(&TopologySatelliteNetwork::MakeGSLChangeEvent, this));
         m_basicSimulation->RegisterTimestamp("Initialize satellite-to-ground links");
 
         // Wireshark
@@ -205,11 +212,33 @@ namespace ns3 {
         	mkdir_force_if_not_exists(m_satellite_network_dir + "/system_"+ to_string(m_system_id) + "_orbital_elements");
         }
         MakeLinkDelayUpdateEvent(0);
+        m_tickAggregator.AddPhase("link_delay", TOPOLOGY_TICK_CHANNEL,
+        		MakeCallback(&TopologySatelliteNetwork::MakeLinkDelayUpdateEvent, this));
         m_basicSimulation->RegisterTimestamp("Initialize link propagation delay");
 
    		Ptr<SAGPhysicalLayerGSL> gsl_channel = m_gslSatNetDevices.Get(0)->GetChannel()->GetObject<SAGPhysicalLayerGSL>();
    		if (gsl_channel-> GetEnableBER()){
+   			m_enableGslAcm = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_gsl_acm", "false"));
+   			if(m_enableGslAcm){
+   				m_gslAcmHysteresisDb = parse_positive_double(m_basicSimulation->GetConfigParamOrDefault("gsl_acm_hysteresis_db", "0.5"));
+   				m_gslAcmSymbolRateBaud = parse_positive_double(m_basicSimulation->GetConfigParamOrDefault("gsl_acm_symbol_rate_baud", "0"));
+   				std::cout << "    >> GSL ACM hysteresis... " << m_gslAcmHysteresisDb << " dB" << std::endl;
+   			}
+   			// "json" appends the per-satellite SINR and PER averages every tick, "binary" instead logs the SINR of
+   			// every pair as delta-encoded frames, without PER and without network_wide_sinr.json
+   			std::string sinrFormat = m_basicSimulation->GetConfigParamOrDefault("sinr_snapshot_format", "json");
+   			if(sinrFormat == "binary"){
+   				double quantizationDb = parse_positive_double(m_basicSimulation->GetConfigParamOrDefault("sinr_snapshot_quantization_db", "0.01"));
+   				m_sinrExportJson = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("sinr_snapshot_export_json", "false"));
+   				m_sinrRecorder.Open(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_" + SINR_SNAPSHOT_LOG_FILE, quantizationDb);
+   				std::cout << "    >> SINR snapshots quantized to " << quantizationDb << " dB" << std::endl;
+   			}
+   			else if(sinrFormat != "json"){
+   				throw std::runtime_error("Unknown SINR snapshot format: " + sinrFormat);
+   			}
    			MakeLinkSINRUpdateEvent(0);
+   			m_tickAggregator.AddPhase("link_sinr", TOPOLOGY_TICK_LINK_QUALITY,
+   					MakeCallback(&TopologySatelliteNetwork::MakeLinkSINRUpdateEvent, this));
    			std::cout <<"Enable reading SINR-BER from link system simulatior" <<std::endl;
    		}
 
@@ -217,9 +246,14 @@ namespace ns3 {
         if(parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_sun_outage", "false"))){
         	ReadSunTrajectoryEciFromCspice();
             MakeSunOutageEvent(0);
+            m_tickAggregator.AddPhase("sun_outage", TOPOLOGY_TICK_ISL,
+            		MakeCallback(&TopologySatelliteNetwork::MakeSunOutageEvent, this));
             m_basicSimulation->RegisterTimestamp("Enable sun outage simulation");
         }
 
+        // All periodic updates from the first time slot on
+        StartTopologyTicks();
+
         //PacketLossTrace();
 
         // Store IP address to node id (each interface has an IP address, so multiple IPs per node)
@@ -353,15 +387,22 @@ namespace ns3 {
 		InstallGSLInterfaceForAllSatellites();  // just install net devices, and initialize address
 		InstallGSLInterfaceForAllGroundStations();  // just install net devices
 		MakeGSLChangeEvent(0);
+		m_tickAggregator.AddPhase("gsl_change", TOPOLOGY_TICK_GSL,
+				MakeCallback(&TopologySatelliteNetwork::MakeGSLChangeEvent, this));
         m_basicSimulation->RegisterTimestamp("Initialize satellite-to-ground links");
 
         // Sun Outage
         if(parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_sun_outage", "false"))){
         	ReadSunTrajectoryEciFromCspice();
             MakeSunOutageEvent(0);
+            m_tickAggregator.AddPhase("sun_outage", TOPOLOGY_TICK_ISL,
+            		MakeCallback(&TopologySatelliteNetwork::MakeSunOutageEvent, this));
             m_basicSimulation->RegisterTimestamp("Enable sun outage simulation");
         }
 
+        // All periodic updates from the first time slot on
+        StartTopologyTicks();
+
         std::cout << std::endl;
 
     }
@@ -729,6 +770,8 @@ namespace ns3 {
 		m_basicSimulation->RegisterTimestamp("Create satellite objects");
 
 		MakeSatelliteCoordinateUpdateEvent(0);
+		m_tickAggregator.AddPhase("satellite_coordinates", TOPOLOGY_TICK_MOBILITY,
+				MakeCallback(&TopologySatelliteNetwork::MakeSatelliteCoordinateUpdateEvent, this));
 
     }
 
@@ -741,12 +784,7 @@ namespace ns3 {
     		sat->SetPosition(cur);
     		sat->SetVelocity(cur);
     	}
-
-    	int64_t next_update_ns = time + m_dynamicStateUpdateIntervalNs;
-		if (next_update_ns < m_basicSimulation->GetSimulationEndTimeNs()) {
-			Simulator::Schedule(NanoSeconds(m_dynamicStateUpdateIntervalNs),
-					&TopologySatelliteNetwork::MakeSatelliteCoordinateUpdateEvent, this, next_update_ns);
-		}
+    	InvalidateTickKinematics();
 
     }
 
@@ -922,7 +960,9 @@ namespace ns3 {
 		}
 		m_basicSimulation->RegisterTimestamp("Create air craft objects");
 
-		MakeAirCraftFlyingEvent(0, 20);
+		MakeAirCraftFlyingEvent(0, m_airCraftSpeed);
+		m_tickAggregator.AddPhase("aircraft_positions", TOPOLOGY_TICK_MOBILITY,
+				MakeCallback(&TopologySatelliteNetwork::UpdateAirCraftPositions, this));
 
 
     }
@@ -978,15 +1018,13 @@ namespace ns3 {
 
 			m_airCraftsPositions[i].push_back(lla_position);
 		}
+		InvalidateTickKinematics();
 
+    }
 
-    	// schedule next event
-    	int64_t next_update_ns = time + m_dynamicStateUpdateIntervalNs;
-		if (next_update_ns < m_basicSimulation->GetSimulationEndTimeNs()) {
-			Simulator::Schedule(NanoSeconds(m_dynamicStateUpdateIntervalNs),
-					&TopologySatelliteNetwork::MakeAirCraftFlyingEvent, this, next_update_ns, speed);
-		}
-
+    void
+	TopologySatelliteNetwork::UpdateAirCraftPositions(double time){
+    	MakeAirCraftFlyingEvent(time, m_airCraftSpeed);
     }
 
     void
@@ -1250,6 +1288,8 @@ namespace ns3 {
     TopologySatelliteNetwork::ReadISLs()
     {
 
+        // Routing protocols may skip hellos on links whose lifetime is known
+        m_publishIslSchedule = parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_predictable_hello_suppression", "false"));
 
         // Link helper
         PointToPointLaserHelper p2p_laser_helper(m_basicSimulation);
@@ -1307,10 +1347,29 @@ namespace ns3 {
 			cons->SetIslNetDevicesInfo(islNetDevices);
 			cons->SetIslFromTo(islFromTo);
 			cons->SetIslFromToUnique(islFromToUnique);
+
+			// Intra-orbit ISLs of the grid stay up for the whole run, inter-orbit ones are
+			// predicted by MakeRegularISLChangeEvent
+			if(m_publishIslSchedule){
+				std::set<std::string> interOrbit;
+				for(auto& isl : m_islInterOrbit){
+					interOrbit.insert(CalStringKey(isl.first, isl.second));
+					interOrbit.insert(CalStringKey(isl.second, isl.first));
+				}
+				for(auto& isl : islFromToUnique){
+					if(interOrbit.find(CalStringKey(isl.first, isl.second)) == interOrbit.end()){
+						SetRegularISLUpUntil(islNetDevices, isl.first, isl.second, NanoSeconds(m_basicSimulation->GetSimulationEndTimeNs()));
+					}
+				}
+			}
         }
 
         // just for Star type walker constellation
         MakeRegularISLChangeEvent(0);
+        if(m_islInterOrbit.size() != 0){
+        	m_tickAggregator.AddPhase("regular_isl_change", TOPOLOGY_TICK_ISL,
+        			MakeCallback(&TopologySatelliteNetwork::MakeRegularISLChangeEvent, this));
+        }
 
         //EnablePcapAll(p2p_laser_helper);
         // Completed
@@ -1761,13 +1820,7 @@ namespace ns3 {
     		uint32_t satId1 = m_islInterOrbit.at(i).second;
     		Ptr<Node> satNodeId0 = m_satelliteNodes.Get(satId0);
     		Ptr<Node> satNodeId1 = m_satelliteNodes.Get(satId1);
-    		// need ECEF -> LLA todo
-    		Vector satId0Position = satNodeId0->GetObject<MobilityModel>()->GetPosition ();
-    		Vector satId1Position = satNodeId1->GetObject<MobilityModel>()->GetPosition ();
-    		double latitudeSatId0 = atan2(satId0Position.z, sqrt(pow(satId0Position.x, 2) + pow(satId0Position.y, 2))) * 180 / pi;
-    		double latitudeSatId1 = atan2(satId1Position.z, sqrt(pow(satId1Position.x, 2) + pow(satId1Position.y, 2))) * 180 / pi;
-            // here just 66.5, waiting for modification of switch latitude
-            if(std::abs(latitudeSatId0) > 60 || std::abs(latitudeSatId1) > 60){
+            if(BeyondISLSwitchLatitude(GetTickPosition(satNodeId0), GetTickPosition(satNodeId1))){
             	DisableISLBySatId(satId0, satId1, true);
             	//if(m_islDisableNetDevices.find(CalStringKey(satId0, satId1)) == m_islDisableNetDevices.end()){
             	//	DisableISLBySatId(satId0, satId1);
@@ -1777,18 +1830,266 @@ namespace ns3 {
     		}
             else{
             	AddISLBySatId(satId0, satId1, true);
+            	if(m_publishIslSchedule){
+            		UpdateRegularISLSchedule(satId0, satId1);
+            	}
             	//if(m_islDisableNetDevices.find(CalStringKey(satId0, satId1)) != m_islDisableNetDevices.end()){
             	//	AddISLBySatId(satId0, satId1);
 				//}
             }
     	}
 
+    }
 
-    	int64_t next_update_ns = time + m_dynamicStateUpdateIntervalNs;
-		if (next_update_ns < m_basicSimulation->GetSimulationEndTimeNs()) {
-			Simulator::Schedule(NanoSeconds(m_dynamicStateUpdateIntervalNs),
-					&TopologySatelliteNetwork::MakeRegularISLChangeEvent, this, next_update_ns);
+    bool
+	TopologySatelliteNetwork::BeyondISLSwitchLatitude(const Vector& position0, const Vector& position1){
+		// need ECEF -> LLA todo
+		double latitude0 = atan2(position0.z, sqrt(pow(position0.x, 2) + pow(position0.y, 2))) * 180 / pi;
+		double latitude1 = atan2(position1.z, sqrt(pow(position1.x, 2) + pow(position1.y, 2))) * 180 / pi;
+		// here just 66.5, waiting for modification of switch latitude
+		return std::abs(latitude0) > 60 || std::abs(latitude1) > 60;
+	}
+
+    Time
+	TopologySatelliteNetwork::PredictRegularISLDisconnection(uint32_t satId0, uint32_t satId1){
+
+    	// The link is taken down at the first topology tick that finds one of the satellites beyond
+    	// the switch latitude. Step over the ticks coarsely, then scan the last stride tick by tick.
+    	int64_t tickNs = m_dynamicStateUpdateIntervalNs;
+    	int64_t endNs = m_basicSimulation->GetSimulationEndTimeNs();
+    	int64_t strideTicks = std::max<int64_t>(1, 10000000000 / tickNs);
+    	int64_t firstTick = Simulator::Now().GetNanoSeconds() / tickNs + 1;
+    	Ptr<Node> node0 = m_satelliteNodes.Get(satId0);
+    	Ptr<Node> node1 = m_satelliteNodes.Get(satId1);
+    	Vector position0, position1;
+    	auto beyond = [&](int64_t tick){
+    		if(!PredictPosition(node0, tick * tickNs, position0) || !PredictPosition(node1, tick * tickNs, position1)){
+    			return true;
+    		}
+    		return BeyondISLSwitchLatitude(position0, position1);
+    	};
+    	for(int64_t tick = firstTick; tick * tickNs < endNs; tick += strideTicks){
+    		if(beyond(tick)){
+    			int64_t k = std::max(firstTick, tick - strideTicks + 1);
+    			while(k < tick && !beyond(k)){
+    				k++;
+    			}
+    			return NanoSeconds(k * tickNs);
+    		}
+    	}
+    	return NanoSeconds(endNs);
+
+    }
+
+    void
+	TopologySatelliteNetwork::SetRegularISLUpUntil(NetDeviceContainer& islNetDevices, uint32_t satId0, uint32_t satId1, Time until){
+		for(auto& key : {CalStringKey(satId0, satId1), CalStringKey(satId1, satId0)}){
+			Ptr<NetDevice> dev = islNetDevices.GetWithKey(key);
+			Ptr<SAGLinkLayer> link = dev == nullptr ? nullptr : dev->GetObject<SAGLinkLayer>();
+			if(link != nullptr){
+				link->SetScheduledUpUntil(until);
+			}
 		}
+	}
+
+    void
+	TopologySatelliteNetwork::UpdateRegularISLSchedule(uint32_t satId0, uint32_t satId1){
+		NetDeviceContainer islNetDevices = FindConstellationBySatId(satId0)->GetIslNetDevicesInfo();
+		Ptr<NetDevice> dev = islNetDevices.GetWithKey(CalStringKey(satId0, satId1));
+		Ptr<SAGLinkLayer> link = dev == nullptr ? nullptr : dev->GetObject<SAGLinkLayer>();
+		if(link == nullptr || link->GetScheduledUpUntil() > Simulator::Now()){
+			// still valid, it is only recomputed once the link has been taken down and restored
+			return;
+		}
+		SetRegularISLUpUntil(islNetDevices, satId0, satId1, PredictRegularISLDisconnection(satId0, satId1));
+	}
+
+    void
+    TopologySatelliteNetwork::StartTopologyTicks(){
+
+    	std::string timingsFile = m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_topology_tick_timings.csv";
+    	m_tickAggregator.Start(m_dynamicStateUpdateIntervalNs, m_dynamicStateUpdateIntervalNs,
+    			m_basicSimulation->GetSimulationEndTimeNs(), timingsFile);
+    	std::cout << "  > Scheduled " << m_tickAggregator.GetNPhases() << " periodic topology update phase(s)" << std::endl;
+
+    }
+
+    void
+    TopologySatelliteNetwork::InvalidateTickKinematics(){
+    	m_tickKinematicsValid = false;
+    }
+
+    void
+    TopologySatelliteNetwork::RefreshTickKinematics(){
+
+    	uint32_t n = NodeList::GetNNodes();
+    	m_tickPositions.resize(n);
+    	m_tickVelocities.resize(n);
+    	for(uint32_t i = 0; i < n; i++){
+    		Ptr<MobilityModel> mobility = NodeList::GetNode(i)->GetObject<MobilityModel>();
+    		if(mobility == nullptr){
+    			m_tickPositions[i] = Vector(0, 0, 0);
+    			m_tickVelocities[i] = Vector(0, 0, 0);
+    			continue;
+    		}
+    		m_tickPositions[i] = mobility->GetPosition();
+    		m_tickVelocities[i] = mobility->GetVelocity();
+    	}
+    	m_tickKinematicsValid = true;
+    	m_tickKinematicsTimeNs = Simulator::Now().GetNanoSeconds();
+
+    }
+
+    const Vector&
+    TopologySatelliteNetwork::GetTickPosition(Ptr<Node> node){
+    	if(!m_tickKinematicsValid || m_tickKinematicsTimeNs != Simulator::Now().GetNanoSeconds() || node->GetId() >= m_tickPositions.size()){
+    		RefreshTickKinematics();
+    	}
+    	return m_tickPositions[node->GetId()];
+    }
+
+    const Vector&
+    TopologySatelliteNetwork::GetTickVelocity(Ptr<Node> node){
+    	if(!m_tickKinematicsValid || m_tickKinematicsTimeNs != Simulator::Now().GetNanoSeconds() || node->GetId() >= m_tickVelocities.size()){
+    		RefreshTickKinematics();
+    	}
+    	return m_tickVelocities[node->GetId()];
+    }
+
+    bool
+    TopologySatelliteNetwork::PredictPosition(Ptr<Node> node, int64_t timeNs, Vector& position){
+
+    	Ptr<SatellitePositionMobilityModel> satMobility = node->GetObject<SatellitePositionMobilityModel>();
+    	if(satMobility != nullptr){
+    		position = satMobility->GetSatellite()->GetPosition(satMobility->GetStartTime() + NanoSeconds(timeNs));
+    		return true;
+    	}
+    	// ground stations do not move, other moving nodes (e.g. aircrafts) are not predicted
+    	Ptr<MobilityModel> mobility = node->GetObject<MobilityModel>();
+    	position = mobility->GetPosition();
+    	Vector velocity = mobility->GetVelocity();
+    	return velocity.x == 0 && velocity.y == 0 && velocity.z == 0;
+
+    }
+
+    void
+    TopologySatelliteNetwork::UpdateDistributedLookahead(int64_t timeNs){
+
+    	std::vector<int64_t> assignment = m_basicSimulation->GetDistributedNodeSystemIdAssignment();
+    	int64_t epochNs = m_dynamicStateUpdateIntervalNs;
+    	double propagationSpeedMetersPerSecond = 299792458.0;
+
+    	// Positions at the start of this epoch, of the next one and at the end of the next one: a message
+    	// sent at the end of this epoch may be granted up to one lookahead into the next epoch
+    	std::vector<int64_t> samples = {timeNs, timeNs + epochNs, timeNs + 2 * epochNs};
+    	// the first two samples were the last two of the previous epoch
+    	std::unordered_map<uint32_t, std::pair<bool, std::vector<Vector>>> previous;
+    	previous.swap(m_lookaheadPredictions);
+    	bool shifted = m_lookaheadPredictionTimeNs + epochNs == timeNs;
+    	m_lookaheadPredictionTimeNs = timeNs;
+    	auto predict = [&](Ptr<Node> node) -> const std::pair<bool, std::vector<Vector>>& {
+    		auto iter = m_lookaheadPredictions.find(node->GetId());
+    		if(iter != m_lookaheadPredictions.end()){
+    			return iter->second;
+    		}
+    		std::pair<bool, std::vector<Vector>>& entry = m_lookaheadPredictions[node->GetId()];
+    		entry.first = true;
+    		entry.second.resize(samples.size());
+    		uint32_t k = 0;
+    		auto last = shifted ? previous.find(node->GetId()) : previous.end();
+    		if(last != previous.end()){
+    			entry.first = last->second.first;
+    			for(; k + 1 < samples.size(); k++){
+    				entry.second[k] = last->second.second[k + 1];
+    			}
+    		}
+    		for(; k < samples.size(); k++){
+    			entry.first &= PredictPosition(node, samples[k], entry.second[k]);
+    		}
+    		return entry;
+    	};
+    	// Minimum distance of two nodes moving linearly between the samples
+    	auto minDistance = [](const std::vector<Vector>& a, const std::vector<Vector>& b) -> double {
+    		double best = DBL_MAX;
+    		for(uint32_t k = 0; k + 1 < a.size(); k++){
+    			Vector r0 = a[k] - b[k];
+    			Vector dr = (a[k + 1] - b[k + 1]) - r0;
+    			double drdr = dr.x * dr.x + dr.y * dr.y + dr.z * dr.z;
+    			double s = drdr > 0 ? -(r0.x * dr.x + r0.y * dr.y + r0.z * dr.z) / drdr : 0.0;
+    			s = std::min(1.0, std::max(0.0, s));
+    			Vector r(r0.x + s * dr.x, r0.y + s * dr.y, r0.z + s * dr.z);
+    			best = std::min(best, r.GetLength());
+    		}
+    		return best;
+    	};
+    	// Only links between this system and another one bound the delay of the messages it sends;
+    	// nodes without an assignment entry are treated as remote
+    	uint32_t systemId = m_system_id;
+    	auto isLocal = [&assignment, systemId](uint32_t node) -> bool {
+    		return node < assignment.size() && assignment[node] == int64_t(systemId);
+    	};
+    	auto leavesSystem = [&isLocal](Ptr<Node> a, Ptr<Node> b) -> bool {
+    		return isLocal(a->GetId()) != isLocal(b->GetId());
+    	};
+
+    	double minDistanceM = DBL_MAX;
+    	bool unpredictable = false;
+    	for(Ptr<Constellation> cons : m_constellations){
+    		for(std::pair<uint32_t, uint32_t> isl : cons->GetIslFromToUnique()){
+    			Ptr<Node> sat0 = m_satelliteNodes.Get(isl.first);
+    			Ptr<Node> sat1 = m_satelliteNodes.Get(isl.second);
+    			if(!leavesSystem(sat0, sat1)){
+    				continue;
+    			}
+    			const std::pair<bool, std::vector<Vector>>& a = predict(sat0);
+    			const std::pair<bool, std::vector<Vector>>& b = predict(sat1);
+    			minDistanceM = std::min(minDistanceM, minDistance(a.second, b.second));
+    		}
+    	}
+    	for(uint32_t i = 0; i < m_gslSatNetDevices.GetN(); i++){
+    		Ptr<Node> sat = m_gslSatNetDevices.Get(i)->GetNode();
+    		Ptr<SAGPhysicalLayerGSL> gsl_channel = m_gslSatNetDevices.Get(i)->GetChannel()->GetObject<SAGPhysicalLayerGSL>();
+    		for(uint32_t j = 1; j < gsl_channel->GetNDevices(); j++){
+    			Ptr<Node> gnd = gsl_channel->GetDevice(j)->GetNode();
+    			if(!leavesSystem(sat, gnd)){
+    				continue;
+    			}
+    			const std::pair<bool, std::vector<Vector>>& a = predict(sat);
+    			const std::pair<bool, std::vector<Vector>>& b = predict(gnd);
+    			if(!a.first || !b.first){
+    				unpredictable = true;
+    				continue;
+    			}
+    			minDistanceM = std::min(minDistanceM, minDistance(a.second, b.second));
+    		}
+    	}
+
+    	// Without any cross-process link the lookahead only has to stay within the predicted horizon
+    	int64_t lookaheadNs = epochNs;
+    	if(minDistanceM != DBL_MAX){
+    		lookaheadNs = std::min<int64_t>(lookaheadNs, minDistanceM * (1.0 - m_mpiLookaheadSafetyMargin) / propagationSpeedMetersPerSecond * 1e9);
+    	}
+    	if(unpredictable){
+    		// A GSL is never shorter than the altitude of the lowest shell
+    		double lowestAltitudeKm = DBL_MAX;
+    		for(Ptr<Constellation> cons : m_constellations){
+    			lowestAltitudeKm = std::min(lowestAltitudeKm, cons->GetAltitude());
+    		}
+    		lookaheadNs = std::min<int64_t>(lookaheadNs, lowestAltitudeKm * 1000 * (1.0 - m_mpiLookaheadSafetyMargin) / propagationSpeedMetersPerSecond * 1e9);
+    	}
+    	lookaheadNs = std::max<int64_t>(lookaheadNs, 1);
+
+    	DistributedLookahead::Update(NanoSeconds(timeNs), NanoSeconds(lookaheadNs));
+    	WriteMpiLookahead(lookaheadNs);
+
+    }
+
+    void
+    TopologySatelliteNetwork::WriteMpiLookahead(int64_t lookaheadNs){
+    	// read back by the MPI simulator implementation at the next window
+        std::ofstream file(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_mpi_lookahead.txt", std::ofstream::out);
+        file<<lookaheadNs<<std::endl;
+        file.close();
     }
 
     void
@@ -1804,11 +2105,8 @@ namespace ns3 {
 				Ptr<Node> satNodeId0 = m_satelliteNodes.Get(satId0);
 				Ptr<Node> satNodeId1 = m_satelliteNodes.Get(satId1);
 
-				Ptr<MobilityModel> senderMobility = satNodeId0->GetObject<MobilityModel>();
-				Ptr<MobilityModel> receiverMobility = satNodeId1->GetObject<MobilityModel>();
-
 				double propagationSpeedMetersPerSecond = 299792458.0;
-				double distance_m = senderMobility->GetDistanceFrom (receiverMobility);
+				double distance_m = CalculateDistance(GetTickPosition(satNodeId0), GetTickPosition(satNodeId1));
 				double seconds = distance_m / propagationSpeedMetersPerSecond;
 				Time delay = Seconds (seconds);
 				if(la > (uint64_t)delay.GetNanoSeconds()){
@@ -1832,10 +2130,8 @@ namespace ns3 {
 
     		for(uint32_t j = 1; j < gsl_channel->GetNDevices(); j++){
     			Ptr<Node> gnd = gsl_channel->GetDevice(j)->GetNode();
-    			Ptr<MobilityModel> senderMobility = sat->GetObject<MobilityModel>();
-    			Ptr<MobilityModel> receiverMobility = gnd->GetObject<MobilityModel>();
     			double propagationSpeedMetersPerSecond = 299792458.0;
-				double distance_m = senderMobility->GetDistanceFrom (receiverMobility);
+				double distance_m = CalculateDistance(GetTickPosition(sat), GetTickPosition(gnd));
 				double seconds = distance_m / propagationSpeedMetersPerSecond;
 				Time delay = Seconds (seconds);
 				delays.push_back(delay);
@@ -1849,9 +2145,12 @@ namespace ns3 {
     		gsl_channel->SetChannelDelay(delays);
     	}
 
-        std::ofstream file(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_mpi_lookahead.txt", std::ofstream::out);
-        file<<la<<std::endl;
-        file.close();
+        if(m_enable_distributed){
+        	UpdateDistributedLookahead(time);
+        }
+        else{
+        	WriteMpiLookahead(la);
+        }
 
 //    	if(m_system_id == 0 && parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_trajectory_tracing", "false"))){
 //			uint32_t t = uint32_t(Simulator::Now().GetSeconds());
@@ -1894,7 +2193,6 @@ namespace ns3 {
 			uint32_t t = uint32_t(Simulator::Now().GetSeconds());
 			for(uint32_t sat = 0; sat < m_nodesCurSystem.GetN(); sat++){
 				Ptr<Node> satNode = m_nodesCurSystem.Get(sat);
-				std::ofstream file(m_satellite_network_dir + "/system_"+ to_string(m_system_id) + "_coordinates" + "/satellite_" + std::to_string(satNode->GetId()) +".txt", std::ofstream::out | std::ofstream::app);
 				Ptr<MobilityModel> nodeMobility = satNode->GetObject<MobilityModel>();
 				Vector pos = nodeMobility->GetPosition();
 				Vector vect = nodeMobility->GetVelocity();
@@ -1905,10 +2203,11 @@ namespace ns3 {
 //    			double longitudeSatId0 = atan2(y, x) * 180 / pi;
 				double out_latitude, out_longitude, out_altitude;
 				cppmap3d::ecef2geodetic(x,y,z,out_latitude,out_longitude,out_altitude,cppmap3d::Ellipsoid::WGS72);
-				file<<t<<","<<pos.x<<","<<pos.y<<","<<pos.z<<","
+				std::ostringstream line;
+				line<<t<<","<<pos.x<<","<<pos.y<<","<<pos.z<<","
 						<<out_latitude * 180 / pi<<","<<out_longitude * 180 / pi<<","<<out_altitude<<","
-						<<vect.x<<","<<vect.y<<","<<vect.z<<std::endl;
-				file.close();
+						<<vect.x<<","<<vect.y<<","<<vect.z<<"\n";
+				LogSink::Append(m_satellite_network_dir + "/system_"+ to_string(m_system_id) + "_coordinates" + "/satellite_" + std::to_string(satNode->GetId()) +".txt", line.str());
 
 
 				Ptr<SatellitePositionMobilityModel> satMobility = nodeMobility->GetObject<SatellitePositionMobilityModel>();
@@ -1952,21 +2251,12 @@ namespace ns3 {
 
 
 
-    	int64_t dynamicStateUpdateIntervalNsTemp;
-    	if(time == 0) dynamicStateUpdateIntervalNsTemp = m_dynamicStateUpdateIntervalNs + 1;
-    	else dynamicStateUpdateIntervalNsTemp = m_dynamicStateUpdateIntervalNs;
-    	int64_t next_update_ns = time + dynamicStateUpdateIntervalNsTemp;
-		if (next_update_ns < m_basicSimulation->GetSimulationEndTimeNs()) {
-			Simulator::Schedule(NanoSeconds(dynamicStateUpdateIntervalNsTemp),
-					&TopologySatelliteNetwork::MakeLinkDelayUpdateEvent, this, next_update_ns);
-		}
-		else{
+    	// Dump the collected orbital elements after the last time slot
+    	int64_t next_update_ns = time + m_dynamicStateUpdateIntervalNs;
+		if (next_update_ns >= m_basicSimulation->GetSimulationEndTimeNs()) {
 			if(parse_boolean(m_basicSimulation->GetConfigParamOrDefault("enable_trajectory_tracing", "false"))){
 				for(uint32_t sat = 0; sat < m_nodesCurSystem.GetN(); sat++){
-					std::string jsonString = m_satelliteElements[sat].dump(4);
-					std::ofstream fileTopologyChange(m_satellite_network_dir + "/system_"+ to_string(m_system_id) + "_orbital_elements"+ "/satellite_" + std::to_string(m_nodesCurSystem.Get(sat)->GetId()) +".json", std::ofstream::out);
-					fileTopologyChange<<jsonString;
-					fileTopologyChange.close();
+					LogSink::WriteFile(m_satellite_network_dir + "/system_"+ to_string(m_system_id) + "_orbital_elements"+ "/satellite_" + std::to_string(m_nodesCurSystem.Get(sat)->GetId()) +".json", m_satelliteElements[sat].dump(4));
 				}
 			}
 		}
@@ -1978,6 +2268,7 @@ namespace ns3 {
     	std::vector<double> AveSINRs = {};
     	std::vector<double> AvePERs_fwd = {};
     	std::vector<double> AvePERs_rtn = {};
+    	m_sinrRecorder.BeginFrame(m_sinrTick++, int64_t(time));
        	for(uint32_t i = 0; i < m_gslSatNetDevices.GetN(); i++){
        		Ptr<Node> sat = m_gslSatNetDevices.Get(i)->GetNode();
        		Ptr<SAGPhysicalLayerGSL> gsl_channel = m_gslSatNetDevices.Get(i)->GetChannel()->GetObject<SAGPhysicalLayerGSL>();
@@ -2005,18 +2296,27 @@ namespace ns3 {
        			double SINRDb = rvPower-NoiseDbm;
        			//SINRDb=17.74564926372155;
        			//std::cout<<"FrameType is,"<<gs->GetFrameType()<<std::endl;
-       			//satellite-->gs
-       			double actualBlerRTN= sat1->GetLinkResultsRTN()-> GetBler(sat1->GetWaveformId(), SINRDb);
+       			m_sinrRecorder.Add(sat->GetId(), gnd->GetId(), SINRDb);
+       			if(m_enableGslAcm){
+       				UpdateGslAcm(gs, sat, SINRDb);
+       			}
        			//gs-->satellite
        			double actualBlerFWD= gs->GetLinkResultsFWD()-> GetBler(gs->GetTxMCS(), gs->GetFrameType(), SINRDb);
 
        			//std::cout<<"SINR is,"<<SINRDb<<std::endl;
    				SINRs.push_back(SINRDb);
-   				//std::cout<<"PERs_rtn is,"<<actualBlerRTN<<std::endl;
-   				PERs_rtn.push_back(actualBlerRTN);
    				//std::cout<<"PERs_fwd is,"<<actualBlerFWD<<std::endl;
    				PERs_fwd.push_back(actualBlerFWD);
        		}
+       		if(m_enableGslAcm && !SINRs.empty()){
+       			// one waveform serves every ground station of the satellite, the weakest one decides
+       			UpdateGslAcmReturn(sat1, *std::min_element(SINRs.begin(), SINRs.end()));
+       		}
+       		//satellite-->gs, with the waveform chosen above
+       		Ptr<SatLinkResultsRtn> linkResultsRTN = sat1->GetLinkResultsRTN();
+       		for(double SINRDb : SINRs){
+       			PERs_rtn.push_back(linkResultsRTN->GetBler(sat1->GetWaveformId(), SINRDb));
+       		}
        		if (!SINRs.empty()){
 				gsl_channel-> SetChannelSINR(SINRs);
 				gsl_channel-> SetChannelPERFWD(PERs_fwd);
@@ -2034,28 +2334,20 @@ namespace ns3 {
        		}
 
        	}
-    	int64_t dynamicStateUpdateIntervalNsTemp;
-    	if(time == 0) dynamicStateUpdateIntervalNsTemp = m_dynamicStateUpdateIntervalNs + 2;
-    	else dynamicStateUpdateIntervalNsTemp = m_dynamicStateUpdateIntervalNs;
-    	int64_t next_update_ns = time + dynamicStateUpdateIntervalNsTemp;
-		if (next_update_ns < m_basicSimulation->GetSimulationEndTimeNs()) {
-			Simulator::Schedule(NanoSeconds(dynamicStateUpdateIntervalNsTemp),
-					&TopologySatelliteNetwork::MakeLinkSINRUpdateEvent, this, next_update_ns);
-		}
+       	if(m_enableGslAcm){
+       		RetireGslAcmControllers();
+       	}
+       	if(m_sinrRecorder.IsOpen()){
+       		m_sinrRecorder.EndFrame();
+       		return;
+       	}
 		// write sinr-ber.json
 		nlohmann::ordered_json jsonObject2;
 		jsonObject2["sinr"] = AveSINRs;
 		jsonObject2["ber_rtn"] = AvePERs_fwd;
 		jsonObject2["ber_fwd"] = AvePERs_rtn;
 		jsonObject2["time_stamp_ns"] = time;
-		std::ofstream sinr(m_basicSimulation->GetRunDir() + "/results/network_results/global_statistics/network_wide_sinr.json", std::ofstream::app);
-		if (sinr.is_open()) {
-			sinr << jsonObject2.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-			sinr.close();
-			//std::cout << "JSON file created successfully." << std::endl;
-		} else {
-			std::cout << "Failed to create JSON file." << std::endl;
-		}
+		LogSink::Append(m_basicSimulation->GetRunDir() + "/results/network_results/global_statistics/network_wide_sinr.json", jsonObject2.dump(4));
 
     }
 
@@ -2132,10 +2424,9 @@ namespace ns3 {
     		for(auto adj: adjs){
     			// current satellite
     			Ptr<Node> sat = this->GetSatelliteNodes().Get(adj.first);
-    			Ptr<MobilityModel> satMobility = sat->GetObject<MobilityModel>();
-    			Vector oPosition = satMobility->GetPosition ();
+    			const Vector& oPosition = GetTickPosition(sat);
     			double rs[3] = {oPosition.x/1e3, oPosition.y/1e3, oPosition.z/1e3};
-    			Vector oVelocity = satMobility->GetVelocity();
+    			const Vector& oVelocity = GetTickVelocity(sat);
     			double vs[3] = {oVelocity.x/1e3, oVelocity.y/1e3, oVelocity.z/1e3};
 
     			// sun
@@ -2159,10 +2450,9 @@ namespace ns3 {
     				double razel[3];
     				double razelrates[3];
         			Ptr<Node> neighborNode = this->GetSatelliteNodes().Get(neighbor);
-        			Ptr<MobilityModel> neighborNodeMobility = neighborNode->GetObject<MobilityModel>();
-        			Vector nPosition = neighborNodeMobility->GetPosition ();
+        			const Vector& nPosition = GetTickPosition(neighborNode);
         			double recef[3] = {nPosition.x/1e3, nPosition.y/1e3, nPosition.z/1e3};
-        			Vector nVelocity = neighborNodeMobility->GetVelocity();
+        			const Vector& nVelocity = GetTickVelocity(neighborNode);
         			double vecef[3] = {nVelocity.x/1e3, nVelocity.y/1e3, nVelocity.z/1e3};
 
         			rv2azel(recef, vecef, rs, vs, razel, razelrates);
@@ -2208,14 +2498,6 @@ namespace ns3 {
     		AddISLBySatId(link.first, link.second, false);
     	}
 
-
-    	// schedule next event
-    	int64_t next_update_ns = time + m_dynamicStateUpdateIntervalNs;
-		if (next_update_ns < m_basicSimulation->GetSimulationEndTimeNs()) {
-			Simulator::Schedule(NanoSeconds(m_dynamicStateUpdateIntervalNs),
-					&TopologySatelliteNetwork::MakeSunOutageEvent, this, next_update_ns);
-		}
-
     }
 
     void TopologySatelliteNetwork::InstallGSLInterfaceForAllSatellites(){
@@ -2396,9 +2678,7 @@ namespace ns3 {
 
     void TopologySatelliteNetwork::AddGSLByGndAndSat(Ptr<Node> gs, Ptr<Node> sat, uint32_t interface){
 
-    	std::ofstream fileTopologyChange(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_topology_change_message.txt", std::ofstream::out | std::ofstream::app);
-    	fileTopologyChange <<Simulator::Now().GetMilliSeconds()<<","<<gs->GetId()<<","<<sat->GetId()<<std::endl;
-    	fileTopologyChange.close();
+    	LogSink::Append(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_topology_change_message.txt", std::to_string(Simulator::Now().GetMilliSeconds()) + "," + std::to_string(gs->GetId()) + "," + std::to_string(sat->GetId()) + "\n");
     	ConnectionLink addLink(gs->GetId(), interface);
         auto iter = find(m_gsLinkDetails.begin(), m_gsLinkDetails.end(), addLink);
         if(iter == m_gsLinkDetails.end()){
@@ -2595,6 +2875,7 @@ namespace ns3 {
 
     	// just for infrastructure such as earth stations, air crafts,etc.
     	m_switchStrategy->UpdateSwitch(m_gslRecord, m_gslRecordCopy);
+    	m_switchStrategy->RecordHandovers(m_gslRecord, m_gslRecordCopy);
     	// for terminals todo
     	// m_switchStrategyTerminal->UpdateSwitch(...);
 
@@ -2617,13 +2898,13 @@ namespace ns3 {
     	// Update actual GSL rate immediately after GSL handovers todo
     	if(parse_boolean(m_basicSimulation->GetConfigParamOrFail("enable_gsl_data_rate_fixed")) && time == 0){
     		// for gsl data rate fixed mode
-        	for(uint32_t i = 0; i < m_gslGsNetDevices.GetN(); i++){
+        	for(uint32_t i = 0; i < m_gslGsNetDevices.GetN() && !m_enableGslAcm; i++){
         		Ptr<NetDevice> ntd = m_gslGsNetDevices.Get(i);
         		Ptr<SAGLinkLayerGSL> ntdGSL = ntd->GetObject<SAGLinkLayerGSL>();
     	        NS_ASSERT_MSG (ntdGSL != nullptr, "instance error");
     	        ntdGSL->UpdateDataRate();
         	}
-        	for(uint32_t i = 0; i < m_gslSatNetDevices.GetN(); i++){
+        	for(uint32_t i = 0; i < m_gslSatNetDevices.GetN() && !m_enableGslAcm; i++){
         		Ptr<NetDevice> ntd = m_gslSatNetDevices.Get(i);
         		Ptr<SAGLinkLayerGSL> ntdGSL = ntd->GetObject<SAGLinkLayerGSL>();
     	        NS_ASSERT_MSG (ntdGSL != nullptr, "instance error");
@@ -2631,13 +2912,14 @@ namespace ns3 {
         	}
     	}
     	else if(!parse_boolean(m_basicSimulation->GetConfigParamOrFail("enable_gsl_data_rate_fixed"))){
-        	for(uint32_t i = 0; i < m_gslGsNetDevices.GetN(); i++){
+        	// with ACM the rate of both directions follows the MODCOD
+        	for(uint32_t i = 0; i < m_gslGsNetDevices.GetN() && !m_enableGslAcm; i++){
         		Ptr<NetDevice> ntd = m_gslGsNetDevices.Get(i);
         		Ptr<SAGLinkLayerGSL> ntdGSL = ntd->GetObject<SAGLinkLayerGSL>();
     	        NS_ASSERT_MSG (ntdGSL != nullptr, "instance error");
     	        ntdGSL->UpdateDataRate();
         	}
-        	for(uint32_t i = 0; i < m_gslSatNetDevices.GetN(); i++){
+        	for(uint32_t i = 0; i < m_gslSatNetDevices.GetN() && !m_enableGslAcm; i++){
         		Ptr<NetDevice> ntd = m_gslSatNetDevices.Get(i);
         		Ptr<SAGLinkLayerGSL> ntdGSL = ntd->GetObject<SAGLinkLayerGSL>();
     	        NS_ASSERT_MSG (ntdGSL != nullptr, "instance error");
@@ -2645,16 +2927,6 @@ namespace ns3 {
         	}
     	}
 
-		// Plan the next update
-    	int64_t dynamicStateUpdateIntervalNsTemp;
-    	if(time == 0) dynamicStateUpdateIntervalNsTemp = m_dynamicStateUpdateIntervalNs + 1;
-    	else dynamicStateUpdateIntervalNsTemp = m_dynamicStateUpdateIntervalNs;
-    	int64_t next_update_ns = time + dynamicStateUpdateIntervalNsTemp;
-		if (next_update_ns < m_basicSimulation->GetSimulationEndTimeNs()) {
-			Simulator::Schedule(NanoSeconds(dynamicStateUpdateIntervalNsTemp),
-					&TopologySatelliteNetwork::MakeGSLChangeEvent, this, next_update_ns);
-		}
-
     }
 
 
@@ -2716,9 +2988,7 @@ namespace ns3 {
 //                fileTopologyChange <<"ISL Re-establishment Time: "<<Simulator::Now().GetMilliSeconds()<<" ms Add: "<<satId0<<"  "<<satId1<<std::endl;
 //                fileTopologyChange <<"Total Interrupted ISL Number: "<< m_islDisableNetDevices.size()/2 << std::endl;
 
-                std::ofstream fileTopologyChange(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_topology_change_message_isl.txt", std::ofstream::out | std::ofstream::app);
-                fileTopologyChange <<Simulator::Now().GetMilliSeconds()<<","<<satId0<<","<<satId1<<","<<"recover"<<std::endl;
-                fileTopologyChange.close();
+                LogSink::Append(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_topology_change_message_isl.txt", std::to_string(Simulator::Now().GetMilliSeconds()) + "," + std::to_string(satId0) + "," + std::to_string(satId1) + ",recover\n");
     	        OutageLink failedLink(satId0, satId1);
     	        auto iter = find(m_sunOutageLinkDetails.begin(), m_sunOutageLinkDetails.end(), failedLink);
     	        NS_ASSERT_MSG (iter != m_sunOutageLinkDetails.end(), "No Sun Outage Link Details Record");
@@ -2754,9 +3024,7 @@ namespace ns3 {
         DoCreateNetDevice(satId0, satId1, p2p_laser_helper, tch_isl);
 
         //std::cout <<"New ISL Establishment Time: "<<Simulator::Now().GetMilliSeconds()<<" ms Add: "<<satId0<<"  "<<satId1<<std::endl;
-        std::ofstream fileTopologyChange(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_topology_change_message_isl.txt", std::ofstream::out | std::ofstream::app);
-        fileTopologyChange <<Simulator::Now().GetMilliSeconds()<<","<<satId0<<","<<satId1<<","<<"new_establish"<<std::endl;
-        fileTopologyChange.close();
+        LogSink::Append(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_topology_change_message_isl.txt", std::to_string(Simulator::Now().GetMilliSeconds()) + "," + std::to_string(satId0) + "," + std::to_string(satId1) + ",new_establish\n");
     }
 
     void 
@@ -2825,9 +3093,7 @@ namespace ns3 {
 	        //std::cout <<"ISL Interruption Time: "<<Simulator::Now().GetMilliSeconds()<<" ms Disable: "<<satId0<<"  "<<satId1<<std::endl;
 	        //std::cout <<"Total Interrupted ISL Number: "<< m_islDisableNetDevices.size()/2 << std::endl;
 
-	        std::ofstream fileTopologyChange(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_topology_change_message_isl.txt", std::ofstream::out | std::ofstream::app);
-	        fileTopologyChange <<Simulator::Now().GetMilliSeconds()<<","<<satId0<<","<<satId1<<","<<"interruption"<<std::endl;
-	        fileTopologyChange.close();
+	        LogSink::Append(m_satellite_network_dir + "/system_" + std::to_string(m_system_id)+"_topology_change_message_isl.txt", std::to_string(Simulator::Now().GetMilliSeconds()) + "," + std::to_string(satId0) + "," + std::to_string(satId1) + ",interruption\n");
 	        OutageLink failedLink(satId0, satId1);
 	        auto iter = find(m_sunOutageLinkDetails.begin(), m_sunOutageLinkDetails.end(), failedLink);
 	        if(iter == m_sunOutageLinkDetails.end()){
@@ -3091,8 +3357,188 @@ namespace ns3 {
     }
 
 
+    Ptr<const SatAcmModcodTable>
+	TopologySatelliteNetwork::GetAcmModcodTable(Ptr<SAGLinkLayerGSL> gs){
+
+    	std::string protocol = gs->SetTxProtocol();
+    	auto iter = m_acmModcodTables.find(protocol);
+    	if(iter != m_acmModcodTables.end()){
+    		return iter->second;
+    	}
+
+    	Ptr<SatLinkResultsFwd> linkResults = gs->GetLinkResultsFWD();
+    	SatEnums::DvbVersion_t version = gs->GetProtocol() == DVB_S2X ? SatEnums::DVB_S2X : SatEnums::DVB_S2;
+    	SatEnums::SatBbFrameType_t frameType = gs->GetFrameType() == SatEnums::SHORT_FRAME ? SatEnums::SHORT_FRAME : SatEnums::NORMAL_FRAME;
+    	// frame durations at 1 baud, the table scales them to the carrier
+    	Ptr<SatBbFrameConf> conf = CreateObject<SatBbFrameConf>(1.0, version);
+    	DoubleValue targetBler;
+    	conf->GetAttribute("TargetBLER", targetBler);
+
+    	double symbolRate = m_gslAcmSymbolRateBaud;
+    	if(symbolRate == 0){
+    		// the default MODCOD delivers the configured GSL data rate
+    		SatEnums::SatModcod_t modcod = conf->GetDefaultModCod();
+    		double bpsPerBaud = conf->GetBbFramePayloadBits(modcod, frameType) / conf->GetBbFrameDuration(modcod, frameType).GetSeconds();
+    		symbolRate = m_gsl_data_rate_megabit_per_s * 1e6 / bpsPerBaud;
+    	}
+
+    	Ptr<const SatAcmModcodTable> table = Create<SatAcmModcodTable>(conf, linkResults, frameType, targetBler.Get(), symbolRate);
+    	m_acmModcodTables[protocol] = table;
+    	std::cout << "  > ACM MODCOD table for " << protocol << ": " << table->GetN() << " MODCOD(s) at " << symbolRate << " baud" << std::endl;
+    	return table;
+
+    }
+
+    void
+	TopologySatelliteNetwork::UpdateGslAcm(Ptr<SAGLinkLayerGSL> gs, Ptr<Node> sat, double sinrDb){
+
+    	std::pair<uint32_t, uint32_t> key = std::make_pair(gs->GetNode()->GetId(), sat->GetId());
+    	auto iter = m_acmControllers.find(key);
+    	if(iter == m_acmControllers.end()){
+    		iter = m_acmControllers.insert(std::make_pair(key, SatAcmController(gs, GetAcmModcodTable(gs), m_gslAcmHysteresisDb))).first;
+    	}
+    	iter->second.Update(sinrDb);
+
+    }
+
+    Ptr<const SatAcmModcodTable>
+	TopologySatelliteNetwork::GetAcmReturnTable(Ptr<SAGLinkLayerGSL> sat){
+
+    	if(m_acmReturnTable != nullptr){
+    		return m_acmReturnTable;
+    	}
+
+    	Ptr<SatLinkResultsRtn> linkResults = sat->GetLinkResultsRTN();
+    	std::string waveformFile = m_basicSimulation->GetConfigParamOrDefault("gsl_acm_waveform_file", m_basicSimulation->GetRunDir() + "/linkresults/dvbRcs2Waveforms.txt");
+    	Ptr<SatWaveformConf> conf = CreateObject<SatWaveformConf>(waveformFile);
+    	DoubleValue targetBler;
+    	conf->GetAttribute("TargetBLER", targetBler);
+
+    	double symbolRate = m_gslAcmSymbolRateBaud;
+    	if(symbolRate == 0){
+    		// the default waveform delivers the configured GSL data rate
+    		double bpsPerBaud = conf->GetWaveform(conf->GetDefaultWaveformId())->GetThroughputInBitsPerSecond(1.0);
+    		symbolRate = m_gsl_data_rate_megabit_per_s * 1e6 / bpsPerBaud;
+    	}
+
+    	m_acmReturnTable = Create<SatAcmModcodTable>(conf, linkResults, conf->GetDefaultBurstLength(), targetBler.Get(), symbolRate);
+    	std::cout << "  > ACM return waveform table: " << m_acmReturnTable->GetN() << " waveform(s) at " << symbolRate << " baud" << std::endl;
+    	return m_acmReturnTable;
+
+    }
+
+    void
+	TopologySatelliteNetwork::UpdateGslAcmReturn(Ptr<SAGLinkLayerGSL> sat, double sinrDb){
+
+    	uint32_t key = sat->GetNode()->GetId();
+    	auto iter = m_acmReturnControllers.find(key);
+    	if(iter == m_acmReturnControllers.end()){
+    		iter = m_acmReturnControllers.insert(std::make_pair(key, SatAcmController(sat, GetAcmReturnTable(sat), m_gslAcmHysteresisDb))).first;
+    	}
+    	iter->second.Update(sinrDb);
+
+    }
+
+    void
+	TopologySatelliteNetwork::RetireGslAcmControllers(){
+
+    	for(auto iter = m_acmControllers.begin(); iter != m_acmControllers.end();){
+    		if(iter->second.GetLastUpdate() != Simulator::Now()){
+    			FoldAcmResidency(iter->second, m_acmResidency, m_acmSwitches);
+    			iter = m_acmControllers.erase(iter);
+    		}
+    		else{
+    			iter++;
+    		}
+    	}
+    	for(auto iter = m_acmReturnControllers.begin(); iter != m_acmReturnControllers.end();){
+    		if(iter->second.GetLastUpdate() != Simulator::Now()){
+    			FoldAcmResidency(iter->second, m_acmReturnResidency, m_acmReturnSwitches);
+    			iter = m_acmReturnControllers.erase(iter);
+    		}
+    		else{
+    			iter++;
+    		}
+    	}
+
+    }
+
+    void
+	TopologySatelliteNetwork::FoldAcmResidency(SatAcmController& controller, std::map<SatEnums::SatModcod_t, Time>& total, uint64_t& switches){
+
+    	controller.Finalize();
+    	const std::vector<Time>& residency = controller.GetResidency();
+    	for(uint32_t i = 0; i < residency.size(); i++){
+    		total[controller.GetTable()->GetModcod(i)] += residency[i];
+    	}
+    	switches += controller.GetNSwitches();
+
+    }
+
+    void
+	TopologySatelliteNetwork::CollectAcmStatistics(){
+
+    	if(!m_enableGslAcm){
+    		return;
+    	}
+    	for(auto& entry : m_acmControllers){
+    		FoldAcmResidency(entry.second, m_acmResidency, m_acmSwitches);
+    	}
+    	m_acmControllers.clear();
+    	for(auto& entry : m_acmReturnControllers){
+    		FoldAcmResidency(entry.second, m_acmReturnResidency, m_acmReturnSwitches);
+    	}
+    	m_acmReturnControllers.clear();
+
+    	auto toJson = [](const std::map<SatEnums::SatModcod_t, Time>& residency, uint64_t switches){
+    		Time total(0);
+    		for(auto& entry : residency){
+    			total += entry.second;
+    		}
+    		std::vector<std::string> modcods;
+    		std::vector<double> residencyS;
+    		std::vector<double> share;
+    		for(auto& entry : residency){
+    			if(entry.second.IsZero()){
+    				continue;
+    			}
+    			modcods.push_back(SatEnums::GetModcodTypeName(entry.first));
+    			residencyS.push_back(entry.second.GetSeconds());
+    			share.push_back(total.IsZero() ? 0 : entry.second.GetSeconds() / total.GetSeconds());
+    		}
+    		nlohmann::ordered_json jsonObject;
+    		jsonObject["modcod"] = modcods;
+    		jsonObject["residency_s"] = residencyS;
+    		jsonObject["share"] = share;
+    		jsonObject["switches"] = switches;
+    		return jsonObject;
+    	};
+
+    	// ground-to-satellite direction at the top level, satellite-to-ground under "return"
+    	nlohmann::ordered_json jsonObject = toJson(m_acmResidency, m_acmSwitches);
+    	jsonObject["return"] = toJson(m_acmReturnResidency, m_acmReturnSwitches);
+    	LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_gsl_modcod_residency.json", jsonObject.dump(4));
+
+    }
+
+    void
+	TopologySatelliteNetwork::CollectSinrStatistics(){
+
+    	if(!m_sinrRecorder.IsOpen() || !m_sinrExportJson){
+    		return;
+    	}
+    	// the converter reads the frames back from disk
+    	LogSink::Flush();
+    	SinrSnapshotReader::ConvertToJson(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_" + SINR_SNAPSHOT_LOG_FILE,
+    			m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id) + "_network_wide_sinr.json");
+
+    }
+
     void TopologySatelliteNetwork::CollectUtilizationStatistics() {
 
+    	CollectAcmStatistics();
+    	CollectSinrStatistics();
+
     	remove_file_if_exists(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id)+ "_isl_utilization.json");
 		remove_file_if_exists(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id)+ "_gsl_utilization.json");
 
@@ -3167,25 +3613,11 @@ namespace ns3 {
 				// Close CSV file
 				//fclose(file_utilization_csv);
         	}
-			std::ofstream results(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id)+ "_isl_utilization.json", std::ofstream::out);
-			if (results.is_open()) {
-				results << json_v.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				results.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id)+ "_isl_utilization.json", json_v.dump(4));
 
 			json_v_mlu["time_stamp (ns)"] = time_stamp;
 			json_v_mlu["max_utilization_details"] = json_v_mlu_cons;
-			std::ofstream mlu_results(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id)+ "_max_link_utilization.json", std::ofstream::out);
-			if (mlu_results.is_open()) {
-				mlu_results << json_v_mlu.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				mlu_results.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id)+ "_max_link_utilization.json", json_v_mlu.dump(4));
 
         }
 
@@ -3271,28 +3703,14 @@ namespace ns3 {
 				jsonObject["utilization_details"] = jsonUtiliTotal;
 				json_v.push_back(jsonObject);
             }
-			std::ofstream results(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id)+ "_gsl_utilization.json", std::ofstream::out);
-			if (results.is_open()) {
-				results << json_v.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				results.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_system_id)+ "_gsl_utilization.json", json_v.dump(4));
 
             // write throughput.json
 			nlohmann::ordered_json jsonObject2;
 			jsonObject2["throughput_send_bps"] = throughput_send;
 			jsonObject2["throughput_sink_bps"] = throughput_sink;
 			jsonObject2["time_stamp_ns"] = time_stamp;
-			std::ofstream throughput(m_basicSimulation->GetRunDir() + "/logs_ns3/system_"+std::to_string(m_system_id)+"_network_wide_throughput.json", std::ofstream::out);
-			if (throughput.is_open()) {
-				throughput << jsonObject2.dump(4);  // 使用缩进格式将 JSON 内容写入文件
-				throughput.close();
-				//std::cout << "JSON file created successfully." << std::endl;
-			} else {
-				std::cout << "Failed to create JSON file." << std::endl;
-			}
+			LogSink::WriteFile(m_basicSimulation->GetRunDir() + "/logs_ns3/system_"+std::to_string(m_system_id)+"_network_wide_throughput.json", jsonObject2.dump(4));
 
 //            if(!m_enable_distributed){
 //                // write throughput.json
@@ -3497,4 +3915,57 @@ namespace ns3 {
     	return m_gsLinkDetails;
     }
 
+    std::vector<TopologyLink>
+    TopologySatelliteNetwork::GetCurrentLinks(){
+
+    	double propagationSpeedMetersPerSecond = 299792458.0;
+    	std::vector<TopologyLink> links;
+
+    	for(Ptr<Constellation> cons : m_constellations){
+    		std::vector<std::pair<uint32_t, uint32_t>> islFromToUnique = cons->GetIslFromToUnique();
+    		NetDeviceContainer islNetDevices = cons->GetIslNetDevicesInfo();
+    		for(uint32_t i = 0; i < islFromToUnique.size(); i++){
+    			uint32_t satId0 = islFromToUnique.at(i).first;
+    			uint32_t satId1 = islFromToUnique.at(i).second;
+    			Ptr<SAGLinkLayer> dev0 = islNetDevices.GetWithKey(CalStringKey(satId0, satId1))->GetObject<SAGLinkLayer>();
+    			Ptr<SAGLinkLayer> dev1 = islNetDevices.GetWithKey(CalStringKey(satId1, satId0))->GetObject<SAGLinkLayer>();
+    			if(dev0->GetInterruptionInformation(P2PInterruptionType::Predictable)
+    					|| dev0->GetInterruptionInformation(P2PInterruptionType::Unpredictable)){
+    				continue;
+    			}
+    			Ptr<Node> satNode0 = m_satelliteNodes.Get(satId0);
+    			Ptr<Node> satNode1 = m_satelliteNodes.Get(satId1);
+    			double delayNs = CalculateDistance(GetTickPosition(satNode0), GetTickPosition(satNode1)) / propagationSpeedMetersPerSecond * 1e9;
+    			links.push_back({satNode0->GetId(), satNode1->GetId(), dev0, dev0->GetDataRate(), delayNs});
+    			links.push_back({satNode1->GetId(), satNode0->GetId(), dev1, dev1->GetDataRate(), delayNs});
+    		}
+    	}
+
+    	// device 0 of a GSL channel is the satellite, the others are the attached ground devices
+    	for(uint32_t i = 0; i < m_gslSatNetDevices.GetN(); i++){
+    		Ptr<SAGLinkLayerGSL> satDev = m_gslSatNetDevices.Get(i)->GetObject<SAGLinkLayerGSL>();
+    		Ptr<Node> sat = satDev->GetNode();
+    		Ptr<SAGPhysicalLayerGSL> gsl_channel = satDev->GetChannel()->GetObject<SAGPhysicalLayerGSL>();
+    		for(uint32_t j = 1; j < gsl_channel->GetNDevices(); j++){
+    			Ptr<SAGLinkLayerGSL> gndDev = gsl_channel->GetDevice(j)->GetObject<SAGLinkLayerGSL>();
+    			Ptr<Node> gnd = gndDev->GetNode();
+    			double delayNs = CalculateDistance(GetTickPosition(sat), GetTickPosition(gnd)) / propagationSpeedMetersPerSecond * 1e9;
+    			links.push_back({gnd->GetId(), sat->GetId(), gndDev, gndDev->GetDataRate(), delayNs});
+    			links.push_back({sat->GetId(), gnd->GetId(), satDev, satDev->GetDataRate(), delayNs});
+    		}
+    	}
+
+    	return links;
+    }
+
+    void
+    TopologySatelliteNetwork::AddTopologyTickPhase(std::string name, TopologyTickPhase order, Callback<void, double> phase){
+    	m_tickAggregator.AddPhase(name, order, phase);
+    }
+
+    int64_t
+    TopologySatelliteNetwork::GetTopologyTickIntervalNs(){
+    	return (int64_t) m_dynamicStateUpdateIntervalNs;
+    }
+
 }
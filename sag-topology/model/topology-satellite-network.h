@@ -70,6 +70,10 @@
 #include "ns3/bgp-routing-helper.h"
 #include "ns3/point-to-point-laser-channel.h"
 #include "ns3/distributed_node_system_id_assignment.h"
+#include "ns3/distributed_lookahead.h"
+#include "ns3/topology_tick_aggregator.h"
+#include "ns3/sag_acm_controller.h"
+#include "ns3/sinr_snapshot_recorder.h"
 //#include "ns3/sag_rtp_constants.h"
 #include "ns3/earth.h"
 #include "ns3/earth-position-mobility-model.h"
@@ -116,6 +120,15 @@ struct ConnectionLink{
 	}
 };
 
+// Directed link of the current tick, links sending through the same device share its capacity
+struct TopologyLink{
+	uint32_t m_from;
+	uint32_t m_to;
+	Ptr<NetDevice> m_device;		//!< Transmitting device
+	uint64_t m_capacityBps;
+	double m_delayNs;				//!< Propagation delay
+};
+
 /**
  * \ingroup SatelliteNetwork
  *
@@ -204,6 +217,26 @@ public:
 
 	void MakeLinkDelayUpdateEvent(double time);
 	void MakeLinkSINRUpdateEvent(double time);
+	/**
+	 * \brief Adapt the MODCOD of the ground-to-satellite direction of a GSL pair to its SINR
+	 */
+	void UpdateGslAcm(Ptr<SAGLinkLayerGSL> gs, Ptr<Node> sat, double sinrDb);
+	/**
+	 * \brief Drop the controllers of pairs that got no SINR update this tick, i.e. that were handed over
+	 */
+	void RetireGslAcmControllers();
+	Ptr<const SatAcmModcodTable> GetAcmModcodTable(Ptr<SAGLinkLayerGSL> gs);
+	/**
+	 * \brief Adapt the waveform of the satellite-to-ground direction to the weakest SINR of its ground stations
+	 */
+	void UpdateGslAcmReturn(Ptr<SAGLinkLayerGSL> sat, double sinrDb);
+	Ptr<const SatAcmModcodTable> GetAcmReturnTable(Ptr<SAGLinkLayerGSL> sat);
+	void FoldAcmResidency(SatAcmController& controller, std::map<SatEnums::SatModcod_t, Time>& total, uint64_t& switches);
+	void CollectAcmStatistics();
+	/**
+	 * \brief Export the SINR snapshot log to JSON if requested
+	 */
+	void CollectSinrStatistics();
 	void ReadSunTrajectoryEciFromCspice();
 	void MakeSunOutageEvent(double time);
 	void MakeSatelliteCoordinateUpdateEvent(double time);
@@ -218,6 +251,16 @@ public:
 	NodeContainer GetCurrentSystemGsNodes();
 	Ptr<Constellation> FindConstellationBySatId(uint32_t satId);
 
+	/**
+	 * \brief Directed links able to carry traffic now: both directions of every uninterrupted ISL and of every attached GSL
+	 */
+	std::vector<TopologyLink> GetCurrentLinks();
+	/**
+	 * \brief Run a callback with the other periodic topology updates, every dynamic_state_update_interval_ns
+	 */
+	void AddTopologyTickPhase(std::string name, TopologyTickPhase order, Callback<void, double> phase);
+	int64_t GetTopologyTickIntervalNs();
+
 
 private:
 
@@ -250,6 +293,7 @@ private:
 	void ReadAirCrafts();
 	// waiting to be modified todo
 	void MakeAirCraftFlyingEvent(double time, double speed);
+	void UpdateAirCraftPositions(double time);
     double getLatitudeDistance() const {
         // 假设地球是一个球体，计算纬度上每度的距离
         double radius = 6371000; // 地球半径（米）
@@ -296,6 +340,24 @@ private:
 	 */
 	//<<<<<<<<<<<<<<<< todo: optimize
 	void MakeRegularISLChangeEvent(double time);
+	/**
+	 * \brief Whether a regular inter-orbit ISL between satellites at these positions is interrupted
+	 */
+	bool BeyondISLSwitchLatitude(const Vector& position0, const Vector& position1);
+	/**
+	 * \brief Tick at which MakeRegularISLChangeEvent will take this inter-orbit ISL down
+	 *
+	 * \return the simulation end time if the link survives the run
+	 */
+	Time PredictRegularISLDisconnection(uint32_t satId0, uint32_t satId1);
+	/**
+	 * \brief Publish the scheduled lifetime of an ISL to both of its devices, see SAGLinkLayer::SetScheduledUpUntil ()
+	 */
+	void SetRegularISLUpUntil(NetDeviceContainer& islNetDevices, uint32_t satId0, uint32_t satId1, Time until);
+	/**
+	 * \brief Re-predict the lifetime of an up inter-orbit ISL once the previous prediction has passed
+	 */
+	void UpdateRegularISLSchedule(uint32_t satId0, uint32_t satId1);
 	/**
 	 * \brief Add link by satellite Ids
 	 *
@@ -377,6 +439,44 @@ private:
 	 */
 	void DisableGSLByGndAndSat(Ptr<Node> gs, Ptr<Node> sat, uint32_t interface); // for ground stations owning only one interface
 
+	/**
+	 * \brief Position and velocity of a node in the current time slot
+	 *
+	 * All nodes are read from their mobility models once per slot, phases of the same tick share the arrays.
+	 */
+	const Vector& GetTickPosition(Ptr<Node> node);
+	const Vector& GetTickVelocity(Ptr<Node> node);
+	void RefreshTickKinematics();
+	/**
+	 * \brief Mark the shared positions stale, to be called by every phase that moves nodes
+	 */
+	void InvalidateTickKinematics();
+	/**
+	 * \brief Periodic topology updates after time 0 run as phases of one aggregated tick
+	 */
+	void StartTopologyTicks();
+
+	/**
+	 * \brief Publish the MPI lookahead of the epoch starting at timeNs
+	 *
+	 * The lookahead is the smallest propagation delay of any ISL or GSL between this system
+	 * and another one over this epoch and the next one, computed from the predicted positions
+	 * of the nodes of these links.
+	 *
+	 * \param timeNs		Epoch start
+	 */
+	void UpdateDistributedLookahead(int64_t timeNs);
+	/**
+	 * \brief Write system_<id>_mpi_lookahead.txt, from which the MPI simulator takes its lookahead
+	 */
+	void WriteMpiLookahead(int64_t lookaheadNs);
+	/**
+	 * \brief Position of a node at a future time
+	 *
+	 * \return false if the node moves but its trajectory cannot be predicted
+	 */
+	bool PredictPosition(Ptr<Node> node, int64_t timeNs, Vector& position);
+
 
 
 	/**
@@ -455,6 +555,7 @@ private:
 	// ISL devices
 	std::vector<std::pair<uint32_t, uint32_t>> m_islInterOrbit;  			//<! for star type constellation ISL interruption
 	std::map<std::string, std::pair<bool, bool>> m_islDisableNetDevices; 	//<! ISL interruption information: First element represents regular interruption or not; Second element represents unpredictable interruption or not
+	bool m_publishIslSchedule = false;										//!< Publish the lifetime of regular ISLs to their devices
 
 
 	// GSL devices
@@ -474,6 +575,20 @@ private:
 	int64_t m_isl_max_queue_size_pkts;
 	int64_t m_gsl_max_queue_size_pkts;
 	bool m_enable_link_utilization_tracking = false;
+	bool m_enableGslAcm = false;
+	double m_gslAcmHysteresisDb;
+	double m_gslAcmSymbolRateBaud;														//!< Zero: derived from the GSL data rate
+	std::map<std::string, Ptr<const SatAcmModcodTable>> m_acmModcodTables;				//!< Key: forward link protocol
+	std::map<std::pair<uint32_t, uint32_t>, SatAcmController> m_acmControllers;		//!< Key: (ground station node id, satellite node id)
+	std::map<SatEnums::SatModcod_t, Time> m_acmResidency;								//!< Of retired controllers
+	uint64_t m_acmSwitches = 0;
+	Ptr<const SatAcmModcodTable> m_acmReturnTable;										//!< DVB-RCS2 waveforms, shared by all satellites
+	std::map<uint32_t, SatAcmController> m_acmReturnControllers;						//!< Key: satellite node id
+	std::map<SatEnums::SatModcod_t, Time> m_acmReturnResidency;						//!< Of retired return controllers
+	uint64_t m_acmReturnSwitches = 0;
+	SinrSnapshotRecorder m_sinrRecorder;												//!< Not opened in the legacy JSON format
+	uint64_t m_sinrTick = 0;
+	bool m_sinrExportJson = false;
 	int64_t m_link_utilization_tracking_interval_ns;
 	double m_time_end;
 	double m_dynamicStateUpdateIntervalNs;
@@ -498,6 +613,18 @@ private:
 	NodeContainer m_nodesGsCurSystem;								//<! Ground station nodes belonging to the current system
 	NodeContainer m_nodesGsCurSystemVirtual;						//<! Virtual ground station nodes in the current system
 	std::vector<int64_t> distributed_node_system_id_assignment;		//<! Node partitioning algorithm
+	double m_mpiLookaheadSafetyMargin;								//!< Fraction the predicted lookahead is reduced by
+	std::unordered_map<uint32_t, std::pair<bool, std::vector<Vector>>> m_lookaheadPredictions;	//!< Positions at the samples of the last epoch, key: node id
+	int64_t m_lookaheadPredictionTimeNs = -1;						//!< Start of the epoch m_lookaheadPredictions belong to
+
+
+	// Periodic topology updates
+	TopologyTickAggregator m_tickAggregator;						//!< Runs the periodic update phases of each time slot
+	std::vector<Vector> m_tickPositions;							//!< Node positions of the current slot, index: node id
+	std::vector<Vector> m_tickVelocities;							//!< Node velocities of the current slot, index: node id
+	bool m_tickKinematicsValid = false;
+	int64_t m_tickKinematicsTimeNs = -1;
+	double m_airCraftSpeed = 20;
 
 
 	// ISL Sun OutAge
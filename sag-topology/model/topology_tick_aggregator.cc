@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#include "topology_tick_aggregator.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+	NS_LOG_COMPONENT_DEFINE ("TopologyTickAggregator");
+
+	TopologyTickAggregator::TopologyTickAggregator ()
+		: m_intervalNs(0),
+		  m_endTimeNs(0),
+		  m_ticks(0)
+	{
+	}
+
+	TopologyTickAggregator::~TopologyTickAggregator ()
+	{
+	}
+
+	void
+	TopologyTickAggregator::AddPhase(std::string name, TopologyTickPhase order, Callback<void, double> phase){
+		NS_ASSERT_MSG(!phase.IsNull(), "Tick phase " + name + " has no callback");
+		Phase p;
+		p.m_name = name;
+		p.m_order = order;
+		p.m_callback = phase;
+		p.m_calls = 0;
+		p.m_totalSeconds = 0;
+		p.m_maxSeconds = 0;
+		m_phases.push_back(p);
+		std::stable_sort(m_phases.begin(), m_phases.end(), [](const Phase& a, const Phase& b){
+			return a.m_order < b.m_order;
+		});
+	}
+
+	uint32_t
+	TopologyTickAggregator::GetNPhases() const{
+		return m_phases.size();
+	}
+
+	void
+	TopologyTickAggregator::Start(int64_t firstTickNs, int64_t intervalNs, int64_t endTimeNs, std::string timingsFilename){
+		NS_ASSERT_MSG(intervalNs > 0, "Tick interval must be positive");
+		m_intervalNs = intervalNs;
+		m_endTimeNs = endTimeNs;
+		m_timingsFilename = timingsFilename;
+		if(m_phases.empty() || firstTickNs >= m_endTimeNs){
+			return;
+		}
+		Simulator::Schedule(NanoSeconds(firstTickNs) - Simulator::Now(), &TopologyTickAggregator::Tick, this, firstTickNs);
+	}
+
+	void
+	TopologyTickAggregator::Tick(int64_t timeNs){
+		for(Phase& phase : m_phases){
+			auto start = std::chrono::steady_clock::now();
+			phase.m_callback(timeNs);
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			phase.m_calls++;
+			phase.m_totalSeconds += seconds;
+			phase.m_maxSeconds = std::max(phase.m_maxSeconds, seconds);
+		}
+		m_ticks++;
+
+		int64_t next_update_ns = timeNs + m_intervalNs;
+		if (next_update_ns < m_endTimeNs) {
+			Simulator::Schedule(NanoSeconds(m_intervalNs), &TopologyTickAggregator::Tick, this, next_update_ns);
+		}
+		else if(!m_timingsFilename.empty()){
+			WriteTimings(m_timingsFilename);
+		}
+	}
+
+	void
+	TopologyTickAggregator::WriteTimings(std::string filename) const{
+		std::ofstream ofs(filename, std::ofstream::out);
+		if(!ofs.is_open()){
+			throw std::runtime_error("Cannot open tick timings file " + filename);
+		}
+		ofs << "phase,calls,total_s,mean_ms,max_ms" << std::endl;
+		for(const Phase& phase : m_phases){
+			double meanMs = phase.m_calls == 0 ? 0 : phase.m_totalSeconds * 1e3 / phase.m_calls;
+			ofs << phase.m_name << "," << phase.m_calls << "," << phase.m_totalSeconds << ","
+					<< meanMs << "," << phase.m_maxSeconds * 1e3 << std::endl;
+		}
+		ofs.close();
+		NS_LOG_INFO("Wrote timings of " << m_ticks << " topology ticks to " << filename);
+	}
+
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+#ifndef TOPOLOGY_TICK_AGGREGATOR_H
+#define TOPOLOGY_TICK_AGGREGATOR_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/// Execution order of the phases of a topology tick, phases of equal order run in registration order
+typedef enum {
+	TOPOLOGY_TICK_MOBILITY = 0,			//!< Satellite coordinates, aircraft positions
+	TOPOLOGY_TICK_ISL = 1,				//!< Regular ISL switching, sun outage
+	TOPOLOGY_TICK_GSL = 2,				//!< GSL handover
+	TOPOLOGY_TICK_CHANNEL = 3,			//!< Propagation delay, MPI lookahead
+	TOPOLOGY_TICK_LINK_QUALITY = 4,		//!< SINR and packet error rate
+	TOPOLOGY_TICK_FLOW = 5				//!< Flow-level rate allocation
+} TopologyTickPhase;
+
+/**
+ * \ingroup SatelliteNetwork
+ *
+ * \brief Runs all periodic topology updates of one time slot in a single scheduler event
+ *
+ * Each phase is called with the tick time in ns. The wall-clock time spent in
+ * every phase is accumulated and written once the last tick has run.
+ */
+class TopologyTickAggregator
+{
+public:
+	TopologyTickAggregator ();
+	virtual ~TopologyTickAggregator ();
+
+	void AddPhase(std::string name, TopologyTickPhase order, Callback<void, double> phase);
+	uint32_t GetNPhases() const;
+
+	/**
+	 * \brief Schedule the ticks firstTickNs, firstTickNs + intervalNs, ... before endTimeNs
+	 * \param timingsFilename		File the per-phase timings are written to after the last tick, none if empty
+	 */
+	void Start(int64_t firstTickNs, int64_t intervalNs, int64_t endTimeNs, std::string timingsFilename);
+
+	void WriteTimings(std::string filename) const;
+
+private:
+	struct Phase {
+		std::string m_name;
+		TopologyTickPhase m_order;
+		Callback<void, double> m_callback;
+		uint64_t m_calls;
+		double m_totalSeconds;
+		double m_maxSeconds;
+	};
+
+	void Tick(int64_t timeNs);
+
+	std::vector<Phase> m_phases;
+	int64_t m_intervalNs;
+	int64_t m_endTimeNs;
+	uint64_t m_ticks;
+	std::string m_timingsFilename;
+};
+
+}
+
+#endif /* TOPOLOGY_TICK_AGGREGATOR_H */
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2023 NJU
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Xiaoyu Liu <xyliu0119@163.com>
+ */
+
+/**
+ * Regression tests of the routing and handover outputs
+ *
+ * Every test case runs the canonical scenario of test/regression/walker-6x11
+ * (a 6x11 Walker delta constellation, two ground stations and a UDP flow in
+ * each direction) with one routing configuration and compares with the
+ * golden output of test/regression/golden/<variant>.json:
+ *
+ * - forwarding state: next hop node of every node towards every ground
+ *   station, sampled during the run, -1 if there is no route
+ * - GSL handovers: every association change of the handover log
+ * - route traces: node sequence of every path change of every flow
+ * - per-flow delay: number of samples, average, minimum and maximum in us
+ *
+ * Forwarding state, handovers and node sequences must match exactly, times
+ * and delays within the tolerances below. The scenario is built in a child
+ * process per case, see BenchmarkReport::RunIsolated, so that every case
+ * starts from a fresh simulator. A case simulates 120 s of the whole
+ * constellation, so the cases are EXTENSIVE: ./test.py -s sag-regression -f EXTENSIVE
+ *
+ * A missing golden output fails the case. Golden outputs are only written
+ * with SAG_REGRESSION_UPDATE_GOLDEN=1, after an intended change of behavior
+ * record all of them again and review the diff:
+ *
+ * SAG_REGRESSION_UPDATE_GOLDEN=1 ./test.py -s sag-regression -f EXTENSIVE
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/core-module.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/packet.h"
+#include "ns3/socket.h"
+#include "ns3/json.hpp"
+#include "ns3/log_sink.h"
+#include "ns3/benchmark_report.h"
+#include "ns3/basic-simulation.h"
+#include "ns3/topology-satellite-network.h"
+#include "ns3/gsl_handover_recorder.h"
+#include "ns3/satellite_to_ground_routing_configure.h"
+#include "ns3/satellite_to_ground_routing_ipv6_configure.h"
+#include "ns3/open_shortest_path_first_configure.h"
+#include "ns3/minimum_hop_routing_configure.h"
+#include "ns3/minimum_hop_routing_ipv6_configure.h"
+#include "ns3/traffic_light_based_routing_configure.h"
+#include "ns3/sag_application_schedule_udp.h"
+
+using namespace ns3;
+
+/// Sampling of the forwarding state, offset from the topology updates at whole seconds
+static const double FORWARDING_SAMPLE_INTERVAL_S = 10;
+static const double FORWARDING_SAMPLE_OFFSET_S = 0.5;
+
+/// Tolerances of the times and delays
+static const double ROUTE_TIME_TOLERANCE_US = 1000;
+static const double DELAY_ABS_TOLERANCE_US = 10;
+static const double DELAY_REL_TOLERANCE = 0.01;
+
+static nlohmann::json
+ReadJson(std::string filename){
+	std::ifstream ifs(filename);
+	if(!ifs.is_open()){
+		throw std::runtime_error("Cannot open " + filename);
+	}
+	return nlohmann::json::parse(ifs);
+}
+
+static void
+WriteJson(std::string filename, const nlohmann::json& content){
+	std::ofstream ofs(filename, std::ofstream::out | std::ofstream::trunc);
+	ofs << content.dump(1) << std::endl;
+	if(!ofs){
+		throw std::runtime_error("Cannot write " + filename);
+	}
+}
+
+/**
+ * Next hop node of every node towards every ground station at the current time
+ */
+static void
+RecordForwardingState(Ptr<TopologySatelliteNetwork> topology, nlohmann::json* samples){
+
+	const NodeContainer& nodes = topology->GetNodes();
+	// gateways are interface addresses
+	std::map<uint32_t, int64_t> addressToNode;
+	for(uint32_t n = 0; n < nodes.GetN(); n++){
+		Ptr<Ipv4> ipv4 = nodes.Get(n)->GetObject<Ipv4>();
+		for(uint32_t i = 0; i < ipv4->GetNInterfaces(); i++){
+			for(uint32_t a = 0; a < ipv4->GetNAddresses(i); a++){
+				addressToNode[ipv4->GetAddress(i, a).GetLocal().Get()] = nodes.Get(n)->GetId();
+			}
+		}
+	}
+
+	const NodeContainer& groundStations = topology->GetGroundStationNodes();
+	nlohmann::json nextHops = nlohmann::json::array();
+	for(uint32_t n = 0; n < nodes.GetN(); n++){
+		Ptr<Node> node = nodes.Get(n);
+		Ptr<Ipv4RoutingProtocol> routing = node->GetObject<Ipv4>()->GetRoutingProtocol();
+		nlohmann::json row = nlohmann::json::array();
+		for(uint32_t g = 0; g < groundStations.GetN(); g++){
+			Ptr<Node> destination = groundStations.Get(g);
+			if(destination == node){
+				row.push_back(node->GetId());
+				continue;
+			}
+			// the address of the first interface after the loopback, as used by the applications
+			Ipv4Header header;
+			header.SetDestination(destination->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal());
+			Socket::SocketErrno error;
+			Ptr<Ipv4Route> route = routing->RouteOutput(Create<Packet>(), header, 0, error);
+			if(route == 0){
+				row.push_back(-1);
+			}
+			else if(route->GetGateway() == Ipv4Address::GetAny()){
+				row.push_back(destination->GetId());
+			}
+			else{
+				auto it = addressToNode.find(route->GetGateway().Get());
+				row.push_back(it == addressToNode.end() ? -1 : it->second);
+			}
+		}
+		nextHops.push_back(row);
+	}
+	samples->push_back({{"time_ns", Simulator::Now().GetNanoSeconds()}, {"next_hop", nextHops}});
+}
+
+/**
+ * Build and run the scenario of runDir and write the outputs compared by the tests to filename
+ */
+static void
+RunScenario(std::string runDir, std::string filename){
+
+	Ptr<BasicSimulation> basicSimulation = CreateObject<BasicSimulation>(runDir);
+
+	std::vector<std::pair<SAGRoutingHelper, int16_t>> ipv4Routing;
+	std::vector<std::pair<SAGRoutingHelperIPv6, int16_t>> ipv6Routing;
+	SatellitetoGroundRoutingConfigure satelliteToGround(basicSimulation, ipv4Routing);
+	OpenShortestPathFirstConfigure ospf(basicSimulation, ipv4Routing);
+	MinimumHopRoutingConfigure minimumHop(basicSimulation, ipv4Routing);
+	TrafficLightBasedRoutingConfigure tlr(basicSimulation, ipv4Routing);
+	SatellitetoGroundRoutingIPv6Configure satelliteToGroundIPv6(basicSimulation, ipv6Routing);
+	MinimumHopRoutingIPv6Configure minimumHopIPv6(basicSimulation, ipv6Routing);
+
+	Ptr<TopologySatelliteNetwork> topology = CreateObject<TopologySatelliteNetwork>(basicSimulation, ipv4Routing, ipv6Routing);
+	satelliteToGround.Initialize(topology);
+	ospf.Initialize(topology);
+	minimumHop.Initialize(topology);
+	tlr.Initialize(topology);
+	satelliteToGroundIPv6.Initialize(topology);
+	minimumHopIPv6.Initialize(topology);
+
+	SAGApplicationSchedulerUdp udp(basicSimulation, topology);
+
+	nlohmann::json forwarding = nlohmann::json::array();
+	for(double t = FORWARDING_SAMPLE_OFFSET_S; t * 1e9 < basicSimulation->GetSimulationEndTimeNs(); t += FORWARDING_SAMPLE_INTERVAL_S){
+		Simulator::Schedule(Seconds(t), &RecordForwardingState, topology, &forwarding);
+	}
+
+	basicSimulation->Run();
+	udp.WriteResults();
+	LogSink::Flush();
+
+	nlohmann::json output;
+	output["forwarding"] = forwarding;
+
+	nlohmann::json handovers = nlohmann::json::array();
+	GslHandoverReader reader(basicSimulation->GetLogsDir() + "/system_"
+			+ std::to_string(basicSimulation->GetSystemId()) + "_" + GSL_HANDOVER_LOG_FILE);
+	for(const GslHandoverEvent& event : reader.GetEvents()){
+		handovers.push_back({event.m_timeNs, event.m_groundNode, event.m_interface,
+			event.m_oldSatellite == GSL_HANDOVER_NO_SATELLITE ? -1 : int64_t(event.m_oldSatellite),
+			event.m_newSatellite == GSL_HANDOVER_NO_SATELLITE ? -1 : int64_t(event.m_newSatellite),
+			event.m_reason});
+	}
+	output["handovers"] = handovers;
+
+	// a flow without any received packet has no result files
+	nlohmann::json schedule = ReadJson(runDir + "/config_traffic/application_schedule_udp.json")["udp_flows"];
+	nlohmann::json flows = nlohmann::json::array();
+	for(auto& entry : schedule){
+		std::string name = "udp_" + std::to_string(entry["flow_id"].get<int64_t>());
+		std::string prefix = runDir + "/results/network_results/object_statistics/" + name + "/" + name;
+		nlohmann::json flow = {{"name", name}};
+		if(file_exists(prefix + "_path_log.json")){
+			nlohmann::json path = ReadJson(prefix + "_path_log.json")["path_info"];
+			nlohmann::json delay = ReadJson(prefix + "_delay_log.json");
+			flow["route"] = {{"node_ids", path["path_node_ids"]}, {"timestamp_us", path["path_hop_count_timestamp_us"]}};
+			// the average of the file is named _ms but depends on the scheduler, take it from the samples
+			double sumUs = 0;
+			for(auto& sample : delay["delay_sample_us"]){
+				sumUs += sample.get<double>();
+			}
+			flow["samples"] = delay["delay_sample_us"].size();
+			flow["delay"] = {{"average_us", delay["delay_sample_us"].empty() ? 0 : sumUs / delay["delay_sample_us"].size()},
+					{"min_us", delay["min_delay_us"]}, {"max_us", delay["max_delay_us"]}};
+		}
+		flows.push_back(flow);
+	}
+	output["flows"] = flows;
+
+	WriteJson(filename, output);
+	basicSimulation->Finalize();
+}
+
+/**
+ * \brief First difference of actual to expected, empty if none
+ *
+ * Numbers may differ by absTolerance + relTolerance * |expected|.
+ */
+static std::string
+FindMismatch(const nlohmann::json& expected, const nlohmann::json& actual, std::string path,
+		double absTolerance = 0, double relTolerance = 0){
+	if(expected.is_number() && actual.is_number()){
+		double e = expected.get<double>();
+		double a = actual.get<double>();
+		if(std::fabs(e - a) > absTolerance + relTolerance * std::fabs(e)){
+			return path + ": expected " + expected.dump() + ", got " + actual.dump();
+		}
+		return "";
+	}
+	if(expected.type() != actual.type()){
+		return path + ": expected " + expected.dump() + ", got " + actual.dump();
+	}
+	if(expected.is_array()){
+		if(expected.size() != actual.size()){
+			return path + ": expected " + std::to_string(expected.size()) + " entries, got " + std::to_string(actual.size());
+		}
+		for(uint32_t i = 0; i < expected.size(); i++){
+			std::string mismatch = FindMismatch(expected[i], actual[i], path + "[" + std::to_string(i) + "]", absTolerance, relTolerance);
+			if(!mismatch.empty()){
+				return mismatch;
+			}
+		}
+		return "";
+	}
+	if(expected.is_object()){
+		for(auto it = expected.begin(); it != expected.end(); it++){
+			if(actual.count(it.key()) == 0){
+				return path + "." + it.key() + ": missing";
+			}
+			std::string mismatch = FindMismatch(it.value(), actual[it.key()], path + "." + it.key(), absTolerance, relTolerance);
+			if(!mismatch.empty()){
+				return mismatch;
+			}
+		}
+		for(auto it = actual.begin(); it != actual.end(); it++){
+			if(expected.count(it.key()) == 0){
+				return path + "." + it.key() + ": unexpected";
+			}
+		}
+		return "";
+	}
+	return expected == actual ? "" : path + ": expected " + expected.dump() + ", got " + actual.dump();
+}
+
+/**
+ * \ingroup SatelliteNetwork
+ *
+ * \brief Run the canonical scenario with a routing configuration and compare with its golden output
+ */
+class SagRegressionTestCase : public TestCase
+{
+public:
+	/**
+	 * \param variant		Name of the case and of its golden output
+	 * \param patches		JSON merge patches of the canonical run directory, see BenchmarkReport::DeriveRunDir
+	 */
+	SagRegressionTestCase (std::string variant, std::map<std::string, nlohmann::json> patches);
+	virtual ~SagRegressionTestCase ();
+
+private:
+	virtual void DoRun (void);
+
+	std::string m_variant;
+	std::map<std::string, nlohmann::json> m_patches;
+};
+
+SagRegressionTestCase::SagRegressionTestCase (std::string variant, std::map<std::string, nlohmann::json> patches)
+	: TestCase ("Routing and handover outputs of " + variant),
+	  m_variant (variant),
+	  m_patches (patches)
+{
+	// the topology writes its generated files next to the constellation, copy it
+	m_patches["config_topology/config_constellation.json"] = nlohmann::json::object();
+}
+
+SagRegressionTestCase::~SagRegressionTestCase (){
+
+}
+
+void
+SagRegressionTestCase::DoRun (void){
+
+	SetDataDir(NS_TEST_SOURCEDIR);
+	std::string runDir = CreateTempDirFilename("sag-regression-" + m_variant);
+	std::string outputFilename = runDir + "/regression_output.json";
+	BenchmarkReport::DeriveRunDir(CreateDataDirFilename("regression/walker-6x11"), runDir, m_patches);
+
+	int status = BenchmarkReport::RunIsolated([&](){
+		RunScenario(runDir, outputFilename);
+	});
+	NS_TEST_ASSERT_MSG_EQ(status, 0, "Scenario " << m_variant << " failed, see the output above and " << runDir);
+	nlohmann::json actual = ReadJson(outputFilename);
+
+	std::string goldenDir = CreateDataDirFilename("regression/golden");
+	std::string goldenFilename = goldenDir + "/" + m_variant + ".json";
+	const char* update = std::getenv("SAG_REGRESSION_UPDATE_GOLDEN");
+	if(update != NULL && std::string(update) == "1"){
+		mkdir_if_not_exists(goldenDir);
+		WriteJson(goldenFilename, actual);
+		std::cout << "Recorded golden output " << goldenFilename << std::endl;
+		return;
+	}
+	NS_TEST_ASSERT_MSG_EQ(file_exists(goldenFilename), true, "No golden output " << goldenFilename
+			<< ", record it with SAG_REGRESSION_UPDATE_GOLDEN=1 and check it in");
+	nlohmann::json golden = ReadJson(goldenFilename);
+
+	NS_TEST_EXPECT_MSG_EQ(FindMismatch(golden["forwarding"], actual["forwarding"], "forwarding"), "",
+			"Forwarding state of " << m_variant << " differs");
+	NS_TEST_EXPECT_MSG_EQ(FindMismatch(golden["handovers"], actual["handovers"], "handovers"), "",
+			"GSL handovers of " << m_variant << " differ");
+
+	NS_TEST_ASSERT_MSG_EQ(golden["flows"].size(), actual["flows"].size(), "Number of flows of " << m_variant << " differs");
+	for(uint32_t i = 0; i < golden["flows"].size(); i++){
+		nlohmann::json& expected = golden["flows"][i];
+		nlohmann::json& flow = actual["flows"][i];
+		std::string name = expected.value("name", std::to_string(i));
+		NS_TEST_EXPECT_MSG_EQ(flow.count("route"), expected.count("route"), "Flow " << name << " of " << m_variant << " received packets in only one of the runs");
+		if(expected.count("route") == 0 || flow.count("route") == 0){
+			continue;
+		}
+		NS_TEST_EXPECT_MSG_EQ(FindMismatch(expected["route"]["node_ids"], flow["route"]["node_ids"], name + ".route.node_ids"), "",
+				"Route trace of " << m_variant << " differs");
+		NS_TEST_EXPECT_MSG_EQ(FindMismatch(expected["route"]["timestamp_us"], flow["route"]["timestamp_us"], name + ".route.timestamp_us",
+				ROUTE_TIME_TOLERANCE_US), "", "Route change times of " << m_variant << " differ");
+		NS_TEST_EXPECT_MSG_EQ(FindMismatch(expected["samples"], flow["samples"], name + ".samples"), "",
+				"Received packets of " << m_variant << " differ");
+		NS_TEST_EXPECT_MSG_EQ(FindMismatch(expected["delay"], flow["delay"], name + ".delay",
+				DELAY_ABS_TOLERANCE_US, DELAY_REL_TOLERANCE), "", "Delay of " << m_variant << " differs");
+	}
+}
+
+/**
+ * \ingroup SatelliteNetwork
+ *
+ * \brief Deterministic regression tests of the routing strategies and the GSL switching
+ *
+ * TopologySatelliteNetwork::ReadConfig always creates SwitchTriggeredByInvisible,
+ * DistanceNearestFirst and GeographicInformationAwareSwitching cannot be
+ * selected by a run directory. Every case therefore covers the switching
+ * triggered by invisibility, the elevation case makes it switch more often.
+ * Cases per switching strategy are out of scope until the strategy can be
+ * configured.
+ */
+class SagRegressionTestSuite : public TestSuite
+{
+public:
+	SagRegressionTestSuite ();
+};
+
+static nlohmann::json
+EnableRouting(std::string protocol, std::string key){
+	return {{"routing", {{protocol, {{key, true}}}}}};
+}
+
+SagRegressionTestSuite::SagRegressionTestSuite ()
+	: TestSuite ("sag-regression", TestSuite::SYSTEM)
+{
+	std::string ip = "config_protocol/ip_global_attribute.json";
+	AddTestCase (new SagRegressionTestCase ("ospf", {{ip, EnableRouting("ospf", "ospf_enabled")}}), TestCase::EXTENSIVE);
+	AddTestCase (new SagRegressionTestCase ("minimum_hop", {{ip, EnableRouting("minhop", "minhop_enabled")}}), TestCase::EXTENSIVE);
+	AddTestCase (new SagRegressionTestCase ("tlr", {{ip, EnableRouting("tlr", "tlr_enabled")}}), TestCase::EXTENSIVE);
+	AddTestCase (new SagRegressionTestCase ("gsl_elevation_25", {{ip, EnableRouting("minhop", "minhop_enabled")},
+			{"config_protocol/physical_global_attribute.json", {{"antenna", {{"minimum_elevation_angle_deg", 25}}}}}}), TestCase::EXTENSIVE);
+}
+
+static SagRegressionTestSuite g_sagRegressionTestSuite;
@@ -6,6 +6,9 @@
 #include "ns3/sgp4coord.h"
 #include "ns3/cppmap3d.hh"
 #include "ns3/cppjson2structure.hh"
+#include "ns3/gsl_handover_recorder.h"
+#include "ns3/log_sink.h"
+#include <tuple>
 
 
 
@@ -597,13 +600,40 @@ namespace ns3 {
 		std::string simulation_end_string = simulation_end.ToStringiso();
 		
 
-		std::vector<ConnectionLink> infos = m_topology->GetSatellite2GroundConnectionLinkDetails();
-		for(uint32_t i = 0; i < infos.size(); i++){
-			ConnectionLink link = infos[i];
-			uint32_t gndId = link.nodeid1;
-			for(uint32_t j = 0; j < link.connectionTimeInterval.size(); j++){
+		// One entry per (ground node, satellite) with its connected periods in seconds
+		std::vector<std::pair<std::pair<uint32_t, uint32_t>, std::vector<std::pair<double, double>>>> handoverLinks;
+		std::string handoverLog = m_basicSimulation->GetLogsDir() + "/system_" + std::to_string(m_basicSimulation->GetSystemId()) + "_" + GSL_HANDOVER_LOG_FILE;
+		// the log is written through the LogSink
+		LogSink::Flush();
+		if(file_exists(handoverLog)){
+			// Rebuilt from the handover log, which only holds association changes
+			GslHandoverReader reader(handoverLog);
+			std::map<std::tuple<uint32_t, uint32_t, uint32_t>, uint32_t> linkIndex;
+			for(auto interval : reader.GetConnectionIntervals(Simulator::Now().GetNanoSeconds())){
+				std::tuple<uint32_t, uint32_t, uint32_t> key = std::make_tuple(interval.m_groundNode, interval.m_interface, interval.m_satellite);
+				if(linkIndex.find(key) == linkIndex.end()){
+					linkIndex[key] = handoverLinks.size();
+					handoverLinks.push_back(std::make_pair(std::make_pair(interval.m_groundNode, interval.m_satellite), std::vector<std::pair<double, double>>()));
+				}
+				handoverLinks[linkIndex[key]].second.push_back(std::make_pair(interval.m_startNs / 1e9, interval.m_endNs / 1e9));
+			}
+		}
+		else{
+			std::vector<ConnectionLink> infos = m_topology->GetSatellite2GroundConnectionLinkDetails();
+			for(uint32_t i = 0; i < infos.size(); i++){
+				ConnectionLink link = infos[i];
+				for(uint32_t j = 0; j < link.connectionTimeInterval.size(); j++){
+					handoverLinks.push_back(std::make_pair(std::make_pair(link.nodeid1, link.satnodes[j]), link.connectionTimeInterval[j]));
+				}
+			}
+		}
+
+		for(uint32_t i = 0; i < handoverLinks.size(); i++){
+			uint32_t gndId = handoverLinks[i].first.first;
+			{
 				// for one link
-				uint32_t satId = link.satnodes[j];
+				uint32_t satId = handoverLinks[i].first.second;
+				const std::vector<std::pair<double, double>>& connectionTimeInterval = handoverLinks[i].second;
 				string id = std::to_string(gndId) + "-to-" + std::to_string(satId);
 				string name = std::to_string(gndId) + " to " + std::to_string(satId);
 				string position1 = std::to_string(gndId)+"#position";
@@ -618,8 +648,8 @@ namespace ns3 {
 				polyline["arcType"] = "NONE";
 				polyline["width"] = 1;
 
-				JulianDate start = randomSatelliteNode->GetObject<SatellitePositionMobilityModel>()->GetStartTime() + Seconds(link.connectionTimeInterval[j][0].first);
-				JulianDate end = randomSatelliteNode->GetObject<SatellitePositionMobilityModel>()->GetStartTime() + Seconds(link.connectionTimeInterval[j][link.connectionTimeInterval[j].size()-1].second);
+				JulianDate start = randomSatelliteNode->GetObject<SatellitePositionMobilityModel>()->GetStartTime() + Seconds(connectionTimeInterval[0].first);
+				JulianDate end = randomSatelliteNode->GetObject<SatellitePositionMobilityModel>()->GetStartTime() + Seconds(connectionTimeInterval[connectionTimeInterval.size()-1].second);
 				std::string start_string = start.ToStringiso();
 				std::string end_string = end.ToStringiso();
 
@@ -634,8 +664,8 @@ namespace ns3 {
 					showArray.push_back(TempshowArray);
 				}
 
-				for(uint32_t k = 0; k < link.connectionTimeInterval[j].size(); k++){
-					std::pair<double, double> pair = link.connectionTimeInterval[j][k];
+				for(uint32_t k = 0; k < connectionTimeInterval.size(); k++){
+					std::pair<double, double> pair = connectionTimeInterval[k];
 					auto curstart = simulation_start + Seconds(pair.first);
 					auto curend = simulation_start + Seconds(pair.second);
 					std::string time = curstart.ToStringiso()+'/' +curend.ToStringiso();
@@ -646,10 +676,10 @@ namespace ns3 {
 					};
 					showArray.push_back(showArray_duation);
 
-					if(k != link.connectionTimeInterval[j].size()-1)
+					if(k != connectionTimeInterval.size()-1)
 					{
 						auto curstart1 = simulation_start + Seconds(pair.second);
-						auto curend1 = simulation_start + Seconds(link.connectionTimeInterval[j][k+1].first);
+						auto curend1 = simulation_start + Seconds(connectionTimeInterval[k+1].first);
 						std::string time1 = curstart1.ToStringiso()+'/' +curend1.ToStringiso();
 						showArray_duation ={
 							{ "interval", time1 },